@@ -22,6 +22,10 @@
  * @property {number} cameraBrightness - Helligkeit (6 = sehr dunkel, 5 = dunkel, 4 = normal (default), 3 = hell, 2 = sehr hell)
  * @property {number} cameraContrast - Kontrast (6 = sehr schwach, 5 = schwach, 4 = normal (default), 3 = stark, 2 = sehr stark)
  * @property {number} cameraSpecialEffect - Spezialeffekte (0 = Altmodisch, 1 = Blaustich, 2 = Grünstich, 3 = Rotstich, 4 = Schwarzweiß, 5 = Farben invertiert, 6 = Schwarzweiß Negativ, 7 = kein Effekt (default))
+ * @property {number} imageMaxAgeDays - Bilder, die älter sind, werden gelöscht (in Tagen, 0 = nie)
+ * @property {number} imageThinAfterDays - Von älteren Tagen bleibt nur ein Bild (in Tagen, 0 = aus)
+ * @property {number} imageMaxMB - Maximaler Speicher für Bilder in MB (0 = unbegrenzt)
+ * @property {number} sdMinFreePercent - Freier Speicher auf der SD-Karte in %, der mindestens erhalten bleibt
  * @property {string} lamp1Mode - Der Steuermodus ('auto', 'on', 'off') für die Lampe 1 (A1).
  * @property {string} lamp2Mode - Der Steuermodus ('auto', 'on', 'off') für die Lampe 2 (A2).
  * @property {string} heaterMode - Der Steuermodus ('auto', 'on', 'off') für die Heizung (A3).
@@ -50,6 +54,15 @@
  * @typedef {object} ImageFile
  * @property {string} path - Der Pfad zum Bild auf der SD-Karte
  * @property {number} size - Die Größe der Datei in Bytes
+ * @property {number} [time] - Aufnahmezeit (Unix-Zeit in Sekunden, fehlt = unbekannt)
+ */
+
+/**
+ * @typedef {object} ImageListPage
+ * @property {ImageFile[]} images - Die Bilder dieser Seite, die neuesten zuerst
+ * @property {number|null} after - Cursor, mit dem die Seite angefordert wurde (null = erste Seite)
+ * @property {number|null} next - Cursor für die nächste (ältere) Seite (null = keine älteren Bilder)
+ * @property {number} total - Anzahl aller Bilder auf der SD-Karte
  */
 
 /**
@@ -57,6 +70,7 @@
  * @property {string} type - Der Typ der Nachricht (z.B. 'state', 'newImage')
  * @property {State} [values] - Nur bei type='state' oder 'settings'
  * @property {string} [path] - Nur bei type='newImage'
+ * @property {string} [url] - Nur bei type='newImage': Adresse des Bildes im RAM des ESP32 (z.B. "/img/7")
  */
 
 // === Globale Variablen ===
@@ -64,9 +78,18 @@
 /** @type {WebSocket} Die WebSocket-Verbindung zum ESP32 */
 let websocket = null;
 
-/** @type {string[]} Liste der Bildpfade (z.B. ["/img_2025...jpg", ...]) */
+/** @type {string[]} Liste der Bildpfade (z.B. ["/img/2025/12/05/103000.jpg", ...]) */
 let imagePaths = [];
 
+/** @type {Object<string, string>} Bilder, die noch im RAM des ESP32 liegen (Pfad -> z.B. "/img/7") */
+let imageUrls = {};
+
+/** @type {number|null} Cursor für die nächste Seite der Bilderliste (null = alle Bilder geladen) */
+let imageListNext = null;
+
+/** @type {number} Bilder pro Seite der Bilderliste */
+const IMAGE_LIST_PAGE_SIZE = 50;
+
 /** @type {number} Der Index des aktuell angezeigten Bildes im imagePaths Array */
 let currentImageIndex = -1; // -1 == keine Bilder geladen
 
@@ -76,6 +99,45 @@ let timelapseTimerId = null;
 /** @type {boolean} Status, ob der Zeitraffer gerade läuft */
 let isPlaying = false;
 
+/** @type {State} Letzter bekannter Stand der Sensoren und Aktoren (der Server sendet meist nur Änderungen) */
+let currentState = {};
+
+/** @type {boolean} Status, ob gerade das Live-Bild (/stream) angezeigt wird */
+let isLive = false;
+
+/** @type {number} Intervall in ms, in dem der Verlauf neu angefordert wird */
+const HISTORY_REFRESH_INTERVAL = 60000;
+
+/** @type {number} Anzahl der Abschnitte (Punkte) im Verlaufsdiagramm */
+const HISTORY_BUCKETS = 120;
+
+/** @type {object|null} Bisher empfangene Teile der Antwort "history" (der Server sendet sie in Teilen) */
+let historyParts = null;
+
+/** @type {number} Version des binären Status-Frames, die dieses Skript lesen kann (siehe include/StateFrame.h) */
+const STATE_FRAME_VERSION = 1;
+
+/**
+ * Felder des binären Status-Frames mit ihrem Bit in einer der Bitmasken (wie SensorField, ActuatorField und StateFlag
+ * in include/StateFrame.h). Messwerte stehen zusätzlich an einem Offset und gelten nur, wenn ihr Bit in "valid" gesetzt
+ * ist; ohne Offset ist das Feld das Bit selbst.
+ * @type {Array<{name: string, mask: string, bit: number, offset?: number, type?: string, invalid?: *}>}
+ */
+const STATE_FRAME_FIELDS = [
+    {name: 'airTemp', mask: 'valid', bit: 0, offset: 8, type: 'float32', invalid: null},
+    {name: 'humidity', mask: 'valid', bit: 1, offset: 12, type: 'float32', invalid: null},
+    {name: 'soilTemp', mask: 'valid', bit: 2, offset: 16, type: 'float32', invalid: null},
+    {name: 'soilMoisture', mask: 'valid', bit: 3, offset: 20, type: 'int32', invalid: -1},
+    {name: 'lightLux', mask: 'valid', bit: 5, offset: 24, type: 'float32', invalid: null},
+    {name: 'waterLevelOk', mask: 'flags', bit: 0},
+    {name: 'lamp1On', mask: 'actuators', bit: 0},
+    {name: 'lamp2On', mask: 'actuators', bit: 1},
+    {name: 'heaterOn', mask: 'actuators', bit: 2},
+    {name: 'fanOn', mask: 'actuators', bit: 3},
+    {name: 'pumpOn', mask: 'actuators', bit: 4},
+    {name: 'misterOn', mask: 'actuators', bit: 5},
+];
+
 /** @type {number|null} Timer-ID für das Warten auf eine Kamera-Antwort. */
 let captureTimeoutId = null;
 
@@ -108,8 +170,15 @@ window.addEventListener('load', () => {
     document.getElementById('btnPlayPause').addEventListener('click', handlePlayPauseButtonClick);
     document.getElementById('btnPrev').addEventListener('click', handlePrevButtonClick); // 1 Schritt zurück (älter)
     document.getElementById('btnNext').addEventListener('click', handleNextButtonClick); // 1 Schritt vor (neuer)
+    document.getElementById('btnLive').addEventListener('click', handleLiveButtonClick);
     document.getElementById('image-select').addEventListener('change', handleImageSelectChange);
+    document.getElementById('loadOlderImagesButton').addEventListener('click', handleLoadOlderImagesButtonClick);
     document.getElementById('timelapseSpeed').addEventListener('input', handleTimelapseSpeedInput);
+
+    // --- Verlauf ---
+    document.getElementById('history-channel').addEventListener('change', requestHistory);
+    document.getElementById('history-range').addEventListener('change', requestHistory);
+    setInterval(requestHistory, HISTORY_REFRESH_INTERVAL);
 });
 
 // === Ereignishändler ===
@@ -138,7 +207,7 @@ function handleTabLinkClick(event) {
     // Bilder anfordern, wenn Kamera-Tab ausgewählt wurde und noch keine Bilder geladen wurden
     if (tabName === 'Camera' && imagePaths.length === 0) {
         console.log("Fordere Bildliste vom Server an...");
-        sendMessage("getImageList");
+        sendMessage("getImageList", {limit: IMAGE_LIST_PAGE_SIZE});
     }
 }
 
@@ -245,6 +314,19 @@ function handlePlayPauseButtonClick(_event) {
     }
 }
 
+/**
+ * Startet oder stoppt das Live-Bild der Kamera.
+ * @param {Event} _event Das Event-Objekt.
+ */
+function handleLiveButtonClick(_event) {
+    if (isLive) {
+        showImageAtIndex(currentImageIndex); // beendet den Stream (der Browser schließt die Verbindung)
+    } else {
+        stopTimelapse();
+        startLive();
+    }
+}
+
 /**
  * Zeigt das vorherige (ältere) Bild in der Galerie an.
  * @param {Event} _event Das Event-Objekt.
@@ -309,10 +391,13 @@ function initWebsocket() {
 
     console.log('WS: Versuche Verbindung zu ' + gateway);
     websocket = new WebSocket(gateway);
+    websocket.binaryType = 'arraybuffer'; // Binäre Status-Frames als ArrayBuffer empfangen (für DataView)
 
     websocket.onopen = (_event) => {
         console.log('WS: Verbunden.');
         statusIndicator.className = 'status-indicator connected';
+        sendMessage("hello", {stateFormat: 'binary'}); // Status ab jetzt als binären Frame empfangen
+        requestHistory(); // Verlauf nach (Wieder-)Verbindung neu laden
     };
 
     websocket.onclose = (_event) => {
@@ -323,6 +408,15 @@ function initWebsocket() {
     };
 
     websocket.onmessage = (event) => {
+        // Binäre Nachrichten sind immer Status-Frames
+        if (event.data instanceof ArrayBuffer) {
+            const values = decodeStateFrame(event.data);
+            if (values) {
+                handleWSStateMessage(values);
+            }
+            return;
+        }
+
         // Nachricht parsen
         const data = JSON.parse(event.data);
 
@@ -345,7 +439,7 @@ function initWebsocket() {
             case 'newImage':
                 // Ein neues Bild wurde aufgenommen -> Sofort anzeigen
                 if (data.payload && data.payload.path) {
-                    handleWSNewImageMessage(data.payload.path);
+                    handleWSNewImageMessage(data.payload.path, data.payload.url);
                 }
                 break;
 
@@ -354,10 +448,31 @@ function initWebsocket() {
                 handleWSCaptureFailedMessage();
                 break;
 
+            case 'imageSaveFailed':
+                // Ein Bild aus dem RAM konnte nicht auf die SD-Karte geschrieben werden und wurde verworfen
+                if (data.payload && data.payload.path) {
+                    handleWSImageSaveFailedMessage(data.payload.path);
+                }
+                break;
+
             case 'imageList':
-                // Server sendet die Liste der Bilder
+                // Server sendet eine Seite der Bilderliste
                 if (data.payload && data.payload.images) {
-                    handleWSImageListMessage(data.payload.images);
+                    handleWSImageListMessage(data.payload);
+                }
+                break;
+
+            case 'imageListChanged':
+                // Das Bilderverzeichnis wurde neu aufgebaut -> erste Seite neu anfordern
+                if (imagePaths.length > 0) {
+                    sendMessage("getImageList", {limit: IMAGE_LIST_PAGE_SIZE});
+                }
+                break;
+
+            case 'imageRetention':
+                // Alte Bilder wurden automatisch gelöscht
+                if (data.payload) {
+                    handleWSImageRetentionMessage(data.payload);
                 }
                 break;
 
@@ -373,6 +488,28 @@ function initWebsocket() {
                 }
                 break;
 
+            case 'history':
+                // Verlauf eines Messwerts (Minimum, Maximum und Mittelwert je Abschnitt)
+                if (data.payload) {
+                    handleWSHistoryMessage(data.payload);
+                }
+                break;
+
+            case 'job':
+                // Zustand eines Hintergrundauftrags (Aufnahme, Bildliste, Bilder löschen)
+                if (data.payload) {
+                    handleWSJobMessage(data.payload);
+                }
+                break;
+
+            case 'stats':
+                // Laufzeiten der heißen Pfade in µs (mit dem vollständigen Status oder auf "getStats"), nur in der
+                // Konsole (Stufe "Ausführlich")
+                if (data.payload && data.payload.sections) {
+                    console.debug('[ESP32] Laufzeiten in µs', data.payload.sections);
+                }
+                break;
+
             default:
                 console.log("Unbekannter Nachrichtentyp: ", data.type);
         }
@@ -381,10 +518,10 @@ function initWebsocket() {
 
 /**
  * Wird aufgerufen, wenn der Server neue Live-Werte übermittelt hat.
- * @param {object} payload Aktuelle Werte der Sensoren und Aktoren.
+ * @param {object} payload Geänderte (oder alle) Werte der Sensoren und Aktoren.
  */
 function handleWSStateMessage(payload) {
-    const values = /** @type {State} */ payload;
+    const values = /** @type {State} */ Object.assign(currentState, payload);
     let element;
 
     // --- Kachel für Raumklima ---
@@ -439,6 +576,38 @@ function handleWSStateMessage(payload) {
     element.className = values.misterOn ? 'status-on' : 'status-off';
 }
 
+/**
+ * Liest einen binären Status-Frame (Layout siehe include/StateFrame.h, little endian).
+ * @param {ArrayBuffer} buffer Der empfangene Frame.
+ * @returns {State|null} Die Werte im selben Format wie die JSON-Nachricht, oder null bei unbekannter Version.
+ */
+function decodeStateFrame(buffer) {
+    const view = new DataView(buffer);
+    if (buffer.byteLength < 40 || view.getUint8(0) !== STATE_FRAME_VERSION) {
+        console.warn("Unbekannter Status-Frame (Version " + (buffer.byteLength > 0 ? view.getUint8(0) : '?') + ")");
+        return null;
+    }
+    const masks = {valid: view.getUint8(1), actuators: view.getUint8(2), flags: view.getUint8(3)};
+    const values = {
+        seq: view.getUint32(4, true),
+        valid: masks.valid,
+        controlLatencyUs: view.getUint32(28, true),
+        controlLatencyMaxUs: view.getUint32(32, true),
+        controlCycleMaxUs: view.getUint32(36, true),
+    };
+    for (const field of STATE_FRAME_FIELDS) {
+        const set = (masks[field.mask] & (1 << field.bit)) !== 0;
+        if (field.offset === undefined) {
+            values[field.name] = set;
+        } else if (!set) {
+            values[field.name] = field.invalid;
+        } else {
+            values[field.name] = field.type === 'int32' ? view.getInt32(field.offset, true) : view.getFloat32(field.offset, true);
+        }
+    }
+    return values;
+}
+
 /**
  * Wird aufgerufen, wenn Server neue Einstellungen übermittelt hat.
  * @param {object} payload Aktuelle Einstellungen.
@@ -466,6 +635,10 @@ function handleWSSettingsMessage(payload) {
     document.getElementById('cameraBrightness').value = settings['cameraBrightness'];
     document.getElementById('cameraContrast').value = settings['cameraContrast'];
     document.getElementById('cameraSpecialEffect').value = settings['cameraSpecialEffect'];
+    document.getElementById('imageMaxAgeDays').value = settings['imageMaxAgeDays'];
+    document.getElementById('imageThinAfterDays').value = settings['imageThinAfterDays'];
+    document.getElementById('imageMaxMB').value = settings['imageMaxMB'];
+    document.getElementById('sdMinFreePercent').value = settings['sdMinFreePercent'];
     document.querySelector(`input[name="lamp1"][value="${settings.lamp1Mode}"]`).checked = true;
     document.querySelector(`input[name="lamp2"][value="${settings.lamp2Mode}"]`).checked = true;
     document.querySelector(`input[name="heater"][value="${settings.heaterMode}"]`).checked = true;
@@ -477,10 +650,16 @@ function handleWSSettingsMessage(payload) {
 /**
  * Wird aufgerufen, wenn der Server ein neues Bild übermittelt wird.
  * @param {string} path Pfad zum neuen Bild.
+ * @param {string} [url] Adresse des Bildes im RAM des ESP32 (fehlt, wenn es direkt auf die SD-Karte geschrieben wurde).
  */
-function handleWSNewImageMessage(path) {
+function handleWSNewImageMessage(path, url) {
     console.log("Neues Bild empfangen:", path);
 
+    // Solange das Bild im RAM liegt, von dort laden (schneller und ohne Zugriff auf die SD-Karte)
+    if (url) {
+        imageUrls[path] = url;
+    }
+
     resetCaptureButton(); // Button zurücksetzen
 
     // Das Bild im internen Array an die erste Stelle setzen
@@ -491,7 +670,7 @@ function handleWSNewImageMessage(path) {
     if (select) {
         const option = document.createElement('option');
         option.value = path;
-        option.innerText = path.replace(/^\//, ''); // Führenden Slash entfernen
+        option.innerText = getImageLabel(path);
 
         // prepend fügt das Element als erstes Kind ein (Index 0)
         // Das ist viel performanter als innerHTML = '' und alles neu zu bauen.
@@ -516,26 +695,70 @@ function handleWSCaptureFailedMessage() {
 }
 
 /**
- * Wird aufgerufen, wenn der Server die Liste der Bilder sendet.
- * @param {ImageFile[]} images Eine Liste von Bild-Objekten.
+ * Wird aufgerufen, wenn ein Bild endgültig nicht auf die SD-Karte geschrieben werden konnte.
+ * Das Bild wird aus der Liste entfernt, da es weder im RAM noch auf der SD-Karte liegt.
+ * @param {string} path Der Pfad, den "newImage" gemeldet hatte.
+ */
+function handleWSImageSaveFailedMessage(path) {
+    console.error("Server meldet: Bild konnte nicht gespeichert werden:", path);
+    delete imageUrls[path];
+    const idx = imagePaths.indexOf(path);
+    if (idx === -1) {
+        return;
+    }
+    imagePaths.splice(idx, 1);
+    const select = document.getElementById('image-select');
+    const option = select ? Array.from(select.options).find(o => o.value === path) : null;
+    if (option) {
+        option.remove();
+    }
+    if (currentImageIndex === idx) {
+        showImageAtIndex(imagePaths.length > 0 ? 0 : -1);
+    } else if (currentImageIndex > idx) {
+        currentImageIndex--;
+    }
+}
+
+/**
+ * Wird aufgerufen, wenn der Server eine Seite der Bilderliste sendet (bereits nach Aufnahmezeit sortiert).
+ * Die erste Seite ersetzt die Liste, jede weitere wird (mit älteren Bildern) hinten angehängt.
+ * @param {ImageListPage} page Die Seite.
  */
-function handleWSImageListMessage(images) {
-    // Neueste zuerst sortieren, falls nicht schon vom Server erledigt
-    images.sort((a, b) => b.path.localeCompare(a.path));
-    imagePaths = images.map(img => img.path); // Nur die Pfade speichern
+function handleWSImageListMessage(page) {
+    const firstPage = page.after === null;
+    const paths = page.images.map(img => img.path); // Nur die Pfade speichern
+    imagePaths = firstPage ? paths : imagePaths.concat(paths);
+    imageListNext = page.next;
 
     const select = document.getElementById('image-select');
-    select.innerHTML = ''; // Alte Einträge löschen
+    if (firstPage) {
+        select.innerHTML = ''; // Alte Einträge löschen
+    }
+    paths.forEach(path => {
+        const option = document.createElement('option');
+        option.value = path;
+        option.innerText = getImageLabel(path);
+        select.appendChild(option);
+    });
 
-    if (imagePaths.length) {
-        imagePaths.forEach(path => {
-            const option = document.createElement('option');
-            option.value = path;
-            option.innerText = path.replace(/^\//, ''); // Führenden Slash entfernen
-            select.appendChild(option);
-        });
+    const button = document.getElementById('loadOlderImagesButton');
+    button.hidden = imageListNext === null;
+    button.disabled = false;
+
+    if (firstPage) {
+        showImageAtIndex(imagePaths.length > 0 ? 0 : -1); // Erstes Bild anzeigen
+    }
+}
+
+/**
+ * Wird aufgerufen, wenn auf "Ältere Bilder laden" geklickt wurde. Fordert die nächste Seite der Bilderliste an.
+ */
+function handleLoadOlderImagesButtonClick() {
+    if (imageListNext === null) {
+        return;
     }
-    showImageAtIndex(imagePaths.length > 0 ? 0 : -1); // Erstes Bild anzeigen
+    document.getElementById('loadOlderImagesButton').disabled = true; // bis die Seite da ist
+    sendMessage("getImageList", {after: imageListNext, limit: IMAGE_LIST_PAGE_SIZE});
 }
 
 /**
@@ -543,13 +766,161 @@ function handleWSImageListMessage(images) {
  */
 function handleWSImageListClearedMessage() {
     imagePaths = [];
+    imageListNext = null;
+    document.getElementById('loadOlderImagesButton').hidden = true;
     document.getElementById('image-select').innerHTML = '';
     document.getElementById('current-image').src = '';
     document.getElementById('image-timestamp').innerText = '';
 }
 
+/**
+ * Wird aufgerufen, wenn das automatische Aufräumen Bilder gelöscht hat.
+ * @param {{deleted: number, failed: number, reclaimedBytes: number, missingBytes: number, durationMs: number}} run
+ */
+function handleWSImageRetentionMessage(run) {
+    console.log(`Aufräumen: ${run.deleted} Bilder gelöscht, ${(run.reclaimedBytes / 1048576).toFixed(1)} MB frei geworden`);
+    if (run.missingBytes > 0) {
+        console.warn(`Aufräumen: es fehlen noch ${(run.missingBytes / 1048576).toFixed(1)} MB freier Speicher`);
+    }
+    if (imagePaths.length > 0) {
+        sendMessage("getImageList", {limit: IMAGE_LIST_PAGE_SIZE}); // gelöschte Bilder aus der Liste nehmen
+    }
+}
+
+/**
+ * Wird aufgerufen, wenn sich der Zustand eines Hintergrundauftrags ändert (eingereiht, gestartet, Fortschritt, fertig).
+ * Das Ergebnis selbst kommt mit einer eigenen Nachricht (z.B. "newImage", "imageList" oder "imageListCleared").
+ * @param {{id: number, name: string, state: string, done?: number, total?: number, durationMs?: number}} job
+ */
+function handleWSJobMessage(job) {
+    const progress = job.total ? ` ${job.done}/${job.total}` : (job.done ? ` ${job.done}` : '');
+    console.log(`Auftrag ${job.id} (${job.name}): ${job.state}${progress}`);
+
+    const statusDiv = document.getElementById('capture-status');
+    if (job.name === 'captureNow') {
+        if (job.state === 'queued') {
+            statusDiv.innerText = 'Warte auf Kamera...';
+        } else if (job.state === 'running') {
+            statusDiv.innerText = 'Aufnahme...';
+        } else if (job.state === 'failed') {
+            resetCaptureButton(); // eine fehlgeschlagene Aufnahme meldet zusätzlich "captureFailed"
+        }
+    } else if (job.name === 'deleteAllImages') {
+        if (job.state === 'done') {
+            statusDiv.innerText = '';
+        } else if (job.state === 'failed') {
+            statusDiv.innerText = 'Nicht alle Bilder konnten gelöscht werden.';
+        } else {
+            statusDiv.innerText = `Lösche Bilder...${progress}`;
+        }
+    }
+}
+
+/**
+ * Wird aufgerufen, wenn der Server einen Teil des Verlaufs eines Messwerts sendet. Sammelt die Teile und zeichnet das
+ * Diagramm, sobald alle Abschnitte da sind.
+ * @param {{channel: string, from: number, step: number, offset: number, total: number, min: (number|null)[], max: (number|null)[], avg: (number|null)[]}} part
+ */
+function handleWSHistoryMessage(part) {
+    if (part.channel !== document.getElementById('history-channel').value) {
+        return; // veraltete Antwort (Auswahl wurde inzwischen geändert)
+    }
+    if (part.offset === 0) {
+        historyParts = {...part, min: [], max: [], avg: []};
+    }
+    if (!historyParts || historyParts.from !== part.from || historyParts.avg.length !== part.offset) {
+        historyParts = null; // Teil einer anderen Antwort oder Teil verloren
+        return;
+    }
+    historyParts.min.push(...part.min);
+    historyParts.max.push(...part.max);
+    historyParts.avg.push(...part.avg);
+    if (historyParts.avg.length >= part.total) {
+        drawHistory(historyParts);
+        historyParts = null;
+    }
+}
+
+/**
+ * Zeichnet das Diagramm des Verlaufs.
+ * @param {{channel: string, from: number, step: number, min: (number|null)[], max: (number|null)[], avg: (number|null)[]}} history
+ */
+function drawHistory(history) {
+    const canvas = document.getElementById('history-chart');
+    const ctx = canvas.getContext('2d');
+    ctx.clearRect(0, 0, canvas.width, canvas.height);
+
+    // Wertebereich bestimmen (mit etwas Rand)
+    const values = history.min.concat(history.max).filter(v => v !== null);
+    if (!values.length) {
+        ctx.fillStyle = '#888';
+        ctx.fillText('Noch keine Daten', 10, 20);
+        return;
+    }
+    let low = Math.min(...values);
+    let high = Math.max(...values);
+    const margin = (high - low) * 0.1 || 1;
+    low -= margin;
+    high += margin;
+
+    const count = history.avg.length;
+    const width = canvas.width / count; // Breite eines Abschnitts
+    const x = i => (i + 0.5) * width;
+    const y = v => canvas.height - (v - low) / (high - low) * canvas.height;
+
+    // Band zwischen Minimum und Maximum
+    ctx.fillStyle = 'rgba(78, 154, 212, 0.3)';
+    for (let i = 0; i < count; i++) {
+        if (history.min[i] !== null) {
+            const top = y(history.max[i]);
+            ctx.fillRect(x(i) - width / 2, top, width, Math.max(1, y(history.min[i]) - top));
+        }
+    }
+
+    // Mittelwert als Linie (Lücken werden nicht verbunden)
+    ctx.strokeStyle = '#4e9ad4';
+    ctx.lineWidth = 2;
+    ctx.beginPath();
+    let drawing = false;
+    for (let i = 0; i < count; i++) {
+        const v = history.avg[i];
+        if (v === null) {
+            drawing = false;
+            continue;
+        }
+        if (drawing) {
+            ctx.lineTo(x(i), y(v));
+        } else {
+            ctx.moveTo(x(i), y(v));
+            drawing = true;
+        }
+    }
+    ctx.stroke();
+
+    // Beschriftung: Maximum oben, Minimum unten, Beginn des Zeitraums rechts
+    ctx.fillStyle = '#ccc';
+    ctx.fillText((high - margin).toFixed(1), 5, 12);
+    ctx.fillText((low + margin).toFixed(1), 5, canvas.height - 4);
+    const start = new Date(history.from * 1000);
+    ctx.fillText(`ab ${start.toLocaleTimeString('de-DE', {hour: '2-digit', minute: '2-digit'})}`, canvas.width - 70, 12);
+}
+
 // === Hilfsfunktionen ===
 
+/**
+ * Fordert den Verlauf des ausgewählten Messwerts für den ausgewählten Zeitraum an.
+ */
+function requestHistory() {
+    if (!websocket || websocket.readyState !== WebSocket.OPEN) {
+        return;
+    }
+    sendMessage("getHistory", {
+        channel: document.getElementById('history-channel').value,
+        range: parseInt(document.getElementById('history-range').value, 10),
+        buckets: HISTORY_BUCKETS
+    });
+}
+
 /**
  * Sendet eine formatierte Nachricht an den WebSocket.
  * @param {string} type Der Nachrichtentyp.
@@ -574,6 +945,7 @@ function sendMessage(type, payload = {}) {
  * @param {function(Error|null): void} [onDone] Callback, der nach dem Laden aufgerufen wird.
  */
 function showImageAtIndex(index, onDone) {
+    setLive(false);
     currentImageIndex = index;
     const currentImage = document.getElementById('current-image');
     const imageTimestamp = document.getElementById('image-timestamp');
@@ -585,6 +957,12 @@ function showImageAtIndex(index, onDone) {
         }
     };
     currentImage.onerror = () => {
+        // Bild nicht mehr im RAM (überschrieben oder Neustart): von der SD-Karte laden
+        if (imageUrls[path]) {
+            delete imageUrls[path];
+            currentImage.src = getImageUrl(path);
+            return;
+        }
         const err = new Error(`Bild konnte nicht geladen werden: ${path}`);
         console.error(err);
         if (onDone) {
@@ -601,12 +979,37 @@ function showImageAtIndex(index, onDone) {
     }
 
     const path = imagePaths[index];
-    currentImage.src = `/img?path=${path}`;
+    currentImage.src = imageUrls[path] || getImageUrl(path);
     //currentImage.src = `/img?path=${path}&t=${new Date().getTime()}`; // Timestamp anhängen, um Browser-Cache zu umgehen.
-    imageTimestamp.innerText = path.replace(/^\//, ''); // Dateiname als Zeitstempel anzeigen
+    imageTimestamp.innerText = getImageLabel(path); // Aufnahmezeit aus dem Pfad
     select.value = path;
 }
 
+/**
+ * Gibt die Adresse eines Bildes auf der SD-Karte zurück.
+ * Bilder im Bilderverzeichnis ("/img/2025/12/05/103000.jpg") liefert der ESP32 unter ihrem Pfad aus, ältere Bilder im
+ * Wurzelverzeichnis über "/img?path=...".
+ * @param {string} path Pfad auf der SD-Karte.
+ * @returns {string}
+ */
+function getImageUrl(path) {
+    return path.startsWith('/img/') ? path : `/img?path=${path}`;
+}
+
+/**
+ * Gibt die Beschriftung eines Bildes zurück: die Aufnahmezeit aus dem Pfad (z.B. "2025-12-05 10:30:00") oder den
+ * Dateinamen, wenn der Pfad keine enthält.
+ * @param {string} path Pfad auf der SD-Karte.
+ * @returns {string}
+ */
+function getImageLabel(path) {
+    const match = path.match(/^\/img\/(\d{4})\/(\d{2})\/(\d{2})\/(\d{2})(\d{2})(\d{2})\.jpg$/);
+    if (match) {
+        return `${match[1]}-${match[2]}-${match[3]} ${match[4]}:${match[5]}:${match[6]}`;
+    }
+    return path.replace(/^\//, ''); // Führenden Slash entfernen
+}
+
 /**
  * Setzt den "Bild aufnehmen"-Button in seinen Ausgangszustand zurück.
  */
@@ -622,6 +1025,31 @@ function resetCaptureButton() {
     statusDiv.innerText = '';
 }
 
+/**
+ * Zeigt das Live-Bild an (MJPEG-Stream des ESP32).
+ */
+function startLive() {
+    const currentImage = document.getElementById('current-image');
+    currentImage.onload = null;
+    currentImage.onerror = () => {
+        // z.B. zu viele Clients am Stream (503)
+        setLive(false);
+        alert("Live-Bild nicht verfügbar. Bitte später erneut versuchen.");
+    };
+    currentImage.src = '/stream';
+    document.getElementById('image-timestamp').innerText = 'Live';
+    setLive(true);
+}
+
+/**
+ * Setzt den Live-Status und den Live-Button.
+ * @param {boolean} live true, wenn das Live-Bild angezeigt wird.
+ */
+function setLive(live) {
+    isLive = live;
+    document.getElementById('btnLive').classList.toggle('live-on', live);
+}
+
 /**
  * Startet das Intervall.
  */
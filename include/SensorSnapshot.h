@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Bits für SensorSnapshot::valid (ein Bit je Messwert).
+ */
+enum SensorField : uint8_t {
+    FIELD_AIR_TEMP      = 1 << 0, // Raumtemperatur (S1)
+    FIELD_HUMIDITY      = 1 << 1, // Luftfeuchtigkeit (S1)
+    FIELD_SOIL_TEMP     = 1 << 2, // Bodentemperatur (S2)
+    FIELD_SOIL_MOISTURE = 1 << 3, // Bodenfeuchte (S3)
+    FIELD_WATER_LEVEL   = 1 << 4, // Wasserstand (S4)
+    FIELD_LIGHT_LUX     = 1 << 5  // Tageslicht (S5)
+};
+
+/**
+ * Stand aller Messwerte zu einem Zeitpunkt.
+ *
+ * Wird vom Steuerungs-Task über einen Seqlock veröffentlicht, damit Display, Webinterface und AsyncTCP-Callbacks
+ * eine in sich stimmige Kopie lesen können, ohne die Steuerung zu blockieren.
+ */
+struct SensorSnapshot {
+    uint32_t sequence = 0;     // Wird bei jeder Veröffentlichung um 1 erhöht (0 = noch keine Messung)
+    uint8_t valid = 0;         // Bitmaske aus SensorField: welche Messwerte zuletzt gültig gemessen wurden
+    float airTemp = NAN;       // Raumtemperatur in °C (S1)
+    float humidity = NAN;      // Luftfeuchtigkeit in % (S1)
+    float soilTemp = NAN;      // Bodentemperatur in °C (S2)
+    int soilMoisture = -1;     // Bodenfeuchte in % (S3), -1 bedeutet "ungültig/nicht gemessen"
+    bool waterLevelOk = false; // Wasserstand (S4), 'false' (kein Wasser), bis die erste Messung erfolgt
+    float lightLux = NAN;      // Tageslicht in Lux (S5)
+    int64_t updatedAt = 0;     // esp_timer_get_time() der letzten Veröffentlichung in µs
+
+    /**
+     * @brief Gibt an, ob ein Messwert gültig ist.
+     * @param field Der Messwert.
+     */
+    bool isValid(SensorField field) const {
+        return (valid & field) != 0;
+    }
+
+    /**
+     * @brief Übernimmt einen neuen Messwert und setzt sein Bit in valid.
+     * NAN (Messung fehlgeschlagen oder Deadline verpasst) setzt den Messwert auf "ungültig" zurück, damit kein alter
+     * Wert weiter die Steuerung bestimmt.
+     * @param field Der Messwert.
+     * @param value Neuer Wert (Wasserstand: 1 = ok, 0 = leer).
+     */
+    void apply(const SensorField field, const float value) {
+        const bool ok = !std::isnan(value);
+        switch (field) {
+            case FIELD_AIR_TEMP: airTemp = value; break;
+            case FIELD_HUMIDITY: humidity = value; break;
+            case FIELD_SOIL_TEMP: soilTemp = value; break;
+            case FIELD_SOIL_MOISTURE: soilMoisture = ok ? static_cast<int>(value) : -1; break;
+            case FIELD_WATER_LEVEL: waterLevelOk = ok && value != 0.0f; break;
+            case FIELD_LIGHT_LUX: lightLux = value; break;
+        }
+        valid = ok ? static_cast<uint8_t>(valid | field) : static_cast<uint8_t>(valid & ~field);
+    }
+};
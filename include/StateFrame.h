@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Bits für StateFrame::actuators (ein Bit je Aktor).
+ */
+enum ActuatorField : uint8_t {
+    ACTUATOR_LAMP1  = 1 << 0, // Lampe 1 (A1)
+    ACTUATOR_LAMP2  = 1 << 1, // Lampe 2 (A2)
+    ACTUATOR_HEATER = 1 << 2, // Heizer (A3)
+    ACTUATOR_FAN    = 1 << 3, // Lüfter (A4)
+    ACTUATOR_PUMP   = 1 << 4, // Pumpe (A5)
+    ACTUATOR_MISTER = 1 << 5  // Vernebler (A6)
+};
+
+/**
+ * Bits für StateFrame::flags.
+ */
+enum StateFlag : uint8_t {
+    STATE_WATER_LEVEL_OK = 1 << 0 // Wasserstand ausreichend (S4)
+};
+
+constexpr uint8_t STATE_FRAME_VERSION = 1; // Bei jeder Änderung des Layouts erhöhen (und script.js anpassen)
+
+/**
+ * Binäre Statusnachricht für das Webinterface (Alternative zur JSON-Nachricht "state").
+ *
+ * Wird unverändert als binärer WebSocket-Frame gesendet (40 Byte, little endian wie der ESP32) und in script.js mit
+ * einer DataView gelesen. Ungültige Messwerte erkennt der Browser an der Bitmaske `valid` (siehe SensorField), nicht
+ * am Wert selbst. Die Diagnosewerte (SPI-Bus, Live-Stream, Messzeitpunkte) gibt es nur in der JSON-Nachricht.
+ *
+ * | Offset | Typ       | Feld                  |
+ * |--------|-----------|-----------------------|
+ * | 0      | `uint8`   | version               |
+ * | 1      | `uint8`   | valid                 |
+ * | 2      | `uint8`   | actuators             |
+ * | 3      | `uint8`   | flags                 |
+ * | 4      | `uint32`  | sequence              |
+ * | 8      | `float32` | airTemp               |
+ * | 12     | `float32` | humidity              |
+ * | 16     | `float32` | soilTemp              |
+ * | 20     | `int32`   | soilMoisture          |
+ * | 24     | `float32` | lightLux              |
+ * | 28     | `uint32`  | controlLatencyUs      |
+ * | 32     | `uint32`  | controlLatencyMaxUs   |
+ * | 36     | `uint32`  | controlCycleMaxUs     |
+ */
+struct __attribute__((packed)) StateFrame {
+    uint8_t version = STATE_FRAME_VERSION;
+    uint8_t valid = 0;                // Bitmaske aus SensorField
+    uint8_t actuators = 0;            // Bitmaske aus ActuatorField
+    uint8_t flags = 0;                // Bitmaske aus StateFlag
+    uint32_t sequence = 0;            // Versionsnummer der Messwerte (SensorSnapshot::sequence)
+    float airTemp = 0;                // Raumtemperatur in °C (S1)
+    float humidity = 0;               // Luftfeuchtigkeit in % (S1)
+    float soilTemp = 0;               // Bodentemperatur in °C (S2)
+    int32_t soilMoisture = -1;        // Bodenfeuchte in % (S3)
+    float lightLux = 0;               // Tageslicht in Lux (S5)
+    uint32_t controlLatencyUs = 0;    // Reaktionszeit der Steuerung in µs (letzte Messung)
+    uint32_t controlLatencyMaxUs = 0; // Reaktionszeit der Steuerung in µs (Maximum)
+    uint32_t controlCycleMaxUs = 0;   // Längster Steuerungszyklus in µs
+};
+
+static_assert(sizeof(StateFrame) == 40, "StateFrame: Layout muss zu script.js passen");
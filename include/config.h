@@ -24,6 +24,8 @@ constexpr int PIN_SPI_MISO = 19; // GPIO-Pin für SPI MISO Leitung
 constexpr int PIN_SPI_SCK = 18; // GPIO-Pin für SPI Clock Leitung
 constexpr int PIN_SPI_SD_CS = 16; // GPIO-Pin für SPI Chip Select der SD-Karte
 constexpr int PIN_SPI_CAMERA_CS = 17; // GPIO-Pin für SPI Chip Select der Kamera
+constexpr uint32_t SPI_CLOCK_SD = 20000000; // SPI-Takt der SD-Karte in Hz (bei Lesefehlern, z.B. wegen langer Leitungen, reduzieren)
+constexpr uint32_t SPI_CLOCK_CAMERA = 8000000; // SPI-Takt der Kamera in Hz (max. 8 MHz laut ArduCAM)
 
 // Aktoren
 constexpr int PIN_LAMP1_RELAY = 14; // GPIO-Pin für das Relais der Pflanzenlampe 1 (A1)
@@ -64,6 +66,119 @@ constexpr bool WATER_LEVEL_TRIGGERED = false; // Wasserstand (S4) - LOW/false =
 
 constexpr unsigned long LOG_DELAY = 100; // Verzögerung in ms nach einem Log-Eintrag im Display (während des Bootens)
 constexpr unsigned long SENSOR_READ_INTERVAL = 5000; // Intervall in ms, um Sensoren zu lesen (alle 5 Sekunden)
+constexpr unsigned long WATER_LEVEL_READ_INTERVAL = 1000; // Intervall in ms, um den Wasserstand zu lesen (jede Sekunde, schützt die Pumpe)
+constexpr unsigned long SENSOR_READ_DEADLINE = 2000; // Zeit in ms nach Fälligkeit, bis zu der eine Messung (inkl. Wiederholungen) abgeschlossen sein muss
+constexpr unsigned long SENSOR_LOOP_BUDGET_US = 5000; // Zeitbudget in µs für Sensorarbeit pro loop()-Durchlauf (5 ms)
 constexpr unsigned long DISPLAY_UPDATE_INTERVAL = 1000; // Intervall in ms, um das Display zu aktualisieren (jede Sekunde in ms)
-constexpr unsigned long BROADCAST_INTERVAL = 2000; // Intervall in ms für ein WebSocket Broadcast (jede zweite Sekunde in ms)
+constexpr unsigned long BROADCAST_INTERVAL = 2000; // Intervall in ms, in dem geänderte Messwerte per WebSocket gesendet werden (jede zweite Sekunde in ms)
+constexpr unsigned long STATE_KEYFRAME_INTERVAL = 30000; // Intervall in ms für den vollständigen Status inkl. Diagnosewerte (dazwischen nur Änderungen)
 constexpr unsigned long CAMERA_CAPTURE_INTERVAL = 3600000; // Intervall in ms, um ein Bild zu machen (alle 60 Minuten in ms)
+constexpr unsigned long CONTROL_INTERVAL = 50; // Intervall in ms, in dem der Steuerungs-Task spätestens aufwacht (neue Messwerte wecken ihn sofort)
+constexpr unsigned long CAMERA_STATUS_DURATION = 2000; // Dauer in ms, die das Ergebnis einer Aufnahme im Display angezeigt wird
+
+// ------------------------------------------------------------
+// Webinterface
+// ------------------------------------------------------------
+
+constexpr size_t WS_INBOX_ARENA_SIZE = 4096; // Speicher in Byte zum Parsen eingehender WebSocket-Nachrichten (reicht für "saveSettings")
+constexpr unsigned long CAPTURE_JOB_TIMEOUT = 15000; // Maximale Wartezeit in ms auf eine per Webinterface angeforderte Aufnahme
+constexpr uint32_t JOB_SD_LOCK_TIMEOUT = 5000; // Maximale Wartezeit in ms auf den SPI-Bus in Hintergrundaufträgen
+constexpr size_t DELETE_BATCH_SIZE = 16; // Dateien, die beim Leeren der SD-Karte pro Bus-Zugriff gelöscht werden
+constexpr size_t MIGRATE_BATCH_SIZE = 16; // Bilder, die beim Umzug ins Bilderverzeichnis pro Bus-Zugriff verschoben werden
+
+// ------------------------------------------------------------
+// Schwellwerte für Statusnachrichten (Deadband)
+// ------------------------------------------------------------
+// Kleinere Änderungen eines Messwerts werden nicht sofort gesendet, sondern erst mit dem nächsten vollständigen Status.
+
+constexpr float STATE_DEADBAND_TEMP = 0.1f; // Raum- und Bodentemperatur in °C
+constexpr float STATE_DEADBAND_HUMIDITY = 1.0f; // Luftfeuchtigkeit in %
+constexpr int STATE_DEADBAND_SOIL_MOISTURE = 1; // Bodenfeuchte in %
+constexpr float STATE_DEADBAND_LIGHT = 0.05f; // Tageslicht, relativ zum zuletzt gesendeten Wert (5 %, mindestens 1 Lux)
+
+// ------------------------------------------------------------
+// Bildpuffer und Live-Stream
+// ------------------------------------------------------------
+
+constexpr uint8_t FRAME_RING_SLOTS = 2; // Anzahl der letzten Aufnahmen, die im RAM gehalten werden
+constexpr size_t FRAME_RING_SLOT_SIZE = 32768; // Maximale Größe einer Aufnahme im RAM in Byte (größere Bilder werden direkt auf die SD-Karte geschrieben)
+constexpr uint8_t STREAM_RING_SLOTS = 2; // Slots nur für den Live-Stream (eines wird gesendet, in das andere nimmt die Kamera auf)
+constexpr size_t STREAM_RING_SLOT_SIZE = 16384; // Maximale Größe eines Stream-Bildes in Byte (größere werden ausgelassen)
+constexpr uint8_t STREAM_RESOLUTION = 2; // JPEG-Auflösung des Live-Streams (2 = 320x240, siehe ArduCamOV2640::setResolution(); muss in einen Stream-Slot passen)
+constexpr unsigned long STREAM_FRAME_INTERVAL = 200; // Mindestabstand in ms zwischen zwei Bildern des Live-Streams (max. 5 fps)
+constexpr uint8_t IMAGE_SAVE_ATTEMPTS = 3; // Versuche, eine Aufnahme aus dem RAM auf die SD-Karte zu schreiben (danach "imageSaveFailed")
+constexpr unsigned long IMAGE_SAVE_RETRY_INTERVAL = 2000; // Pause in ms vor dem nächsten Versuch
+
+// ------------------------------------------------------------
+// Messwert-Verlauf
+// ------------------------------------------------------------
+
+constexpr uint32_t HISTORY_INTERVAL = 5; // Abstand in s zwischen zwei Einträgen im feinen Verlauf
+constexpr uint16_t HISTORY_CAPACITY = 720; // Einträge im feinen Verlauf (720 x 5 s = 1 Stunde)
+constexpr uint32_t HISTORY_DAY_INTERVAL = 60; // Abstand in s zwischen zwei Einträgen im groben Verlauf (Mittelwert aus dem feinen)
+constexpr uint16_t HISTORY_DAY_CAPACITY = 1440; // Einträge im groben Verlauf (1440 x 1 min = 24 Stunden)
+constexpr uint16_t HISTORY_SPILL_ROWS = 60; // Einträge, die gesammelt an die Datei auf der SD-Karte angehängt werden (60 x 5 s = 5 Minuten)
+constexpr uint16_t HISTORY_MAX_BUCKETS = 240; // Maximale Anzahl Abschnitte pro Abfrage (Punkte im Diagramm)
+constexpr uint16_t HISTORY_CHUNK_BUCKETS = 60; // Abschnitte pro Nachricht "history" (muss in eine JSON-Arena von WebUI passen)
+constexpr char HISTORY_DIR[] = "/history"; // Verzeichnis für die Verlaufsdateien auf der SD-Karte (eine Datei pro Tag)
+
+// ------------------------------------------------------------
+// Bilderverzeichnis
+// ------------------------------------------------------------
+
+constexpr char IMAGE_INDEX_DIR[] = "/index"; // Verzeichnis für die Indexdatei auf der SD-Karte
+constexpr char IMAGE_INDEX_PATH[] = "/index/images.idx"; // Indexdatei mit allen Bildern (siehe ImageIndex)
+constexpr uint16_t IMAGE_LIST_PAGE_SIZE = 50; // Bilder pro Seite, wenn der Client keine Anzahl angibt
+constexpr uint16_t IMAGE_LIST_MAX_PAGE = 100; // Maximale Anzahl Bilder pro Seite
+constexpr unsigned long RETENTION_INTERVAL = 600000; // Intervall in ms, in dem alte Bilder nach den Einstellungen aufgeräumt werden (alle 10 Minuten)
+constexpr unsigned long RETENTION_SLICE_MS = 20; // Maximale Dauer in ms, die das Aufräumen den SPI-Bus am Stück hält
+constexpr unsigned long RETENTION_PAUSE_MS = 30; // Pause in ms zwischen zwei Zeitscheiben (Kamera und Webinterface kommen an die SD-Karte)
+constexpr unsigned long INDEX_REBUILD_SLICE_MS = 20; // Maximale Dauer in ms, die der Neuaufbau des Bilderverzeichnisses den SPI-Bus am Stück hält
+constexpr unsigned long INDEX_REBUILD_PAUSE_MS = 30; // Pause in ms zwischen zwei Zeitscheiben des Neuaufbaus
+
+// ------------------------------------------------------------
+// FreeRTOS-Tasks (Stackgröße in Bytes, Priorität, Kern)
+// ------------------------------------------------------------
+
+// Steuerung der Aktoren: höchste Priorität, damit z.B. die Pumpe immer rechtzeitig abgeschaltet wird.
+constexpr uint32_t CONTROL_TASK_STACK = 4096;
+constexpr int CONTROL_TASK_PRIORITY = 5;
+constexpr int CONTROL_TASK_CORE = 1;
+
+// Sensoren und Display (beide am I2C-Bus, daher im selben Task)
+constexpr uint32_t SENSOR_TASK_STACK = 4096;
+constexpr int SENSOR_TASK_PRIORITY = 2;
+constexpr int SENSOR_TASK_CORE = 1;
+
+// Kamera und SD-Karte (langsame SPI-Zugriffe)
+constexpr uint32_t CAMERA_TASK_STACK = 8192;
+constexpr int CAMERA_TASK_PRIORITY = 1;
+constexpr int CAMERA_TASK_CORE = 0;
+
+// Webinterface und OTA (auf dem Kern des WLAN-Stacks)
+constexpr uint32_t NETWORK_TASK_STACK = 8192;
+constexpr int NETWORK_TASK_PRIORITY = 1;
+constexpr int NETWORK_TASK_CORE = 0;
+
+// Hintergrundaufträge aus dem Webinterface (Bildliste, Bilder löschen, Aufnahme); unter der Priorität von AsyncTCP,
+// damit der Webserver auch während langer SD-Zugriffe antwortet
+constexpr uint32_t JOB_TASK_STACK = 6144;
+constexpr int JOB_TASK_PRIORITY = 1;
+constexpr int JOB_TASK_CORE = 0;
+
+// ------------------------------------------------------------
+// Speicherbudget (interner RAM; ohne PSRAM liegen auch die Bildpuffer dort)
+// ------------------------------------------------------------
+
+// Was die Firmware beim Start fest reserviert (ca. 180 KB):
+//   Bildpuffer        FRAME_RING_SLOTS x FRAME_RING_SLOT_SIZE      2 x 32 KB = 64 KB
+//   Stream-Puffer     STREAM_RING_SLOTS x STREAM_RING_SLOT_SIZE    2 x 16 KB = 32 KB
+//   JSON-Arenen       WebUI::JSON_ARENA_COUNT x JSON_ARENA_SIZE    2 x  6 KB = 12 KB
+//   Eingangs-Arena    WS_INBOX_ARENA_SIZE                                      4 KB
+//   Empfangspuffer    WebUI::RX_BUFFER_COUNT x RX_BUFFER_SIZE      2 x  2 KB =  4 KB
+//   Verlauf (fein)    HISTORY_CAPACITY x (4 + 6 Kanäle x 2 Byte)   720 x 16 B ≈ 11 KB
+//   Verlauf (grob)    HISTORY_DAY_CAPACITY x 16 Byte              1440 x 16 B ≈ 23 KB
+//   Task-Stacks       control, sensor, camera, network, jobs     4+4+8+8+6 KB = 30 KB
+// Dazu kommen WLAN, AsyncTCP und die Puffer der Verbindungen, die erst im Betrieb wachsen. Wer hier etwas vergrößert,
+// muss es woanders einsparen; setup() prüft am Ende den freien Speicher.
+constexpr size_t MIN_FREE_HEAP = 40960; // Freier interner RAM in Byte nach allen festen Reservierungen, unter dem setup() warnt
@@ -40,6 +40,12 @@ struct Settings {
     uint8_t cameraContrast = 4; // Kontrast (6 = sehr schwach, 5 = schwach, 4 = normal (default), 3 = stark, 2 = sehr stark)
     uint8_t cameraSpecialEffect = 7; // Spezialeffekte (0 = Altmodisch, 1 = Blaustich, 2 = Grünstich, 3 = Rotstich, 4 = Schwarzweiß, 5 = Farben invertiert, 6 = Schwarzweiß Negativ, 7 = kein Effekt (default))
 
+    // Aufräumen der SD-Karte (siehe ImageRetention, jeweils 0 = aus)
+    int imageMaxAgeDays = 0; // Bilder, die älter sind, werden gelöscht (in Tagen)
+    int imageThinAfterDays = 0; // Von älteren Tagen bleibt nur das Bild, das am nächsten an 12 Uhr liegt (in Tagen)
+    int imageMaxMB = 0; // Maximaler Speicher für Bilder in MB (die ältesten werden gelöscht)
+    int sdMinFreePercent = 10; // Freier Speicher auf der SD-Karte in %, der mindestens erhalten bleibt (die ältesten Bilder werden gelöscht)
+
     // Modus für die Steuerung der Aktoren (automatisch, immer an, immer aus)
     ControlMode lamp1Mode = MODE_AUTO; // Modus für Lampe 1 (A1)
     ControlMode lamp2Mode = MODE_AUTO; // Modus für Lampe 2 (A2)
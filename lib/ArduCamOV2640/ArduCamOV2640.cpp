@@ -3,15 +3,83 @@
 #include <SPI.h>
 #include <FS.h>
 #include <SD.h>
+#include <esp_heap_caps.h>
+
+/**
+ * @brief Sucht einen JPEG-Marker (0xFF gefolgt von marker) in einem Block.
+ * @param data Der Block.
+ * @param from Ab dieser Position wird gesucht.
+ * @param size Größe des Blocks.
+ * @param marker Zweites Byte des Markers (0xD8 = Anfang, 0xD9 = Ende).
+ * @param previous Letztes Byte des vorherigen Blocks (falls der Marker über die Blockgrenze geht).
+ * @return Position des zweiten Marker-Bytes, oder -1, wenn der Marker nicht gefunden wurde.
+ */
+static long findMarker(const uint8_t* data, size_t from, const size_t size, const uint8_t marker, const uint8_t previous) {
+    if (from == 0 && previous == 0xFF && size > 0 && data[0] == marker) {
+        return 0;
+    }
+    while (from < size) {
+        // memchr() durchsucht den Block deutlich schneller als eine Schleife über jedes Byte
+        const auto* ff = static_cast<const uint8_t*>(memchr(data + from, 0xFF, size - from));
+        if (!ff) {
+            return -1;
+        }
+        const size_t index = ff - data;
+        if (index + 1 < size && data[index + 1] == marker) {
+            return static_cast<long>(index + 1);
+        }
+        from = index + 1;
+    }
+    return -1;
+}
+
+/**
+ * Schreibt in einen Puffer fester Größe (Ziel für captureToBuffer()).
+ * Was nicht mehr hineinpasst, wird verworfen und als Schreibfehler gemeldet.
+ */
+class BufferPrint : public Print {
+public:
+    BufferPrint(uint8_t* buffer, const size_t capacity) : _buffer(buffer), _capacity(capacity) {}
+
+    size_t write(const uint8_t byte) override {
+        return write(&byte, 1);
+    }
+
+    size_t write(const uint8_t* data, const size_t size) override {
+        if (size > _capacity - _size) {
+            _overflow = true;
+            return 0;
+        }
+        memcpy(_buffer + _size, data, size);
+        _size += size;
+        return size;
+    }
+
+    size_t getSize() const { return _size; }
+    bool isOverflow() const { return _overflow; }
+
+private:
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _size = 0;
+    bool _overflow = false;
+};
 
 ArduCamOV2640::ArduCamOV2640(const uint8_t csPin)
-    : _csPin(csPin), _myCAM(OV2640, csPin), _lastError(0) {}
+    : _csPin(csPin), _myCAM(OV2640, csPin), _lastError(0), _resolution(OV2640_320x240), _bus(nullptr), _busDevice(SpiBusArbiter::NO_DEVICE),
+      _burstRead(true), _buffer(nullptr) {}
+
+bool ArduCamOV2640::begin(SpiBusArbiter* bus, const int device) {
+    _bus = bus;
+    _busDevice = device;
 
-bool ArduCamOV2640::begin() {
     // CS-Pin konfigurieren
     pinMode(_csPin, OUTPUT);
     digitalWrite(_csPin, HIGH);
 
+    // Den Bus für die gesamte Initialisierung halten (viele kurze Zugriffe in einem Rutsch)
+    const SpiBusArbiter::Lock lock(_bus, _busDevice);
+
     // 1. CPLD (Chip auf der ArduCAM) zurücksetzen
     _myCAM.write_reg(0x07, 0x80);
     delay(100);
@@ -39,63 +107,51 @@ bool ArduCamOV2640::begin() {
     _myCAM.set_format(JPEG);
     _myCAM.InitCAM();
     _myCAM.OV2640_set_JPEG_size(OV2640_320x240); // QVGA
+    _resolution = OV2640_320x240;
 
     //  Sensor Zeit geben, die neuen Einstellungen zu verarbeiten (Weißabgleich etc.)
     delay(200);
-
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
     return true;
 }
 
 void ArduCamOV2640::setResolution(const uint8_t resolution) {
     // FIFO in einen sauberen Zustand versetzen
-    _myCAM.flush_fifo();
-    _myCAM.clear_fifo_flag();
+    {
+        const SpiBusArbiter::Lock lock(_bus, _busDevice);
+        _myCAM.flush_fifo();
+        _myCAM.clear_fifo_flag();
+    }
 
     // Befehl an den Sensor senden
     _myCAM.OV2640_set_JPEG_size(resolution);
+    _resolution = resolution;
 
     // Warten, bis der Sensor sich stabilisiert hat
     delay(200);
+}
 
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
+uint8_t ArduCamOV2640::getResolution() const {
+    return _resolution;
 }
 
 void ArduCamOV2640::setLightMode(const uint8_t mode) {
     _myCAM.OV2640_set_Light_Mode(mode);
-
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
 }
 
 void ArduCamOV2640::setColorSaturation(const uint8_t saturation) {
     _myCAM.OV2640_set_Color_Saturation(saturation);
-
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
 }
 
 void ArduCamOV2640::setBrightness(const uint8_t brightness) {
     _myCAM.OV2640_set_Brightness(brightness);
-
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
 }
 
 void ArduCamOV2640::setContrast(const uint8_t contrast) {
     _myCAM.OV2640_set_Contrast(contrast);
-
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
 }
 
 void ArduCamOV2640::setSpecialEffect(const uint8_t effect) {
     _myCAM.OV2640_set_Special_effects(effect);
-
-    // CS-Pin freigeben, um SPI-Bus-Konflikte zu vermeiden
-    //digitalWrite(_csPin, HIGH);
 }
 
 bool ArduCamOV2640::saveToSD(const char *filename) {
@@ -104,29 +160,54 @@ bool ArduCamOV2640::saveToSD(const char *filename) {
     // Bild aufzeichnen
     takePicture();
 
-    // Bild speichern
+    // Bild speichern. Der Bus wird für die ganze Datei gehalten, damit kein anderer Task zwischen den Blöcken auf
+    // die SD-Karte zugreift; Kamera und SD-Karte wechseln sich innerhalb dieses Zugriffs ab.
+    const SpiBusArbiter::Lock batch(_bus, SpiBusArbiter::NO_DEVICE);
+    const unsigned long start = micros();
     File file = SD.open(filename, FILE_WRITE);
     if (!file) {
         _lastError = 3; // Failed to open file for writing
         return false;
     }
-    const bool success = writeFifoToStream(file);
+    const bool success = writeFifoToStream(file, true);
     file.close();
+    _stats.transferUs = micros() - start;
     return success;
 }
 
+size_t ArduCamOV2640::captureToBuffer(uint8_t* buffer, const size_t capacity) {
+    _lastError = 0;
+
+    // Bild aufzeichnen
+    takePicture();
+
+    // Der Puffer liegt im RAM, die Kamera kann den Bus bis zum Ende behalten
+    BufferPrint target(buffer, capacity);
+    const unsigned long start = micros();
+    const bool success = writeFifoToStream(target, false);
+    _stats.transferUs = micros() - start;
+    if (target.isOverflow()) {
+        _lastError = 6; // Puffer zu klein
+        return 0;
+    }
+    return success ? target.getSize() : 0;
+}
+
 bool ArduCamOV2640::sendToSerialHost() {
     _lastError = 0;
 
     // Bild aufzeichnen
     takePicture();
 
+    // Der Stream nutzt den SPI-Bus nicht, die Kamera kann den Bus bis zum Ende behalten
+    const SpiBusArbiter::Lock batch(_bus, SpiBusArbiter::NO_DEVICE);
+
     // Protokoll-Start-Marker für Host-Software
     Serial.write(0xFF);
     Serial.write(0xAA);
 
     // Inhalt senden
-    const bool success = writeFifoToStream(Serial);
+    const bool success = writeFifoToStream(Serial, false);
 
     // Protokoll-End-Marker
     Serial.write(0xFF);
@@ -135,19 +216,37 @@ bool ArduCamOV2640::sendToSerialHost() {
 }
 
 void ArduCamOV2640::takePicture() {
+    const unsigned long start = millis();
+    _stats = TransferStats();
+
     // Bild aufzeichnen
-    _myCAM.flush_fifo(); // Puffer leeren
-    _myCAM.clear_fifo_flag(); // Status-Register zurücksetzen (bereit für die erste Aufnahme)
-    _myCAM.start_capture(); // Aufnahme starten
-    while (!_myCAM.get_bit(ARDUCHIP_TRIG, CAP_DONE_MASK)) {
-        // warten, bis das Bild fertig im FIFO liegt
+    {
+        const SpiBusArbiter::Lock lock(_bus, _busDevice);
+        _myCAM.flush_fifo(); // Puffer leeren
+        _myCAM.clear_fifo_flag(); // Status-Register zurücksetzen (bereit für die erste Aufnahme)
+        _myCAM.start_capture(); // Aufnahme starten
+    }
+    while (true) {
+        // warten, bis das Bild fertig im FIFO liegt (der Bus ist zwischen den Abfragen für andere Tasks frei)
+        {
+            const SpiBusArbiter::Lock lock(_bus, _busDevice);
+            if (_myCAM.get_bit(ARDUCHIP_TRIG, CAP_DONE_MASK)) {
+                break;
+            }
+        }
         yield(); // Wichtig für ESP32 Watchdog
     }
+    _stats.captureMs = millis() - start;
 }
 
-bool ArduCamOV2640::writeFifoToStream(Stream &stream)
+bool ArduCamOV2640::writeFifoToStream(Print &stream, const bool streamOnBus)
 {
-    uint32_t length = _myCAM.read_fifo_length();
+    const unsigned long start = micros();
+    uint32_t length;
+    {
+        const SpiBusArbiter::Lock lock(_bus, _busDevice);
+        length = _myCAM.read_fifo_length();
+    }
 
     // Sicherheitscheck: Wenn Länge 0 oder riesig (Fehler), abbrechen
     if (length >= MAX_FIFO_SIZE || length == 0) {
@@ -158,6 +257,99 @@ bool ArduCamOV2640::writeFifoToStream(Stream &stream)
         return false;
     }
 
+    // Puffer beim ersten Mal anlegen. DMA-fähiger Speicher, damit der SPI-Treiber direkt hineinschreiben kann.
+    if (_burstRead && !_buffer) {
+        _buffer = static_cast<uint8_t*>(heap_caps_malloc(BURST_BUFFER_SIZE, MALLOC_CAP_DMA));
+    }
+
+    _stats.burst = _burstRead && _buffer; // ohne Puffer bleibt nur das langsame Verfahren
+    const bool success = _stats.burst ? burstFifoToStream(stream, length, streamOnBus) : byteFifoToStream(stream, length);
+    _stats.transferUs = micros() - start; // saveToSD() überschreibt den Wert inkl. Öffnen und Schließen der Datei
+    return success;
+}
+
+bool ArduCamOV2640::burstFifoToStream(Print &stream, uint32_t length, const bool streamOnBus) {
+    bool started = false;  // JPEG-Anfang (0xFF 0xD8) gefunden
+    uint8_t previous = 0;  // Letztes Byte des vorherigen Blocks (Marker können über die Blockgrenze gehen)
+    bool selected = false; // Kamera ist ausgewählt und der Burst-Read läuft
+    bool success = false;
+
+    // Kamera abwählen und den Bus für die SD-Karte (bzw. andere Tasks) freigeben
+    const auto deselect = [&] {
+        if (selected) {
+            _myCAM.CS_HIGH();
+            if (_bus) {
+                _bus->release();
+            }
+            selected = false;
+        }
+    };
+
+    while (length > 0) {
+        // Einen ganzen Block mit einem einzigen Aufruf aus dem FIFO lesen.
+        // Schreibt der Stream selbst auf den Bus (SD-Karte), muss die Kamera nach jedem Block abgewählt werden.
+        // Sonst (z.B. Serial) läuft der Burst-Read ohne Unterbrechung durch.
+        const size_t size = length < BURST_BUFFER_SIZE ? length : BURST_BUFFER_SIZE;
+        if (!selected) {
+            // Takt und Modus der Kamera. Ohne Bus die Kamera nicht auswählen und kein release() aufrufen, das würde
+            // den äußeren Lock des Aufrufers (z.B. aus saveToSD()) freigeben.
+            if (_bus && !_bus->acquire(_busDevice)) {
+                _lastError = 7; // SPI-Bus nicht erhalten
+                break;
+            }
+            _myCAM.CS_LOW();
+            _myCAM.set_fifo_burst(); // Burst-Read Modus aktivieren (liest ab der aktuellen FIFO-Position weiter)
+            selected = true;
+        }
+        SPI.transferBytes(nullptr, _buffer, size);
+        length -= size;
+        if (streamOnBus) {
+            deselect();
+        }
+
+        size_t begin = 0;
+        if (!started) {
+            const long soi = findMarker(_buffer, 0, size, 0xD8, previous);
+            if (soi < 0) {
+                previous = _buffer[size - 1];
+                continue; // noch kein JPEG-Anfang in diesem Block
+            }
+            started = true;
+            if (soi == 0) {
+                // Das 0xFF lag noch im vorherigen Block
+                const uint8_t ff = 0xFF;
+                stream.write(&ff, 1);
+                _stats.bytes++;
+            } else {
+                begin = soi - 1;
+            }
+        }
+
+        // JPEG-Ende (0xFF 0xD9) suchen, frühestens nach dem Anfang
+        const long eoi = findMarker(_buffer, begin, size, 0xD9, begin == 0 ? previous : 0);
+        const size_t end = eoi < 0 ? size : eoi + 1;
+        if (stream.write(_buffer + begin, end - begin) != end - begin) {
+            _lastError = 3; // Schreibfehler
+            break;
+        }
+        _stats.bytes += end - begin;
+        if (eoi >= 0) {
+            success = true; // Bild ist komplett
+            break;
+        }
+
+        previous = _buffer[size - 1];
+        yield(); // Watchdog streicheln
+    }
+
+    deselect();
+    if (!success && _lastError == 0) {
+        _lastError = 5; // JPEG-Ende (0xFF,0xD9) nicht gefunden
+    }
+    return success;
+}
+
+bool ArduCamOV2640::byteFifoToStream(Print &stream, uint32_t length) {
     // Puffer für blockweises Schreiben (schneller als Byte-by-Byte)
     constexpr int bufferSize = 256;
     byte buf[bufferSize];
@@ -183,6 +375,7 @@ bool ArduCamOV2640::writeFifoToStream(Stream &stream)
             if (i >= bufferSize) {
                 _myCAM.CS_HIGH(); // Kurz SPI unterbrechen (manchmal nötig für Stabilität, hier optional aber sicher)
                 stream.write(buf, bufferSize); // Blockweise senden ist viel schneller als einzeln!
+                _stats.bytes += bufferSize;
 
                 // Da wir CS_HIGH sind, ist der SPI-Bus frei.
                 // Das ist der perfekte Moment, um dem System kurz Luft zu geben.
@@ -197,6 +390,7 @@ bool ArduCamOV2640::writeFifoToStream(Stream &stream)
                 // Ende des JPEGs (Marker 0xFF 0xD9) erkannt
                 _myCAM.CS_HIGH(); // SPI-Bus für die Kamera freigeben...
                 stream.write(buf, i); // ...und den Rest des Puffers auf die SD-Karte schreiben
+                _stats.bytes += i;
                 success = true;
                 break; // Bild ist komplett
             }
@@ -218,6 +412,14 @@ bool ArduCamOV2640::writeFifoToStream(Stream &stream)
     return success;
 }
 
+void ArduCamOV2640::setBurstRead(const bool enabled) {
+    _burstRead = enabled;
+}
+
+const ArduCamOV2640::TransferStats& ArduCamOV2640::getLastTransferStats() const {
+    return _stats;
+}
+
 int ArduCamOV2640::getLastError() const {
     return _lastError;
 }
@@ -230,6 +432,8 @@ const char* ArduCamOV2640::getErrorMessage() const {
         case 3: return "Schreibfehler";
         case 4: return "FIFO-Länge 0 oder Max";
         case 5: return "Kein JPEG-Ende";
+        case 6: return "Puffer zu klein";
+        case 7: return "SPI-Bus belegt";
         default: return "Unbekannter Fehler";
     }
 }
\ No newline at end of file
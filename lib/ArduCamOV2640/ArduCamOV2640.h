@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "SpiBusArbiter.h"
 
 // Im Original-Sketch sollte man die ArduCAM-Bibliothek für die Hardware anpassen, indem man in memorysaver.h das
 // Kameramodell einkommentiert. Uncool! Ich definiere hier direkt die Hardware und lasse die Hersteller-Bibliothek
@@ -23,6 +24,27 @@
 class ArduCamOV2640
 {
 public:
+    static constexpr size_t BURST_BUFFER_SIZE = 4096;      // Blockgröße für das Auslesen im Burst-Modus in Byte
+
+    /**
+     * @struct TransferStats
+     * @brief Messwerte der letzten Aufnahme.
+     */
+    struct TransferStats {
+        uint32_t bytes = 0;        // Größe des JPEGs in Byte
+        uint32_t captureMs = 0;    // Dauer der Aufnahme in den FIFO in ms
+        uint32_t transferUs = 0;   // Dauer vom Auslesen des FIFO bis zum Schließen der Datei in µs
+        bool burst = false;        // true, wenn im Burst-Modus ausgelesen wurde
+
+        /**
+         * @brief Gibt den Durchsatz vom FIFO bis in die Datei zurück.
+         * @return Durchsatz in MB/s (0, wenn keine Daten übertragen wurden).
+         */
+        float getThroughput() const {
+            return transferUs > 0 ? static_cast<float>(bytes) / static_cast<float>(transferUs) : 0.0f;
+        }
+    };
+
     /**
      * @brief Konstruktor der Kamera-Klasse.
      * @param csPin Der GPIO-Pin, der als Chip Select für die ArduCAM verwendet wird.
@@ -32,9 +54,12 @@ public:
     /**
      * @brief Initialisiert die Kamera-Hardware und die SPI/I2C-Kommunikation.
      * Muss im setup() des Hauptprogramms aufgerufen werden.
+     * @param bus Arbiter für den gemeinsamen SPI-Bus (optional). Ohne Arbiter wird der Bus ohne Schutz und mit dem
+     *            Standard-Takt genutzt.
+     * @param device ID der Kamera beim Arbiter (siehe SpiBusArbiter::addDevice()).
      * @return true bei erfolgreicher Initialisierung, andernfalls false.
      */
-    bool begin();
+    bool begin(SpiBusArbiter* bus = nullptr, int device = SpiBusArbiter::NO_DEVICE);
 
     /**
      * @brief Ändert die JPEG-Auflösung.
@@ -51,6 +76,11 @@ public:
      */
     void setResolution(uint8_t resolution);
 
+    /**
+     * @brief Gibt die eingestellte JPEG-Auflösung zurück (siehe setResolution()).
+     */
+    uint8_t getResolution() const;
+
     /**
      * @brief Setzt den Weißabgleich.
      * @param mode Modus:
@@ -115,12 +145,37 @@ public:
      */
     bool saveToSD(const char *filename);
 
+    /**
+     * @brief Nimmt ein Bild auf und legt das JPEG im RAM ab (z.B. in einem Slot des FrameRing).
+     * Der FIFO wird in einem Zug ausgelesen, die SD-Karte wird nicht berührt.
+     * @param buffer Zielpuffer.
+     * @param capacity Größe des Zielpuffers in Byte.
+     * @return Größe des JPEGs in Byte, oder 0 bei einem Fehler (z.B. Puffer zu klein, siehe getLastError()).
+     */
+    size_t captureToBuffer(uint8_t* buffer, size_t capacity);
+
     /**
      * @brief Nimmt ein Bild auf und sendet das Bild inklusiv Protokoll-Marker (FF AA / FF BB) über Serial.
      * @return true bei Erfolg.
      */
     bool sendToSerialHost();
 
+    /**
+     * @brief Wählt das Verfahren zum Auslesen des FIFO.
+     *
+     * Im Burst-Modus (Standard) wird der FIFO blockweise mit SPI.transferBytes() in einen Puffer im DMA-fähigen
+     * Speicher gelesen (mit dem beim Arbiter angemeldeten Takt) und der Block als Ganzes geschrieben. Ohne Burst-Modus wird wie bisher jedes Byte einzeln
+     * gelesen (langsam, nur noch für Vergleichsmessungen).
+     *
+     * @param enabled true für den Burst-Modus.
+     */
+    void setBurstRead(bool enabled);
+
+    /**
+     * @brief Gibt die Messwerte der letzten Aufnahme zurück.
+     */
+    const TransferStats& getLastTransferStats() const;
+
     /**
      * @brief Gibt den letzten Fehlercode zurück.
      * @return Fehlercode gemäß SimpleDHT-Definition.
@@ -137,6 +192,12 @@ private:
     uint8_t _csPin; // Der GPIO-Pin für den Chip Select der Kamera.
     ArduCAM _myCAM; // Die Instanz der originalen ArduCAM-Treiberbibliothek.
     int _lastError; // Fehlercode
+    uint8_t _resolution; // Eingestellte JPEG-Auflösung
+    SpiBusArbiter* _bus; // Arbiter für den gemeinsamen SPI-Bus (nullptr = keiner)
+    int _busDevice; // ID der Kamera beim Arbiter
+    bool _burstRead; // true = FIFO blockweise auslesen
+    uint8_t* _buffer; // Puffer für den Burst-Modus (DMA-fähig, BURST_BUFFER_SIZE Byte)
+    TransferStats _stats; // Messwerte der letzten Aufnahme
 
     /**
      * @brief Schießt ein Foto und speichert die Daten in den FIFO-Puffer.
@@ -145,8 +206,27 @@ private:
 
     /**
      * @brief List die Daten aus dem FIFO-Puffer in den Stream.
+     * @param stream Der Ziel-Stream (Datei, Serial oder Puffer im RAM).
+     * @param streamOnBus true, wenn der Stream selbst den SPI-Bus nutzt (z.B. eine Datei auf der SD-Karte).
+     * @return true bei Erfolg, andernfalls false.
+     */
+    bool writeFifoToStream(Print &stream, bool streamOnBus);
+
+    /**
+     * @brief Liest die Daten aus dem FIFO-Puffer blockweise in den Stream (Burst-Modus).
+     * @param stream Der Ziel-Stream.
+     * @param length Anzahl der Bytes im FIFO.
+     * @param streamOnBus true, wenn der Bus für jeden Block freigegeben werden muss. Andernfalls bleibt die Kamera
+     *                    ausgewählt und der Burst-Read läuft ohne Unterbrechung durch.
+     * @return true bei Erfolg, andernfalls false.
+     */
+    bool burstFifoToStream(Print &stream, uint32_t length, bool streamOnBus);
+
+    /**
+     * @brief Liest die Daten aus dem FIFO-Puffer Byte für Byte in den Stream (ursprüngliches Verfahren).
      * @param stream Der Ziel-Stream.
+     * @param length Anzahl der Bytes im FIFO.
      * @return true bei Erfolg, andernfalls false.
      */
-    bool writeFifoToStream(Stream &stream);
+    bool byteFifoToStream(Print &stream, uint32_t length);
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+/**
+ * Benchmark für die ArduCamOV2640-Bibliothek: byteweises Auslesen des FIFO gegen den Burst-Modus.
+ *
+ * Für mehrere Auflösungen werden je Verfahren einige Bilder auf die SD-Karte geschrieben und die Dauer vom
+ * Auslesen des FIFO bis zum Schließen der Datei sowie der Durchsatz in MB/s ausgegeben.
+ *
+ * Ausführen wie example.cpp (src_dir auf die Bibliothek umbiegen), dabei example.cpp ausschließen:
+ *   build_src_filter = +<benchmark.cpp>
+ */
+
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include "ArduCamOV2640.h"
+#include "SpiBusArbiter.h"
+
+// GPIO-Pin für den SPI Chip Select der SD-Karte und Kamera
+constexpr uint8_t SD_CS_PIN = 16;
+constexpr uint8_t CAM_CS_PIN = 17;
+
+constexpr int RUNS = 3; // Aufnahmen je Auflösung und Verfahren
+
+SpiBusArbiter spiBus;
+ArduCamOV2640 camera(CAM_CS_PIN);
+
+/**
+ * @brief Nimmt RUNS Bilder auf und gibt die Mittelwerte aus.
+ * @param burst true für den Burst-Modus, false für das byteweise Auslesen.
+ */
+void measure(const bool burst) {
+    camera.setBurstRead(burst);
+
+    uint32_t bytes = 0;
+    uint32_t transferUs = 0;
+    for (int i = 0; i < RUNS; i++) {
+        if (!camera.saveToSD("/bench.jpg")) {
+            Serial.printf("  Fehler: %s\n", camera.getErrorMessage());
+            return;
+        }
+        const ArduCamOV2640::TransferStats& stats = camera.getLastTransferStats();
+        bytes += stats.bytes;
+        transferUs += stats.transferUs;
+    }
+
+    Serial.printf("  %-6s %7u Byte  %6u ms  %5.2f MB/s\n", burst ? "burst" : "byte",
+        bytes / RUNS, transferUs / RUNS / 1000, static_cast<float>(bytes) / static_cast<float>(transferUs));
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+
+    Wire.begin();
+
+    // Geräte beim Arbiter anmelden (setzt alle CS-Pins auf HIGH) und SPI-Bus initialisieren
+    const int sdDevice = spiBus.addDevice("sd", SD_CS_PIN, 20000000, SPI_MODE0, false);
+    const int cameraDevice = spiBus.addDevice("camera", CAM_CS_PIN, 8000000);
+    spiBus.begin();
+    SPI.begin();
+
+    if (!SD.begin(SD_CS_PIN, SPI, spiBus.getClock(sdDevice)) || !camera.begin(&spiBus, cameraDevice)) {
+        Serial.println("SD-Karte oder Kamera nicht gefunden.");
+        return;
+    }
+
+    const uint8_t resolutions[] = {OV2640_320x240, OV2640_800x600, OV2640_1600x1200};
+    const char* names[] = {"320x240", "800x600", "1600x1200"};
+    for (int r = 0; r < 3; r++) {
+        Serial.printf("%s:\n", names[r]);
+        camera.setResolution(resolutions[r]);
+        measure(false);
+        measure(true);
+    }
+
+    SD.remove("/bench.jpg");
+    Serial.println("Benchmark beendet.");
+}
+
+void loop() {
+    // Bleibt leer, alle Aktionen sind im setup()
+}
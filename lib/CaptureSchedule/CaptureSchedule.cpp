@@ -0,0 +1,43 @@
+#include "CaptureSchedule.h"
+
+namespace {
+constexpr uint32_t SECONDS_PER_DAY = 86400;
+}
+
+bool CaptureSchedule::isDue(const tm& now, const int capturesPerDay) {
+    const int day = now.tm_year * 366 + now.tm_yday;
+    const auto second = static_cast<uint32_t>(now.tm_hour * 3600 + now.tm_min * 60 + now.tm_sec);
+    const int slot = capturesPerDay > 0
+        ? static_cast<int>(min(second, SECONDS_PER_DAY - 1) * static_cast<uint32_t>(capturesPerDay) / SECONDS_PER_DAY)
+        : NONE;
+
+    if (day != _day) {
+        // Nach dem Start ist der laufende Abschnitt fällig, an einem neuen Tag der erste
+        _lastSlot = _day == NONE ? slot - 1 : NONE;
+        _day = day;
+        _capturesPerDay = capturesPerDay;
+        _capturesToday = 0;
+    } else if (capturesPerDay != _capturesPerDay) {
+        // Neue Einteilung: erst ab dem nächsten Abschnitt
+        _lastSlot = slot;
+        _capturesPerDay = capturesPerDay;
+    }
+
+    if (capturesPerDay <= 0 || slot <= _lastSlot) {
+        return false;
+    }
+    _lastSlot = slot;
+    _capturesToday++;
+    return true;
+}
+
+void CaptureSchedule::reset() {
+    _day = NONE;
+    _capturesPerDay = NONE;
+    _lastSlot = NONE;
+    _capturesToday = 0;
+}
+
+int CaptureSchedule::getCapturesToday() const {
+    return _capturesToday;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ctime>
+
+/**
+ * Zeitplan für die Kamera: verteilt cameraCapturesPerDay Aufnahmen gleichmäßig über den Tag.
+ *
+ * Der Tag ist in gleich lange Abschnitte geteilt (bei 4 Aufnahmen: 0, 6, 12 und 18 Uhr). In jedem Abschnitt ist genau
+ * eine Aufnahme fällig, zu Beginn des Abschnitts oder beim ersten Aufruf danach. Verpasste Abschnitte (Neustart am
+ * Nachmittag, Uhr springt vor) werden nicht nachgeholt, sondern ergeben höchstens eine Aufnahme. Ändert sich die
+ * Anzahl pro Tag, gilt sie ab dem nächsten Abschnitt.
+ *
+ * Die Klasse liest keine Uhr; die lokale Zeit übergibt der Aufrufer (z.B. aus Hal::get().getLocalTime()). Tests
+ * können so einen ganzen Tag in Mikrosekunden durchspielen.
+ */
+class CaptureSchedule {
+public:
+    /**
+     * @brief Prüft, ob eine Aufnahme fällig ist, und zählt sie dann als erledigt.
+     * @param now Aktuelle lokale Zeit.
+     * @param capturesPerDay Aufnahmen pro Tag (0 = keine).
+     * @return true, wenn jetzt eine Aufnahme angefordert werden soll.
+     */
+    bool isDue(const tm& now, int capturesPerDay);
+
+    /**
+     * @brief Vergisst den bisherigen Ablauf (der nächste Aufruf verhält sich wie nach dem Start).
+     */
+    void reset();
+
+    /**
+     * @brief Gibt die Anzahl der heute angeforderten Aufnahmen zurück.
+     */
+    int getCapturesToday() const;
+
+private:
+    static constexpr int NONE = -1;
+
+    int _day = NONE;            // Tag der letzten Prüfung (Jahr * 366 + Tag im Jahr)
+    int _capturesPerDay = NONE; // Anzahl pro Tag, mit der _lastSlot berechnet wurde
+    int _lastSlot = NONE;       // Abschnitt der letzten Aufnahme
+    int _capturesToday = 0;
+};
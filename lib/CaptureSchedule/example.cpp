@@ -0,0 +1,30 @@
+/**
+ * Beispiel zur Nutzung der CaptureSchedule-Bibliothek
+ *
+ * Spielt einen Tag im Zeitraffer durch (eine Minute pro Millisekunde) und gibt die Uhrzeiten aus, zu denen bei
+ * 4 Aufnahmen pro Tag ein Bild fällig ist. Nach 12 Uhr wird auf 8 Aufnahmen pro Tag umgestellt.
+ */
+
+#include <Arduino.h>
+#include "CaptureSchedule.h"
+
+CaptureSchedule captureSchedule;
+
+void setup() {
+    Serial.begin(115200);
+
+    tm timeInfo{};
+    timeInfo.tm_year = 125; // 2025
+    timeInfo.tm_yday = 0;
+    for (int minute = 0; minute < 24 * 60; minute++) {
+        timeInfo.tm_hour = minute / 60;
+        timeInfo.tm_min = minute % 60;
+        const int capturesPerDay = timeInfo.tm_hour < 12 ? 4 : 8;
+        if (captureSchedule.isDue(timeInfo, capturesPerDay)) {
+            Serial.printf("%02d:%02d Aufnahme %d\n", timeInfo.tm_hour, timeInfo.tm_min, captureSchedule.getCapturesToday());
+        }
+        delay(1);
+    }
+}
+
+void loop() {}
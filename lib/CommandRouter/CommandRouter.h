@@ -0,0 +1,223 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+/**
+ * @brief Berechnet den FNV-1a-Hash (32 Bit) eines nullterminierten Strings.
+ *
+ * Als constexpr-Funktion kann der Hash bereits zur Compile-Zeit berechnet werden (z.B. für feste Namenstabellen).
+ * @param text Der String.
+ * @param hash Zwischenwert (nur für die Rekursion).
+ */
+constexpr uint32_t fnv1a(const char* text, const uint32_t hash = 2166136261u) {
+    return *text ? fnv1a(text + 1, (hash ^ static_cast<uint8_t>(*text)) * 16777619u) : hash;
+}
+
+/**
+ * Eintrag einer festen Namenstabelle (siehe findByName()).
+ */
+template <typename T>
+struct NamedValue {
+    const char* name; // Name, wie er in der Nachricht steht
+    uint32_t hash;    // fnv1a(name)
+    T value;          // zugeordneter Wert
+
+    constexpr NamedValue(const char* name, const T value) : name(name), hash(fnv1a(name)), value(value) {}
+};
+
+/**
+ * @brief Sucht einen Namen in einer festen Tabelle.
+ *
+ * Verglichen werden zunächst nur die (zur Compile-Zeit berechneten) Hashes, ein strcmp() gibt es nur beim Treffer.
+ * @param table Die Tabelle.
+ * @param name Der gesuchte Name (nullptr ist erlaubt).
+ * @return Zeiger auf den Wert, oder nullptr, wenn der Name nicht in der Tabelle steht.
+ */
+template <typename T, size_t N>
+const T* findByName(const NamedValue<T> (&table)[N], const char* name) {
+    if (!name) {
+        return nullptr;
+    }
+    const uint32_t hash = fnv1a(name);
+    for (const NamedValue<T>& entry : table) {
+        if (entry.hash == hash && strcmp(entry.name, name) == 0) {
+            return &entry.value;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Verteilt Nachrichten anhand ihres Typs an registrierte Handler.
+ *
+ * Die Handler werden beim Start mit on() registriert und in einer Hash-Tabelle mit fester Größe abgelegt (FNV-1a,
+ * offene Adressierung). Die Suche kostet unabhängig von der Anzahl der Befehle einen Hash über den Typ und im Normalfall
+ * einen einzigen strcmp(). Kollidieren zwei Hashes, wird der nächste freie Platz benutzt.
+ *
+ * Handler können die Nutzdaten als JsonObject oder bereits ausgelesen als eigenen Typ erhalten. Ein solcher Typ braucht
+ * eine Methode `bool read(JsonObject payload)`, die false liefert, wenn Felder fehlen oder ungültig sind. Der Handler
+ * wird dann nicht aufgerufen.
+ *
+ * @tparam Context Wird unverändert an die Handler durchgereicht (z.B. der absendende Client).
+ * @tparam Capacity Maximale Anzahl der Befehle.
+ */
+template <typename Context, uint8_t Capacity = 16>
+class CommandRouter {
+public:
+    /**
+     * @enum Result
+     * @brief Ergebnis von dispatch().
+     */
+    enum class Result : uint8_t {
+        Handled,       // Handler wurde aufgerufen
+        Unknown,       // kein Handler für diesen Typ registriert
+        InvalidPayload // Nutzdaten konnten nicht gelesen werden
+    };
+
+    /**
+     * @brief Handler mit den rohen Nutzdaten.
+     * Format: (context, payload) -> void
+     */
+    using Handler = std::function<void(Context context, JsonObject payload)>;
+
+    /**
+     * @brief Registriert einen Handler für einen Nachrichtentyp.
+     * @param type Der Nachrichtentyp (z.B. "setMode"), wird nicht kopiert.
+     * @param handler Der Handler.
+     * @return true bei Erfolg, false wenn die Tabelle voll oder der Typ bereits registriert ist.
+     */
+    bool on(const char* type, Handler handler) {
+        if (!handler) {
+            return false;
+        }
+        return add(type, [handler](Context context, const JsonObject payload) {
+            handler(context, payload);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Registriert einen Handler, der die Nutzdaten bereits ausgelesen erhält.
+     * @tparam Payload Typ der Nutzdaten mit der Methode `bool read(JsonObject payload)`.
+     * @param type Der Nachrichtentyp, wird nicht kopiert.
+     * @param handler Der Handler, Format: (context, const Payload&) -> void
+     * @return true bei Erfolg, false wenn die Tabelle voll oder der Typ bereits registriert ist.
+     */
+    template <typename Payload>
+    bool on(const char* type, void (*handler)(Context context, const Payload& payload)) {
+        if (!handler) {
+            return false;
+        }
+        return add(type, [handler](Context context, const JsonObject payload) {
+            Payload data{};
+            if (!data.read(payload)) {
+                return false;
+            }
+            handler(context, data);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Ruft den Handler für einen Nachrichtentyp auf.
+     * @param type Der Nachrichtentyp (nullptr ist erlaubt).
+     * @param context Wird an den Handler weitergegeben.
+     * @param payload Die Nutzdaten der Nachricht (darf leer sein).
+     * @return Ergebnis der Verteilung.
+     */
+    Result dispatch(const char* type, Context context, const JsonObject payload) const {
+        const Entry* entry = find(type);
+        if (!entry) {
+            return Result::Unknown;
+        }
+        return entry->invoke(context, payload) ? Result::Handled : Result::InvalidPayload;
+    }
+
+    /**
+     * @brief Prüft, ob für einen Nachrichtentyp ein Handler registriert ist.
+     */
+    bool contains(const char* type) const {
+        return find(type) != nullptr;
+    }
+
+    /**
+     * @brief Gibt die Anzahl der registrierten Befehle zurück.
+     */
+    uint8_t getCount() const {
+        return _count;
+    }
+
+private:
+    /**
+     * @brief Interner Aufruf eines Handlers.
+     * Format: (context, payload) -> false, wenn die Nutzdaten ungültig sind
+     */
+    using Invoker = std::function<bool(Context context, JsonObject payload)>;
+
+    /**
+     * @brief Kleinste Zweierpotenz, die mindestens doppelt so groß wie die Kapazität ist (höchstens halb voll).
+     */
+    static constexpr size_t tableSize(const size_t size = 2) {
+        return size >= 2 * static_cast<size_t>(Capacity) ? size : tableSize(size * 2);
+    }
+
+    static constexpr size_t TABLE_SIZE = tableSize();
+    static constexpr size_t MASK = TABLE_SIZE - 1;
+
+    struct Entry {
+        const char* type = nullptr; // nullptr = frei
+        uint32_t hash = 0;
+        Invoker invoke;
+    };
+
+    /**
+     * @brief Trägt einen Handler in die Tabelle ein.
+     * @return true bei Erfolg, false wenn die Tabelle voll oder der Typ bereits registriert ist.
+     */
+    bool add(const char* type, Invoker invoke) {
+        if (!type || _count >= Capacity) {
+            return false;
+        }
+        const uint32_t hash = fnv1a(type);
+        for (size_t i = hash & MASK;; i = (i + 1) & MASK) {
+            Entry& entry = _entries[i];
+            if (!entry.type) {
+                entry.type = type;
+                entry.hash = hash;
+                entry.invoke = std::move(invoke);
+                _count++;
+                return true;
+            }
+            if (entry.hash == hash && strcmp(entry.type, type) == 0) {
+                return false; // doppelt registriert
+            }
+        }
+    }
+
+    /**
+     * @brief Sucht den Eintrag zu einem Typ.
+     * @return Zeiger auf den Eintrag, oder nullptr, wenn der Typ nicht registriert ist.
+     */
+    const Entry* find(const char* type) const {
+        if (!type) {
+            return nullptr;
+        }
+        const uint32_t hash = fnv1a(type);
+        for (size_t i = hash & MASK;; i = (i + 1) & MASK) {
+            const Entry& entry = _entries[i];
+            if (!entry.type) {
+                return nullptr; // die Tabelle ist nie voll, daher endet die Suche spätestens hier
+            }
+            if (entry.hash == hash && strcmp(entry.type, type) == 0) {
+                return &entry;
+            }
+        }
+    }
+
+    Entry _entries[TABLE_SIZE];
+    uint8_t _count = 0;
+};
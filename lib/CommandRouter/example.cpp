@@ -0,0 +1,69 @@
+/**
+ * Beispiel zur Nutzung der CommandRouter-Bibliothek
+ *
+ * Befehle werden als JSON-Zeilen über den Serial Monitor eingegeben, z.B.:
+ *   {"type":"led","payload":{"state":"on"}}
+ *   {"type":"ping"}
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "CommandRouter.h"
+
+constexpr NamedValue<uint8_t> LED_STATES[] = {
+    {"off", LOW},
+    {"on", HIGH},
+};
+
+struct LedCommand {
+    uint8_t state;
+
+    bool read(const JsonObject payload) {
+        const uint8_t* value = findByName(LED_STATES, payload["state"].as<const char*>());
+        if (!value) {
+            return false;
+        }
+        state = *value;
+        return true;
+    }
+};
+
+void handleLed(Stream* out, const LedCommand& command) {
+    digitalWrite(LED_BUILTIN, command.state);
+    out->println("LED geschaltet");
+}
+
+CommandRouter<Stream*> router;
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(LED_BUILTIN, OUTPUT);
+
+    router.on("led", handleLed);
+    router.on("ping", [](Stream* out, JsonObject) {
+        out->println("pong");
+    });
+}
+
+void loop() {
+    if (!Serial.available()) {
+        return;
+    }
+
+    JsonDocument doc;
+    if (deserializeJson(doc, Serial)) {
+        Serial.println("Kein gültiges JSON");
+        return;
+    }
+
+    switch (router.dispatch(doc["type"], &Serial, doc["payload"])) {
+        case CommandRouter<Stream*>::Result::Handled:
+            break;
+        case CommandRouter<Stream*>::Result::InvalidPayload:
+            Serial.println("Fehlerhafte Nutzdaten");
+            break;
+        case CommandRouter<Stream*>::Result::Unknown:
+            Serial.println("Unbekannter Befehl");
+            break;
+    }
+}
@@ -0,0 +1,126 @@
+#include "Controller.h"
+
+Controller::Controller(Relay& lamp1, Relay& lamp2, Relay& heater, Relay& fan, Relay& pump, Relay& mister)
+    : _lamp1(lamp1), _lamp2(lamp2), _heater(heater), _fan(fan), _pump(pump), _mister(mister) {}
+
+void Controller::update(const SensorSnapshot& sensors, const Settings& settings, const int hour) {
+    if (hour != UNKNOWN_HOUR) {
+        // -- Steuerung für die Lampen (A1, A2) --
+        controlLamp(_lamp1, settings.lamp1Mode, hour, settings.light1OnHour, settings.light1OffHour,
+                    settings.light1LuxThresholdDark, settings.light1LuxThresholdBright, sensors.lightLux);
+        controlLamp(_lamp2, settings.lamp2Mode, hour, settings.light2OnHour, settings.light2OffHour,
+                    settings.light2LuxThresholdDark, settings.light2LuxThresholdBright, sensors.lightLux);
+
+        controlHeater(sensors, settings);
+        controlFan(sensors, settings);
+        controlPump(sensors, settings);
+        controlMister(sensors, settings);
+    }
+
+    // Abgelaufene Pulse beenden
+    _fan.update();
+    _pump.update();
+}
+
+void Controller::controlLamp(Relay& lamp, const ControlMode mode, const int hour, const int onHour, const int offHour,
+                             const float luxThresholdDark, const float luxThresholdBright, const float lux) {
+    if (mode == MODE_AUTO) {
+        if (hour >= onHour && hour < offHour) {
+            // Tageszeit
+            if (!isnan(lux)) {
+                if (lux < luxThresholdDark) {
+                    // Zu dunkel -> Lampe AN
+                    lamp.on();
+                } else if (lux > luxThresholdBright) {
+                    // Hell genug -> Lampe AUS
+                    lamp.off();
+                }
+                // Dazwischen (im Hysterese-Bereich): Zustand beibehalten, nichts tun!
+                // Dies verhindert das Oszillieren.
+            } else {
+                // Sensorausfall: Lampe im Zweifel AN
+                lamp.on();
+            }
+        } else {
+            // Nachtzeit
+            lamp.off();
+        }
+    } else if (mode == MODE_ON) {
+        lamp.on();
+    } else {
+        lamp.off();
+    }
+}
+
+void Controller::controlHeater(const SensorSnapshot& sensors, const Settings& settings) {
+    if (settings.heaterMode == MODE_AUTO) {
+        if (isnan(sensors.soilTemp)) {
+            // Sensorausfall: Heizung im Zweifel AUS
+            _heater.off();
+        }
+        else if (sensors.soilTemp < settings.soilTempTarget) {
+            _heater.on();
+        }
+        else if (sensors.soilTemp > settings.soilTempTarget + 0.5f) {
+            _heater.off();
+        }
+    } else if (settings.heaterMode == MODE_ON) {
+        _heater.on();
+    } else {
+        _heater.off();
+    }
+}
+
+void Controller::controlFan(const SensorSnapshot& sensors, const Settings& settings) {
+    if (settings.fanMode == MODE_AUTO) {
+        if (sensors.airTemp > settings.airTempThresholdHigh && !_fan.isOn()) {
+            _fan.pulse(settings.fanCooldownDurationMs);
+        }
+    } else if (settings.fanMode == MODE_ON) {
+        _fan.on();
+    } else {
+        _fan.off();
+    }
+}
+
+void Controller::controlPump(const SensorSnapshot& sensors, const Settings& settings) {
+    if (settings.pumpMode == MODE_AUTO) {
+        if (sensors.waterLevelOk && !_pump.isOn()) {
+            if (sensors.soilMoisture < settings.soilMoistureTarget && sensors.soilMoisture != -1) {
+                _pump.pulse(settings.wateringDurationMs);
+            }
+        }
+    } else if (settings.pumpMode == MODE_ON) {
+        if (sensors.waterLevelOk) {
+            _pump.on();
+        }
+        else {
+            _pump.off();
+        }
+    } else {
+        _pump.off();
+    }
+}
+
+void Controller::controlMister(const SensorSnapshot& sensors, const Settings& settings) {
+    if (settings.misterMode == MODE_AUTO) {
+        if (sensors.waterLevelOk && !isnan(sensors.humidity)) {
+            if (sensors.humidity < settings.humidityTarget) {
+                _mister.on();
+            }
+            else if (sensors.humidity > settings.humidityTarget + 5.0f) {
+                _mister.off();
+            }
+        } else {
+            _mister.off();
+        }
+    } else if (settings.misterMode == MODE_ON) {
+        if (sensors.waterLevelOk) {
+            _mister.on();
+        } else {
+            _mister.off();
+        }
+    } else {
+        _mister.off();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Relay.h"
+#include "../../include/settings.h"
+#include "../../include/SensorSnapshot.h"
+
+/**
+ * Steuerungslogik für alle Aktoren (Lampen, Heizer, Lüfter, Pumpe, Vernebler).
+ *
+ * Entscheidet anhand der Messwerte, der Einstellungen und der aktuellen Stunde, welches Relais schaltet. Die Klasse
+ * kennt weder Tasks noch die Uhrzeit des Systems und läuft daher auch im nativen Build (Tests, Simulation).
+ */
+class Controller {
+public:
+    /**
+     * Stunde ist unbekannt (Uhrzeit noch nicht synchronisiert).
+     */
+    static constexpr int UNKNOWN_HOUR = -1;
+
+    /**
+     * @brief Konstruktor.
+     * @param lamp1 Lampe 1 (A1)
+     * @param lamp2 Lampe 2 (A2)
+     * @param heater Heizer (A3)
+     * @param fan Lüfter (A4)
+     * @param pump Wasserpumpe (A5)
+     * @param mister Vernebler (A6)
+     */
+    Controller(Relay& lamp1, Relay& lamp2, Relay& heater, Relay& fan, Relay& pump, Relay& mister);
+
+    /**
+     * @brief Führt einen Steuerungszyklus aus.
+     *
+     * Ohne Uhrzeit (hour = UNKNOWN_HOUR) bleiben alle Aktoren, wie sie sind. Laufende Pulse von Lüfter und Pumpe
+     * werden in jedem Fall beendet, sobald ihre Zeit abgelaufen ist.
+     *
+     * @param sensors Aktuelle Messwerte.
+     * @param settings Aktuelle Einstellungen.
+     * @param hour Aktuelle Stunde (0-23) oder UNKNOWN_HOUR.
+     */
+    void update(const SensorSnapshot& sensors, const Settings& settings, int hour);
+
+private:
+    /**
+     * @brief Steuert eine Lampe nach Tageszeit und Tageslicht (mit Hysterese).
+     */
+    static void controlLamp(Relay& lamp, ControlMode mode, int hour, int onHour, int offHour,
+                            float luxThresholdDark, float luxThresholdBright, float lux);
+
+    void controlHeater(const SensorSnapshot& sensors, const Settings& settings);
+    void controlFan(const SensorSnapshot& sensors, const Settings& settings);
+    void controlPump(const SensorSnapshot& sensors, const Settings& settings);
+    void controlMister(const SensorSnapshot& sensors, const Settings& settings);
+
+    Relay& _lamp1;
+    Relay& _lamp2;
+    Relay& _heater;
+    Relay& _fan;
+    Relay& _pump;
+    Relay& _mister;
+};
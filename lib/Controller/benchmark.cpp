@@ -0,0 +1,79 @@
+/**
+ * Benchmark für die Controller-Bibliothek: Dauer eines Steuerungszyklus (Controller::update()).
+ *
+ * Die Messwerte wechseln in jedem Zyklus, damit alle Zweige (Hysterese, Pulse, Nachtzeit) durchlaufen werden.
+ * Gemessen wird mit der echten Uhr, auch im nativen Build.
+ *
+ * Auf dem Board ausführen wie example.cpp (src_dir auf die Bibliothek umbiegen), dabei example.cpp ausschließen:
+ *   build_src_filter = +<benchmark.cpp>
+ * Im nativen Build ohne Board:
+ *   pio run -e native -t exec
+ */
+
+#include <Arduino.h>
+#include "Controller.h"
+
+#if defined(NATIVE)
+#include <chrono>
+#else
+#include <esp_timer.h>
+#endif
+
+constexpr int CYCLES = 100000;
+
+Relay lamp1(14);
+Relay lamp2(27);
+Relay heater(26);
+Relay fan(25);
+Relay pump(33);
+Relay mister(32);
+
+Controller controller(lamp1, lamp2, heater, fan, pump, mister);
+
+/**
+ * @brief Gibt eine monotone Zeit in µs zurück.
+ */
+int64_t nowUs() {
+#if defined(NATIVE)
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+void setup() {
+    Serial.begin(115200);
+    for (Relay* relay : {&lamp1, &lamp2, &heater, &fan, &pump, &mister}) {
+        relay->begin();
+    }
+
+    Settings settings;
+    SensorSnapshot sensors;
+    sensors.waterLevelOk = true;
+
+    uint32_t switches = 0;
+    bool lastLamp = false;
+    const int64_t start = nowUs();
+    for (int i = 0; i < CYCLES; i++) {
+        sensors.airTemp = 20.0f + static_cast<float>(i % 13);
+        sensors.humidity = 60.0f + static_cast<float>(i % 17);
+        sensors.soilTemp = 23.0f + static_cast<float>(i % 7) * 0.25f;
+        sensors.soilMoisture = 40 + i % 21;
+        sensors.lightLux = static_cast<float>(i % 31);
+
+        controller.update(sensors, settings, (i / 100) % 24);
+
+        if (lamp1.isOn() != lastLamp) {
+            lastLamp = lamp1.isOn();
+            switches++;
+        }
+    }
+    const int64_t elapsed = nowUs() - start;
+
+    Serial.printf("%d Zyklen in %lld us: %.3f us pro Zyklus (Lampe 1 hat %lu-mal geschaltet)\n",
+                  CYCLES, static_cast<long long>(elapsed), static_cast<double>(elapsed) / CYCLES,
+                  static_cast<unsigned long>(switches));
+}
+
+void loop() {}
@@ -0,0 +1,51 @@
+/**
+ * Beispiel zur Nutzung der Controller-Bibliothek
+ *
+ * Statt echter Sensoren wird ein Tag im Zeitraffer durchgespielt (eine Stunde pro Sekunde): Tageslicht und
+ * Bodentemperatur folgen der Uhrzeit. Der Zustand der Lampe und des Heizers wird im Format des Serial Plotters
+ * ausgegeben.
+ */
+
+#include <Arduino.h>
+#include "Controller.h"
+
+Relay lamp1(14);
+Relay lamp2(27);
+Relay heater(26);
+Relay fan(25);
+Relay pump(33);
+Relay mister(32);
+
+Controller controller(lamp1, lamp2, heater, fan, pump, mister);
+Settings settings;
+
+void setup() {
+    Serial.begin(115200);
+    for (Relay* relay : {&lamp1, &lamp2, &heater, &fan, &pump, &mister}) {
+        relay->begin();
+    }
+}
+
+void loop() {
+    static int hour = 0;
+
+    SensorSnapshot sensors;
+    sensors.lightLux = hour >= 8 && hour < 18 ? 800.0f : 1.0f; // tagsüber hell
+    sensors.soilTemp = hour < 12 ? 23.0f : 25.0f;               // nachmittags warm genug
+    sensors.airTemp = 22.0f;
+    sensors.humidity = 75.0f;
+    sensors.soilMoisture = 60;
+    sensors.waterLevelOk = true;
+
+    controller.update(sensors, settings, hour);
+
+    Serial.print(">Hour:");
+    Serial.println(hour);
+    Serial.print(">Lamp1:");
+    Serial.println(lamp1.isOn() ? 1 : 0);
+    Serial.print(">Heater:");
+    Serial.println(heater.isOn() ? 1 : 0);
+
+    hour = (hour + 1) % 24;
+    delay(1000);
+}
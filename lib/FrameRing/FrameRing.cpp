@@ -0,0 +1,205 @@
+#include "FrameRing.h"
+#include <esp_heap_caps.h>
+
+// --- Ref ---
+
+FrameRing::Ref::Ref(FrameRing* ring, const uint8_t slot) : _ring(ring), _slot(slot) {}
+
+FrameRing::Ref::Ref(const Ref& other) : _ring(other._ring), _slot(other._slot) {
+    if (_ring) {
+        _ring->pin(_slot);
+    }
+}
+
+FrameRing::Ref::Ref(Ref&& other) noexcept : _ring(other._ring), _slot(other._slot) {
+    other._ring = nullptr;
+}
+
+FrameRing::Ref& FrameRing::Ref::operator=(const Ref& other) {
+    if (this != &other) {
+        if (other._ring) {
+            other._ring->pin(other._slot); // zuerst pinnen, falls beide auf denselben Slot zeigen
+        }
+        reset();
+        _ring = other._ring;
+        _slot = other._slot;
+    }
+    return *this;
+}
+
+FrameRing::Ref& FrameRing::Ref::operator=(Ref&& other) noexcept {
+    if (this != &other) {
+        reset();
+        _ring = other._ring;
+        _slot = other._slot;
+        other._ring = nullptr;
+    }
+    return *this;
+}
+
+FrameRing::Ref::~Ref() {
+    reset();
+}
+
+void FrameRing::Ref::reset() {
+    if (_ring) {
+        _ring->unpin(_slot);
+        _ring = nullptr;
+    }
+}
+
+FrameRing::Ref::operator bool() const {
+    return _ring != nullptr;
+}
+
+const uint8_t* FrameRing::Ref::data() const {
+    return _ring ? _ring->_slots[_slot].data : nullptr;
+}
+
+size_t FrameRing::Ref::size() const {
+    return _ring ? _ring->_slots[_slot].size : 0;
+}
+
+uint32_t FrameRing::Ref::seq() const {
+    return _ring ? _ring->_slots[_slot].seq : 0;
+}
+
+unsigned long FrameRing::Ref::capturedAt() const {
+    return _ring ? _ring->_slots[_slot].capturedAt : 0;
+}
+
+// --- FrameRing ---
+
+FrameRing::FrameRing()
+    : _count(0), _slotSize(0), _memory(nullptr), _external(false), _writing(-1), _latestSeq(0), _latestSlot(0),
+      _mux(portMUX_INITIALIZER_UNLOCKED) {}
+
+FrameRing::~FrameRing() {
+    heap_caps_free(_memory);
+}
+
+uint8_t FrameRing::begin(uint8_t slots, const size_t slotSize) {
+    if (_memory) {
+        return _count; // schon initialisiert
+    }
+    if (slots > MAX_SLOTS) {
+        slots = MAX_SLOTS;
+    }
+
+    // Bevorzugt PSRAM, sonst interner Speicher. Reicht es nicht, mit weniger Slots versuchen.
+    for (; slots > 0; slots--) {
+        const size_t size = slots * slotSize;
+        _memory = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+        _external = _memory != nullptr;
+        if (!_memory) {
+            _memory = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_8BIT));
+        }
+        if (_memory) {
+            break;
+        }
+    }
+
+    _count = slots;
+    _slotSize = _memory ? slotSize : 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        _slots[i].data = _memory + i * slotSize;
+    }
+    return _count;
+}
+
+uint8_t* FrameRing::beginWrite() {
+    int best = -1;
+    portENTER_CRITICAL(&_mux);
+    if (_writing < 0) {
+        // Ältesten ungepinnten Slot suchen (leere Slots haben seq 0 und kommen zuerst)
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_slots[i].refs == 0 && (best < 0 || _slots[i].seq < _slots[best].seq)) {
+                best = i;
+            }
+        }
+        if (best >= 0) {
+            _slots[best].seq = 0; // für Leser unsichtbar machen
+            _slots[best].size = 0;
+            _writing = best;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+    return best >= 0 ? _slots[best].data : nullptr;
+}
+
+uint32_t FrameRing::commit(const size_t size) {
+    uint32_t seq = 0;
+    portENTER_CRITICAL(&_mux);
+    if (_writing >= 0) {
+        Slot& slot = _slots[_writing];
+        slot.size = size < _slotSize ? size : _slotSize;
+        slot.capturedAt = millis();
+        slot.seq = seq = ++_latestSeq;
+        _latestSlot = _writing;
+        _writing = -1;
+    }
+    portEXIT_CRITICAL(&_mux);
+    return seq;
+}
+
+void FrameRing::abort() {
+    portENTER_CRITICAL(&_mux);
+    _writing = -1; // Slot bleibt leer (seq 0)
+    portEXIT_CRITICAL(&_mux);
+}
+
+FrameRing::Ref FrameRing::latest() {
+    portENTER_CRITICAL(&_mux);
+    Ref ref = _latestSeq > 0 && _slots[_latestSlot].seq == _latestSeq ? pinLocked(_latestSlot) : Ref();
+    portEXIT_CRITICAL(&_mux);
+    return ref;
+}
+
+FrameRing::Ref FrameRing::get(const uint32_t seq) {
+    Ref ref;
+    if (seq == 0) {
+        return ref;
+    }
+    portENTER_CRITICAL(&_mux);
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_slots[i].seq == seq) {
+            ref = pinLocked(i);
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+    return ref;
+}
+
+FrameRing::Ref FrameRing::pinLocked(const uint8_t slot) {
+    _slots[slot].refs++;
+    return {this, slot};
+}
+
+void FrameRing::pin(const uint8_t slot) {
+    portENTER_CRITICAL(&_mux);
+    _slots[slot].refs++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void FrameRing::unpin(const uint8_t slot) {
+    portENTER_CRITICAL(&_mux);
+    _slots[slot].refs--;
+    portEXIT_CRITICAL(&_mux);
+}
+
+uint32_t FrameRing::getLatestSeq() const {
+    return _latestSeq;
+}
+
+uint8_t FrameRing::getSlotCount() const {
+    return _count;
+}
+
+size_t FrameRing::getSlotSize() const {
+    return _slotSize;
+}
+
+bool FrameRing::isExternal() const {
+    return _external;
+}
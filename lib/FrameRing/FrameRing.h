@@ -0,0 +1,181 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Ringpuffer für die letzten Kamerabilder im RAM.
+ *
+ * Beim Start wird Speicher für eine feste Anzahl gleich großer Slots reserviert (im PSRAM, falls vorhanden). Die
+ * Kamera schreibt jedes Bild direkt in den ältesten freien Slot, danach kann es beliebig oft ausgeliefert werden,
+ * ohne die SD-Karte erneut zu lesen.
+ *
+ * Leser halten ein Bild über eine Ref fest ("pinnen"). Solange eine Ref existiert, wird der Slot nicht überschrieben,
+ * auch wenn die Auslieferung an einen langsamen Client mehrere Sekunden dauert.
+ */
+class FrameRing {
+public:
+    static constexpr uint8_t MAX_SLOTS = 8; // Maximale Anzahl Slots
+
+    /**
+     * Verweis auf ein Bild im Ringpuffer.
+     *
+     * Hält das Bild fest, bis die letzte Kopie zerstört wird (Referenzzählung). Eine leere Ref (operator bool = false)
+     * steht für "Bild nicht (mehr) vorhanden".
+     */
+    class Ref {
+    public:
+        Ref() = default;
+        Ref(const Ref& other);
+        Ref(Ref&& other) noexcept;
+        Ref& operator=(const Ref& other);
+        Ref& operator=(Ref&& other) noexcept;
+        ~Ref();
+
+        /**
+         * @brief Gibt das Bild frei (die Ref ist danach leer).
+         */
+        void reset();
+
+        /**
+         * @brief true, wenn die Ref auf ein Bild zeigt.
+         */
+        explicit operator bool() const;
+
+        /**
+         * @brief Gibt die JPEG-Daten zurück.
+         */
+        const uint8_t* data() const;
+
+        /**
+         * @brief Gibt die Größe des Bildes in Byte zurück.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Gibt die laufende Nummer des Bildes zurück (beginnt nach jedem Neustart bei 1).
+         */
+        uint32_t seq() const;
+
+        /**
+         * @brief Gibt den Aufnahmezeitpunkt (millis()) zurück.
+         */
+        unsigned long capturedAt() const;
+
+    private:
+        friend class FrameRing;
+
+        /**
+         * @brief Übernimmt einen bereits gepinnten Slot.
+         */
+        Ref(FrameRing* ring, uint8_t slot);
+
+        FrameRing* _ring = nullptr; // nullptr = leer
+        uint8_t _slot = 0;
+    };
+
+    FrameRing();
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /**
+     * @brief Reserviert den Speicher für die Slots.
+     * Reicht der Speicher nicht, werden entsprechend weniger Slots angelegt.
+     * @param slots Gewünschte Anzahl Slots (max. MAX_SLOTS).
+     * @param slotSize Größe eines Slots in Byte (= maximale Größe eines Bildes).
+     * @return Anzahl der angelegten Slots (0 = kein Speicher).
+     */
+    uint8_t begin(uint8_t slots, size_t slotSize);
+
+    /**
+     * @brief Reserviert einen Slot für ein neues Bild.
+     * Genommen wird der älteste Slot, den gerade niemand liest. Bis zu commit() bzw. abort() ist der Slot für Leser
+     * unsichtbar. Es darf nur ein Task schreiben.
+     * @return Zeiger auf den Slot (getSlotSize() Byte), oder nullptr, wenn alle Slots gepinnt sind.
+     */
+    uint8_t* beginWrite();
+
+    /**
+     * @brief Veröffentlicht das mit beginWrite() geschriebene Bild.
+     * @param size Größe des Bildes in Byte.
+     * @return Laufende Nummer des Bildes (0, wenn kein Schreibvorgang lief).
+     */
+    uint32_t commit(size_t size);
+
+    /**
+     * @brief Verwirft den mit beginWrite() reservierten Slot (z.B. nach einer fehlgeschlagenen Aufnahme).
+     */
+    void abort();
+
+    /**
+     * @brief Gibt das neueste Bild zurück.
+     * @return Ref auf das Bild, oder eine leere Ref, wenn noch keines aufgenommen wurde.
+     */
+    Ref latest();
+
+    /**
+     * @brief Gibt ein Bild anhand seiner laufenden Nummer zurück.
+     * @param seq Laufende Nummer (siehe commit()).
+     * @return Ref auf das Bild, oder eine leere Ref, wenn es bereits überschrieben wurde.
+     */
+    Ref get(uint32_t seq);
+
+    /**
+     * @brief Gibt die Nummer des neuesten Bildes zurück (0 = noch keines).
+     */
+    uint32_t getLatestSeq() const;
+
+    /**
+     * @brief Gibt die Anzahl der Slots zurück.
+     */
+    uint8_t getSlotCount() const;
+
+    /**
+     * @brief Gibt die Größe eines Slots in Byte zurück.
+     */
+    size_t getSlotSize() const;
+
+    /**
+     * @brief true, wenn die Slots im PSRAM liegen.
+     */
+    bool isExternal() const;
+
+private:
+    /**
+     * @struct Slot
+     * @brief Verwaltungsdaten eines Slots.
+     */
+    struct Slot {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        uint32_t seq = 0;              // 0 = leer oder wird gerade geschrieben
+        unsigned long capturedAt = 0;  // millis() beim commit()
+        uint16_t refs = 0;             // Anzahl der Refs auf diesen Slot
+    };
+
+    /**
+     * @brief Pinnt einen Slot (nur innerhalb der Sperre aufrufen).
+     */
+    Ref pinLocked(uint8_t slot);
+
+    /**
+     * @brief Erhöht den Referenzzähler eines Slots.
+     */
+    void pin(uint8_t slot);
+
+    /**
+     * @brief Verringert den Referenzzähler eines Slots.
+     */
+    void unpin(uint8_t slot);
+
+    Slot _slots[MAX_SLOTS];
+    uint8_t _count;                  // Anzahl der Slots
+    size_t _slotSize;                // Größe eines Slots in Byte
+    uint8_t* _memory;                // Speicher für alle Slots (ein Block)
+    bool _external;                  // true = PSRAM
+    int _writing;                    // Index des Slots, der gerade geschrieben wird (-1 = keiner)
+    uint32_t _latestSeq;             // Nummer des neuesten Bildes
+    uint8_t _latestSlot;             // Slot des neuesten Bildes
+    portMUX_TYPE _mux;               // Schützt die Verwaltungsdaten (kurze kritische Abschnitte)
+};
@@ -0,0 +1,68 @@
+/**
+ * Beispiel zur Nutzung der FrameRing-Bibliothek
+ *
+ * Alle fünf Sekunden wird ein Bild in den Ringpuffer aufgenommen. Über http://<ip>/latest.jpg ist das neueste Bild
+ * abrufbar, ohne dass eine SD-Karte nötig ist.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <ESPAsyncWebServer.h>
+#include "ArduCamOV2640.h"
+#include "FrameRing.h"
+
+constexpr uint8_t CAM_CS_PIN = 17;
+
+const char* WIFI_SSID = "MeinWLAN";
+const char* WIFI_PASSWORD = "geheim";
+
+ArduCamOV2640 camera(CAM_CS_PIN);
+FrameRing frames;
+AsyncWebServer server(80);
+
+void setup() {
+    Serial.begin(115200);
+    SPI.begin();
+    if (!camera.begin()) {
+        Serial.println(camera.getErrorMessage());
+        return;
+    }
+
+    Serial.printf("%u Slots angelegt (%s)\n", frames.begin(3, 32768), frames.isExternal() ? "PSRAM" : "intern");
+
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    while (WiFi.status() != WL_CONNECTED) {
+        delay(500);
+    }
+    Serial.println(WiFi.localIP());
+
+    server.on("/latest.jpg", HTTP_GET, [](AsyncWebServerRequest* request) {
+        const FrameRing::Ref frame = frames.latest();
+        if (!frame) {
+            request->send(404);
+            return;
+        }
+        // Die Kopie der Ref im Lambda hält das Bild fest, bis die Antwort gesendet ist
+        request->send(request->beginResponse("image/jpeg", frame.size(),
+            [frame](uint8_t* buffer, const size_t maxLen, const size_t index) -> size_t {
+                const size_t length = min(maxLen, frame.size() - index);
+                memcpy(buffer, frame.data() + index, length);
+                return length;
+            }));
+    });
+    server.begin();
+}
+
+void loop() {
+    uint8_t* buffer = frames.beginWrite();
+    if (buffer) {
+        const size_t size = camera.captureToBuffer(buffer, frames.getSlotSize());
+        if (size > 0) {
+            Serial.printf("Bild %u: %u Byte\n", frames.commit(size), size);
+        } else {
+            frames.abort();
+            Serial.println(camera.getErrorMessage());
+        }
+    }
+    delay(5000);
+}
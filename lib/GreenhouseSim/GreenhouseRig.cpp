@@ -0,0 +1,95 @@
+#if defined(NATIVE)
+
+#include "GreenhouseRig.h"
+#include <chrono>
+
+GreenhouseRig::GreenhouseRig(const Settings& settings, const GreenhouseSim::Params& params, const Timing& timing)
+    : _settings(settings),
+      _timing(timing),
+      _sim(_settings, params, _pins),
+      _air(_pins.air),
+      _soilTemp(_pins.soilTemp),
+      _soilMoisture(_pins.soilMoisture, params.soilAdcDry, params.soilAdcWet),
+      _waterLevel(_pins.waterLevel),
+      _light(_pins.lightAddress),
+      _lamp1(_pins.actuators[GreenhouseSim::LAMP1], _pins.relayActiveHigh),
+      _lamp2(_pins.actuators[GreenhouseSim::LAMP2], _pins.relayActiveHigh),
+      _heater(_pins.actuators[GreenhouseSim::HEATER], _pins.relayActiveHigh),
+      _fan(_pins.actuators[GreenhouseSim::FAN], _pins.relayActiveHigh),
+      _pump(_pins.actuators[GreenhouseSim::PUMP], _pins.relayActiveHigh),
+      _mister(_pins.actuators[GreenhouseSim::MISTER], _pins.relayActiveHigh),
+      _controller(_lamp1, _lamp2, _heater, _fan, _pump, _mister) {}
+
+GreenhouseRig::GreenhouseRig(const Settings& settings, const GreenhouseSim::Params& params)
+    : GreenhouseRig(settings, params, Timing()) {}
+
+bool GreenhouseRig::begin() {
+    HostHal::instance().reset();
+    _sensors = SensorSnapshot();
+
+    // Relais zuerst, damit ihr Ausgangszustand nicht als Schaltvorgang in den Tagesbericht eingeht
+    for (Relay* relay : {&_lamp1, &_lamp2, &_heater, &_fan, &_pump, &_mister}) {
+        relay->begin();
+    }
+    _sim.begin();
+
+    bool ok = _air.begin();
+    ok = _soilTemp.begin() && ok;
+    ok = _soilMoisture.begin() && ok;
+    ok = _waterLevel.begin() && ok;
+    ok = _light.begin() && ok;
+
+    if (_scheduler.getSensorCount() == 0) {
+        // Dieselbe Verdrahtung wie setupSensorScheduler() in main.cpp, die Messwerte landen direkt im Snapshot
+        const SensorWiring::Sensors sensors{_air, _soilTemp, _soilMoisture, _waterLevel, _light};
+        const SensorWiring::Intervals intervals{_timing.sensorIntervalMs, _timing.waterLevelIntervalMs, _timing.deadlineMs};
+        SensorWiring::addSensors(_scheduler, sensors, intervals, [this](const SensorField field, const float value) {
+            store(field, value);
+        });
+    }
+    _scheduler.triggerAll();
+    return ok;
+}
+
+GreenhouseRig::RunResult GreenhouseRig::run(const double seconds) {
+    HostHal& hal = HostHal::instance();
+    const double end = _sim.getElapsedSeconds() + seconds;
+    const uint64_t stepUs = static_cast<uint64_t>(_timing.controlIntervalMs) * 1000;
+    RunResult result{seconds, 0.0, 0};
+
+    const auto start = std::chrono::steady_clock::now();
+    while (_sim.getElapsedSeconds() < end - 1e-6) {
+        // Ein Durchlauf wie loop() (Sensoren) und controlTask() (Steuerung) in main.cpp
+        _scheduler.run();
+        _controller.update(_sensors, _settings, _sim.getHour());
+        hal.advance(stepUs);
+        _sim.update();
+        result.cycles++;
+    }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+GreenhouseRig::RunResult GreenhouseRig::runDays(const uint32_t days) {
+    return run(86400.0 * days);
+}
+
+GreenhouseSim& GreenhouseRig::getSim() {
+    return _sim;
+}
+
+Settings& GreenhouseRig::getSettings() {
+    return _settings;
+}
+
+const SensorSnapshot& GreenhouseRig::getSensors() const {
+    return _sensors;
+}
+
+void GreenhouseRig::store(const SensorField field, const float value) {
+    _sensors.apply(field, value);
+    _sensors.sequence++;
+    _sensors.updatedAt = static_cast<int64_t>(HostHal::instance().getTimeUs());
+}
+
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#if defined(NATIVE)
+
+#include "GreenhouseSim.h"
+#include "Controller.h"
+#include "SensorAM2302.h"
+#include "SensorBH1750.h"
+#include "SensorCapacitiveSoil.h"
+#include "SensorDS18B20.h"
+#include "SensorScheduler.h"
+#include "SensorWiring.h"
+#include "SensorXKCY25NPN.h"
+
+/**
+ * Prüfstand für den nativen Build: die echte Steuerung im geschlossenen Regelkreis mit GreenhouseSim.
+ *
+ * Der Prüfstand besitzt dieselben Sensor- und Relais-Objekte wie main.cpp, liest die Sensoren über den SensorScheduler
+ * und ruft den Controller im Takt des Steuerungs-Tasks auf. Zwischen zwei Zyklen wird die virtuelle Uhr vorgestellt und
+ * das Modell nachgeführt. Tasks, Queue und Seqlock fehlen; die Messwerte landen direkt im SensorSnapshot.
+ */
+class GreenhouseRig {
+public:
+    /**
+     * Zeitverhalten der Firmware (wie in config.h).
+     */
+    struct Timing {
+        unsigned long controlIntervalMs = 50;    // CONTROL_INTERVAL
+        unsigned long sensorIntervalMs = 5000;   // SENSOR_READ_INTERVAL
+        unsigned long waterLevelIntervalMs = 1000; // WATER_LEVEL_READ_INTERVAL
+        unsigned long deadlineMs = 2000;         // SENSOR_READ_DEADLINE
+    };
+
+    /**
+     * Ergebnis von run().
+     */
+    struct RunResult {
+        double simulatedSeconds; // simulierte Zeit
+        double wallSeconds;      // dafür benötigte echte Zeit
+        uint32_t cycles;         // Steuerungszyklen
+
+        /** @brief Gibt an, wie viel schneller als Echtzeit die Simulation lief. */
+        double speedup() const { return wallSeconds > 0.0 ? simulatedSeconds / wallSeconds : 0.0; }
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param settings Einstellungen der Steuerung (werden kopiert, siehe getSettings()).
+     * @param params Physikalische Parameter des Modells.
+     * @param timing Zeitverhalten der Firmware.
+     */
+    GreenhouseRig(const Settings& settings, const GreenhouseSim::Params& params, const Timing& timing);
+
+    /** @brief Konstruktor mit dem Zeitverhalten aus config.h. */
+    explicit GreenhouseRig(const Settings& settings = Settings(), const GreenhouseSim::Params& params = GreenhouseSim::Params());
+
+    /**
+     * @brief Setzt die simulierte Hardware zurück und startet Modell, Relais, Sensoren und Scheduler.
+     * @return true, wenn alle Sensoren gefunden wurden.
+     */
+    bool begin();
+
+    /**
+     * @brief Lässt die Steuerung für eine simulierte Zeit laufen.
+     * @param seconds Simulierte Zeit in Sekunden.
+     */
+    RunResult run(double seconds);
+
+    /** @brief Lässt die Steuerung für ganze Tage laufen (je Tag ein Eintrag in getSim().getReports()). */
+    RunResult runDays(uint32_t days);
+
+    /** @brief Gibt das Modell zurück. */
+    GreenhouseSim& getSim();
+
+    /** @brief Gibt die Einstellungen zurück (Änderungen gelten ab dem nächsten Zyklus). */
+    Settings& getSettings();
+
+    /** @brief Gibt die zuletzt an den Controller übergebenen Messwerte zurück. */
+    const SensorSnapshot& getSensors() const;
+
+private:
+    void store(SensorField field, float value);
+
+    Settings _settings;
+    Timing _timing;
+    GreenhouseSim::Pins _pins;
+    GreenhouseSim _sim;
+
+    SensorAM2302 _air;
+    SensorDS18B20 _soilTemp;
+    SensorCapacitiveSoil _soilMoisture;
+    SensorXKCY25NPN _waterLevel;
+    SensorBH1750 _light;
+    SensorScheduler _scheduler;
+
+    Relay _lamp1;
+    Relay _lamp2;
+    Relay _heater;
+    Relay _fan;
+    Relay _pump;
+    Relay _mister;
+    Controller _controller;
+
+    SensorSnapshot _sensors;
+};
+
+#endif
@@ -0,0 +1,269 @@
+#if defined(NATIVE)
+
+#include "GreenhouseSim.h"
+
+namespace {
+constexpr double SECONDS_PER_DAY = 86400.0;
+constexpr float MAX_STEP_S = 1.0f; // Schrittweite der Integration
+
+const char* const ACTUATOR_NAMES[GreenhouseSim::ACTUATOR_COUNT] = {"lamp1", "lamp2", "heater", "fan", "pump", "mister"};
+
+/**
+ * @brief Exakter Schritt eines Speichers erster Ordnung: x strebt mit Zeitkonstante tau gegen target.
+ */
+float approach(const float x, const float target, const float tau, const float dt) {
+    return target + (x - target) * expf(-dt / tau);
+}
+}
+
+GreenhouseSim::GreenhouseSim(const Settings& settings, const Params& params, const Pins& pins)
+    : _settings(settings),
+      _params(params),
+      _pins(pins),
+      _airTemp(params.airTemp),
+      _soilTemp(params.soilTemp),
+      _humidity(params.humidity),
+      _soilMoisture(params.soilMoisture),
+      _tankMl(params.tankCapacity) {}
+
+GreenhouseSim::GreenhouseSim(const Settings& settings, const Params& params) : GreenhouseSim(settings, params, Pins()) {}
+
+GreenhouseSim::GreenhouseSim(const Settings& settings) : GreenhouseSim(settings, Params(), Pins()) {}
+
+void GreenhouseSim::begin() {
+    HostHal& hal = HostHal::instance();
+    hal.attachI2c(_pins.lightAddress, &_light);
+    _startUs = hal.getTimeUs();
+    _lastUs = _startUs;
+    _elapsed = 0.0;
+    _reports.clear();
+    _lux = getDaylight(getElapsedSeconds() + _params.startHour * 3600.0);
+    startDay();
+    publish();
+}
+
+void GreenhouseSim::update() {
+    const uint64_t now = HostHal::instance().getTimeUs();
+    if (now <= _lastUs) {
+        return;
+    }
+    float remaining = static_cast<float>(now - _lastUs) / 1e6f;
+    _lastUs = now;
+
+    while (remaining > 0.0f) {
+        // Schritte enden an der Tagesgrenze, damit jede Sekunde dem richtigen Tag zugerechnet wird
+        const double toMidnight = SECONDS_PER_DAY * (_day.day + 1) - _elapsed;
+        float dt = remaining < MAX_STEP_S ? remaining : MAX_STEP_S;
+        if (dt > toMidnight) {
+            dt = static_cast<float>(toMidnight);
+        }
+        step(dt);
+        remaining -= dt;
+        if (_elapsed >= SECONDS_PER_DAY * (_day.day + 1) - 1e-6) {
+            finishDay();
+            startDay();
+        }
+    }
+    publish();
+}
+
+void GreenhouseSim::refill() {
+    _tankMl = _params.tankCapacity;
+    publish();
+}
+
+void GreenhouseSim::setSoilTempConnected(const bool connected) {
+    _soilTempConnected = connected;
+    publish();
+}
+
+int GreenhouseSim::getHour() const {
+    const auto seconds = static_cast<uint64_t>(_elapsed) + static_cast<uint64_t>(_params.startHour) * 3600;
+    return static_cast<int>(seconds / 3600 % 24);
+}
+
+double GreenhouseSim::getElapsedSeconds() const {
+    return _elapsed;
+}
+
+GreenhouseSim::State GreenhouseSim::getState() const {
+    return {_airTemp, _soilTemp, _humidity, _soilMoisture, _lux, _tankMl, _pendingMl};
+}
+
+const std::vector<GreenhouseSim::DayReport>& GreenhouseSim::getReports() const {
+    return _reports;
+}
+
+const char* GreenhouseSim::getName(const Actuator actuator) {
+    return actuator < ACTUATOR_COUNT ? ACTUATOR_NAMES[actuator] : "?";
+}
+
+void GreenhouseSim::printReport(const DayReport& report) {
+    Serial.printf("Tag %lu\n", static_cast<unsigned long>(report.day + 1));
+    Serial.printf("  %-7s %8s %9s %9s\n", "Aktor", "Anteil", "Laufzeit", "Wechsel");
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+        const auto actuator = static_cast<Actuator>(i);
+        Serial.printf("  %-7s %7.1f%% %7.1f m %9lu\n", getName(actuator), report.duty(actuator) * 100.0f,
+                      report.onSeconds[i] / 60.0f, static_cast<unsigned long>(report.switches[i]));
+    }
+    Serial.printf("  Luft        %5.1f .. %5.1f °C  (über Schwelle max. %.2f K)\n", report.airTempMin,
+                  report.airTempMax, report.airTempOvershoot);
+    Serial.printf("  Boden       %5.1f .. %5.1f °C  (unter Ziel max. %.2f K, über Hysterese max. %.2f K)\n",
+                  report.soilTempMin, report.soilTempMax, report.soilTempUndershoot, report.soilTempOvershoot);
+    Serial.printf("  Feuchte     %5.1f .. %5.1f %%   (unter Ziel max. %.1f %%, über Hysterese max. %.1f %%)\n",
+                  report.humidityMin, report.humidityMax, report.humidityUndershoot, report.humidityOvershoot);
+    Serial.printf("  Bodenfeuchte %4.1f .. %5.1f %%   (unter Ziel max. %.1f %%, über Ziel max. %.1f %%)\n",
+                  report.soilMoistureMin, report.soilMoistureMax, report.soilMoistureUndershoot,
+                  report.soilMoistureOvershoot);
+    Serial.printf("  Wasser      %.0f ml (Pumpe %.0f ml, Vernebler %.0f ml), Tank leer %.0f s\n", report.waterMl(),
+                  report.pumpWaterMl, report.misterWaterMl, report.tankEmptySeconds);
+}
+
+void GreenhouseSim::step(const float dt) {
+    const Params& p = _params;
+    const double secondOfDay = fmod(_elapsed + p.startHour * 3600.0, SECONDS_PER_DAY);
+    const float daylight = getDaylight(secondOfDay);
+    const int lamps = (isOn(LAMP1) ? 1 : 0) + (isOn(LAMP2) ? 1 : 0);
+    const bool heater = isOn(HEATER);
+    const bool fan = isOn(FAN);
+    const bool pump = isOn(PUMP) && _tankMl > 0.0f;
+    const bool mister = isOn(MISTER) && _tankMl > 0.0f;
+
+    // Statistik mit dem Zustand zu Beginn des Schritts
+    record(dt);
+
+    // Luft: Raum + Lampen + Sonne, Lüfter tauscht die Luft schneller aus
+    const float sunHeat = p.sunHeatK * daylight / p.daylightPeakLux;
+    const float airTarget = getRoomTemp(secondOfDay) + p.lampHeatK * static_cast<float>(lamps) + sunHeat;
+    _airTemp = approach(_airTemp, airTarget, fan ? p.fanAirTau : p.airTau, dt);
+    _airTemp += (_soilTemp - _airTemp) * dt / p.soilToAirTau;
+
+    // Boden: große Wärmekapazität, Heizmatte von unten
+    _soilTemp = approach(_soilTemp, _airTemp + (heater ? p.heaterHeatK : 0.0f), p.soilTau, dt);
+
+    // Luftfeuchtigkeit: Raumluft + Verdunstung aus dem Boden, Vernebler hebt sie an
+    const float humidityTarget = p.roomHumidity + p.transpiration * _soilMoisture / 100.0f;
+    _humidity = approach(_humidity, humidityTarget, fan ? p.fanHumidityTau : p.humidityTau, dt);
+    if (mister) {
+        _humidity += p.misterRate * dt;
+        const float used = min(p.misterFlow * dt, _tankMl);
+        _tankMl -= used;
+        _day.misterWaterMl += used;
+    }
+    _humidity = constrain(_humidity, 0.0f, 100.0f);
+
+    // Bodenfeuchte: Austrocknung, gegossenes Wasser versickert verzögert
+    float drying = p.dryingPerDay / static_cast<float>(SECONDS_PER_DAY) * (1.0f + p.dryingPerK * (_airTemp - 20.0f));
+    if (lamps > 0) {
+        drying *= p.dryingLampFactor;
+    }
+    _soilMoisture -= max(drying, 0.0f) * dt;
+    if (pump) {
+        const float pumped = min(p.pumpFlow * dt, _tankMl);
+        _tankMl -= pumped;
+        _pendingMl += pumped;
+        _day.pumpWaterMl += pumped;
+    }
+    const float infiltrated = _pendingMl * (1.0f - expf(-dt / p.infiltrationTau));
+    _pendingMl -= infiltrated;
+    _soilMoisture = constrain(_soilMoisture + infiltrated * p.moisturePerMl, 0.0f, 100.0f);
+
+    // Licht am Sensor
+    _lux = daylight + p.lampLux * static_cast<float>(lamps);
+
+    _elapsed += dt;
+}
+
+void GreenhouseSim::publish() {
+    HostHal& hal = HostHal::instance();
+    hal.setDht(_pins.air, _airTemp, _humidity);
+    hal.setOneWireTemperature(_pins.soilTemp, _soilTempConnected ? _soilTemp : NAN); // NAN = kein Sensor
+    const float adc = static_cast<float>(_params.soilAdcDry) +
+                      static_cast<float>(_params.soilAdcWet - _params.soilAdcDry) * _soilMoisture / 100.0f;
+    hal.setAnalog(_pins.soilMoisture, static_cast<uint16_t>(lroundf(adc)));
+    hal.setInput(_pins.waterLevel, _tankMl > _params.tankSensorLevel ? LOW : HIGH); // LOW = Wasser erkannt
+    _light.setLux(_lux);
+}
+
+void GreenhouseSim::record(const float dt) {
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+        if (isOn(static_cast<Actuator>(i))) {
+            _day.onSeconds[i] += dt;
+        }
+    }
+    if (_tankMl <= _params.tankSensorLevel) {
+        _day.tankEmptySeconds += dt;
+    }
+
+    _day.airTempMin = min(_day.airTempMin, _airTemp);
+    _day.airTempMax = max(_day.airTempMax, _airTemp);
+    _day.soilTempMin = min(_day.soilTempMin, _soilTemp);
+    _day.soilTempMax = max(_day.soilTempMax, _soilTemp);
+    _day.humidityMin = min(_day.humidityMin, _humidity);
+    _day.humidityMax = max(_day.humidityMax, _humidity);
+    _day.soilMoistureMin = min(_day.soilMoistureMin, _soilMoisture);
+    _day.soilMoistureMax = max(_day.soilMoistureMax, _soilMoisture);
+
+    // Abweichungen nur dort, wo der Controller im Automatikbetrieb eingreifen sollte
+    const Settings& s = _settings;
+    if (s.fanMode == MODE_AUTO) {
+        _day.airTempOvershoot = max(_day.airTempOvershoot, _airTemp - s.airTempThresholdHigh);
+    }
+    if (s.heaterMode == MODE_AUTO) {
+        _day.soilTempUndershoot = max(_day.soilTempUndershoot, s.soilTempTarget - _soilTemp);
+        _day.soilTempOvershoot = max(_day.soilTempOvershoot, _soilTemp - (s.soilTempTarget + 0.5f));
+    }
+    if (s.misterMode == MODE_AUTO) {
+        _day.humidityUndershoot = max(_day.humidityUndershoot, s.humidityTarget - _humidity);
+        _day.humidityOvershoot = max(_day.humidityOvershoot, _humidity - (s.humidityTarget + 5.0f));
+    }
+    if (s.pumpMode == MODE_AUTO) {
+        const auto target = static_cast<float>(s.soilMoistureTarget);
+        _day.soilMoistureUndershoot = max(_day.soilMoistureUndershoot, target - _soilMoisture);
+        _day.soilMoistureOvershoot = max(_day.soilMoistureOvershoot, _soilMoisture - target);
+    }
+}
+
+void GreenhouseSim::startDay() {
+    const uint32_t day = static_cast<uint32_t>(_reports.size());
+    _day = DayReport{};
+    _day.day = day;
+    _day.airTempMin = _day.soilTempMin = _day.humidityMin = _day.soilMoistureMin = INFINITY;
+    _day.airTempMax = _day.soilTempMax = _day.humidityMax = _day.soilMoistureMax = -INFINITY;
+
+    const HostHal& hal = HostHal::instance();
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+        _togglesAtDayStart[i] = hal.getToggleCount(_pins.actuators[i]);
+    }
+}
+
+void GreenhouseSim::finishDay() {
+    const HostHal& hal = HostHal::instance();
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+        _day.switches[i] = hal.getToggleCount(_pins.actuators[i]) - _togglesAtDayStart[i];
+    }
+    _reports.push_back(_day);
+}
+
+bool GreenhouseSim::isOn(const Actuator actuator) const {
+    const HostHal& hal = HostHal::instance();
+    const uint8_t pin = _pins.actuators[actuator];
+    return hal.getMode(pin) == OUTPUT && hal.getOutput(pin) == (_pins.relayActiveHigh ? HIGH : LOW);
+}
+
+float GreenhouseSim::getRoomTemp(const double secondOfDay) const {
+    // Sinus mit dem Maximum um 15 Uhr
+    const double phase = (secondOfDay / 3600.0 - 9.0) / 24.0 * 2.0 * PI;
+    return _params.roomTempMean + _params.roomTempSwing * static_cast<float>(sin(phase));
+}
+
+float GreenhouseSim::getDaylight(const double secondOfDay) const {
+    const double hour = secondOfDay / 3600.0;
+    if (hour <= _params.sunriseHour || hour >= _params.sunsetHour) {
+        return 0.0f;
+    }
+    const double phase = (hour - _params.sunriseHour) / (_params.sunsetHour - _params.sunriseHour) * PI;
+    return _params.daylightPeakLux * static_cast<float>(sin(phase));
+}
+
+#endif
@@ -0,0 +1,229 @@
+#pragma once
+
+#if defined(NATIVE)
+
+#include <vector>
+#include "HostHal.h"
+#include "../../include/settings.h"
+
+/**
+ * Physikalisches Modell des Gewächshauses für den nativen Build (Steuerung im Zeitraffer testen).
+ *
+ * Das Modell hängt an der simulierten Hardware von HostHal: Es liest die Relais an ihren Pins und gibt die Messwerte
+ * über die simulierten Sensoren aus (AM2302, DS18B20, Bodenfeuchte-ADC, Füllstand, BH1750). Die echten Sensor- und
+ * Relais-Klassen und der Controller laufen also unverändert dagegen.
+ *
+ * Die Zeit ist die virtuelle Uhr von HostHal: update() rechnet vom letzten Aufruf bis jetzt (in Schritten von höchstens
+ * einer Sekunde), der Aufrufer stellt die Uhr mit delay() oder HostHal::advance() vor. Ein Tag dauert so nur
+ * Bruchteile einer Sekunde.
+ *
+ * Das Modell ist bewusst einfach (je Größe ein Speicher erster Ordnung):
+ * - Luft: strebt gegen Raumtemperatur + Wärme von Lampen und Sonne, mit dem Lüfter viel schneller.
+ * - Boden: hohe Wärmekapazität, strebt gegen Lufttemperatur bzw. mit Heizmatte darüber.
+ * - Luftfeuchtigkeit: strebt gegen Raumluft + Verdunstung aus dem Boden, der Vernebler hebt sie, der Lüfter senkt sie.
+ * - Bodenfeuchte: trocknet abhängig von Temperatur und Licht aus; Wasser der Pumpe versickert verzögert.
+ * - Tageslicht: Sinusbogen zwischen Sonnenauf- und -untergang.
+ * - Wassertank: Pumpe und Vernebler entnehmen Wasser, unterhalb des Sensors meldet S4 "leer".
+ *
+ * Für jeden simulierten Tag entsteht ein DayReport mit Einschaltdauern, Schaltvorgängen, Über-/Unterschwingen
+ * gegenüber den Einstellungen und Wasserverbrauch.
+ */
+class GreenhouseSim {
+public:
+    /**
+     * Aktoren in der Reihenfolge von DayReport::onSeconds und DayReport::switches.
+     */
+    enum Actuator { LAMP1, LAMP2, HEATER, FAN, PUMP, MISTER, ACTUATOR_COUNT };
+
+    /**
+     * Pins der simulierten Hardware (wie in config.h).
+     */
+    struct Pins {
+        uint8_t air = 13;           // AM2302 (S1)
+        uint8_t soilTemp = 4;       // DS18B20 (S2)
+        uint8_t soilMoisture = 34;  // Bodenfeuchte-ADC (S3)
+        uint8_t waterLevel = 35;    // Füllstandsensor (S4)
+        uint8_t lightAddress = 0x23; // I2C-Adresse des BH1750 (S5)
+        uint8_t actuators[ACTUATOR_COUNT] = {14, 27, 26, 25, 33, 32}; // A1 bis A6
+        bool relayActiveHigh = false; // wie Relay (Default: LOW schaltet ein)
+    };
+
+    /**
+     * Physikalische Parameter (Zeitkonstanten in Sekunden).
+     */
+    struct Params {
+        // Raum und Tageslicht
+        float roomTempMean = 20.5f;      // mittlere Raumtemperatur in °C
+        float roomTempSwing = 2.0f;      // Tagesschwankung (± °C, Maximum um 15 Uhr)
+        float roomHumidity = 45.0f;      // Luftfeuchtigkeit im Raum in %
+        int sunriseHour = 7;
+        int sunsetHour = 19;
+        float daylightPeakLux = 2000.0f; // Tageslicht am Mittag
+        float sunHeatK = 6.0f;           // Erwärmung der Luft durch die Sonne am Mittag in K
+
+        // Luft
+        float airTau = 1200.0f;          // Luftaustausch mit dem Raum
+        float fanAirTau = 120.0f;        // ... bei laufendem Lüfter
+        float lampHeatK = 2.0f;          // Erwärmung der Luft je Lampe in K
+        float lampLux = 0.0f;            // Licht einer Lampe am Lichtsensor (0 = Sensor sieht nur Tageslicht)
+
+        // Boden
+        float soilTau = 2400.0f;         // Wärmeaustausch Boden <-> Luft
+        float heaterHeatK = 10.0f;       // Heizmatte: Boden strebt gegen Luft + heaterHeatK
+        float soilToAirTau = 7200.0f;    // Rückwirkung des Bodens auf die Luft
+
+        // Luftfeuchtigkeit
+        float humidityTau = 1800.0f;     // Ausgleich mit dem Raum
+        float fanHumidityTau = 120.0f;   // ... bei laufendem Lüfter
+        float transpiration = 25.0f;     // zusätzliche Feuchte in % bei nassem Boden (100 %)
+        float misterRate = 0.04f;        // Vernebler in %/s
+        float misterFlow = 0.01f;        // Wasserverbrauch des Verneblers in ml/s
+
+        // Bodenfeuchte
+        float dryingPerDay = 12.0f;      // Austrocknung in %/Tag bei 20 °C ohne Licht
+        float dryingPerK = 0.04f;        // schneller je K über 20 °C
+        float dryingLampFactor = 1.2f;   // schneller bei eingeschalteter Lampe
+        float pumpFlow = 25.0f;          // Förderleistung der Pumpe in ml/s
+        float moisturePerMl = 0.04f;     // Bodenfeuchte in % je ml versickertem Wasser
+        float infiltrationTau = 180.0f;  // Versickern des gegossenen Wassers
+
+        // Wassertank
+        float tankCapacity = 4000.0f;    // ml
+        float tankSensorLevel = 400.0f;  // darunter meldet der Füllstandsensor "kein Wasser" (ml)
+
+        // Kalibrierung des Bodenfeuchtesensors (wie SOIL_MOISTURE_ADC_DRY/WET in config.h)
+        int soilAdcDry = 2500;
+        int soilAdcWet = 1100;
+
+        // Startwerte
+        int startHour = 0;
+        float airTemp = 20.0f;
+        float soilTemp = 20.0f;
+        float humidity = 55.0f;
+        float soilMoisture = 55.0f;
+    };
+
+    /**
+     * Momentaner Zustand des Modells.
+     */
+    struct State {
+        float airTemp;      // °C
+        float soilTemp;     // °C
+        float humidity;     // %
+        float soilMoisture; // %
+        float lux;          // am Lichtsensor
+        float tankMl;       // Wasser im Tank
+        float pendingMl;    // gegossen, aber noch nicht versickert
+    };
+
+    /**
+     * Auswertung eines simulierten Tages.
+     */
+    struct DayReport {
+        uint32_t day;                           // 0 = erster Tag
+        float onSeconds[ACTUATOR_COUNT];        // Einschaltdauer in s
+        uint32_t switches[ACTUATOR_COUNT];      // Pegelwechsel am Relais (ein und aus)
+        float pumpWaterMl;                      // von der Pumpe gefördert
+        float misterWaterMl;                    // vom Vernebler verbraucht
+        float airTempMin, airTempMax;
+        float soilTempMin, soilTempMax;
+        float humidityMin, humidityMax;
+        float soilMoistureMin, soilMoistureMax;
+        float airTempOvershoot;                 // max. K über airTempThresholdHigh
+        float soilTempUndershoot;               // max. K unter soilTempTarget
+        float soilTempOvershoot;                // max. K über soilTempTarget + 0,5
+        float humidityUndershoot;               // max. % unter humidityTarget
+        float humidityOvershoot;                // max. % über humidityTarget + 5
+        float soilMoistureUndershoot;           // max. % unter soilMoistureTarget
+        float soilMoistureOvershoot;            // max. % über soilMoistureTarget
+        float tankEmptySeconds;                 // Zeit mit Tank unter dem Sensor
+
+        /** @brief Einschaltdauer als Anteil des Tages (0..1). */
+        float duty(Actuator actuator) const { return onSeconds[actuator] / 86400.0f; }
+
+        /** @brief Gesamter Wasserverbrauch in ml. */
+        float waterMl() const { return pumpWaterMl + misterWaterMl; }
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param settings Einstellungen, gegen die Über-/Unterschwingen gemessen wird (Referenz muss gültig bleiben).
+     * @param params Physikalische Parameter.
+     * @param pins Pins der simulierten Hardware.
+     */
+    GreenhouseSim(const Settings& settings, const Params& params, const Pins& pins);
+
+    /** @brief Konstruktor mit Standard-Pins. */
+    GreenhouseSim(const Settings& settings, const Params& params);
+
+    /** @brief Konstruktor mit Standard-Parametern und -Pins. */
+    explicit GreenhouseSim(const Settings& settings);
+
+    /**
+     * @brief Schließt die simulierten Sensoren an und gibt die Startwerte aus.
+     * Die Relais müssen schon initialisiert sein (Relay::begin()), damit ihr erster Pegel nicht als Schaltvorgang zählt.
+     */
+    void begin();
+
+    /**
+     * @brief Rechnet das Modell bis zur aktuellen virtuellen Zeit weiter und gibt die neuen Messwerte aus.
+     */
+    void update();
+
+    /** @brief Füllt den Wassertank auf. */
+    void refill();
+
+    /** @brief Trennt den Bodentemperatursensor vom Bus oder schließt ihn wieder an (Sensorausfall). */
+    void setSoilTempConnected(bool connected);
+
+    /** @brief Gibt die Stunde (0-23) der simulierten Uhrzeit zurück. */
+    int getHour() const;
+
+    /** @brief Gibt die simulierte Zeit seit begin() in Sekunden zurück. */
+    double getElapsedSeconds() const;
+
+    /** @brief Gibt den momentanen Zustand zurück. */
+    State getState() const;
+
+    /** @brief Gibt die Auswertungen aller abgeschlossenen Tage zurück. */
+    const std::vector<DayReport>& getReports() const;
+
+    /** @brief Gibt eine Auswertung auf Serial aus. */
+    static void printReport(const DayReport& report);
+
+    /** @brief Gibt den Namen eines Aktors zurück (z.B. "lamp1"). */
+    static const char* getName(Actuator actuator);
+
+private:
+    void step(float dt);
+    void publish();
+    void record(float dt);
+    void startDay();
+    void finishDay();
+    bool isOn(Actuator actuator) const;
+    float getRoomTemp(double secondOfDay) const;
+    float getDaylight(double secondOfDay) const;
+
+    const Settings& _settings;
+    Params _params;
+    Pins _pins;
+    SimulatedBH1750 _light;
+
+    float _airTemp;
+    float _soilTemp;
+    float _humidity;
+    float _soilMoisture;
+    float _tankMl;
+    float _pendingMl = 0.0f;
+    float _lux = 0.0f;
+    bool _soilTempConnected = true;
+
+    uint64_t _startUs = 0;
+    uint64_t _lastUs = 0;
+    double _elapsed = 0.0; // simulierte Sekunden seit begin()
+    DayReport _day{};
+    uint32_t _togglesAtDayStart[ACTUATOR_COUNT] = {};
+    std::vector<DayReport> _reports;
+};
+
+#endif
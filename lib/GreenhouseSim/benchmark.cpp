@@ -0,0 +1,46 @@
+/**
+ * Benchmark für die GreenhouseSim-Bibliothek: echte Steuerung im Zeitraffer (nur im nativen Build).
+ *
+ * Simuliert zwei Wochen mit dem Takt des Steuerungs-Tasks (50 ms) und gibt aus, wie viel schneller als Echtzeit das
+ * lief, dazu den Wasserverbrauch und die Auswertung des letzten Tages. Der Tank wird jeden Morgen aufgefüllt, wenn er
+ * weniger als einen Liter enthält.
+ *
+ *   pio run -e sim -t exec
+ */
+
+#include <Arduino.h>
+#include "GreenhouseRig.h"
+
+constexpr uint32_t DAYS = 14;
+constexpr float REFILL_BELOW_ML = 1000.0f;
+
+GreenhouseRig rig;
+
+void setup() {
+    if (!rig.begin()) {
+        Serial.println("Sensoren nicht gefunden");
+        return;
+    }
+
+    GreenhouseRig::RunResult total{0.0, 0.0, 0};
+    for (uint32_t day = 0; day < DAYS; day++) {
+        if (rig.getSim().getState().tankMl < REFILL_BELOW_ML) {
+            rig.getSim().refill();
+        }
+        const GreenhouseRig::RunResult result = rig.runDays(1);
+        total.simulatedSeconds += result.simulatedSeconds;
+        total.wallSeconds += result.wallSeconds;
+        total.cycles += result.cycles;
+    }
+    Serial.printf("%lu Tage (%lu Steuerungszyklen) in %.2f s: %.0f-fache Echtzeit\n", static_cast<unsigned long>(DAYS),
+                  static_cast<unsigned long>(total.cycles), total.wallSeconds, total.speedup());
+
+    float waterMl = 0.0f;
+    for (const GreenhouseSim::DayReport& report : rig.getSim().getReports()) {
+        waterMl += report.waterMl();
+    }
+    Serial.printf("Wasserverbrauch: %.0f ml (%.0f ml pro Tag)\n", waterMl, waterMl / DAYS);
+    GreenhouseSim::printReport(rig.getSim().getReports().back());
+}
+
+void loop() {}
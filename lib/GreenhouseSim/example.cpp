@@ -0,0 +1,32 @@
+/**
+ * Beispiel zur Nutzung der GreenhouseSim-Bibliothek (nur im nativen Build)
+ *
+ * Die echte Steuerung regelt eine Woche lang das simulierte Gewächshaus. Am dritten Tag wird die Bodentemperatur
+ * höher eingestellt, am fünften Tag der Tank aufgefüllt. Für jeden Tag wird eine Auswertung ausgegeben.
+ */
+
+#include <Arduino.h>
+#include "GreenhouseRig.h"
+
+GreenhouseRig rig;
+
+void setup() {
+    Serial.begin(115200);
+    if (!rig.begin()) {
+        Serial.println("Sensoren nicht gefunden");
+        return;
+    }
+
+    for (int day = 0; day < 7; day++) {
+        if (day == 2) {
+            rig.getSettings().soilTempTarget = 26.0f;
+        }
+        if (day == 4) {
+            rig.getSim().refill();
+        }
+        rig.runDays(1);
+        GreenhouseSim::printReport(rig.getSim().getReports().back());
+    }
+}
+
+void loop() {}
@@ -0,0 +1,95 @@
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include "EspHal.h"
+#include <LittleFS.h>
+#include <Wire.h>
+
+Hal& Hal::platform() {
+    return EspHal::instance();
+}
+
+EspHal& EspHal::instance() {
+    static EspHal hal;
+    return hal;
+}
+
+void EspHal::pinMode(const uint8_t pin, const uint8_t mode) {
+    ::pinMode(pin, mode);
+}
+
+void EspHal::digitalWrite(const uint8_t pin, const uint8_t level) {
+    ::digitalWrite(pin, level);
+}
+
+int EspHal::digitalRead(const uint8_t pin) {
+    return ::digitalRead(pin);
+}
+
+uint16_t EspHal::analogRead(const uint8_t pin) {
+    return ::analogRead(pin);
+}
+
+uint32_t EspHal::millis() {
+    return ::millis();
+}
+
+uint32_t EspHal::micros() {
+    return ::micros();
+}
+
+void EspHal::delay(const unsigned long ms) {
+    ::delay(ms);
+}
+
+void EspHal::delayMicroseconds(const unsigned int us) {
+    ::delayMicroseconds(us);
+}
+
+bool EspHal::getLocalTime(tm& info) {
+    return ::getLocalTime(&info, 0); // Timeout 0: nicht bis zu 5 s auf NTP warten
+}
+
+time_t EspHal::time() {
+    return ::time(nullptr);
+}
+
+bool EspHal::i2cWrite(const uint8_t address, const uint8_t* data, const size_t length) {
+    Wire.beginTransmission(address);
+    if (Wire.write(data, length) != length) {
+        Wire.endTransmission();
+        return false;
+    }
+    return Wire.endTransmission() == 0;
+}
+
+size_t EspHal::i2cRead(const uint8_t address, uint8_t* data, const size_t length) {
+    const size_t received = Wire.requestFrom(static_cast<uint16_t>(address), length, true);
+    size_t count = 0;
+    while (count < received && Wire.available()) {
+        data[count++] = static_cast<uint8_t>(Wire.read());
+    }
+    return count;
+}
+
+void EspHal::spiTransfer(const uint8_t csPin, const uint8_t* tx, uint8_t* rx, const size_t length) {
+    SPI.beginTransaction(_spiSettings);
+    ::digitalWrite(csPin, LOW);
+    for (size_t i = 0; i < length; i++) {
+        const uint8_t in = SPI.transfer(tx ? tx[i] : 0xFF);
+        if (rx) {
+            rx[i] = in;
+        }
+    }
+    ::digitalWrite(csPin, HIGH);
+    SPI.endTransaction();
+}
+
+fs::FS& EspHal::fileSystem() {
+    return LittleFS;
+}
+
+void EspHal::setSpiSettings(const SPISettings& settings) {
+    _spiSettings = settings;
+}
+
+#endif
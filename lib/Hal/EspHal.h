@@ -0,0 +1,47 @@
+#pragma once
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <SPI.h>
+#include "Hal.h"
+
+/**
+ * HAL für den ESP32: leitet alle Aufrufe an den Arduino-Core weiter (Wire für I2C, SPI, LittleFS).
+ *
+ * Wire.begin(), SPI.begin() und LittleFS.begin() ruft weiterhin das Hauptprogramm auf, da dort Pins und Optionen
+ * festgelegt werden.
+ */
+class EspHal : public Hal {
+public:
+    /**
+     * @brief Gibt die einzige Instanz zurück.
+     */
+    static EspHal& instance();
+
+    void pinMode(uint8_t pin, uint8_t mode) override;
+    void digitalWrite(uint8_t pin, uint8_t level) override;
+    int digitalRead(uint8_t pin) override;
+    uint16_t analogRead(uint8_t pin) override;
+    uint32_t millis() override;
+    uint32_t micros() override;
+    void delay(unsigned long ms) override;
+    void delayMicroseconds(unsigned int us) override;
+    bool getLocalTime(tm& info) override;
+    time_t time() override;
+    bool i2cWrite(uint8_t address, const uint8_t* data, size_t length) override;
+    size_t i2cRead(uint8_t address, uint8_t* data, size_t length) override;
+    void spiTransfer(uint8_t csPin, const uint8_t* tx, uint8_t* rx, size_t length) override;
+    fs::FS& fileSystem() override;
+
+    /**
+     * @brief Legt Takt und Modus für spiTransfer() fest (Standard: 1 MHz, SPI_MODE0).
+     */
+    void setSpiSettings(const SPISettings& settings);
+
+private:
+    EspHal() = default;
+
+    SPISettings _spiSettings{1000000, MSBFIRST, SPI_MODE0};
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "Hal.h"
+
+Hal* Hal::_active = nullptr;
+
+Hal& Hal::get() {
+    if (!_active) {
+        _active = &platform();
+    }
+    return *_active;
+}
+
+void Hal::set(Hal* hal) {
+    _active = hal ? hal : &platform();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ctime>
+
+/**
+ * Dünne Hardware-Abstraktion (HAL) für GPIO, ADC, Uhr, Wanduhr, I2C, SPI und Dateisystem.
+ *
+ * Die Bibliotheken greifen nicht mehr direkt auf digitalWrite(), analogRead(), millis(), getLocalTime(), Wire oder
+ * LittleFS zu, sondern über Hal::get(). Auf dem ESP32 leitet EspHal alles an den Arduino-Core weiter. Im nativen Build
+ * (env:native) steht dort HostHal: Pins, ADC und I2C-/SPI-Geräte werden simuliert, Uhr und Wanduhr sind virtuell
+ * (delay() wartet nicht, sondern stellt die Uhr vor) und das Dateisystem liegt in einem Verzeichnis des Rechners. So laufen Relais, Sensoren, Einstellungen
+ * und Steuerung samt Tests auch unter Linux, ohne Board und in Sekunden.
+ *
+ * Die Methoden heißen wie die Arduino-Funktionen, damit der Umstieg nur ein "Hal::get()." vor dem Aufruf ist.
+ */
+class Hal {
+public:
+    virtual ~Hal() = default;
+
+    // --- GPIO ---
+
+    /** @brief Wie pinMode() (INPUT, OUTPUT, INPUT_PULLUP, ...). */
+    virtual void pinMode(uint8_t pin, uint8_t mode) = 0;
+
+    /** @brief Wie digitalWrite() (HIGH oder LOW). */
+    virtual void digitalWrite(uint8_t pin, uint8_t level) = 0;
+
+    /** @brief Wie digitalRead(). */
+    virtual int digitalRead(uint8_t pin) = 0;
+
+    // --- ADC ---
+
+    /** @brief Wie analogRead() (0..4095 auf dem ESP32). */
+    virtual uint16_t analogRead(uint8_t pin) = 0;
+
+    // --- Uhr ---
+
+    /**
+     * @brief Wie millis(): Millisekunden seit dem Start.
+     * Läuft nach 2^32 ms (49,7 Tage) über. Zeitstempel daher als uint32_t speichern und nur Differenzen vergleichen
+     * (now - start >= duration); im nativen Build ist unsigned long 64 Bit breit und würde den Überlauf verdecken.
+     */
+    virtual uint32_t millis() = 0;
+
+    /** @brief Wie micros(): Mikrosekunden seit dem Start (Überlauf nach 71,6 Minuten, siehe millis()). */
+    virtual uint32_t micros() = 0;
+
+    /** @brief Wie delay(). */
+    virtual void delay(unsigned long ms) = 0;
+
+    /** @brief Wie delayMicroseconds() (aktives Warten). */
+    virtual void delayMicroseconds(unsigned int us) = 0;
+
+    // --- Wanduhr ---
+
+    /**
+     * @brief Wie getLocalTime(), wartet aber nie auf die Synchronisation.
+     * @param info Ziel für die lokale Zeit.
+     * @return false, solange die Uhrzeit nicht synchronisiert ist (info bleibt dann unverändert).
+     */
+    virtual bool getLocalTime(tm& info) = 0;
+
+    /** @brief Wie time(nullptr): Sekunden seit 1970 (vor der Synchronisation Sekunden seit dem Start). */
+    virtual time_t time() = 0;
+
+    // --- I2C ---
+
+    /**
+     * @brief Sendet Bytes an ein I2C-Gerät.
+     * @param address 7-Bit-Adresse des Geräts.
+     * @return true, wenn das Gerät alle Bytes bestätigt hat.
+     */
+    virtual bool i2cWrite(uint8_t address, const uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Liest Bytes von einem I2C-Gerät.
+     * @param address 7-Bit-Adresse des Geräts.
+     * @return Anzahl der gelesenen Bytes (0, wenn das Gerät nicht antwortet).
+     */
+    virtual size_t i2cRead(uint8_t address, uint8_t* data, size_t length) = 0;
+
+    // --- SPI ---
+
+    /**
+     * @brief Überträgt Bytes an ein SPI-Gerät und liest gleichzeitig seine Antwort (CS wird dafür auf LOW gezogen).
+     * Den Bus muss der Aufrufer vorher holen (SpiBusArbiter).
+     * @param csPin Chip-Select des Geräts.
+     * @param tx Zu sendende Bytes (nullptr = 0xFF senden).
+     * @param rx Ziel für die empfangenen Bytes (nullptr = verwerfen).
+     */
+    virtual void spiTransfer(uint8_t csPin, const uint8_t* tx, uint8_t* rx, size_t length) = 0;
+
+    // --- Dateisystem ---
+
+    /** @brief Das interne Dateisystem (LittleFS auf dem ESP32, ein Verzeichnis auf dem Rechner). */
+    virtual fs::FS& fileSystem() = 0;
+
+    /**
+     * @brief Gibt die aktive HAL zurück (ohne set() die der Plattform).
+     */
+    static Hal& get();
+
+    /**
+     * @brief Ersetzt die aktive HAL (z.B. durch eine Simulation oder für Fehlerinjektion in Tests).
+     * @param hal Die neue HAL (nullptr = wieder die der Plattform).
+     */
+    static void set(Hal* hal);
+
+private:
+    /**
+     * @brief Gibt die HAL der Plattform zurück (EspHal bzw. HostHal).
+     */
+    static Hal& platform();
+
+    static Hal* _active;
+};
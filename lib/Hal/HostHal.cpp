@@ -0,0 +1,265 @@
+#if defined(NATIVE)
+
+#include "HostHal.h"
+#include <LittleFS.h>
+
+namespace {
+constexpr int DHT_TIMEOUT = 0x10; // SimpleDHTErrStartLow: kein Sensor antwortet
+constexpr float BH1750_FACTOR = 1.2f;
+}
+
+Hal& Hal::platform() {
+    return HostHal::instance();
+}
+
+HostHal& HostHal::instance() {
+    static HostHal hal;
+    return hal;
+}
+
+HostHal::HostHal() = default;
+
+void HostHal::pinMode(const uint8_t pin, const uint8_t mode) {
+    if (valid(pin)) {
+        _pins[pin].mode = mode;
+    }
+}
+
+void HostHal::digitalWrite(const uint8_t pin, const uint8_t level) {
+    if (!valid(pin)) {
+        return;
+    }
+    Pin& p = _pins[pin];
+    const uint8_t value = level ? HIGH : LOW;
+    if (p.output != value) {
+        p.toggles++;
+    }
+    p.output = value;
+}
+
+int HostHal::digitalRead(const uint8_t pin) {
+    if (!valid(pin)) {
+        return LOW;
+    }
+    const Pin& p = _pins[pin];
+    if (p.mode == OUTPUT) {
+        return p.output;
+    }
+    if (p.inputSet) {
+        return p.input;
+    }
+    return p.mode == INPUT_PULLUP ? HIGH : LOW;
+}
+
+uint16_t HostHal::analogRead(const uint8_t pin) {
+    return valid(pin) ? _pins[pin].analog : 0;
+}
+
+uint32_t HostHal::millis() {
+    // Wie auf dem ESP32 nach 2^32 ms (49,7 Tage) übergelaufen
+    return static_cast<uint32_t>(_timeUs / 1000);
+}
+
+uint32_t HostHal::micros() {
+    return static_cast<uint32_t>(_timeUs);
+}
+
+void HostHal::delay(const unsigned long ms) {
+    advance(static_cast<uint64_t>(ms) * 1000);
+}
+
+void HostHal::delayMicroseconds(const unsigned int us) {
+    advance(us);
+}
+
+bool HostHal::getLocalTime(tm& info) {
+    if (!_wallClockSet) {
+        return false;
+    }
+    const time_t now = time();
+    return gmtime_r(&now, &info) != nullptr;
+}
+
+time_t HostHal::time() {
+    const auto uptime = static_cast<time_t>(_timeUs / 1000000);
+    return _wallClockSet ? _wallClockBase + uptime : uptime;
+}
+
+bool HostHal::i2cWrite(const uint8_t address, const uint8_t* data, const size_t length) {
+    I2cDevice* device = address < 128 ? _i2c[address] : nullptr;
+    return device && device->write(data, length);
+}
+
+size_t HostHal::i2cRead(const uint8_t address, uint8_t* data, const size_t length) {
+    I2cDevice* device = address < 128 ? _i2c[address] : nullptr;
+    return device ? device->read(data, length) : 0;
+}
+
+void HostHal::spiTransfer(const uint8_t csPin, const uint8_t* tx, uint8_t* rx, const size_t length) {
+    SpiDevice* device = valid(csPin) ? _spi[csPin] : nullptr;
+    if (device) {
+        device->transfer(tx, rx, length);
+    } else if (rx) {
+        memset(rx, 0xFF, length); // niemand treibt MISO
+    }
+}
+
+fs::FS& HostHal::fileSystem() {
+    return LittleFS;
+}
+
+void HostHal::reset() {
+    for (Pin& pin : _pins) {
+        pin = Pin();
+    }
+    for (I2cDevice*& device : _i2c) {
+        device = nullptr;
+    }
+    for (SpiDevice*& device : _spi) {
+        device = nullptr;
+    }
+    _timeUs = 0;
+    _wallClockSet = false;
+    _wallClockBase = 0;
+}
+
+void HostHal::advance(const uint64_t us) {
+    _timeUs += us;
+}
+
+void HostHal::setUptime(const uint64_t us) {
+    _timeUs = us;
+}
+
+void HostHal::setWallClock(const time_t epoch) {
+    _wallClockSet = true;
+    _wallClockBase = epoch - static_cast<time_t>(_timeUs / 1000000);
+}
+
+void HostHal::clearWallClock() {
+    _wallClockSet = false;
+    _wallClockBase = 0;
+}
+
+uint64_t HostHal::getTimeUs() const {
+    return _timeUs;
+}
+
+uint8_t HostHal::getOutput(const uint8_t pin) const {
+    return valid(pin) ? _pins[pin].output : LOW;
+}
+
+uint8_t HostHal::getMode(const uint8_t pin) const {
+    return valid(pin) ? _pins[pin].mode : 0;
+}
+
+uint32_t HostHal::getToggleCount(const uint8_t pin) const {
+    return valid(pin) ? _pins[pin].toggles : 0;
+}
+
+void HostHal::setInput(const uint8_t pin, const uint8_t level) {
+    if (valid(pin)) {
+        _pins[pin].input = level ? HIGH : LOW;
+        _pins[pin].inputSet = true;
+    }
+}
+
+void HostHal::setAnalog(const uint8_t pin, const uint16_t value) {
+    if (valid(pin)) {
+        _pins[pin].analog = value;
+    }
+}
+
+void HostHal::attachI2c(const uint8_t address, I2cDevice* device) {
+    if (address < 128) {
+        _i2c[address] = device;
+    }
+}
+
+void HostHal::attachSpi(const uint8_t csPin, SpiDevice* device) {
+    if (valid(csPin)) {
+        _spi[csPin] = device;
+    }
+}
+
+void HostHal::setDht(const uint8_t pin, const float temperature, const float humidity, const int error) {
+    if (valid(pin)) {
+        _pins[pin].dht = true;
+        _pins[pin].temperature = temperature;
+        _pins[pin].humidity = humidity;
+        _pins[pin].dhtError = error;
+    }
+}
+
+void HostHal::setOneWireTemperature(const uint8_t pin, const float temperature) {
+    if (valid(pin)) {
+        _pins[pin].dht = false;
+        _pins[pin].temperature = temperature;
+    }
+}
+
+int HostHal::readDht(const uint8_t pin, float& temperature, float& humidity) const {
+    if (!valid(pin) || !_pins[pin].dht) {
+        return DHT_TIMEOUT;
+    }
+    const Pin& p = _pins[pin];
+    if (p.dhtError == 0) {
+        temperature = p.temperature;
+        humidity = p.humidity;
+    }
+    return p.dhtError;
+}
+
+float HostHal::readOneWireTemperature(const uint8_t pin) const {
+    return valid(pin) && !_pins[pin].dht ? _pins[pin].temperature : NAN;
+}
+
+void HostHal::setFileSystemRoot(const std::string& root) {
+    LittleFS.setRoot(root);
+}
+
+bool HostHal::valid(const uint8_t pin) {
+    return pin < PIN_COUNT;
+}
+
+void SimulatedBH1750::setLux(const float lux) {
+    _lux = lux;
+}
+
+uint8_t SimulatedBH1750::getMode() const {
+    return _mode;
+}
+
+bool SimulatedBH1750::write(const uint8_t* data, const size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        const uint8_t command = data[i];
+        if (command == 0x00) {
+            _powered = false; // Power Down
+        } else if (command == 0x01) {
+            _powered = true; // Power On
+        } else if (command == 0x07) {
+            // Reset: nur der Messwert, der Modus bleibt
+        } else if ((command & 0xF0) == 0x10 || (command & 0xF0) == 0x20) {
+            _mode = command;
+            _powered = true;
+        } else {
+            return false; // unbekannter Befehl
+        }
+    }
+    return true;
+}
+
+size_t SimulatedBH1750::read(uint8_t* data, const size_t length) {
+    if (!_powered || _mode == 0) {
+        return 0;
+    }
+    // Hohe Auflösung 2 zählt in halben Lux
+    const float counts = _lux * BH1750_FACTOR * ((_mode & 0x0F) == 0x01 ? 2.0f : 1.0f);
+    const auto raw = static_cast<uint16_t>(constrain(counts, 0.0f, 65535.0f));
+    const uint8_t bytes[2] = {static_cast<uint8_t>(raw >> 8), static_cast<uint8_t>(raw & 0xFF)};
+    const size_t count = min<size_t>(length, sizeof(bytes));
+    memcpy(data, bytes, count);
+    return count;
+}
+
+#endif
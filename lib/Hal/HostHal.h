@@ -0,0 +1,200 @@
+#pragma once
+
+#if defined(NATIVE)
+
+#include <cmath>
+#include <string>
+#include "Hal.h"
+
+/**
+ * HAL für den nativen Build (env:native): simuliert das Board auf dem Rechner.
+ *
+ * - GPIO: Ausgänge merken sich ihren Pegel (getOutput()), Eingänge liefern, was mit setInput() vorgegeben wurde.
+ *   Ohne Vorgabe liest ein Eingang mit Pull-Up HIGH, sonst LOW.
+ * - ADC: liefert, was mit setAnalog() vorgegeben wurde (sonst 0, wie ein offener Pin).
+ * - Uhr: virtuell, beginnt bei 0 und läuft nur mit delay(), delayMicroseconds() oder advance(). Tests laufen damit
+ *   deterministisch und ohne zu warten; ein Tag ist in Mikrosekunden vorbei. setUptime() springt z.B. direkt vor den
+ *   Überlauf von millis().
+ * - Wanduhr: unsynchronisiert, bis setWallClock() sie stellt; danach läuft sie mit der virtuellen Uhr (in UTC).
+ * - I2C und SPI: Geräte werden mit attachI2c() bzw. attachSpi() angeschlossen (z.B. SimulatedBH1750).
+ * - AM2302 (SimpleDHT) und DS18B20 (DallasTemperature) werden nicht auf Bit-Ebene simuliert; ihre Ersatz-Treiber im
+ *   Verzeichnis native/ lesen die Werte aus setDht() bzw. setOneWireTemperature().
+ * - Dateisystem: LittleFS liegt im Verzeichnis aus setFileSystemRoot() (Standard: $TMPDIR/biodom-littlefs).
+ */
+class HostHal : public Hal {
+public:
+    static constexpr uint8_t PIN_COUNT = 64;
+
+    /**
+     * @brief Ein simuliertes I2C-Gerät.
+     */
+    class I2cDevice {
+    public:
+        virtual ~I2cDevice() = default;
+
+        /** @brief Empfängt Bytes vom Controller. @return false = NACK. */
+        virtual bool write(const uint8_t* data, size_t length) = 0;
+
+        /** @brief Liefert Bytes an den Controller. @return Anzahl der gelieferten Bytes. */
+        virtual size_t read(uint8_t* data, size_t length) = 0;
+    };
+
+    /**
+     * @brief Ein simuliertes SPI-Gerät.
+     */
+    class SpiDevice {
+    public:
+        virtual ~SpiDevice() = default;
+
+        /** @brief Eine Übertragung bei gezogenem CS (tx bzw. rx können nullptr sein). */
+        virtual void transfer(const uint8_t* tx, uint8_t* rx, size_t length) = 0;
+    };
+
+    /**
+     * @brief Gibt die einzige Instanz zurück.
+     */
+    static HostHal& instance();
+
+    void pinMode(uint8_t pin, uint8_t mode) override;
+    void digitalWrite(uint8_t pin, uint8_t level) override;
+    int digitalRead(uint8_t pin) override;
+    uint16_t analogRead(uint8_t pin) override;
+    uint32_t millis() override;
+    uint32_t micros() override;
+    void delay(unsigned long ms) override;
+    void delayMicroseconds(unsigned int us) override;
+    bool getLocalTime(tm& info) override;
+    time_t time() override;
+    bool i2cWrite(uint8_t address, const uint8_t* data, size_t length) override;
+    size_t i2cRead(uint8_t address, uint8_t* data, size_t length) override;
+    void spiTransfer(uint8_t csPin, const uint8_t* tx, uint8_t* rx, size_t length) override;
+    fs::FS& fileSystem() override;
+
+    // --- Simulation ---
+
+    /**
+     * @brief Setzt alle Pins, Geräte und die Uhr zurück (das Dateisystem bleibt).
+     */
+    void reset();
+
+    /** @brief Stellt die virtuelle Uhr um so viele µs vor (die Wanduhr läuft mit). */
+    void advance(uint64_t us);
+
+    /**
+     * @brief Setzt die Zeit seit dem Start, z.B. kurz vor den Überlauf von millis() (2^32 ms).
+     * Die Wanduhr springt dabei mit.
+     */
+    void setUptime(uint64_t us);
+
+    /**
+     * @brief Stellt die Wanduhr (wie eine NTP-Synchronisation). Danach liefert getLocalTime() die Zeit in UTC.
+     * @param epoch Sekunden seit 1970 zum aktuellen Zeitpunkt der virtuellen Uhr.
+     */
+    void setWallClock(time_t epoch);
+
+    /** @brief Macht die Wanduhr wieder unsynchronisiert (getLocalTime() liefert false). */
+    void clearWallClock();
+
+    /** @brief Gibt die virtuelle Zeit in µs zurück (ohne Überlauf). */
+    uint64_t getTimeUs() const;
+
+    /** @brief Gibt den zuletzt geschriebenen Pegel eines Ausgangs zurück. */
+    uint8_t getOutput(uint8_t pin) const;
+
+    /** @brief Gibt den mit pinMode() gesetzten Modus zurück (0 = nie gesetzt). */
+    uint8_t getMode(uint8_t pin) const;
+
+    /** @brief Gibt an, wie oft ein Ausgang seinen Pegel gewechselt hat. */
+    uint32_t getToggleCount(uint8_t pin) const;
+
+    /** @brief Gibt den Pegel eines Eingangs vor. */
+    void setInput(uint8_t pin, uint8_t level);
+
+    /** @brief Gibt den Messwert eines ADC-Pins vor. */
+    void setAnalog(uint8_t pin, uint16_t value);
+
+    /**
+     * @brief Schließt ein I2C-Gerät an (nullptr = entfernen).
+     * Das Gerät muss so lange leben, wie es angeschlossen ist.
+     */
+    void attachI2c(uint8_t address, I2cDevice* device);
+
+    /**
+     * @brief Schließt ein SPI-Gerät an einem Chip-Select an (nullptr = entfernen).
+     */
+    void attachSpi(uint8_t csPin, SpiDevice* device);
+
+    /**
+     * @brief Simuliert einen AM2302 (DHT22) an einem Pin.
+     * @param error Fehlercode, den SimpleDHT liefern soll (0 = Erfolg).
+     */
+    void setDht(uint8_t pin, float temperature, float humidity, int error = 0);
+
+    /**
+     * @brief Simuliert einen DS18B20 an einem 1-Wire-Pin (NAN = kein Sensor angeschlossen).
+     */
+    void setOneWireTemperature(uint8_t pin, float temperature);
+
+    /**
+     * @brief Gibt die Werte eines simulierten AM2302 zurück (für den Ersatz-Treiber).
+     * @return Fehlercode (0 = Erfolg; ohne setDht() der Code für "Timeout").
+     */
+    int readDht(uint8_t pin, float& temperature, float& humidity) const;
+
+    /**
+     * @brief Gibt die Temperatur eines simulierten DS18B20 zurück (für den Ersatz-Treiber, NAN = keiner).
+     */
+    float readOneWireTemperature(uint8_t pin) const;
+
+    /**
+     * @brief Legt das Verzeichnis fest, in dem das simulierte LittleFS liegt (wird bei Bedarf angelegt).
+     */
+    void setFileSystemRoot(const std::string& root);
+
+private:
+    HostHal();
+
+    struct Pin {
+        uint8_t mode = 0;
+        uint8_t output = 0;
+        uint8_t input = 0;
+        bool inputSet = false;
+        uint16_t analog = 0;
+        uint32_t toggles = 0;
+        bool dht = false;
+        int dhtError = 0;
+        float temperature = NAN; // AM2302 bzw. DS18B20
+        float humidity = NAN;
+    };
+
+    static bool valid(uint8_t pin);
+
+    Pin _pins[PIN_COUNT];
+    I2cDevice* _i2c[128] = {};
+    SpiDevice* _spi[PIN_COUNT] = {};
+    uint64_t _timeUs = 0;
+    bool _wallClockSet = false;
+    time_t _wallClockBase = 0; // Wanduhr = _wallClockBase + Sekunden seit dem Start
+};
+
+/**
+ * Simulierter Lichtsensor BH1750 am I2C-Bus (Befehle wie im Datenblatt, Messwert = Lux * 1,2).
+ */
+class SimulatedBH1750 : public HostHal::I2cDevice {
+public:
+    /** @brief Setzt die Beleuchtungsstärke, die der Sensor misst. */
+    void setLux(float lux);
+
+    /** @brief Gibt den zuletzt gesetzten Messmodus zurück (0 = keiner). */
+    uint8_t getMode() const;
+
+    bool write(const uint8_t* data, size_t length) override;
+    size_t read(uint8_t* data, size_t length) override;
+
+private:
+    float _lux = 0.0f;
+    uint8_t _mode = 0;
+    bool _powered = false;
+};
+
+#endif
@@ -0,0 +1,210 @@
+#if defined(NATIVE)
+
+#include "Arduino.h"
+#include <cctype>
+#include "Hal.h"
+
+HardwareSerial Serial;
+
+uint32_t millis() {
+    return Hal::get().millis();
+}
+
+uint32_t micros() {
+    return Hal::get().micros();
+}
+
+void delay(const unsigned long ms) {
+    Hal::get().delay(ms);
+}
+
+void delayMicroseconds(const unsigned int us) {
+    Hal::get().delayMicroseconds(us);
+}
+
+void yield() {}
+
+long map(const long x, const long inMin, const long inMax, const long outMin, const long outMax) {
+    const long run = inMax - inMin;
+    if (run == 0) {
+        return outMin;
+    }
+    return (x - inMin) * (outMax - outMin) / run + outMin;
+}
+
+long random(const long max) {
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(const long min, const long max) {
+    return min < max ? min + random(max - min) : min;
+}
+
+#if !defined(__GLIBC__) || __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+size_t strlcpy(char* dst, const char* src, const size_t size) {
+    const size_t length = strlen(src);
+    if (size > 0) {
+        const size_t count = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, count);
+        dst[count] = '\0';
+    }
+    return length;
+}
+#endif
+
+// --- String ---
+
+namespace {
+std::string toText(unsigned long long value, const unsigned char base, const bool negative) {
+    if (base < 2 || base > 36) {
+        return "";
+    }
+    char buffer[72];
+    char* p = buffer + sizeof(buffer);
+    *--p = '\0';
+    do {
+        const unsigned digit = value % base;
+        *--p = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    if (negative) {
+        *--p = '-';
+    }
+    return p;
+}
+
+std::string toText(const long long value, const unsigned char base) {
+    const bool negative = value < 0 && base == 10;
+    const auto magnitude = negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+    return toText(magnitude, base, negative);
+}
+
+std::string toText(const double value, const unsigned int decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), value);
+    return buffer;
+}
+}
+
+String::String(const int value, const unsigned char base) : _text(toText(static_cast<long long>(value), base)) {}
+String::String(const unsigned int value, const unsigned char base) : _text(toText(static_cast<unsigned long long>(value), base, false)) {}
+String::String(const long value, const unsigned char base) : _text(toText(static_cast<long long>(value), base)) {}
+String::String(const unsigned long value, const unsigned char base) : _text(toText(static_cast<unsigned long long>(value), base, false)) {}
+String::String(const long long value) : _text(toText(value, 10)) {}
+String::String(const unsigned long long value) : _text(toText(value, 10, false)) {}
+String::String(const float value, const unsigned int decimals) : _text(toText(static_cast<double>(value), decimals)) {}
+String::String(const double value, const unsigned int decimals) : _text(toText(value, decimals)) {}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    return _text.size() == other._text.size() && strcasecmp(_text.c_str(), other._text.c_str()) == 0;
+}
+
+int String::indexOf(const char c, const unsigned int from) const {
+    const size_t position = _text.find(c, from);
+    return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+int String::indexOf(const String& text, const unsigned int from) const {
+    const size_t position = _text.find(text._text, from);
+    return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+int String::lastIndexOf(const char c) const {
+    const size_t position = _text.rfind(c);
+    return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+bool String::startsWith(const String& prefix) const {
+    return _text.compare(0, prefix._text.size(), prefix._text) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return _text.size() >= suffix._text.size() &&
+           _text.compare(_text.size() - suffix._text.size(), suffix._text.size(), suffix._text) == 0;
+}
+
+String String::substring(const unsigned int from) const {
+    return from < _text.size() ? String(_text.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        std::swap(from, to);
+    }
+    if (from >= _text.size()) {
+        return String();
+    }
+    return String(_text.substr(from, to - from));
+}
+
+void String::trim() {
+    const size_t first = _text.find_first_not_of(" \t\r\n");
+    const size_t last = _text.find_last_not_of(" \t\r\n");
+    _text = first == std::string::npos ? "" : _text.substr(first, last - first + 1);
+}
+
+void String::toLowerCase() {
+    for (char& c : _text) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+void String::toUpperCase() {
+    for (char& c : _text) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+}
+
+String operator+(const String& left, const String& right) {
+    String result(left);
+    result += right;
+    return result;
+}
+
+String operator+(const String& left, const char* right) {
+    String result(left);
+    result += right;
+    return result;
+}
+
+String operator+(const char* left, const String& right) {
+    String result(left);
+    result += right;
+    return result;
+}
+
+// --- Serial ---
+
+size_t HardwareSerial::write(const uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, const size_t length) {
+    return fwrite(data, 1, length, stdout);
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const int written = vprintf(format, args);
+    va_end(args);
+    return written > 0 ? static_cast<size_t>(written) : 0;
+}
+
+size_t HardwareSerial::print(const char* text) {
+    return text ? fputs(text, stdout) >= 0 ? strlen(text) : 0 : 0;
+}
+
+size_t HardwareSerial::print(const long value, const int base) {
+    return print(String(value, static_cast<unsigned char>(base)));
+}
+
+size_t HardwareSerial::print(const unsigned long value, const int base) {
+    return print(String(value, static_cast<unsigned char>(base)));
+}
+
+size_t HardwareSerial::print(const double value, const int decimals) {
+    return print(String(value, static_cast<unsigned int>(decimals)));
+}
+
+#endif
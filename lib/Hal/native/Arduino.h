@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * Ersatz für den Arduino-Core im nativen Build (env:native, nur mit -Ilib/Hal/native eingebunden).
+ *
+ * Enthält nur, was die Bibliotheken außer der Hardware brauchen: Typen, Konstanten, String, Serial (auf stdout) und
+ * die Zeitfunktionen (über Hal::get(), also die virtuelle Uhr von HostHal). digitalWrite(), analogRead() & Co. gibt es
+ * hier absichtlich nicht, Hardwarezugriffe laufen über Hal.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <math.h>
+#include <string>
+
+using std::max;
+using std::min;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+// Pin-Modi wie im ESP32-Core
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(string) (string)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// 32 Bit wie auf dem ESP32 (dort ist unsigned long 32 Bit breit), damit "millis() - start" genauso überläuft
+uint32_t millis();
+uint32_t micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+long random(long max);
+long random(long min, long max);
+
+#if !defined(__GLIBC__) || __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+/**
+ * Teilmenge der Arduino-Klasse String (auf std::string).
+ */
+class String {
+public:
+    String() = default;
+    String(const char* text) : _text(text ? text : "") {}
+    String(const std::string& text) : _text(text) {}
+    String(char c) : _text(1, c) {}
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value);
+    explicit String(unsigned long long value);
+    explicit String(float value, unsigned int decimals = 2);
+    explicit String(double value, unsigned int decimals = 2);
+
+    const char* c_str() const { return _text.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(_text.length()); }
+    bool isEmpty() const { return _text.empty(); }
+    char operator[](unsigned int index) const { return index < _text.length() ? _text[index] : '\0'; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    String& operator+=(const String& other) { _text += other._text; return *this; }
+    String& operator+=(const char* other) { _text += other ? other : ""; return *this; }
+    String& operator+=(char c) { _text += c; return *this; }
+    bool concat(const String& other) { _text += other._text; return true; }
+    bool reserve(unsigned int size) { _text.reserve(size); return true; }
+
+    bool operator==(const String& other) const { return _text == other._text; }
+    bool operator==(const char* other) const { return _text == (other ? other : ""); }
+    bool operator!=(const String& other) const { return !(*this == other); }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return _text < other._text; }
+    bool equals(const String& other) const { return *this == other; }
+    bool equalsIgnoreCase(const String& other) const;
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& text, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    long toInt() const { return strtol(_text.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(_text.c_str(), nullptr); }
+
+private:
+    std::string _text;
+};
+
+String operator+(const String& left, const String& right);
+String operator+(const String& left, const char* right);
+String operator+(const char* left, const String& right);
+
+/**
+ * Serielle Schnittstelle: Ausgaben gehen nach stdout, gelesen wird nichts.
+ */
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    void end() {}
+    void flush() { fflush(stdout); }
+    int available() { return 0; }
+    int read() { return -1; }
+    explicit operator bool() const { return true; }
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* data, size_t length);
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const char* text);
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int value, int base = 10) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned int value, int base = 10) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(double value, int decimals = 2);
+
+    size_t println() { return print("\n"); }
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { return print(value, format) + println(); }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * Wird im nativen Build wie auf dem Board einmal aufgerufen (siehe main.cpp im selben Verzeichnis).
+ */
+void setup();
+void loop();
@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * Ersatz für DallasTemperature im nativen Build: ein DS18B20 je Pin, dessen Temperatur mit
+ * HostHal::setOneWireTemperature() vorgegeben wird (NAN = kein Sensor). Die Temperatur wird wie vom Sensor auf die
+ * eingestellte Auflösung gerundet.
+ *
+ * Wie beim echten Sensor übernimmt das Scratchpad den neuen Wert erst nach millisToWaitForConversion() ab
+ * requestTemperaturesByAddress(); wer früher liest, bekommt den alten Wert (nach dem Einschalten 85 °C).
+ */
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature {
+public:
+    explicit DallasTemperature(OneWire* oneWire) : _oneWire(oneWire) {}
+
+    void begin() {}
+    uint8_t getDeviceCount();
+    bool getAddress(uint8_t* address, uint8_t index);
+    bool validAddress(const uint8_t* address);
+    bool setResolution(const uint8_t* address, uint8_t bits, bool skipGlobalBitResolutionCalculation = false);
+    void setWaitForConversion(bool wait) { _wait = wait; }
+    bool requestTemperaturesByAddress(const uint8_t* address);
+    float getTempC(const uint8_t* address);
+    int16_t millisToWaitForConversion(uint8_t bitResolution) const;
+
+private:
+    bool connected() const;
+
+    OneWire* _oneWire;
+    uint8_t _resolution = 12;
+    bool _wait = true;
+    float _scratchpad = 85.0f;  // Einschaltwert des DS18B20
+    bool _pending = false;      // Wandlung angefordert, Scratchpad noch nicht aktualisiert
+    uint32_t _requestedAt = 0;  // millis() der Anforderung
+};
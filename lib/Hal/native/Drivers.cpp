@@ -0,0 +1,93 @@
+#if defined(NATIVE)
+
+#include "DallasTemperature.h"
+#include "SimpleDHT.h"
+#include "Wire.h"
+#include "HostHal.h"
+
+namespace {
+// ROM-Code des simulierten DS18B20 (Family-Code 0x28, CRC passt)
+constexpr uint8_t DS18B20_ADDRESS[8] = {0x28, 0xFF, 0x64, 0x1E, 0x0F, 0x00, 0x00, 0x6B};
+}
+
+TwoWire Wire;
+
+int SimpleDHT22::read2(float* temperature, float* humidity, uint8_t data[40]) {
+    if (data) {
+        return SimpleDHTErrDataRead; // Rohdaten werden nicht simuliert
+    }
+    float t = NAN;
+    float h = NAN;
+    const int error = HostHal::instance().readDht(static_cast<uint8_t>(_pin), t, h);
+    if (error == SimpleDHTErrSuccess) {
+        if (temperature) {
+            *temperature = t;
+        }
+        if (humidity) {
+            *humidity = h;
+        }
+    }
+    return error;
+}
+
+uint8_t DallasTemperature::getDeviceCount() {
+    return connected() ? 1 : 0;
+}
+
+bool DallasTemperature::getAddress(uint8_t* address, const uint8_t index) {
+    if (index != 0 || !connected()) {
+        return false;
+    }
+    memcpy(address, DS18B20_ADDRESS, sizeof(DS18B20_ADDRESS));
+    return true;
+}
+
+bool DallasTemperature::validAddress(const uint8_t* address) {
+    return memcmp(address, DS18B20_ADDRESS, sizeof(DS18B20_ADDRESS)) == 0;
+}
+
+bool DallasTemperature::setResolution(const uint8_t*, const uint8_t bits, bool) {
+    _resolution = constrain(bits, 9, 12);
+    return connected();
+}
+
+bool DallasTemperature::requestTemperaturesByAddress(const uint8_t*) {
+    if (!connected()) {
+        return false;
+    }
+    _pending = true;
+    _requestedAt = millis();
+    if (_wait) {
+        delay(millisToWaitForConversion(_resolution)); // wie die Bibliothek: auf das Ende der Wandlung warten
+    }
+    return true;
+}
+
+float DallasTemperature::getTempC(const uint8_t*) {
+    const float temperature = HostHal::instance().readOneWireTemperature(_oneWire->getPin());
+    if (isnan(temperature)) {
+        return DEVICE_DISCONNECTED_C;
+    }
+    // Erst nach Ende der Wandlung steht der neue Wert im Scratchpad
+    if (_pending && millis() - _requestedAt >= static_cast<uint32_t>(millisToWaitForConversion(_resolution))) {
+        const float step = 0.5f / static_cast<float>(1 << (_resolution - 9)); // 0,5 °C bei 9 Bit, 0,0625 °C bei 12 Bit
+        _scratchpad = roundf(temperature / step) * step;
+        _pending = false;
+    }
+    return _scratchpad;
+}
+
+int16_t DallasTemperature::millisToWaitForConversion(const uint8_t bitResolution) const {
+    switch (bitResolution) {
+        case 9: return 94;
+        case 10: return 188;
+        case 11: return 375;
+        default: return 750;
+    }
+}
+
+bool DallasTemperature::connected() const {
+    return !isnan(HostHal::instance().readOneWireTemperature(_oneWire->getPin()));
+}
+
+#endif
@@ -0,0 +1,246 @@
+#if defined(NATIVE)
+
+#include "FS.h"
+#include <filesystem>
+#include <sys/stat.h>
+
+namespace stdfs = std::filesystem;
+
+namespace fs {
+
+struct File::Handle {
+    FILE* file = nullptr;
+    std::string path;     // Pfad auf dem Board ("/config.json")
+    std::string hostPath; // Pfad auf dem Rechner
+    bool directory = false;
+    std::vector<std::string> children; // Einträge eines Verzeichnisses (Pfade auf dem Board)
+    size_t nextChild = 0;
+    const FS* fs = nullptr;
+
+    ~Handle() {
+        if (file) {
+            fclose(file);
+        }
+    }
+};
+
+size_t File::write(const uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* data, const size_t length) {
+    return _handle && _handle->file ? fwrite(data, 1, length, _handle->file) : 0;
+}
+
+int File::available() {
+    if (!_handle || !_handle->file) {
+        return 0;
+    }
+    const size_t current = position();
+    const size_t total = size();
+    return total > current ? static_cast<int>(total - current) : 0;
+}
+
+int File::read() {
+    uint8_t c = 0;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if (!_handle || !_handle->file) {
+        return -1;
+    }
+    const int c = fgetc(_handle->file);
+    if (c != EOF) {
+        ungetc(c, _handle->file);
+    }
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t* data, const size_t length) {
+    return _handle && _handle->file ? fread(data, 1, length, _handle->file) : 0;
+}
+
+size_t File::readBytes(char* data, const size_t length) {
+    return read(reinterpret_cast<uint8_t*>(data), length);
+}
+
+void File::flush() {
+    if (_handle && _handle->file) {
+        fflush(_handle->file);
+    }
+}
+
+bool File::seek(const uint32_t position, const SeekMode mode) {
+    static constexpr int WHENCE[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return _handle && _handle->file && fseek(_handle->file, position, WHENCE[mode]) == 0;
+}
+
+size_t File::position() const {
+    if (!_handle || !_handle->file) {
+        return 0;
+    }
+    const long current = ftell(_handle->file);
+    return current > 0 ? static_cast<size_t>(current) : 0;
+}
+
+size_t File::size() const {
+    if (!_handle || !_handle->file) {
+        return 0;
+    }
+    fflush(_handle->file);
+    struct stat info {};
+    return fstat(fileno(_handle->file), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+void File::close() {
+    _handle.reset();
+}
+
+File::operator bool() const {
+    return _handle && (_handle->file || _handle->directory);
+}
+
+time_t File::getLastWrite() {
+    struct stat info {};
+    return _handle && stat(_handle->hostPath.c_str(), &info) == 0 ? info.st_mtime : 0;
+}
+
+const char* File::path() const {
+    return _handle ? _handle->path.c_str() : nullptr;
+}
+
+const char* File::name() const {
+    if (!_handle) {
+        return nullptr;
+    }
+    const size_t slash = _handle->path.rfind('/');
+    return _handle->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+bool File::isDirectory() const {
+    return _handle && _handle->directory;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!_handle || !_handle->directory || _handle->nextChild >= _handle->children.size()) {
+        return File();
+    }
+    FS& fs = const_cast<FS&>(*_handle->fs);
+    return fs.open(_handle->children[_handle->nextChild++].c_str(), mode);
+}
+
+void File::rewindDirectory() {
+    if (_handle) {
+        _handle->nextChild = 0;
+    }
+}
+
+FS::FS(std::string root) : _root(std::move(root)) {}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+    File result;
+    const std::string hostPath = toHostPath(path);
+    std::error_code error;
+    if (stdfs::is_directory(hostPath, error)) {
+        auto handle = std::make_shared<File::Handle>();
+        handle->directory = true;
+        handle->path = path;
+        handle->hostPath = hostPath;
+        handle->fs = this;
+        const std::string prefix = handle->path == "/" ? "" : handle->path;
+        for (const auto& entry : stdfs::directory_iterator(hostPath, error)) {
+            handle->children.push_back(prefix + "/" + entry.path().filename().string());
+        }
+        result._handle = handle;
+        return result;
+    }
+
+    const bool writing = mode[0] == 'w' || mode[0] == 'a';
+    if (writing && create) {
+        stdfs::create_directories(stdfs::path(hostPath).parent_path(), error);
+    }
+    const char* hostMode = mode[0] == 'r' ? (mode[1] == '+' ? "r+b" : "rb") : mode[0] == 'w' ? (mode[1] == '+' ? "w+b" : "wb") : "ab";
+    FILE* file = fopen(hostPath.c_str(), hostMode);
+    if (!file) {
+        return result;
+    }
+    auto handle = std::make_shared<File::Handle>();
+    handle->file = file;
+    handle->path = path;
+    handle->hostPath = hostPath;
+    handle->fs = this;
+    result._handle = handle;
+    return result;
+}
+
+File FS::open(const String& path, const char* mode, const bool create) {
+    return open(path.c_str(), mode, create);
+}
+
+bool FS::exists(const char* path) {
+    std::error_code error;
+    return stdfs::exists(toHostPath(path), error);
+}
+
+bool FS::exists(const String& path) {
+    return exists(path.c_str());
+}
+
+bool FS::remove(const char* path) {
+    std::error_code error;
+    const std::string hostPath = toHostPath(path);
+    return stdfs::is_regular_file(hostPath, error) && stdfs::remove(hostPath, error);
+}
+
+bool FS::remove(const String& path) {
+    return remove(path.c_str());
+}
+
+bool FS::rename(const char* from, const char* to) {
+    std::error_code error;
+    stdfs::rename(toHostPath(from), toHostPath(to), error);
+    return !error;
+}
+
+bool FS::rename(const String& from, const String& to) {
+    return rename(from.c_str(), to.c_str());
+}
+
+bool FS::mkdir(const char* path) {
+    std::error_code error;
+    const std::string hostPath = toHostPath(path);
+    return stdfs::create_directory(hostPath, error) || stdfs::is_directory(hostPath, error);
+}
+
+bool FS::mkdir(const String& path) {
+    return mkdir(path.c_str());
+}
+
+bool FS::rmdir(const char* path) {
+    std::error_code error;
+    const std::string hostPath = toHostPath(path);
+    return stdfs::is_directory(hostPath, error) && stdfs::remove(hostPath, error);
+}
+
+bool FS::rmdir(const String& path) {
+    return rmdir(path.c_str());
+}
+
+void FS::setRoot(const std::string& root) {
+    _root = root;
+}
+
+const std::string& FS::getRoot() const {
+    return _root;
+}
+
+std::string FS::toHostPath(const char* path) const {
+    std::error_code error;
+    stdfs::create_directories(_root, error);
+    return _root + (path && path[0] == '/' ? "" : "/") + (path ? path : "");
+}
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+/**
+ * Ersatz für FS.h des ESP32-Core im nativen Build: ein Dateisystem in einem Verzeichnis des Rechners.
+ *
+ * Pfade beginnen wie auf dem Board mit "/" und werden an das Wurzelverzeichnis angehängt. Kopien eines File-Objekts
+ * teilen sich die geöffnete Datei (wie auf dem Board).
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FS;
+
+class File {
+public:
+    File() = default;
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* data, size_t length);
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t* data, size_t length);
+    size_t readBytes(char* data, size_t length);
+    void flush();
+    bool seek(uint32_t position, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    explicit operator bool() const;
+    time_t getLastWrite();
+    const char* path() const;
+    const char* name() const;
+    bool isDirectory() const;
+    File openNextFile(const char* mode = FILE_READ);
+    void rewindDirectory();
+
+private:
+    friend class FS;
+
+    struct Handle;
+    std::shared_ptr<Handle> _handle;
+};
+
+class FS {
+public:
+    explicit FS(std::string root);
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false);
+    bool exists(const char* path);
+    bool exists(const String& path);
+    bool remove(const char* path);
+    bool remove(const String& path);
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to);
+    bool mkdir(const char* path);
+    bool mkdir(const String& path);
+    bool rmdir(const char* path);
+    bool rmdir(const String& path);
+
+    /**
+     * @brief Legt das Wurzelverzeichnis fest (wird beim nächsten Zugriff bei Bedarf angelegt).
+     */
+    void setRoot(const std::string& root);
+
+    const std::string& getRoot() const;
+
+protected:
+    std::string toHostPath(const char* path) const;
+
+    std::string _root;
+};
+
+}
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
@@ -0,0 +1,48 @@
+#if defined(NATIVE)
+
+#include "LittleFS.h"
+#include <filesystem>
+
+namespace stdfs = std::filesystem;
+
+namespace {
+constexpr size_t TOTAL_BYTES = 1441792; // Größe der LittleFS-Partition auf dem Board (default.csv)
+
+std::string defaultRoot() {
+    const char* tmp = getenv("TMPDIR");
+    return std::string(tmp && tmp[0] ? tmp : "/tmp") + "/biodom-littlefs";
+}
+}
+
+LittleFSFS LittleFS;
+
+LittleFSFS::LittleFSFS() : FS(defaultRoot()) {}
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+    std::error_code error;
+    stdfs::create_directories(_root, error);
+    return stdfs::is_directory(_root, error);
+}
+
+bool LittleFSFS::format() {
+    std::error_code error;
+    stdfs::remove_all(_root, error);
+    return begin();
+}
+
+size_t LittleFSFS::totalBytes() {
+    return TOTAL_BYTES;
+}
+
+size_t LittleFSFS::usedBytes() {
+    std::error_code error;
+    size_t used = 0;
+    for (const auto& entry : stdfs::recursive_directory_iterator(_root, error)) {
+        if (entry.is_regular_file(error)) {
+            used += entry.file_size(error);
+        }
+    }
+    return used;
+}
+
+#endif
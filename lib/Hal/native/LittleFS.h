@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * Ersatz für LittleFS.h im nativen Build: das interne Dateisystem liegt in einem Verzeichnis des Rechners
+ * (Standard: $TMPDIR/biodom-littlefs, siehe HostHal::setFileSystemRoot()).
+ */
+
+#include "FS.h"
+
+class LittleFSFS : public fs::FS {
+public:
+    LittleFSFS();
+
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end() {}
+
+    /** @brief Löscht alle Dateien und Verzeichnisse. */
+    bool format();
+
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * Ersatz für OneWire im nativen Build: merkt sich nur den Pin, DallasTemperature fragt damit HostHal.
+ */
+
+#include "Arduino.h"
+
+class OneWire {
+public:
+    explicit OneWire(uint8_t pin) : _pin(pin) {}
+
+    uint8_t getPin() const { return _pin; }
+
+private:
+    uint8_t _pin;
+};
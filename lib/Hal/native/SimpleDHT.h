@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * Ersatz für SimpleDHT im nativen Build: liefert die Werte, die mit HostHal::setDht() für den Pin vorgegeben wurden.
+ * Das Protokoll auf dem Pin wird nicht simuliert.
+ */
+
+#include "Arduino.h"
+
+// Fehlercodes wie in SimpleDHT
+#define SimpleDHTErrSuccess 0
+#define SimpleDHTErrStartLow 0x10
+#define SimpleDHTErrStartHigh 0x11
+#define SimpleDHTErrDataLow 0x12
+#define SimpleDHTErrDataRead 0x13
+#define SimpleDHTErrDataEOF 0x14
+#define SimpleDHTErrDataChecksum 0x15
+#define SimpleDHTErrZeroSamples 0x16
+#define SimpleDHTErrNoPin 0x17
+#define SimpleDHTErrPinMode 0x18
+
+class SimpleDHT22 {
+public:
+    explicit SimpleDHT22(int pin) : _pin(pin) {}
+
+    /**
+     * @brief Liest Temperatur und Luftfeuchtigkeit.
+     * @param data Rohdaten (wird nicht unterstützt, muss nullptr sein).
+     * @return SimpleDHTErrSuccess oder ein Fehlercode.
+     */
+    int read2(float* temperature, float* humidity, uint8_t data[40]);
+
+private:
+    int _pin;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+/**
+ * Ersatz für Wire.h im nativen Build. I2C läuft über Hal::i2cWrite()/i2cRead(), hier bleibt nur begin() für Code,
+ * der den Bus selbst startet.
+ */
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+    bool begin() { return true; }
+    bool begin(int, int, uint32_t = 0) { return true; }
+    bool end() { return true; }
+    bool setClock(uint32_t) { return true; }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,16 @@
+#if defined(NATIVE)
+
+#include "Arduino.h"
+
+/**
+ * Einstiegspunkt im nativen Build: ruft setup() einmal auf, wie der Arduino-Core auf dem Board.
+ *
+ * loop() wird nicht aufgerufen, Tests und Benchmarks laufen vollständig in setup(). Liegt in der Bibliothek, damit ein
+ * Programm mit eigenem main() diese Datei einfach nicht mitlinkt.
+ */
+int main() {
+    setup();
+    return 0;
+}
+
+#endif
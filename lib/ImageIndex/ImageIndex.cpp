@@ -0,0 +1,486 @@
+#include "ImageIndex.h"
+
+ImageIndex::ImageIndex(fs::FS& fs, const char* path) : _fs(fs), _path(path) {}
+
+bool ImageIndex::begin(SpiBusArbiter* bus, const int device) {
+    _bus = bus;
+    _device = device;
+
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    File file = _fs.open(_path, FILE_READ);
+    if (file) {
+        Header header;
+        const size_t fileSize = file.size();
+        const bool valid = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+                           header.magic == MAGIC && header.version == VERSION && header.entrySize == sizeof(Entry) &&
+                           (fileSize - sizeof(Header)) % sizeof(Entry) == 0; // unvollständiger Eintrag = beschädigt
+        file.close();
+        if (valid) {
+            _size = (fileSize - sizeof(Header)) / sizeof(Entry);
+            _count = header.count;
+            _first = min(header.first, _size);
+            _bytes = header.bytes;
+            publishStats();
+            return true;
+        }
+    }
+
+    reset();
+    return false;
+}
+
+bool ImageIndex::add(const char* path, const uint32_t time, const uint32_t size) {
+    if (!path || size == 0) {
+        return false; // Größe 0 steht für "gelöscht"
+    }
+    Entry entry;
+    entry.time = time;
+    entry.size = size;
+    strlcpy(entry.path, path, PATH_LENGTH);
+
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    File file = _fs.open(_path, "r+");
+    if (!file) {
+        return false;
+    }
+    bool success = writeEntry(file, _size, entry);
+    if (success) {
+        if (_depth > 0 && _addedCount < REBUILD_ADDS) {
+            _added[_addedCount++] = _size; // die Suche des Neuaufbaus soll das Bild nicht noch einmal eintragen
+        }
+        _size++;
+        _count++;
+        _bytes += size;
+        success = writeHeader(file);
+    }
+    file.close();
+    return success;
+}
+
+bool ImageIndex::remove(const char* path) {
+    if (!path) {
+        return false;
+    }
+
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    File file = _fs.open(_path, "r+");
+    if (!file) {
+        return false;
+    }
+    Entry entry;
+    const uint32_t position = find(file, path, entry);
+    const bool success = position != NO_CURSOR && markDeleted(file, position, entry);
+    file.close();
+    return success;
+}
+
+bool ImageIndex::removeAt(const uint32_t position, const char* path) {
+    if (!path) {
+        return false;
+    }
+
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    if (position >= _size) {
+        return false;
+    }
+    File file = _fs.open(_path, "r+");
+    if (!file) {
+        return false;
+    }
+    const Block* block = loadBlock(file, position / BLOCK_ENTRIES);
+    bool success = false;
+    if (block) {
+        const Entry& entry = block->entries[position % BLOCK_ENTRIES];
+        success = entry.size > 0 && strcmp(entry.path, path) == 0 && markDeleted(file, position, entry);
+    }
+    file.close();
+    return success;
+}
+
+bool ImageIndex::rename(const char* from, const char* to) {
+    if (!from || !to) {
+        return false;
+    }
+
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    File file = _fs.open(_path, "r+");
+    if (!file) {
+        return false;
+    }
+    Entry entry;
+    const uint32_t position = find(file, from, entry);
+    bool success = position != NO_CURSOR;
+    if (success) {
+        strlcpy(entry.path, to, PATH_LENGTH);
+        success = writeEntry(file, position, entry);
+    }
+    file.close();
+    publishStats(); // Cache-Zähler
+    return success;
+}
+
+bool ImageIndex::clear() {
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    stopRebuild();
+    return reset();
+}
+
+bool ImageIndex::rebuild(const char* dirname, const char* extension, const std::function<void(uint32_t count)>& progress) {
+    if (!startRebuild(dirname, extension)) {
+        return false;
+    }
+    while (!rebuildStep(REBUILD_SLICE_MS)) {
+        if (progress) {
+            progress(_count);
+        }
+        yield(); // zwischen den Zeitscheiben kommen andere Tasks an den Bus
+    }
+    if (progress) {
+        progress(_count);
+    }
+    return _rebuildOk;
+}
+
+bool ImageIndex::startRebuild(const char* dirname, const char* extension) {
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    stopRebuild();
+    _rebuildOk = false;
+    if (!reset()) {
+        return false;
+    }
+    File root = _fs.open(dirname);
+    if (!root || !root.isDirectory()) {
+        return false;
+    }
+    _dirs[0] = root;
+    _depth = 1;
+    _extension = extension;
+    _addedCount = 0;
+    _rebuildOk = true;
+    return true;
+}
+
+bool ImageIndex::rebuildStep(const unsigned long sliceMs, const uint32_t lockTimeoutMs) {
+    if (_depth == 0) {
+        return true;
+    }
+    const SpiBusArbiter::Lock lock(_bus, _device, lockTimeoutMs);
+    if (!lock) {
+        return false; // später erneut versuchen
+    }
+    File index = _fs.open(_path, "r+");
+    bool success = static_cast<bool>(index);
+    if (success) {
+        // Die offenen Verzeichnisse bleiben über die Zeitscheiben hinweg erhalten, nur der Bus wird freigegeben
+        const unsigned long sliceStart = millis();
+        do {
+            success = rebuildNext(index);
+        } while (success && _depth > 0 && millis() - sliceStart < sliceMs);
+        success = writeHeader(index) && success;
+        index.close();
+    }
+    if (!success) {
+        _rebuildOk = false;
+        stopRebuild();
+    }
+    return _depth == 0;
+}
+
+bool ImageIndex::isRebuildOk() const {
+    return _rebuildOk;
+}
+
+uint16_t ImageIndex::getPage(const uint32_t after, const uint16_t limit, Entry* out, uint32_t& next) {
+    next = NO_CURSOR;
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    if (!lock) {
+        return 0;
+    }
+
+    File file; // wird erst bei einem Cache-Fehlgriff geöffnet
+    uint32_t position = after == NO_CURSOR || after > _size ? _size : after;
+    uint16_t count = 0;
+    const Block* block = nullptr;
+    while (position > _first && count < limit) { // vor _first liegen nur gelöschte Einträge
+        position--;
+        if (!block || block->number != position / BLOCK_ENTRIES) {
+            block = loadBlock(file, position / BLOCK_ENTRIES);
+            if (!block) {
+                break;
+            }
+        }
+        const Entry& entry = block->entries[position % BLOCK_ENTRIES];
+        if (entry.size > 0) {
+            out[count++] = entry;
+        }
+    }
+    if (file) {
+        file.close();
+    }
+
+    if (count == limit && position > _first) {
+        next = position; // Position des letzten gelieferten Bildes
+    }
+    publishStats(); // Cache-Zähler
+    return count;
+}
+
+uint16_t ImageIndex::getOldest(const uint32_t from, const uint16_t limit, Entry* out, uint32_t* positions, uint32_t& next) {
+    next = NO_CURSOR;
+    const SpiBusArbiter::Lock lock(_bus, _device);
+    if (!lock) {
+        return 0;
+    }
+
+    File file;
+    uint32_t position = from == NO_CURSOR || from < _first ? _first : from;
+    uint16_t count = 0;
+    const Block* block = nullptr;
+    while (position < _size && count < limit) {
+        if (!block || block->number != position / BLOCK_ENTRIES) {
+            block = loadBlock(file, position / BLOCK_ENTRIES);
+            if (!block) {
+                break;
+            }
+        }
+        const Entry& entry = block->entries[position % BLOCK_ENTRIES];
+        if (entry.size > 0) {
+            out[count] = entry;
+            positions[count] = position;
+            count++;
+        } else if (position == _first) {
+            _first++; // gelöschter Eintrag am Anfang, wird mit dem nächsten Kopf gespeichert
+        }
+        position++;
+    }
+    if (file) {
+        file.close();
+    }
+
+    if (count == limit && position < _size) {
+        next = position; // Position nach dem letzten gelieferten Bild
+    }
+    publishStats(); // Cache-Zähler
+    return count;
+}
+
+ImageIndex::Stats ImageIndex::getStats() const {
+    return _stats.read();
+}
+
+uint32_t ImageIndex::getCount() const {
+    return _count;
+}
+
+uint32_t ImageIndex::getSize() const {
+    return _size;
+}
+
+uint64_t ImageIndex::getBytes() const {
+    return _bytes;
+}
+
+uint32_t ImageIndex::getCacheHits() const {
+    return _hits;
+}
+
+uint32_t ImageIndex::getCacheMisses() const {
+    return _misses;
+}
+
+uint32_t ImageIndex::find(File& file, const char* path, Entry& entry) {
+    const Block* block = nullptr;
+    for (uint32_t position = _first; position < _size; position++) {
+        if (!block || block->number != position / BLOCK_ENTRIES) {
+            block = loadBlock(file, position / BLOCK_ENTRIES);
+            if (!block) {
+                break;
+            }
+        }
+        const Entry& candidate = block->entries[position % BLOCK_ENTRIES];
+        if (candidate.size > 0 && strcmp(candidate.path, path) == 0) {
+            entry = candidate;
+            return position;
+        }
+    }
+    return NO_CURSOR;
+}
+
+bool ImageIndex::markDeleted(File& file, const uint32_t position, Entry entry) {
+    const uint32_t size = entry.size;
+    entry.size = 0;
+    if (!writeEntry(file, position, entry)) {
+        return false;
+    }
+    _count--;
+    _bytes -= min<uint64_t>(size, _bytes);
+    if (position == _first) {
+        _first++;
+    }
+    return writeHeader(file);
+}
+
+bool ImageIndex::rebuildNext(File& index) {
+    File& dir = _dirs[_depth - 1];
+    File file = dir.openNextFile();
+    if (!file) {
+        dir.close(); // Verzeichnis fertig, weiter im übergeordneten
+        _depth--;
+        return true;
+    }
+    if (file.isDirectory()) {
+        if (_depth < REBUILD_DEPTH) {
+            _dirs[_depth++] = file; // bleibt offen, bis alle Dateien darin bearbeitet sind
+            return true;
+        }
+        file.close(); // zu tief verschachtelt, übersprungen
+        return true;
+    }
+
+    const char* path = file.path();
+    const size_t length = strlen(path);
+    const size_t extensionLength = strlen(_extension);
+    bool success = true;
+    if (file.size() > 0 && length >= extensionLength && strcasecmp(path + length - extensionLength, _extension) == 0 &&
+        !isAddedDuringRebuild(index, path)) {
+        Entry entry;
+        entry.time = static_cast<uint32_t>(file.getLastWrite());
+        entry.size = file.size();
+        strlcpy(entry.path, path, PATH_LENGTH);
+        success = writeEntry(index, _size, entry);
+        if (success) {
+            _size++;
+            _count++;
+            _bytes += entry.size;
+        }
+    }
+    file.close();
+    return success;
+}
+
+bool ImageIndex::isAddedDuringRebuild(File& index, const char* path) {
+    for (uint8_t i = 0; i < _addedCount; i++) {
+        const Block* block = loadBlock(index, _added[i] / BLOCK_ENTRIES);
+        if (block && strncmp(block->entries[_added[i] % BLOCK_ENTRIES].path, path, PATH_LENGTH - 1) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ImageIndex::stopRebuild() {
+    while (_depth > 0) {
+        _dirs[--_depth].close();
+    }
+}
+
+ImageIndex::Block* ImageIndex::loadBlock(File& file, const uint32_t number) {
+    Block* block = findBlock(number);
+    if (block) {
+        _hits++;
+        block->lastUse = ++_useCounter;
+        return block;
+    }
+    _misses++;
+
+    // Den am längsten nicht benutzten Block ersetzen (leere haben lastUse 0)
+    block = &_cache[0];
+    for (Block& candidate : _cache) {
+        if (candidate.lastUse < block->lastUse) {
+            block = &candidate;
+        }
+    }
+
+    if (!file) {
+        file = _fs.open(_path, FILE_READ);
+        if (!file) {
+            return nullptr;
+        }
+    }
+    const uint32_t first = number * BLOCK_ENTRIES;
+    if (first >= _size) {
+        return nullptr;
+    }
+    const auto length = static_cast<uint16_t>(min<uint32_t>(BLOCK_ENTRIES, _size - first));
+    const size_t bytes = length * sizeof(Entry);
+    if (!file.seek(offsetOf(first)) || file.read(reinterpret_cast<uint8_t*>(block->entries), bytes) != bytes) {
+        block->number = NO_CURSOR;
+        block->lastUse = 0;
+        return nullptr;
+    }
+    block->number = number;
+    block->length = length;
+    block->lastUse = ++_useCounter;
+    return block;
+}
+
+ImageIndex::Block* ImageIndex::findBlock(const uint32_t number) {
+    for (Block& block : _cache) {
+        if (block.number == number) {
+            return &block;
+        }
+    }
+    return nullptr;
+}
+
+bool ImageIndex::writeEntry(File& file, const uint32_t position, const Entry& entry) {
+    if (!file.seek(offsetOf(position)) ||
+        file.write(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry)) != sizeof(entry)) {
+        return false;
+    }
+
+    // Liegt der Block im RAM, dort ebenfalls ändern bzw. anhängen
+    Block* block = findBlock(position / BLOCK_ENTRIES);
+    if (block) {
+        const uint16_t index = position % BLOCK_ENTRIES;
+        block->entries[index] = entry;
+        if (index >= block->length) {
+            block->length = index + 1;
+        }
+    }
+    return true;
+}
+
+bool ImageIndex::writeHeader(File& file) {
+    Header header;
+    header.count = _count;
+    header.first = _first;
+    header.bytes = _bytes;
+    publishStats(); // jede Änderung der Zähler endet hier
+    return file.seek(0) && file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+}
+
+bool ImageIndex::reset() {
+    _size = 0;
+    _count = 0;
+    _first = 0;
+    _bytes = 0;
+    publishStats();
+    for (Block& block : _cache) {
+        block.number = NO_CURSOR;
+        block.lastUse = 0;
+        block.length = 0;
+    }
+
+    File file = _fs.open(_path, FILE_WRITE); // leert die Datei
+    if (!file) {
+        return false;
+    }
+    const bool success = writeHeader(file);
+    file.close();
+    return success;
+}
+
+void ImageIndex::publishStats() {
+    Stats stats;
+    stats.count = _count;
+    stats.size = _size;
+    stats.bytes = _bytes;
+    stats.cacheHits = _hits;
+    stats.cacheMisses = _misses;
+    _stats.write(stats);
+}
+
+uint32_t ImageIndex::offsetOf(const uint32_t position) {
+    return sizeof(Header) + position * sizeof(Entry);
+}
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <functional>
+#include "Seqlock.h"
+#include "SpiBusArbiter.h"
+
+/**
+ * Verzeichnis der Kamerabilder als Indexdatei auf der SD-Karte.
+ *
+ * Statt bei jeder Anfrage das ganze Verzeichnis zu durchsuchen (jede Datei wird dabei geöffnet), steht jedes Bild mit
+ * Zeitstempel, Größe und Pfad als Eintrag fester Länge in einer Datei. Neue Bilder werden mit add() angehängt, gelöschte
+ * mit remove() nur als gelöscht markiert. Die Einträge liegen in der Reihenfolge der Aufnahme (damit auch nach Zeit
+ * sortiert); ihre Position in der Datei dient als Cursor für das seitenweise Lesen mit getPage().
+ *
+ * Die Datei wird blockweise (BLOCK_ENTRIES Einträge) gelesen. Die zuletzt benutzten CACHE_BLOCKS Blöcke bleiben im RAM,
+ * sodass die erste Seite (die neuesten Bilder) meist ohne Zugriff auf die SD-Karte auskommt.
+ *
+ * Zum Aufräumen liest getOldest() die ältesten Bilder zuerst, removeAt() löscht ein Bild über seine Position. Gelöschte
+ * Einträge am Anfang der Datei werden dabei übersprungen (die Position des ältesten Bildes steht im Kopf).
+ *
+ * Dateiformat: 24 Byte Kopf (Kennung, Version, Eintragsgröße, Anzahl nicht gelöschter Einträge, Position des ältesten,
+ * Summe der Bildgrößen), danach die Einträge. Eine Datei älterer Version gilt als ungültig und wird neu aufgebaut.
+ *
+ * Alle Methoden holen den SPI-Bus über den Arbiter und sind dadurch auch gegeneinander geschützt. Sie dürfen aus
+ * verschiedenen Tasks aufgerufen werden, auch wenn der Aufrufer den Bus bereits hält. Für Statistiken, die den Bus
+ * nicht holen sollen, liefert getStats() eine konsistente Kopie der Zähler.
+ */
+class ImageIndex {
+public:
+    static constexpr size_t PATH_LENGTH = 40;        // Maximale Länge eines Pfads inkl. Nullterminator
+    static constexpr uint16_t BLOCK_ENTRIES = 16;    // Einträge pro Block (Lese- und Cache-Einheit)
+    static constexpr uint8_t CACHE_BLOCKS = 4;       // Anzahl der Blöcke im RAM
+    static constexpr uint32_t NO_CURSOR = UINT32_MAX; // Cursor: von vorne beginnen bzw. keine weitere Seite
+    static constexpr uint8_t REBUILD_DEPTH = 6;      // Maximale Verzeichnistiefe beim Neuaufbau (tiefere werden übersprungen)
+    static constexpr uint8_t REBUILD_ADDS = 8;       // Bilder, die während des Neuaufbaus mit add() dazukommen dürfen (ohne doppelte Einträge)
+    static constexpr unsigned long REBUILD_SLICE_MS = 20; // Zeitscheibe in ms für rebuild()
+
+    /**
+     * @struct Entry
+     * @brief Ein Bild im Index (48 Byte, so auch in der Datei).
+     */
+    struct Entry {
+        uint32_t time = 0;           // Aufnahmezeit (Unix-Zeit in Sekunden, 0 = unbekannt)
+        uint32_t size = 0;           // Größe in Byte (0 = gelöscht)
+        char path[PATH_LENGTH] = {}; // Pfad auf der SD-Karte (z.B. "/img/2025/12/05/103000.jpg")
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param fs Das Dateisystem (z.B. SD).
+     * @param path Pfad der Indexdatei, wird nicht kopiert.
+     */
+    ImageIndex(fs::FS& fs, const char* path);
+
+    /**
+     * @brief Liest den Kopf der Indexdatei.
+     * Fehlt die Datei oder ist sie beschädigt, wird eine leere angelegt. Dann fehlen die vorhandenen Bilder im Index und
+     * er sollte mit rebuild() neu aufgebaut werden.
+     * @param bus Arbiter für den SPI-Bus (nullptr = ohne Arbiter, dann nur aus einem Task benutzen).
+     * @param device ID der SD-Karte beim Arbiter.
+     * @return true, wenn eine gültige Indexdatei vorhanden war.
+     */
+    bool begin(SpiBusArbiter* bus = nullptr, int device = SpiBusArbiter::NO_DEVICE);
+
+    /**
+     * @brief Hängt ein neues Bild an.
+     * @param path Pfad des Bildes (wird bei mehr als PATH_LENGTH - 1 Zeichen abgeschnitten).
+     * @param time Aufnahmezeit (Unix-Zeit in Sekunden, 0 = unbekannt).
+     * @param size Größe in Byte.
+     * @return true bei Erfolg.
+     */
+    bool add(const char* path, uint32_t time, uint32_t size);
+
+    /**
+     * @brief Markiert ein Bild als gelöscht (die Datei selbst muss der Aufrufer löschen).
+     * Gesucht wird vom ältesten Bild an, das Löschen alter Bilder ist daher am schnellsten.
+     * @param path Pfad des Bildes.
+     * @return true, wenn das Bild im Index stand.
+     */
+    bool remove(const char* path);
+
+    /**
+     * @brief Markiert das Bild an einer Position als gelöscht (die Datei selbst muss der Aufrufer löschen).
+     * @param position Position aus getOldest().
+     * @param path Pfad des Bildes; steht dort inzwischen ein anderes Bild, wird nichts gelöscht.
+     * @return true, wenn das Bild an dieser Position stand.
+     */
+    bool removeAt(uint32_t position, const char* path);
+
+    /**
+     * @brief Ändert den Pfad eines Bildes (z.B. nachdem die Datei verschoben wurde). Die Position bleibt erhalten.
+     * @param from Bisheriger Pfad.
+     * @param to Neuer Pfad.
+     * @return true, wenn das Bild im Index stand.
+     */
+    bool rename(const char* from, const char* to);
+
+    /**
+     * @brief Leert den Index (z.B. nachdem alle Bilder gelöscht wurden).
+     * @return true bei Erfolg.
+     */
+    bool clear();
+
+    /**
+     * @brief Baut den Index aus dem Inhalt eines Verzeichnisses und aller Unterverzeichnisse neu auf.
+     * Kurzform für startRebuild() und rebuildStep() in Zeitscheiben zu REBUILD_SLICE_MS, bis alles durchsucht ist.
+     * Zwischen den Zeitscheiben ist der Bus frei, der Aufruf selbst dauert aber so lange wie das Durchsuchen der
+     * Verzeichnisse und sollte daher im Hintergrund laufen.
+     * @param dirname Das Verzeichnis (z.B. "/").
+     * @param extension Nur Dateien mit dieser Endung (z.B. ".jpg").
+     * @param progress Wird nach jeder Zeitscheibe mit der bisherigen Anzahl aufgerufen (optional).
+     * @return true bei Erfolg.
+     */
+    bool rebuild(const char* dirname, const char* extension, const std::function<void(uint32_t count)>& progress = nullptr);
+
+    /**
+     * @brief Beginnt den Neuaufbau: leert den Index und öffnet das Verzeichnis (ein laufender Neuaufbau wird verworfen).
+     * Die Einträge werden in der Reihenfolge der Verzeichnisse übernommen (bei FAT die Reihenfolge, in der die Dateien
+     * angelegt wurden). Bilder, die währenddessen mit add() eingetragen werden, übernimmt die Suche nicht ein zweites Mal.
+     * @param dirname Das Verzeichnis (z.B. "/").
+     * @param extension Nur Dateien mit dieser Endung (z.B. ".jpg"), wird nicht kopiert.
+     * @return true, wenn das Verzeichnis geöffnet werden konnte.
+     */
+    bool startRebuild(const char* dirname, const char* extension);
+
+    /**
+     * @brief Arbeitet den Neuaufbau eine Zeitscheibe lang ab und gibt den Bus danach wieder frei.
+     * @param sliceMs Maximale Dauer in ms (mindestens eine Datei wird immer bearbeitet).
+     * @param lockTimeoutMs Maximale Wartezeit auf den SPI-Bus in ms.
+     * @return true, wenn der Neuaufbau abgeschlossen ist (Ergebnis siehe isRebuildOk()); false, wenn noch Arbeit übrig
+     *         ist (oder der Bus belegt war).
+     */
+    bool rebuildStep(unsigned long sliceMs, uint32_t lockTimeoutMs = UINT32_MAX);
+
+    /**
+     * @brief Gibt an, ob der laufende bzw. letzte Neuaufbau ohne Schreibfehler war.
+     */
+    bool isRebuildOk() const;
+
+    /**
+     * @brief Liest eine Seite des Index, die neuesten Bilder zuerst.
+     * @param after Cursor: Position des letzten Bildes der vorherigen Seite (NO_CURSOR = mit dem neuesten beginnen).
+     * @param limit Maximale Anzahl der Bilder.
+     * @param out Ziel-Array mit mindestens limit Einträgen.
+     * @param next Cursor für die nächste Seite (NO_CURSOR, wenn keine älteren Bilder mehr folgen).
+     * @return Anzahl der gelesenen Bilder.
+     */
+    uint16_t getPage(uint32_t after, uint16_t limit, Entry* out, uint32_t& next);
+
+    /**
+     * @brief Liest die ältesten Bilder zuerst (z.B. zum Aufräumen).
+     * @param from Cursor: Position, ab der gelesen wird (NO_CURSOR = mit dem ältesten beginnen).
+     * @param limit Maximale Anzahl der Bilder.
+     * @param out Ziel-Array mit mindestens limit Einträgen.
+     * @param positions Ziel-Array mit mindestens limit Einträgen für die Positionen (für removeAt()).
+     * @param next Cursor für den nächsten Aufruf (NO_CURSOR, wenn keine neueren Bilder mehr folgen).
+     * @return Anzahl der gelesenen Bilder.
+     */
+    uint16_t getOldest(uint32_t from, uint16_t limit, Entry* out, uint32_t* positions, uint32_t& next);
+
+    /**
+     * @struct Stats
+     * @brief Zähler des Index (siehe getStats()).
+     */
+    struct Stats {
+        uint32_t count = 0;       // Bilder (ohne gelöschte)
+        uint32_t size = 0;        // Einträge in der Datei (mit gelöschten)
+        uint64_t bytes = 0;       // Summe der Bildgrößen in Byte
+        uint32_t cacheHits = 0;   // Blöcke aus dem RAM
+        uint32_t cacheMisses = 0; // Blöcke von der SD-Karte
+    };
+
+    /**
+     * @brief Gibt eine konsistente Kopie der Zähler zurück, ohne den SPI-Bus zu holen.
+     * Darf jederzeit aus jedem Task aufgerufen werden; die Zähler werden nach jeder Änderung veröffentlicht.
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Gibt die Anzahl der Bilder im Index zurück (ohne gelöschte).
+     */
+    uint32_t getCount() const;
+
+    /**
+     * @brief Gibt die Anzahl der Einträge in der Datei zurück (mit gelöschten).
+     */
+    uint32_t getSize() const;
+
+    /**
+     * @brief Gibt die Summe der Bildgrößen in Byte zurück (ohne gelöschte).
+     */
+    uint64_t getBytes() const;
+
+    /**
+     * @brief Gibt an, wie oft ein Block im RAM gefunden wurde.
+     */
+    uint32_t getCacheHits() const;
+
+    /**
+     * @brief Gibt an, wie oft ein Block von der SD-Karte gelesen werden musste.
+     */
+    uint32_t getCacheMisses() const;
+
+private:
+    static constexpr uint32_t MAGIC = 0x58444949; // "IIDX"
+    static constexpr uint16_t VERSION = 2;
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint16_t version = VERSION;
+        uint16_t entrySize = sizeof(Entry);
+        uint32_t count = 0; // Anzahl der nicht gelöschten Einträge
+        uint32_t first = 0; // Position des ältesten nicht gelöschten Eintrags (davor nur gelöschte)
+        uint64_t bytes = 0; // Summe der Bildgrößen der nicht gelöschten Einträge
+    };
+
+    struct Block {
+        uint32_t number = NO_CURSOR; // Nummer des Blocks in der Datei (NO_CURSOR = leer)
+        uint32_t lastUse = 0;        // für die Verdrängung (least recently used)
+        uint16_t length = 0;         // gültige Einträge
+        Entry entries[BLOCK_ENTRIES];
+    };
+
+    /**
+     * @brief Gibt einen Block aus dem Cache zurück oder liest ihn von der SD-Karte.
+     * @param file Die geöffnete Indexdatei (wird bei Bedarf geöffnet).
+     * @param number Nummer des Blocks.
+     * @return Der Block, oder nullptr bei einem Lesefehler.
+     */
+    Block* loadBlock(File& file, uint32_t number);
+
+    /**
+     * @brief Sucht ein (nicht gelöschtes) Bild, beginnend beim ältesten.
+     * @param file Die zum Schreiben geöffnete Indexdatei.
+     * @param path Pfad des Bildes.
+     * @param entry Ziel für den gefundenen Eintrag.
+     * @return Position des Eintrags, oder NO_CURSOR, wenn das Bild nicht im Index steht.
+     */
+    uint32_t find(File& file, const char* path, Entry& entry);
+
+    /**
+     * @brief Markiert einen Eintrag als gelöscht und schreibt den Kopf.
+     * @param file Die zum Schreiben geöffnete Indexdatei.
+     * @param position Position des Eintrags.
+     * @param entry Der (nicht gelöschte) Eintrag, wie er an der Position steht.
+     */
+    bool markDeleted(File& file, uint32_t position, Entry entry);
+
+    /**
+     * @brief Bearbeitet die nächste Datei des Neuaufbaus: steigt in ein Unterverzeichnis ab, trägt ein passendes Bild
+     * ein oder schließt das Verzeichnis, wenn es keine weiteren Dateien hat.
+     * @param index Die zum Schreiben geöffnete Indexdatei.
+     * @return false bei einem Schreibfehler.
+     */
+    bool rebuildNext(File& index);
+
+    /**
+     * @brief Gibt an, ob ein Bild während des Neuaufbaus schon mit add() eingetragen wurde.
+     */
+    bool isAddedDuringRebuild(File& index, const char* path);
+
+    /**
+     * @brief Schließt die offenen Verzeichnisse des Neuaufbaus.
+     */
+    void stopRebuild();
+
+    /**
+     * @brief Sucht einen Block im Cache.
+     * @return Der Block, oder nullptr, wenn er nicht im RAM liegt.
+     */
+    Block* findBlock(uint32_t number);
+
+    /**
+     * @brief Schreibt einen Eintrag an seine Position und ändert ihn auch im Cache (den Kopf schreibt der Aufrufer).
+     */
+    bool writeEntry(File& file, uint32_t position, const Entry& entry);
+
+    /**
+     * @brief Schreibt den Kopf an den Anfang der Datei.
+     */
+    bool writeHeader(File& file);
+
+    /**
+     * @brief Legt eine leere Indexdatei an und leert den Cache.
+     */
+    bool reset();
+
+    /**
+     * @brief Veröffentlicht die Zähler für getStats() (nur bei gehaltenem Bus, damit es nur einen Schreiber gibt).
+     */
+    void publishStats();
+
+    static uint32_t offsetOf(uint32_t position);
+
+    fs::FS& _fs;
+    const char* _path;
+    SpiBusArbiter* _bus = nullptr;
+    int _device = SpiBusArbiter::NO_DEVICE;
+    uint32_t _size = 0;  // Einträge in der Datei
+    uint32_t _count = 0; // davon nicht gelöscht
+    uint32_t _first = 0; // davor nur gelöschte Einträge
+    uint64_t _bytes = 0; // Summe der Bildgrößen
+    Block _cache[CACHE_BLOCKS];
+    uint32_t _useCounter = 0;
+    uint32_t _hits = 0;
+    uint32_t _misses = 0;
+    Seqlock<Stats> _stats; // veröffentlichte Zähler für andere Tasks
+
+    File _dirs[REBUILD_DEPTH];      // offene Verzeichnisse des Neuaufbaus, das innerste zuletzt
+    uint8_t _depth = 0;             // 0 = kein Neuaufbau
+    const char* _extension = "";
+    bool _rebuildOk = true;
+    uint32_t _added[REBUILD_ADDS] = {}; // Positionen der Bilder, die während des Neuaufbaus mit add() kamen
+    uint8_t _addedCount = 0;
+};
+
+static_assert(sizeof(ImageIndex::Entry) == 48, "ImageIndex: Eintragsgroesse ist Teil des Dateiformats");
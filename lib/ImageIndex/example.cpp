@@ -0,0 +1,54 @@
+/**
+ * Beispiel zur Nutzung der ImageIndex-Bibliothek
+ *
+ * Legt den Index im LittleFS an, trägt bei jeder Eingabe im Serial Monitor ein Bild ein und gibt die Bilder
+ * seitenweise (je 5, neueste zuerst) aus.
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "ImageIndex.h"
+
+ImageIndex imageIndex(LittleFS, "/images.idx");
+uint32_t imageNumber = 0;
+
+void printPages() {
+    ImageIndex::Entry page[5];
+    uint32_t cursor = ImageIndex::NO_CURSOR;
+    int pageNumber = 1;
+    do {
+        const uint16_t count = imageIndex.getPage(cursor, 5, page, cursor);
+        Serial.printf("Seite %d:\n", pageNumber++);
+        for (uint16_t i = 0; i < count; i++) {
+            Serial.printf("  %s (%u Byte)\n", page[i].path, page[i].size);
+        }
+    } while (cursor != ImageIndex::NO_CURSOR);
+    Serial.printf("%u Bilder, Cache: %u Treffer, %u Fehlgriffe\n",
+        imageIndex.getCount(), imageIndex.getCacheHits(), imageIndex.getCacheMisses());
+}
+
+void setup() {
+    Serial.begin(115200);
+    if (!LittleFS.begin(true)) {
+        Serial.println("LittleFS konnte nicht eingebunden werden");
+        return;
+    }
+    if (!imageIndex.begin()) {
+        Serial.println("Neuer Index angelegt");
+    }
+    imageNumber = imageIndex.getSize();
+    printPages();
+}
+
+void loop() {
+    if (Serial.available()) {
+        while (Serial.available()) {
+            Serial.read();
+        }
+        char path[ImageIndex::PATH_LENGTH];
+        snprintf(path, sizeof(path), "/img_%05u.jpg", ++imageNumber);
+        imageIndex.add(path, 0, 40000 + imageNumber);
+        printPages();
+    }
+    delay(100);
+}
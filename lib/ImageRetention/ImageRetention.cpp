@@ -0,0 +1,179 @@
+#include "ImageRetention.h"
+
+namespace {
+constexpr uint32_t SECONDS_PER_DAY = 86400;
+constexpr uint32_t NOON = 12 * 3600;
+constexpr uint64_t BYTES_PER_MB = 1024 * 1024;
+}
+
+ImageRetention::ImageRetention(ImageIndex& index, RemoveFunction remove) : _index(index), _remove(std::move(remove)) {}
+
+void ImageRetention::begin(SpiBusArbiter* bus, const int device) {
+    _bus = bus;
+    _device = device;
+}
+
+void ImageRetention::start(const Policy& policy, const uint32_t now, const uint64_t usedBytes, const uint64_t totalBytes) {
+    _run = Run();
+    _startedAt = millis();
+    _ageCutoff = getCutoff(now, policy.maxAgeDays);
+    _thinCutoff = getCutoff(now, policy.thinAfterDays);
+    _missing = getMissingBytes(policy, _index.getBytes(), usedBytes, totalBytes);
+    _run.missingBytes = _missing;
+
+    _cursor = ImageIndex::NO_CURSOR;
+    _atEnd = false;
+    _candidate.position = ImageIndex::NO_CURSOR;
+    _batchCount = 0;
+    _batchIndex = 0;
+    publish();
+}
+
+bool ImageRetention::step(const unsigned long sliceMs, const uint32_t lockTimeoutMs) {
+    if (_run.finished) {
+        return true;
+    }
+    const SpiBusArbiter::Lock lock(_bus, _device, lockTimeoutMs);
+    if (!lock) {
+        return false; // später erneut versuchen
+    }
+
+    // Mindestens ein Bild pro Zeitscheibe, damit der Durchlauf auch bei sehr kurzen Zeitscheiben vorankommt
+    const unsigned long sliceStart = millis();
+    bool more = true;
+    do {
+        if (_batchIndex >= _batchCount) {
+            _batchCount = _atEnd ? 0 : _index.getOldest(_cursor, BATCH_ENTRIES, _batch, _positions, _cursor);
+            _batchIndex = 0;
+            _atEnd = _cursor == ImageIndex::NO_CURSOR;
+            if (_batchCount == 0) {
+                more = false;
+                break;
+            }
+        }
+        const uint16_t i = _batchIndex++;
+        _run.checked++;
+        more = apply(_batch[i], _positions[i]);
+    } while (more && millis() - sliceStart < sliceMs);
+    _run.busyMs += millis() - sliceStart;
+
+    if (!more) {
+        finish();
+    }
+    publish();
+    return !more;
+}
+
+const ImageRetention::Run& ImageRetention::getRun() const {
+    return _run;
+}
+
+ImageRetention::Stats ImageRetention::getStats() const {
+    return _stats.read();
+}
+
+uint32_t ImageRetention::getRunCount() const {
+    return _runs;
+}
+
+uint64_t ImageRetention::getTotalReclaimedBytes() const {
+    return _totalReclaimed;
+}
+
+uint64_t ImageRetention::getMissingBytes(const Policy& policy, const uint64_t imageBytes, const uint64_t usedBytes, const uint64_t totalBytes) {
+    uint64_t missing = 0;
+    const uint64_t maxImageBytes = policy.maxImageMB * BYTES_PER_MB;
+    if (policy.maxImageMB > 0 && imageBytes > maxImageBytes) {
+        missing = imageBytes - maxImageBytes;
+    }
+    if (policy.minFreePercent > 0 && totalBytes > 0) {
+        const uint64_t freeBytes = usedBytes < totalBytes ? totalBytes - usedBytes : 0;
+        const uint64_t minFreeBytes = totalBytes / 100 * min<uint8_t>(policy.minFreePercent, 100);
+        if (freeBytes < minFreeBytes) {
+            missing = max(missing, minFreeBytes - freeBytes);
+        }
+    }
+    return missing;
+}
+
+bool ImageRetention::apply(const ImageIndex::Entry& entry, const uint32_t position) {
+    const bool dated = entry.time > 0;
+    if (_missing > 0) {
+        removeImage(entry.path, entry.size, position); // Speichergrenze oder Wasserlinie: die ältesten zuerst
+    } else if (dated && entry.time < _ageCutoff) {
+        removeImage(entry.path, entry.size, position);
+    } else if (dated && entry.time < _thinCutoff) {
+        thin(entry, position);
+    } else if (dated || (_ageCutoff == 0 && _thinCutoff == 0)) {
+        return false; // neuer als alle Grenzen, die folgenden Bilder auch
+    }
+    // Bilder ohne Aufnahmezeit betrifft nur der Speicherplatz, sie beenden den Durchlauf nicht
+    return true;
+}
+
+void ImageRetention::thin(const ImageIndex::Entry& entry, const uint32_t position) {
+    uint32_t secondOfDay = 0;
+    const int32_t day = dayOf(entry.time, secondOfDay);
+    const uint32_t distance = secondOfDay > NOON ? secondOfDay - NOON : NOON - secondOfDay;
+
+    if (_candidate.position == ImageIndex::NO_CURSOR || _candidate.day != day) {
+        // Erstes Bild des Tages: vorerst behalten (der vorherige Tag ist damit fertig)
+    } else if (distance < _candidate.distance) {
+        // Dieses liegt näher an 12 Uhr. Lässt sich das bisherige nicht löschen, bleibt es das Bild des Tages (Abstand 0,
+        // damit es nicht bei jedem weiteren Bild erneut versucht wird) und dieses wird gelöscht.
+        if (!removeImage(_candidate.path, _candidate.size, _candidate.position)) {
+            _candidate.distance = 0;
+            removeImage(entry.path, entry.size, position);
+            return;
+        }
+    } else {
+        removeImage(entry.path, entry.size, position);
+        return;
+    }
+    _candidate.position = position;
+    _candidate.day = day;
+    _candidate.distance = distance;
+    _candidate.size = entry.size;
+    strlcpy(_candidate.path, entry.path, sizeof(_candidate.path));
+}
+
+bool ImageRetention::removeImage(const char* path, const uint32_t size, const uint32_t position) {
+    if (!_remove(path)) {
+        _run.failed++;
+        return false;
+    }
+    _index.removeAt(position, path);
+    _run.deleted++;
+    _run.reclaimedBytes += size;
+    _missing = size < _missing ? _missing - size : 0;
+    return true;
+}
+
+void ImageRetention::finish() {
+    _run.finished = true;
+    _run.missingBytes = _missing;
+    _run.durationMs = millis() - _startedAt;
+    _runs++;
+    _totalReclaimed += _run.reclaimedBytes;
+}
+
+void ImageRetention::publish() {
+    Stats stats;
+    stats.run = _run;
+    stats.runs = _runs;
+    stats.totalReclaimedBytes = _totalReclaimed;
+    _stats.write(stats);
+}
+
+uint32_t ImageRetention::getCutoff(const uint32_t now, const uint16_t days) {
+    const uint64_t seconds = static_cast<uint64_t>(days) * SECONDS_PER_DAY;
+    return days > 0 && now > seconds ? static_cast<uint32_t>(now - seconds) : 0;
+}
+
+int32_t ImageRetention::dayOf(const uint32_t time, uint32_t& secondOfDay) {
+    const time_t t = time;
+    tm local{};
+    localtime_r(&t, &local);
+    secondOfDay = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    return (local.tm_year + 1900) * 1000 + local.tm_yday;
+}
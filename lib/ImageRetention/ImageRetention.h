@@ -0,0 +1,207 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "ImageIndex.h"
+#include "Seqlock.h"
+#include "SpiBusArbiter.h"
+
+/**
+ * Räumt die Kamerabilder nach einstellbaren Regeln auf, damit die SD-Karte nicht vollläuft.
+ *
+ * Regeln (jeweils 0 = aus):
+ * - Höchstalter: Bilder, die älter als maxAgeDays Tage sind, werden gelöscht.
+ * - Ausdünnen: Von Tagen, die älter als thinAfterDays Tage sind, bleibt nur das Bild, das am nächsten an 12 Uhr liegt.
+ * - Speichergrenze: Die Bilder belegen höchstens maxImageMB MB (laut ImageIndex).
+ * - Wasserlinie: Auf der Karte bleiben mindestens minFreePercent Prozent frei.
+ * Für die beiden letzten Regeln werden die ältesten Bilder gelöscht, bis genug Platz frei ist.
+ *
+ * Ein Durchlauf beginnt mit start() und wird mit step() in kurzen Zeitscheiben abgearbeitet. Jede Zeitscheibe hält den
+ * SPI-Bus nur so lange wie angegeben; dazwischen kommen Kamera und Webinterface an die Karte. Die Bilder werden vom
+ * ältesten an gelesen (ImageIndex::getOldest()), der Durchlauf endet beim ersten Bild, das keine Regel mehr betrifft.
+ *
+ * Die Dateien löscht eine Funktion des Aufrufers (z.B. MicroSDCard::removeImage()), die Einträge im Index
+ * ImageRetention selbst.
+ */
+class ImageRetention {
+public:
+    static constexpr uint16_t BATCH_ENTRIES = 16; // Einträge, die pro Zugriff aus dem Index gelesen werden
+
+    /**
+     * @struct Policy
+     * @brief Die Regeln für einen Durchlauf (0 = Regel aus).
+     */
+    struct Policy {
+        uint16_t maxAgeDays = 0;    // Bilder älter als so viele Tage löschen
+        uint16_t thinAfterDays = 0; // Tage, die älter sind, auf ein Bild ausdünnen
+        uint32_t maxImageMB = 0;    // Höchstens so viel Speicher für Bilder
+        uint8_t minFreePercent = 0; // Mindestens so viel Platz auf der Karte frei lassen
+    };
+
+    /**
+     * @struct Run
+     * @brief Ergebnis eines Durchlaufs.
+     */
+    struct Run {
+        uint32_t checked = 0;        // geprüfte Bilder
+        uint32_t deleted = 0;        // gelöschte Bilder
+        uint32_t failed = 0;         // Bilder, die sich nicht löschen ließen
+        uint64_t reclaimedBytes = 0; // freigegebener Speicher in Byte (laut Index)
+        uint64_t missingBytes = 0;   // noch fehlender Speicher für Speichergrenze und Wasserlinie in Byte
+        unsigned long busyMs = 0;    // Summe der Zeitscheiben in ms
+        unsigned long durationMs = 0; // Dauer vom Start bis zum Ende in ms
+        bool finished = false;       // true, wenn der Durchlauf abgeschlossen ist
+    };
+
+    /**
+     * @struct Stats
+     * @brief Stand für andere Tasks (siehe getStats()).
+     */
+    struct Stats {
+        Run run;                          // laufender bzw. zuletzt abgeschlossener Durchlauf
+        uint32_t runs = 0;                // abgeschlossene Durchläufe
+        uint64_t totalReclaimedBytes = 0; // freigegebener Speicher aller Durchläufe in Byte
+    };
+
+    /**
+     * @brief Löscht eine Bilddatei.
+     * Format: (path) -> true, wenn die Datei danach nicht mehr existiert
+     */
+    using RemoveFunction = std::function<bool(const char* path)>;
+
+    /**
+     * @brief Konstruktor.
+     * @param index Das Bilderverzeichnis.
+     * @param remove Löscht eine Bilddatei (wird bei gehaltenem SPI-Bus aufgerufen).
+     */
+    ImageRetention(ImageIndex& index, RemoveFunction remove);
+
+    /**
+     * @brief Legt fest, über welchen Arbiter der SPI-Bus für eine Zeitscheibe geholt wird.
+     * @param bus Arbiter für den SPI-Bus (nullptr = ohne Arbiter).
+     * @param device ID der SD-Karte beim Arbiter.
+     */
+    void begin(SpiBusArbiter* bus = nullptr, int device = SpiBusArbiter::NO_DEVICE);
+
+    /**
+     * @brief Beginnt einen neuen Durchlauf (ein laufender wird verworfen).
+     * @param policy Die Regeln.
+     * @param now Aktuelle Zeit (Unix-Zeit in Sekunden, 0 = unbekannt, dann gelten Höchstalter und Ausdünnen nicht).
+     * @param usedBytes Belegter Speicher auf der Karte in Byte (nur für die Wasserlinie).
+     * @param totalBytes Gesamter Speicher auf der Karte in Byte (0 = unbekannt, dann gilt die Wasserlinie nicht).
+     */
+    void start(const Policy& policy, uint32_t now, uint64_t usedBytes, uint64_t totalBytes);
+
+    /**
+     * @brief Arbeitet den Durchlauf eine Zeitscheibe lang ab.
+     * @param sliceMs Maximale Dauer in ms (ein einzelnes Bild wird immer fertig gelöscht).
+     * @param lockTimeoutMs Maximale Wartezeit auf den SPI-Bus in ms.
+     * @return true, wenn der Durchlauf abgeschlossen ist; false, wenn noch Arbeit übrig ist (oder der Bus belegt war).
+     */
+    bool step(unsigned long sliceMs, uint32_t lockTimeoutMs = UINT32_MAX);
+
+    /**
+     * @brief Gibt den laufenden bzw. zuletzt abgeschlossenen Durchlauf zurück.
+     * Nur für den Task, der start() und step() aufruft; andere Tasks lesen getStats().
+     */
+    const Run& getRun() const;
+
+    /**
+     * @brief Gibt eine konsistente Kopie von Durchlauf und Summen zurück.
+     * Darf aus jedem Task aufgerufen werden, auch während step() läuft (veröffentlicht wird nach jeder Zeitscheibe).
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Gibt die Anzahl der abgeschlossenen Durchläufe zurück.
+     */
+    uint32_t getRunCount() const;
+
+    /**
+     * @brief Gibt den insgesamt freigegebenen Speicher in Byte zurück (alle Durchläufe).
+     */
+    uint64_t getTotalReclaimedBytes() const;
+
+    /**
+     * @brief Berechnet den Speicher, der für Speichergrenze und Wasserlinie freigegeben werden muss.
+     * @param policy Die Regeln.
+     * @param imageBytes Speicher der Bilder in Byte (laut Index).
+     * @param usedBytes Belegter Speicher auf der Karte in Byte.
+     * @param totalBytes Gesamter Speicher auf der Karte in Byte (0 = unbekannt).
+     * @return Fehlender Speicher in Byte (0 = genug frei).
+     */
+    static uint64_t getMissingBytes(const Policy& policy, uint64_t imageBytes, uint64_t usedBytes, uint64_t totalBytes);
+
+private:
+    /**
+     * @brief Das Bild eines Tages, das beim Ausdünnen bisher behalten wird.
+     */
+    struct Candidate {
+        uint32_t position = ImageIndex::NO_CURSOR; // NO_CURSOR = kein Bild
+        int32_t day = 0;       // Tag (siehe dayOf())
+        uint32_t distance = 0; // Abstand zu 12 Uhr in Sekunden
+        uint32_t size = 0;
+        char path[ImageIndex::PATH_LENGTH] = {};
+    };
+
+    /**
+     * @brief Wendet die Regeln auf ein Bild an und löscht es gegebenenfalls.
+     * @return false, wenn keine Regel mehr greift und der Durchlauf enden kann.
+     */
+    bool apply(const ImageIndex::Entry& entry, uint32_t position);
+
+    /**
+     * @brief Ausdünnen: behält pro Tag das Bild, das am nächsten an 12 Uhr liegt, und löscht das andere.
+     */
+    void thin(const ImageIndex::Entry& entry, uint32_t position);
+
+    /**
+     * @brief Löscht ein Bild (Datei und Eintrag im Index) und zählt den freigegebenen Speicher.
+     * @return false, wenn sich die Datei nicht löschen ließ (gezählt in Run::failed).
+     */
+    bool removeImage(const char* path, uint32_t size, uint32_t position);
+
+    /**
+     * @brief Schließt den Durchlauf ab.
+     */
+    void finish();
+
+    /**
+     * @brief Veröffentlicht den Stand für getStats().
+     */
+    void publish();
+
+    /**
+     * @brief Gibt den Zeitpunkt zurück, der so viele Tage vor now liegt (0 = Regel aus oder Zeit unbekannt).
+     */
+    static uint32_t getCutoff(uint32_t now, uint16_t days);
+
+    /**
+     * @brief Gibt den Tag (Ortszeit) einer Aufnahmezeit als fortlaufende Zahl zurück.
+     * @param time Unix-Zeit in Sekunden.
+     * @param secondOfDay Ziel für die Sekunde des Tages (Ortszeit).
+     */
+    static int32_t dayOf(uint32_t time, uint32_t& secondOfDay);
+
+    ImageIndex& _index;
+    RemoveFunction _remove;
+    SpiBusArbiter* _bus = nullptr;
+    int _device = SpiBusArbiter::NO_DEVICE;
+
+    uint32_t _ageCutoff = 0;  // Bilder davor werden gelöscht (0 = aus)
+    uint32_t _thinCutoff = 0; // Bilder davor werden ausgedünnt (0 = aus)
+    uint64_t _missing = 0;    // noch freizugebender Speicher in Byte
+    uint32_t _cursor = ImageIndex::NO_CURSOR;
+    bool _atEnd = true;       // keine weiteren Einträge im Index
+    Candidate _candidate;
+    ImageIndex::Entry _batch[BATCH_ENTRIES];
+    uint32_t _positions[BATCH_ENTRIES] = {};
+    uint16_t _batchCount = 0;
+    uint16_t _batchIndex = 0;
+
+    Run _run;
+    unsigned long _startedAt = 0;
+    uint32_t _runs = 0;
+    uint64_t _totalReclaimed = 0;
+    Seqlock<Stats> _stats; // veröffentlichter Stand für andere Tasks
+};
@@ -0,0 +1,60 @@
+/**
+ * Beispiel zur Nutzung der ImageRetention-Bibliothek
+ *
+ * Legt im LittleFS einen Index mit 10 Tagen zu je 4 Bildern an (ohne echte Dateien) und räumt bei jeder Eingabe im
+ * Serial Monitor auf: Bilder älter als 8 Tage löschen, Tage älter als 5 Tage auf ein Bild ausdünnen.
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "ImageIndex.h"
+#include "ImageRetention.h"
+
+ImageIndex imageIndex(LittleFS, "/images.idx");
+ImageRetention retention(imageIndex, [](const char* path) {
+    Serial.printf("  lösche %s\n", path);
+    return true; // im Beispiel gibt es die Dateien nicht
+});
+
+constexpr uint32_t DAY = 86400;
+const uint32_t START = 1733356800; // 05.12.2024 0:00 UTC
+
+void setup() {
+    Serial.begin(115200);
+    if (!LittleFS.begin(true)) {
+        Serial.println("LittleFS konnte nicht eingebunden werden");
+        return;
+    }
+    imageIndex.begin();
+    imageIndex.clear();
+    char path[ImageIndex::PATH_LENGTH];
+    for (int day = 0; day < 10; day++) {
+        for (int hour = 0; hour < 24; hour += 6) {
+            snprintf(path, sizeof(path), "/img/day%d/%02d0000.jpg", day, hour);
+            imageIndex.add(path, START + day * DAY + hour * 3600, 50000);
+        }
+    }
+    Serial.printf("%u Bilder, %llu Byte\n", imageIndex.getCount(), imageIndex.getBytes());
+}
+
+void loop() {
+    if (Serial.available()) {
+        while (Serial.available()) {
+            Serial.read();
+        }
+        ImageRetention::Policy policy;
+        policy.maxAgeDays = 8;
+        policy.thinAfterDays = 5;
+        retention.start(policy, START + 10 * DAY, 0, 0);
+        int slices = 1;
+        while (!retention.step(5)) {
+            slices++;
+            delay(10);
+        }
+        const ImageRetention::Run& run = retention.getRun();
+        Serial.printf("%u geprüft, %u gelöscht, %llu Byte frei, %d Zeitscheiben, %lu ms\n",
+            run.checked, run.deleted, run.reclaimedBytes, slices, run.durationMs);
+        Serial.printf("Noch %u Bilder\n", imageIndex.getCount());
+    }
+    delay(100);
+}
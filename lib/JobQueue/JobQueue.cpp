@@ -0,0 +1,157 @@
+#include "JobQueue.h"
+
+bool JobQueue::begin(const char* name, const uint32_t stackSize, const UBaseType_t priority, const BaseType_t core) {
+    if (_queue) {
+        return true; // läuft bereits
+    }
+    _queue = xQueueCreate(MAX_JOBS, sizeof(uint8_t));
+    if (!_queue) {
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(workerTask, name, stackSize, this, priority, nullptr, core) != pdPASS) {
+        vQueueDelete(_queue);
+        _queue = nullptr;
+        return false;
+    }
+    return true;
+}
+
+uint32_t JobQueue::submit(const char* name, const uint32_t owner, Work work) {
+    if (!_queue || !work) {
+        return 0;
+    }
+
+    // Platz reservieren (die Arbeit wird erst danach übernommen, da das Kopieren allokieren kann)
+    int index = -1;
+    uint32_t id = 0;
+    portENTER_CRITICAL(&_mux);
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (_slots[i].job.id == 0) {
+            index = i;
+            id = ++_nextId;
+            if (id == 0) {
+                id = ++_nextId; // 0 steht für "frei"
+            }
+            _slots[i].job.id = id;
+            _slots[i].job.name = name;
+            break;
+        }
+    }
+    if (index < 0) {
+        _rejected++;
+    }
+    portEXIT_CRITICAL(&_mux);
+    if (index < 0) {
+        return 0;
+    }
+
+    Slot& slot = _slots[index];
+    slot.job.owner = owner;
+    slot.job.state = State::Queued;
+    slot.job.done = 0;
+    slot.job.total = 0;
+    slot.job.queuedAt = millis();
+    slot.job.startedAt = 0;
+    slot.job.finishedAt = 0;
+    slot.work = std::move(work);
+    notify(slot.job); // vor dem Einreihen, damit "queued" sicher vor "running" gemeldet wird
+
+    // Die Warteschlange ist so groß wie die Anzahl der Plätze und kann daher nicht voll sein
+    const auto item = static_cast<uint8_t>(index);
+    xQueueSend(_queue, &item, 0);
+    return id;
+}
+
+uint32_t JobQueue::findPending(const char* name) {
+    uint32_t id = 0;
+    portENTER_CRITICAL(&_mux);
+    for (const Slot& slot : _slots) {
+        if (slot.job.id != 0 && slot.job.name && strcmp(slot.job.name, name) == 0) {
+            id = slot.job.id;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+    return id;
+}
+
+uint8_t JobQueue::getPendingCount() {
+    uint8_t count = 0;
+    portENTER_CRITICAL(&_mux);
+    for (const Slot& slot : _slots) {
+        if (slot.job.id != 0) {
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+    return count;
+}
+
+uint32_t JobQueue::getFinishedCount() const {
+    return _finished;
+}
+
+uint32_t JobQueue::getFailedCount() const {
+    return _failed;
+}
+
+uint32_t JobQueue::getRejectedCount() const {
+    return _rejected;
+}
+
+unsigned long JobQueue::getMaxRunTime() const {
+    return _maxRunTime;
+}
+
+void JobQueue::workerTask(void* parameter) {
+    auto* self = static_cast<JobQueue*>(parameter);
+    uint8_t index = 0;
+    while (true) {
+        if (xQueueReceive(self->_queue, &index, portMAX_DELAY) == pdTRUE && index < MAX_JOBS) {
+            self->run(self->_slots[index]);
+        }
+    }
+}
+
+void JobQueue::run(Slot& slot) {
+    Job& job = slot.job;
+    job.state = State::Running;
+    job.startedAt = millis();
+    notify(job);
+
+    // Fortschritt höchstens alle PROGRESS_INTERVAL ms melden (der letzte Schritt wird mit "done" gemeldet)
+    unsigned long lastProgress = job.startedAt;
+    const bool success = slot.work([this, &job, &lastProgress](const uint32_t done, const uint32_t total) {
+        job.done = done;
+        job.total = total;
+        const unsigned long now = millis();
+        if (now - lastProgress >= PROGRESS_INTERVAL) {
+            lastProgress = now;
+            notify(job);
+        }
+    });
+
+    job.state = success ? State::Done : State::Failed;
+    job.finishedAt = millis();
+    const unsigned long runTime = job.finishedAt - job.startedAt;
+    if (runTime > _maxRunTime) {
+        _maxRunTime = runTime;
+    }
+    _finished++;
+    if (!success) {
+        _failed++;
+    }
+    notify(job);
+
+    // Arbeit (inkl. gebundener Daten) freigeben, bevor der Platz wieder vergeben werden kann
+    slot.work = nullptr;
+    portENTER_CRITICAL(&_mux);
+    job.id = 0;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void JobQueue::notify(const Job& job) const {
+    if (onEvent) {
+        onEvent(job);
+    }
+}
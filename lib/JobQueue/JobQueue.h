@@ -0,0 +1,154 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <functional>
+
+/**
+ * Warteschlange für langsame Aufträge, die ein eigener Worker-Task nacheinander abarbeitet.
+ *
+ * Gedacht für Befehle aus dem Webinterface, die zu lange für den AsyncTCP-Task dauern (z.B. SD-Karte durchsuchen oder
+ * leeren). submit() kehrt sofort mit einer Auftragsnummer zurück, die Arbeit erledigt der Worker-Task. Über den
+ * Callback onEvent wird jeder Zustandswechsel gemeldet (eingereiht, gestartet, Fortschritt, fertig, fehlgeschlagen).
+ *
+ * Die Plätze für Aufträge sind fest reserviert (MAX_JOBS). Ist kein Platz frei, wird der Auftrag abgelehnt.
+ */
+class JobQueue {
+public:
+    static constexpr uint8_t MAX_JOBS = 8; // Maximale Anzahl eingereihter (und laufender) Aufträge
+    static constexpr unsigned long PROGRESS_INTERVAL = 250; // Mindestabstand in ms zwischen zwei Fortschrittsmeldungen
+
+    /**
+     * @enum State
+     * @brief Zustand eines Auftrags.
+     */
+    enum class State : uint8_t {
+        Queued,  // Wartet auf den Worker-Task
+        Running, // Wird gerade ausgeführt
+        Done,    // Erfolgreich abgeschlossen
+        Failed   // Fehlgeschlagen
+    };
+
+    /**
+     * @struct Job
+     * @brief Beschreibung eines Auftrags, wie sie an onEvent übergeben wird.
+     */
+    struct Job {
+        uint32_t id = 0;             // Auftragsnummer (0 = Platz frei)
+        const char* name = "";       // Name des Auftrags (z.B. "deleteAllImages"), wird nicht kopiert
+        uint32_t owner = 0;          // Frei verwendbar, z.B. die ID des WebSocket-Clients
+        State state = State::Queued; // Aktueller Zustand
+        uint32_t done = 0;           // Fortschritt: erledigte Schritte
+        uint32_t total = 0;          // Fortschritt: Schritte insgesamt (0 = unbekannt)
+        unsigned long queuedAt = 0;  // millis() beim Einreihen
+        unsigned long startedAt = 0; // millis() beim Start
+        unsigned long finishedAt = 0; // millis() beim Abschluss
+    };
+
+    /**
+     * @brief Meldet den Fortschritt eines laufenden Auftrags.
+     * Format: (done, total) -> void
+     */
+    using Progress = std::function<void(uint32_t done, uint32_t total)>;
+
+    /**
+     * @brief Die eigentliche Arbeit eines Auftrags, läuft im Worker-Task.
+     * Format: (progress) -> true bei Erfolg, false bei Fehler
+     */
+    using Work = std::function<bool(const Progress& progress)>;
+
+    /**
+     * @brief Callback für Zustandswechsel und Fortschritt.
+     * Format: (job) -> void
+     */
+    using EventCallback = std::function<void(const Job& job)>;
+
+    /**
+     * @brief Wird bei jedem Zustandswechsel und (gedrosselt) bei Fortschritt aufgerufen.
+     * Läuft im Worker-Task, beim Einreihen im Task des Aufrufers von submit().
+     */
+    EventCallback onEvent;
+
+    /**
+     * @brief Legt die Warteschlange an und startet den Worker-Task.
+     * @param name Name des Tasks.
+     * @param stackSize Stackgröße des Tasks in Byte.
+     * @param priority Priorität des Tasks.
+     * @param core Kern, auf dem der Task läuft.
+     * @return true bei Erfolg, false wenn Warteschlange oder Task nicht angelegt werden konnten.
+     */
+    bool begin(const char* name, uint32_t stackSize, UBaseType_t priority, BaseType_t core);
+
+    /**
+     * @brief Reiht einen Auftrag ein (kehrt sofort zurück).
+     * @param name Name des Auftrags, wird nicht kopiert.
+     * @param owner Frei verwendbar (z.B. ID des Clients, der das Ergebnis bekommt).
+     * @param work Die Arbeit.
+     * @return Auftragsnummer, oder 0, wenn kein Platz frei ist.
+     */
+    uint32_t submit(const char* name, uint32_t owner, Work work);
+
+    /**
+     * @brief Sucht einen eingereihten oder laufenden Auftrag mit diesem Namen.
+     * @return Auftragsnummer, oder 0, wenn es keinen gibt.
+     */
+    uint32_t findPending(const char* name);
+
+    /**
+     * @brief Gibt die Anzahl der eingereihten und laufenden Aufträge zurück.
+     */
+    uint8_t getPendingCount();
+
+    /**
+     * @brief Gibt die Anzahl der abgeschlossenen Aufträge zurück (erfolgreich oder nicht).
+     */
+    uint32_t getFinishedCount() const;
+
+    /**
+     * @brief Gibt die Anzahl der fehlgeschlagenen Aufträge zurück.
+     */
+    uint32_t getFailedCount() const;
+
+    /**
+     * @brief Gibt die Anzahl der abgelehnten Aufträge zurück (kein Platz frei).
+     */
+    uint32_t getRejectedCount() const;
+
+    /**
+     * @brief Gibt die längste Laufzeit eines Auftrags in ms zurück.
+     */
+    unsigned long getMaxRunTime() const;
+
+private:
+    struct Slot {
+        Job job;
+        Work work;
+    };
+
+    /**
+     * @brief Einstiegspunkt des Worker-Tasks.
+     * @param parameter Zeiger auf die JobQueue.
+     */
+    static void workerTask(void* parameter);
+
+    /**
+     * @brief Führt einen Auftrag aus und gibt danach seinen Platz frei.
+     * @param slot Der Auftrag.
+     */
+    void run(Slot& slot);
+
+    /**
+     * @brief Ruft onEvent mit einer Kopie des Auftrags auf.
+     */
+    void notify(const Job& job) const;
+
+    Slot _slots[MAX_JOBS];
+    QueueHandle_t _queue = nullptr; // Indizes der eingereihten Plätze in _slots
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED; // schützt die Belegung der Plätze und _nextId
+    uint32_t _nextId = 0;
+    uint32_t _finished = 0;
+    uint32_t _failed = 0;
+    uint32_t _rejected = 0;
+    unsigned long _maxRunTime = 0;
+};
@@ -0,0 +1,51 @@
+/**
+ * Beispiel zur Nutzung der JobQueue-Bibliothek
+ *
+ * Jede Eingabe im Serial Monitor startet einen Auftrag, der 2 Sekunden lang "arbeitet". loop() blinkt währenddessen
+ * ungestört weiter, die Zustände der Aufträge erscheinen im Serial Monitor.
+ */
+
+#include <Arduino.h>
+#include "JobQueue.h"
+
+JobQueue jobs;
+
+void printEvent(const JobQueue::Job& job) {
+    static const char* const STATES[] = {"eingereiht", "gestartet", "fertig", "fehlgeschlagen"};
+    Serial.printf("Auftrag %u (%s): %s", job.id, job.name, STATES[static_cast<uint8_t>(job.state)]);
+    if (job.total > 0) {
+        Serial.printf(" %u/%u", job.done, job.total);
+    }
+    Serial.println();
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(LED_BUILTIN, OUTPUT);
+
+    jobs.onEvent = printEvent;
+    if (!jobs.begin("jobs", 4096, 1, 0)) {
+        Serial.println("JobQueue konnte nicht gestartet werden");
+    }
+}
+
+void loop() {
+    if (Serial.available()) {
+        while (Serial.available()) {
+            Serial.read();
+        }
+        const uint32_t id = jobs.submit("demo", 0, [](const JobQueue::Progress& progress) {
+            for (uint32_t i = 1; i <= 20; i++) {
+                vTaskDelay(pdMS_TO_TICKS(100));
+                progress(i, 20);
+            }
+            return true;
+        });
+        if (id == 0) {
+            Serial.println("Warteschlange voll");
+        }
+    }
+
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+    delay(250);
+}
@@ -0,0 +1,131 @@
+#include "JsonArena.h"
+#include <esp_heap_caps.h>
+
+JsonArena::JsonArena()
+    : _memory(nullptr), _capacity(0), _used(0), _last(NO_BLOCK), _highWaterMark(0), _failed(0), _inUse(false) {}
+
+JsonArena::~JsonArena() {
+    heap_caps_free(_memory);
+}
+
+bool JsonArena::begin(const size_t capacity) {
+    if (_memory) {
+        return true;
+    }
+    _memory = static_cast<uint8_t*>(heap_caps_malloc(align(capacity), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    if (!_memory) {
+        return false;
+    }
+    _capacity = align(capacity);
+    reset();
+    return true;
+}
+
+bool JsonArena::tryAcquire() {
+    bool expected = false;
+    return _memory && _inUse.compare_exchange_strong(expected, true);
+}
+
+void JsonArena::release() {
+    reset();
+    _inUse = false;
+}
+
+void JsonArena::reset() {
+    _used = 0;
+    _last = NO_BLOCK;
+}
+
+void* JsonArena::allocate(const size_t size) {
+    const size_t needed = ALIGNMENT + align(size); // Kopf + Block
+    if (!_memory || needed > _capacity - _used) {
+        _failed++;
+        return nullptr;
+    }
+    _last = _used;
+    _used += needed;
+    if (_used > _highWaterMark) {
+        _highWaterMark = _used;
+    }
+    void* pointer = _memory + _last + ALIGNMENT;
+    sizeOf(pointer) = align(size);
+    return pointer;
+}
+
+void JsonArena::deallocate(void* pointer) {
+    // Nur der letzte Block kann zurückgegeben werden, alle anderen bleiben bis reset() belegt
+    if (pointer && _last != NO_BLOCK && pointer == _memory + _last + ALIGNMENT) {
+        _used = _last;
+        _last = NO_BLOCK;
+    }
+}
+
+void* JsonArena::reallocate(void* pointer, const size_t newSize) {
+    if (!pointer) {
+        return allocate(newSize);
+    }
+    const size_t oldSize = sizeOf(pointer);
+    const size_t alignedSize = align(newSize);
+
+    // Letzter Block: an Ort und Stelle wachsen oder schrumpfen
+    if (_last != NO_BLOCK && pointer == _memory + _last + ALIGNMENT) {
+        if (alignedSize > _capacity - _last - ALIGNMENT) {
+            _failed++;
+            return nullptr; // der alte Block bleibt gültig
+        }
+        sizeOf(pointer) = alignedSize;
+        _used = _last + ALIGNMENT + alignedSize;
+        if (_used > _highWaterMark) {
+            _highWaterMark = _used;
+        }
+        return pointer;
+    }
+
+    // Anderer Block: Schrumpfen geht immer, Wachsen nur per Kopie
+    if (alignedSize <= oldSize) {
+        return pointer;
+    }
+    void* moved = allocate(newSize);
+    if (moved) {
+        memcpy(moved, pointer, oldSize);
+    }
+    return moved;
+}
+
+ArduinoJson::Allocator* JsonArena::heap() {
+    /**
+     * Speicher vom Heap (malloc/free), wie bei einem JsonDocument ohne eigenen Allocator.
+     */
+    class HeapAllocator : public ArduinoJson::Allocator {
+    public:
+        void* allocate(const size_t size) override { return malloc(size); }
+        void deallocate(void* pointer) override { free(pointer); }
+        void* reallocate(void* pointer, const size_t newSize) override { return realloc(pointer, newSize); }
+    };
+    static HeapAllocator allocator;
+    return &allocator;
+}
+
+size_t JsonArena::getCapacity() const {
+    return _capacity;
+}
+
+size_t JsonArena::getUsed() const {
+    return _used;
+}
+
+size_t JsonArena::getHighWaterMark() const {
+    return _highWaterMark;
+}
+
+uint32_t JsonArena::getFailedCount() const {
+    return _failed;
+}
+
+size_t JsonArena::align(const size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+size_t& JsonArena::sizeOf(void* pointer) {
+    return *reinterpret_cast<size_t*>(static_cast<uint8_t*>(pointer) - ALIGNMENT);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+/**
+ * Speicher mit fester Größe für ein JsonDocument (Arena).
+ *
+ * Ein JsonDocument holt sich seinen Speicher normalerweise in vielen kleinen Stücken vom Heap. Bei einem Broadcast
+ * alle zwei Sekunden zerstückelt das auf Dauer den Heap. Die Arena reserviert ihren Speicher einmal in begin() und
+ * vergibt ihn danach nur noch fortlaufend ("bump allocator"). Freigegeben wird alles auf einmal mit reset().
+ *
+ * Mehrere Arenen bilden einen Pool: tryAcquire() reserviert eine freie Arena für ein Dokument, release() gibt sie
+ * wieder frei (und setzt sie zurück).
+ *
+ * ```cpp
+ * JsonArena arena;
+ * arena.begin(4096);
+ * if (arena.tryAcquire()) {
+ *     {
+ *         JsonDocument doc(&arena);
+ *         doc["type"] = "state";
+ *         serializeJson(doc, Serial);
+ *     }
+ *     arena.release();
+ * }
+ * ```
+ */
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    static constexpr size_t ALIGNMENT = 8; // Ausrichtung jedes Blocks (und Größe des Blockkopfs) in Byte
+
+    JsonArena();
+    ~JsonArena();
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    /**
+     * @brief Reserviert den Speicher (im internen RAM, die Arena wird bei jedem Broadcast benutzt).
+     * @param capacity Größe in Byte.
+     * @return true bei Erfolg.
+     */
+    bool begin(size_t capacity);
+
+    /**
+     * @brief Reserviert die Arena für ein Dokument.
+     * @return false, wenn sie bereits vergeben ist (oder begin() nicht erfolgreich war).
+     */
+    bool tryAcquire();
+
+    /**
+     * @brief Gibt die Arena wieder frei und setzt sie zurück.
+     * Das Dokument, das die Arena benutzt hat, muss vorher zerstört (oder geleert) worden sein.
+     */
+    void release();
+
+    /**
+     * @brief Verwirft alle Blöcke auf einmal.
+     */
+    void reset();
+
+    // --- ArduinoJson::Allocator ---
+
+    /**
+     * @brief Vergibt einen Block.
+     * @return nullptr, wenn die Arena voll ist (das JsonDocument meldet dann overflowed()).
+     */
+    void* allocate(size_t size) override;
+
+    /**
+     * @brief Gibt einen Block frei. Nur der zuletzt vergebene Block wird tatsächlich zurückgegeben, alle anderen erst
+     * mit reset().
+     */
+    void deallocate(void* pointer) override;
+
+    /**
+     * @brief Ändert die Größe eines Blocks. Der zuletzt vergebene Block wächst an Ort und Stelle, alle anderen werden
+     * umkopiert.
+     */
+    void* reallocate(void* pointer, size_t newSize) override;
+
+    /**
+     * @brief Gibt einen Allocator zurück, der wie ein normales JsonDocument den Heap benutzt.
+     * Ersatz, wenn keine Arena frei ist: JsonDocument doc(arena.tryAcquire() ? &arena : JsonArena::heap());
+     */
+    static ArduinoJson::Allocator* heap();
+
+    /**
+     * @brief Gibt die Größe der Arena in Byte zurück.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Gibt den belegten Speicher in Byte zurück.
+     */
+    size_t getUsed() const;
+
+    /**
+     * @brief Gibt den höchsten belegten Speicher in Byte seit dem Start zurück.
+     */
+    size_t getHighWaterMark() const;
+
+    /**
+     * @brief Gibt zurück, wie oft eine Anforderung nicht erfüllt werden konnte (Arena voll).
+     */
+    uint32_t getFailedCount() const;
+
+private:
+    static constexpr size_t NO_BLOCK = SIZE_MAX;
+
+    /**
+     * @brief Rundet auf ein Vielfaches von ALIGNMENT auf.
+     */
+    static size_t align(size_t size);
+
+    /**
+     * @brief Gibt die Größe eines Blocks zurück (steht im Kopf vor dem Block).
+     */
+    static size_t& sizeOf(void* pointer);
+
+    uint8_t* _memory;             // Speicher der Arena
+    size_t _capacity;             // Größe in Byte
+    size_t _used;                 // Belegte Bytes (Kopf des nächsten Blocks)
+    size_t _last;                 // Offset des Kopfs des zuletzt vergebenen Blocks (NO_BLOCK = keiner)
+    size_t _highWaterMark;        // Höchster Wert von _used
+    uint32_t _failed;             // Anforderungen, die nicht erfüllt werden konnten
+    std::atomic<bool> _inUse;     // Für ein Dokument vergeben
+};
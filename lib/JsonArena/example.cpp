@@ -0,0 +1,39 @@
+/**
+ * Beispiel zur Nutzung der JsonArena-Bibliothek
+ *
+ * Erstellt jede Sekunde eine JSON-Nachricht in der Arena und gibt sie zusammen mit dem freien Heap aus. Der freie
+ * Heap bleibt dabei konstant.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "JsonArena.h"
+
+JsonArena arena;
+
+void setup() {
+    Serial.begin(115200);
+    if (!arena.begin(2048)) {
+        Serial.println("Zu wenig Speicher.");
+    }
+}
+
+void loop() {
+    if (arena.tryAcquire()) {
+        {
+            JsonDocument doc(&arena);
+            doc["type"] = "state";
+            doc["payload"]["uptime"] = millis();
+            doc["payload"]["freeHeap"] = ESP.getFreeHeap();
+            serializeJson(doc, Serial);
+            Serial.println();
+
+            if (doc.overflowed()) {
+                Serial.println("Arena zu klein!");
+            }
+        }
+        arena.release();
+    }
+    Serial.printf("Belegt: max. %u von %u Byte\n", arena.getHighWaterMark(), arena.getCapacity());
+    delay(1000);
+}
@@ -1,4 +1,5 @@
 #include "LED.h"
+#include "Hal.h"
 
 LED::LED(uint8_t pin, bool activeHigh)
   : _pin(pin),
@@ -10,20 +11,20 @@ LED::LED(uint8_t pin, bool activeHigh)
     _blinking(false) {}
 
 void LED::begin() {
-    pinMode(_pin, OUTPUT);
+    Hal::get().pinMode(_pin, OUTPUT);
     off();
 }
 
 void LED::on() {
     _state = true;
     _blinking = false;
-    digitalWrite(_pin, _activeHigh ? HIGH : LOW);
+    Hal::get().digitalWrite(_pin, _activeHigh ? HIGH : LOW);
 }
 
 void LED::off() {
     _state = false;
     _blinking = false;
-    digitalWrite(_pin, _activeHigh ? LOW : HIGH);
+    Hal::get().digitalWrite(_pin, _activeHigh ? LOW : HIGH);
 }
 
 void LED::toggle() {
@@ -31,7 +32,7 @@ void LED::toggle() {
     else on();
 }
 
-void LED::blink(unsigned long onMs, unsigned long offMs) {
+void LED::blink(uint32_t onMs, uint32_t offMs) {
     _onMs = onMs;
     _offMs = offMs;
     if (_onMs == 0 && _offMs == 0) {
@@ -41,20 +42,20 @@ void LED::blink(unsigned long onMs, unsigned long offMs) {
     _blinking = true;
     // Start mit Einschalten
     _state = true;
-    digitalWrite(_pin, _activeHigh ? HIGH : LOW);
-    _lastToggle = millis();
+    Hal::get().digitalWrite(_pin, _activeHigh ? HIGH : LOW);
+    _lastToggle = Hal::get().millis();
 }
 
 void LED::update() {
     if (!_blinking) return;
 
-    unsigned long now = millis();
+    const uint32_t now = Hal::get().millis();
     if (_state) {
         // aktuell ein, prüfen ob onMs abgelaufen
         if (_onMs > 0 && (now - _lastToggle >= _onMs)) {
             // schalte aus
             _state = false;
-            digitalWrite(_pin, _activeHigh ? LOW : HIGH);
+            Hal::get().digitalWrite(_pin, _activeHigh ? LOW : HIGH);
             _lastToggle = now;
         }
     } else {
@@ -62,7 +63,7 @@ void LED::update() {
         if (_offMs > 0 && (now - _lastToggle >= _offMs)) {
             // schalte ein
             _state = true;
-            digitalWrite(_pin, _activeHigh ? HIGH : LOW);
+            Hal::get().digitalWrite(_pin, _activeHigh ? HIGH : LOW);
             _lastToggle = now;
         }
     }
@@ -34,7 +34,7 @@ public:
      * @param offMs Ausschaltzeit in Millisekunden.
      * Wenn onMs==0 und offMs==0 wird Blinken deaktiviert.
      */
-    void blink(unsigned long onMs, unsigned long offMs);
+    void blink(uint32_t onMs, uint32_t offMs);
 
     /**
      * Muss regelmäßig in loop() aufgerufen werden, um Blink-Transitions auszuführen.
@@ -49,8 +49,8 @@ private:
     uint8_t _pin;
     bool _activeHigh;
     bool _state;               // aktueller logischer Zustand (true=>LED leuchtet)
-    unsigned long _onMs;       // Blink: Einschaltzeit
-    unsigned long _offMs;      // Blink: Ausschaltzeit
-    unsigned long _lastToggle; // Timestamp der letzten Umschaltung
+    uint32_t _onMs;       // Blink: Einschaltzeit
+    uint32_t _offMs;      // Blink: Ausschaltzeit
+    uint32_t _lastToggle; // Timestamp der letzten Umschaltung (millis())
     bool _blinking;
 };
@@ -0,0 +1,175 @@
+#include "MetricsWriter.h"
+#include <cmath>
+#include <cstdarg>
+
+// Typnamen in der Zeile "# TYPE"
+static const char* const TYPE_NAMES[] = {"gauge", "counter", "histogram"};
+
+void MetricsWriter::Sample::label(const char* name, const char* value) {
+    if (labelCount >= MAX_LABELS) {
+        return;
+    }
+    Label& entry = labels[labelCount++];
+    entry.name = name;
+    strncpy(entry.value, value, LABEL_VALUE_SIZE - 1);
+    entry.value[LABEL_VALUE_SIZE - 1] = '\0';
+}
+
+void MetricsWriter::Sample::label(const char* name, const double value) {
+    if (labelCount >= MAX_LABELS) {
+        return;
+    }
+    Label& entry = labels[labelCount++];
+    entry.name = name;
+    formatValue(entry.value, LABEL_VALUE_SIZE, value);
+}
+
+MetricsWriter::MetricsWriter(const Family* families, const uint8_t count, SampleFunction samples)
+    : _families(families), _count(count), _samples(std::move(samples)) {
+    rewind();
+}
+
+size_t MetricsWriter::fill(uint8_t* buffer, const size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (_lineOffset >= _lineLength && !nextLine()) {
+            break; // Text vollständig
+        }
+        const size_t available = _lineLength - _lineOffset;
+        const size_t length = available < maxLen - written ? available : maxLen - written;
+        memcpy(buffer + written, _line + _lineOffset, length);
+        _lineOffset += length;
+        written += length;
+    }
+    return written;
+}
+
+bool MetricsWriter::isDone() const {
+    return _phase == Phase::Done && _lineOffset >= _lineLength;
+}
+
+void MetricsWriter::rewind() {
+    _phase = _count > 0 ? Phase::TypeLine : Phase::Eof;
+    _family = 0;
+    _index = 0;
+    _lineLength = 0;
+    _lineOffset = 0;
+}
+
+int MetricsWriter::formatValue(char* buffer, const size_t size, const double value) {
+    if (std::isnan(value)) {
+        return snprintf(buffer, size, "NaN");
+    }
+    if (std::isinf(value)) {
+        return snprintf(buffer, size, value > 0 ? "+Inf" : "-Inf");
+    }
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        return snprintf(buffer, size, "%.0f", value); // Zähler und Byte-Angaben ohne Exponent
+    }
+    return snprintf(buffer, size, "%.10g", value);
+}
+
+bool MetricsWriter::nextLine() {
+    _lineLength = 0;
+    _lineOffset = 0;
+    while (true) {
+        const Family* family = _family < _count ? &_families[_family] : nullptr; // gesetzt bis einschließlich Samples
+        switch (_phase) {
+            case Phase::TypeLine:
+                _phase = Phase::UnitLine;
+                if (append("# TYPE %s %s\n", family->name, TYPE_NAMES[static_cast<uint8_t>(family->type)])) {
+                    return true;
+                }
+                break;
+            case Phase::UnitLine:
+                _phase = Phase::HelpLine;
+                if (family->unit && append("# UNIT %s %s\n", family->name, family->unit)) {
+                    return true;
+                }
+                break;
+            case Phase::HelpLine:
+                _phase = Phase::Samples;
+                _index = 0;
+                if (family->help && append("# HELP %s ", family->name) && appendEscaped(family->help) && append("\n")) {
+                    return true;
+                }
+                break;
+            case Phase::Samples:
+                if (sampleLine()) {
+                    return true;
+                }
+                // Familie fertig, weiter mit der nächsten
+                _family++;
+                _phase = _family < _count ? Phase::TypeLine : Phase::Eof;
+                break;
+            case Phase::Eof:
+                _phase = Phase::Done;
+                append("# EOF\n");
+                return true;
+            case Phase::Done:
+                return false;
+        }
+        _lineLength = 0; // Zeile ausgelassen (zu lang oder ohne Inhalt)
+    }
+}
+
+bool MetricsWriter::sampleLine() {
+    const Family& family = _families[_family];
+    while (true) {
+        Sample sample;
+        if (!_samples(_family, _index++, sample)) {
+            return false;
+        }
+        if (sample.omit) {
+            continue;
+        }
+
+        _lineLength = 0;
+        const char* suffix = family.type == Type::Counter ? "_total" : sample.suffix;
+        bool complete = append("%s%s", family.name, suffix ? suffix : "");
+        for (uint8_t i = 0; complete && i < sample.labelCount; i++) {
+            complete = append(i == 0 ? "{%s=\"" : ",%s=\"", sample.labels[i].name) &&
+                       appendEscaped(sample.labels[i].value) && append("\"");
+        }
+        if (complete && sample.labelCount > 0) {
+            complete = append("}");
+        }
+        char value[32];
+        formatValue(value, sizeof(value), sample.value);
+        if (complete && append(" %s\n", value)) {
+            return true;
+        }
+        // Zeile passt nicht in LINE_SIZE: lieber auslassen als abgeschnitten senden
+    }
+}
+
+bool MetricsWriter::appendEscaped(const char* text) {
+    for (const char* c = text; *c; c++) {
+        const char* escaped = nullptr;
+        switch (*c) {
+            case '\\': escaped = "\\\\"; break;
+            case '"': escaped = "\\\""; break;
+            case '\n': escaped = "\\n"; break;
+            default: break;
+        }
+        const size_t length = escaped ? 2 : 1;
+        if (_lineLength + length >= LINE_SIZE) {
+            return false;
+        }
+        memcpy(_line + _lineLength, escaped ? escaped : c, length);
+        _lineLength += length;
+    }
+    return true;
+}
+
+bool MetricsWriter::append(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(_line + _lineLength, LINE_SIZE - _lineLength, format, args);
+    va_end(args);
+    if (length < 0 || _lineLength + length >= LINE_SIZE) {
+        return false;
+    }
+    _lineLength += length;
+    return true;
+}
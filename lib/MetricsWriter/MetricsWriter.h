@@ -0,0 +1,157 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+/**
+ * Erzeugt Kennzahlen im Text-Format von OpenMetrics (Prometheus) Stück für Stück, z.B. für eine Chunked-Antwort.
+ *
+ * Die Kennzahlen sind in Familien (Family) eingeteilt: Name, Typ, Einheit und Beschreibung stehen in einer festen
+ * Tabelle, die Werte liefert eine Callback-Funktion je Familie und laufender Nummer (Sample). fill() schreibt immer
+ * nur so viele Zeilen in den Puffer, wie hineinpassen, und macht beim nächsten Aufruf an derselben Stelle weiter:
+ *
+ *     const MetricsWriter::Family FAMILIES[] = {
+ *         {"demo_temperature_celsius", MetricsWriter::Type::Gauge, "celsius", "Temperatur"},
+ *     };
+ *     MetricsWriter writer(FAMILIES, 1, [](uint8_t family, uint16_t index, MetricsWriter::Sample& sample) {
+ *         if (index > 0) return false; // keine weiteren Werte
+ *         sample.value = 21.5;
+ *         return true;
+ *     });
+ *     size_t length;
+ *     while ((length = writer.fill(buffer, sizeof(buffer))) > 0) { ... }
+ *
+ * Es wird nie Speicher reserviert: Eine Zeile entsteht in einem festen Puffer (LINE_SIZE), der ganze Text existiert
+ * nie am Stück. Am Ende steht "# EOF".
+ */
+class MetricsWriter {
+public:
+    static constexpr uint8_t MAX_LABELS = 3;        // Maximale Anzahl Labels pro Wert
+    static constexpr uint8_t LABEL_VALUE_SIZE = 24; // Platz für den Wert eines Labels (inkl. Nullterminator)
+    static constexpr size_t LINE_SIZE = 256;        // Platz für eine Zeile; längere Zeilen werden ausgelassen
+
+    /**
+     * @enum Type
+     * @brief Typ einer Familie.
+     */
+    enum class Type : uint8_t {
+        Gauge,    // Momentanwert
+        Counter,  // steigt nur (der Wert heißt <name>_total)
+        Histogram // Werte <name>_bucket{le="..."}, <name>_sum und <name>_count
+    };
+
+    /**
+     * @struct Family
+     * @brief Beschreibung einer Familie. Die Zeichenketten werden nicht kopiert.
+     */
+    struct Family {
+        const char* name; // Name ohne Suffix (bei Zählern ohne "_total"), muss mit der Einheit enden
+        Type type;
+        const char* unit; // Einheit (z.B. "seconds"), nullptr = ohne
+        const char* help; // Beschreibung
+    };
+
+    /**
+     * @struct Sample
+     * @brief Ein einzelner Wert einer Familie mit seinen Labels.
+     */
+    struct Sample {
+        const char* suffix = ""; // wird an den Namen angehängt, z.B. "_bucket" (bei Zählern automatisch "_total")
+        double value = 0;        // NAN und ±INFINITY sind erlaubt
+        bool omit = false;       // true: Wert auslassen (z.B. weil er gerade nicht gelesen werden konnte)
+
+        /**
+         * @brief Fügt ein Label hinzu (weitere als MAX_LABELS werden ignoriert).
+         * @param name Name des Labels, wird nicht kopiert.
+         * @param value Wert, wird kopiert (höchstens LABEL_VALUE_SIZE - 1 Zeichen).
+         */
+        void label(const char* name, const char* value);
+
+        /** @brief Fügt ein Label mit einer Zahl als Wert hinzu (z.B. "le" im Histogramm, formatiert wie die Werte). */
+        void label(const char* name, double value);
+
+        struct Label {
+            const char* name;
+            char value[LABEL_VALUE_SIZE];
+        };
+        Label labels[MAX_LABELS];
+        uint8_t labelCount = 0;
+    };
+
+    /**
+     * @brief Liefert einen Wert einer Familie.
+     * Format: (Familie, laufende Nummer ab 0, Ziel) -> false, wenn die Familie keine weiteren Werte hat
+     * Mit sample.omit = true entfällt ein einzelner Wert, die Familie geht danach mit der nächsten Nummer weiter.
+     */
+    using SampleFunction = std::function<bool(uint8_t family, uint16_t index, Sample& sample)>;
+
+    /**
+     * @brief Konstruktor.
+     * @param families Tabelle der Familien (wird nicht kopiert).
+     * @param count Anzahl der Familien.
+     * @param samples Liefert die Werte.
+     */
+    MetricsWriter(const Family* families, uint8_t count, SampleFunction samples);
+
+    /**
+     * @brief Schreibt die nächsten Zeichen des Texts.
+     * @param buffer Ziel.
+     * @param maxLen Platz im Ziel.
+     * @return Anzahl geschriebener Zeichen; 0, wenn der Text vollständig ist.
+     */
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+    /** @brief Gibt an, ob der Text vollständig geschrieben wurde. */
+    bool isDone() const;
+
+    /** @brief Beginnt wieder am Anfang (z.B. für die nächste Abfrage mit neuen Werten). */
+    void rewind();
+
+    /**
+     * @brief Schreibt einen Wert im Format von OpenMetrics ("NaN", "+Inf", ganze Zahlen ohne Nachkommastellen).
+     * @return Länge wie bei snprintf().
+     */
+    static int formatValue(char* buffer, size_t size, double value);
+
+private:
+    /**
+     * @enum Phase
+     * @brief Nächste Zeile, die erzeugt wird.
+     */
+    enum class Phase : uint8_t { TypeLine, UnitLine, HelpLine, Samples, Eof, Done };
+
+    /**
+     * @brief Erzeugt die nächste Zeile in _line.
+     * @return false, wenn der Text vollständig ist.
+     */
+    bool nextLine();
+
+    /**
+     * @brief Erzeugt die Zeile für den nächsten Wert der aktuellen Familie.
+     * @return false, wenn die Familie keine weiteren Werte hat.
+     */
+    bool sampleLine();
+
+    /**
+     * @brief Hängt Text an _line an und maskiert dabei \, " und Zeilenumbrüche.
+     * @return false, wenn die Zeile zu lang wird.
+     */
+    bool appendEscaped(const char* text);
+
+    /**
+     * @brief Hängt formatierten Text an _line an.
+     * @return false, wenn die Zeile zu lang wird.
+     */
+    bool append(const char* format, ...);
+
+    const Family* _families;
+    uint8_t _count;
+    SampleFunction _samples;
+
+    Phase _phase = Phase::TypeLine;
+    uint8_t _family = 0;  // aktuelle Familie
+    uint16_t _index = 0;  // nächster Wert der aktuellen Familie
+    char _line[LINE_SIZE];
+    size_t _lineLength = 0;
+    size_t _lineOffset = 0; // bereits ausgegebene Zeichen der Zeile
+};
@@ -0,0 +1,38 @@
+/**
+ * Beispiel zur Nutzung der MetricsWriter-Bibliothek
+ *
+ * Gibt alle fünf Sekunden die Betriebszeit und den freien Heap im Text-Format von OpenMetrics auf der seriellen
+ * Konsole aus, in Stücken zu 32 Byte wie bei einer Chunked-Antwort.
+ */
+
+#include <Arduino.h>
+#include "MetricsWriter.h"
+
+enum Family : uint8_t { FAMILY_UPTIME, FAMILY_HEAP, FAMILY_COUNT };
+
+const MetricsWriter::Family FAMILIES[FAMILY_COUNT] = {
+    {"demo_uptime_seconds", MetricsWriter::Type::Gauge, "seconds", "Zeit seit dem Start"},
+    {"demo_heap_free_bytes", MetricsWriter::Type::Gauge, "bytes", "Freier Heap"},
+};
+
+MetricsWriter writer(FAMILIES, FAMILY_COUNT, [](const uint8_t family, const uint16_t index, MetricsWriter::Sample& sample) {
+    if (index > 0) {
+        return false; // je Familie ein Wert
+    }
+    sample.value = family == FAMILY_UPTIME ? millis() / 1000.0 : ESP.getFreeHeap();
+    return true;
+});
+
+void setup() {
+    Serial.begin(115200);
+}
+
+void loop() {
+    uint8_t buffer[32];
+    size_t length;
+    writer.rewind();
+    while ((length = writer.fill(buffer, sizeof(buffer))) > 0) {
+        Serial.write(buffer, length);
+    }
+    delay(5000);
+}
@@ -2,10 +2,17 @@
 
 MicroSDCard::MicroSDCard(const uint8_t csPin) : _csPin(csPin), _isReady(false) {}
 
-bool MicroSDCard::begin() {
+bool MicroSDCard::begin(SpiBusArbiter* bus, const int device) {
     pinMode(_csPin, OUTPUT);
     digitalWrite(_csPin, HIGH);
-    _isReady = SD.begin(_csPin);
+    if (!bus) {
+        _isReady = SD.begin(_csPin);
+        return _isReady;
+    }
+
+    // Die SD-Bibliothek startet ihre SPI-Transaktionen selbst, mit dem hier übergebenen Takt.
+    const SpiBusArbiter::Lock lock(bus, device);
+    _isReady = SD.begin(_csPin, bus->getSPI(), bus->getClock(device));
     return _isReady;
 }
 
@@ -96,6 +103,192 @@ bool MicroSDCard::deleteAllFilesInDir(const char* dirname) const {
     return allSuccess;
 }
 
+int MicroSDCard::deleteFilesInDir(const char* dirname, const size_t maxFiles) const {
+    if (!_isReady) {
+        return -1;
+    }
+    File root = SD.open(dirname);
+    if (!root || !root.isDirectory()) {
+        return -1;
+    }
+
+    int deleted = 0;
+    size_t attempts = 0;
+    File file = root.openNextFile();
+    while (file && attempts < maxFiles) {
+        if (!file.isDirectory()) {
+            const String path = String(file.path()); // vollständiger Pfad, file.name() enthält nur den Dateinamen
+            file.close(); // vor dem Löschen schließen
+            attempts++;
+            if (SD.remove(path)) {
+                deleted++;
+            } else {
+                Serial.printf("SD-Fehler: Konnte '%s' nicht löschen.\n", path.c_str());
+            }
+        } else {
+            file.close();
+        }
+        file = root.openNextFile();
+    }
+    root.close();
+    return deleted;
+}
+
+int MicroSDCard::deleteFilesInTree(const char* dirname, const size_t maxFiles) {
+    if (!_isReady) {
+        return -1;
+    }
+    File root = SD.open(dirname);
+    if (!root || !root.isDirectory()) {
+        return -1;
+    }
+    _imageDir[0] = '\0'; // Verzeichnisse können verschwinden, prepareImagePath() muss neu prüfen
+
+    size_t attempts = 0;
+    const int deleted = deleteTree(root, maxFiles, attempts);
+    root.close();
+    return deleted;
+}
+
+int MicroSDCard::deleteTree(File& dir, const size_t maxFiles, size_t& attempts) {
+    int deleted = 0;
+    File file = dir.openNextFile();
+    while (file && attempts < maxFiles) {
+        const String path = String(file.path());
+        if (file.isDirectory()) {
+            deleted += deleteTree(file, maxFiles, attempts);
+            file.close();
+            if (attempts < maxFiles) {
+                SD.rmdir(path); // schlägt fehl, wenn sich etwas nicht löschen ließ
+            }
+        } else {
+            file.close(); // vor dem Löschen schließen
+            attempts++;
+            if (SD.remove(path)) {
+                deleted++;
+            } else {
+                Serial.printf("SD-Fehler: Konnte '%s' nicht löschen.\n", path.c_str());
+            }
+        }
+        file = dir.openNextFile();
+    }
+    return deleted;
+}
+
+void MicroSDCard::formatImagePath(const tm& timeInfo, char* path, const size_t size) {
+    snprintf(path, size, "%s/%04d/%02d/%02d/%02d%02d%02d.jpg", IMAGE_DIR,
+        timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday,
+        timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
+}
+
+bool MicroSDCard::prepareImagePath(const char* path) {
+    const char* end = strrchr(path, '/');
+    const size_t length = end ? end - path : 0;
+    if (length == 0 || length >= sizeof(_imageDir)) {
+        return length == 0; // Wurzelverzeichnis gibt es immer
+    }
+    if (strncmp(_imageDir, path, length) == 0 && _imageDir[length] == '\0') {
+        return true; // wie beim letzten Bild
+    }
+
+    // Jede Ebene anlegen, die noch fehlt (z.B. "/img", "/img/2025", "/img/2025/12", "/img/2025/12/05")
+    char dir[IMAGE_PATH_LENGTH];
+    for (size_t i = 1; i <= length; i++) {
+        if (i == length || path[i] == '/') {
+            memcpy(dir, path, i);
+            dir[i] = '\0';
+            if (!SD.exists(dir) && !SD.mkdir(dir)) {
+                Serial.printf("SD-Fehler: Konnte '%s' nicht anlegen.\n", dir);
+                return false;
+            }
+        }
+    }
+    memcpy(_imageDir, path, length);
+    _imageDir[length] = '\0';
+    return true;
+}
+
+bool MicroSDCard::removeImage(const char* path) {
+    if (!_isReady) {
+        return false;
+    }
+    if (!SD.remove(path) && SD.exists(path)) {
+        Serial.printf("SD-Fehler: Konnte '%s' nicht löschen.\n", path);
+        return false;
+    }
+
+    // Leere Verzeichnisse unterhalb von IMAGE_DIR entfernen, von innen nach außen
+    const size_t rootLength = strlen(IMAGE_DIR);
+    if (strncmp(path, IMAGE_DIR, rootLength) != 0 || path[rootLength] != '/') {
+        return true; // altes Layout
+    }
+    char dir[IMAGE_PATH_LENGTH];
+    strlcpy(dir, path, sizeof(dir));
+    char* end = strrchr(dir, '/');
+    while (end && static_cast<size_t>(end - dir) > rootLength) {
+        *end = '\0';
+        if (!SD.rmdir(dir)) {
+            break; // nicht leer
+        }
+        _imageDir[0] = '\0'; // prepareImagePath() muss neu prüfen
+        end = strrchr(dir, '/');
+    }
+    return true;
+}
+
+int MicroSDCard::migrateLegacyImages(const size_t maxFiles, const std::function<void(const char* from, const char* to)>& moved) {
+    if (!_isReady) {
+        return -1;
+    }
+    File root = SD.open("/");
+    if (!root || !root.isDirectory()) {
+        return -1;
+    }
+
+    int count = 0;
+    size_t attempts = 0;
+    char from[IMAGE_PATH_LENGTH];
+    char to[IMAGE_PATH_LENGTH];
+    File file = root.openNextFile();
+    while (file && attempts < maxFiles) {
+        const bool isImage = !file.isDirectory() && legacyImagePath(file.name(), to, sizeof(to));
+        snprintf(from, sizeof(from), "/%s", file.name());
+        file.close(); // vor dem Umbenennen schließen
+        if (isImage) {
+            attempts++;
+            if (prepareImagePath(to) && !SD.exists(to) && SD.rename(from, to)) {
+                count++;
+                if (moved) {
+                    moved(from, to);
+                }
+            } else {
+                Serial.printf("SD-Fehler: Konnte '%s' nicht nach '%s' verschieben.\n", from, to);
+            }
+        }
+        file = root.openNextFile();
+    }
+    root.close();
+    return count;
+}
+
+bool MicroSDCard::legacyImagePath(const char* name, char* path, const size_t size) {
+    // Altes Layout: "img_YYYYMMDD_HHMMSS.jpg", ohne Uhrzeit "img_<millis>.jpg"
+    const size_t length = strlen(name);
+    if (length < 9 || strncmp(name, "img_", 4) != 0 || strcmp(name + length - 4, ".jpg") != 0) {
+        return false;
+    }
+    bool dated = length == 23 && name[12] == '_';
+    for (size_t i = 4; i < 19 && dated; i++) {
+        dated = i == 12 || isdigit(static_cast<unsigned char>(name[i]));
+    }
+    if (dated) {
+        snprintf(path, size, "%s/%.4s/%.2s/%.2s/%.6s.jpg", IMAGE_DIR, name + 4, name + 8, name + 10, name + 13);
+    } else {
+        snprintf(path, size, "%s/%s", UNDATED_DIR, name + 4);
+    }
+    return true;
+}
+
 File MicroSDCard::openFileForReading(const char* path) {
     return SD.open(path, FILE_READ);
 }
@@ -150,6 +343,16 @@ bool MicroSDCard::appendFile(const char* path, const char* message) {
     return success;
 }
 
+bool MicroSDCard::appendFile(const char* path, const uint8_t* data, const size_t size) {
+    File file = SD.open(path, FILE_APPEND, true);
+    if (!file) {
+        return false;
+    }
+    const bool success = file.write(data, size) == size;
+    file.close();
+    return success;
+}
+
 bool MicroSDCard::processStreamChunk(const char* path, Stream &input, size_t bufferSize = 64, const char* endMarker = nullptr)
 {
     if (!input.available()) {
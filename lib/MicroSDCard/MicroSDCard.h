@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <SD.h> // Die spezifische Implementierung für SD-Karten.
+#include "SpiBusArbiter.h"
 
 /**
  * Klasse für den MicroSD SPI Kartenleser.
@@ -12,6 +13,10 @@
 class MicroSDCard
 {
 public:
+    static constexpr const char* IMAGE_DIR = "/img";           // Bilderverzeichnis (darunter Jahr/Monat/Tag)
+    static constexpr const char* UNDATED_DIR = "/img/undated"; // Bilder ohne Aufnahmezeit
+    static constexpr size_t IMAGE_PATH_LENGTH = 32;            // Maximale Länge eines Bildpfads inkl. Nullterminator
+
     /**
      * @brief Konstruktor der MicroSDCard-Klasse.
      * @param csPin Der GPIO-Pin, der als Chip Select für das SD-Modul verwendet wird.
@@ -21,9 +26,12 @@ public:
     /**
      * @brief Initialisiert das SD-Kartenmodul.
      * Muss im setup() des Hauptprogramms aufgerufen werden.
+     * @param bus Arbiter für den gemeinsamen SPI-Bus (optional). Der SPI-Takt wird dann vom Arbiter übernommen,
+     *            ohne Arbiter gilt der Standard-Takt der SD-Bibliothek (4 MHz).
+     * @param device ID der SD-Karte beim Arbiter (siehe SpiBusArbiter::addDevice()).
      * @return true bei erfolgreicher Initialisierung, andernfalls false.
      */
-    bool begin();
+    bool begin(SpiBusArbiter* bus = nullptr, int device = SpiBusArbiter::NO_DEVICE);
 
     /**
      * @return true, wenn die SD-Karte bereit ist
@@ -69,6 +77,65 @@ public:
      */
     bool deleteAllFilesInDir(const char* dirname) const;
 
+    /**
+     * @brief Löscht höchstens maxFiles Dateien (keine Ordner) in einem Verzeichnis.
+     * Damit lässt sich ein großes Verzeichnis in mehreren kurzen Schritten leeren, zwischen denen z.B. der SPI-Bus
+     * freigegeben wird. Auch fehlgeschlagene Löschversuche zählen zu maxFiles.
+     * @param dirname Der Pfad des Verzeichnisses (z.B. "/").
+     * @param maxFiles Maximale Anzahl der Löschversuche.
+     * @return Anzahl der gelöschten Dateien, oder -1, wenn das Verzeichnis nicht geöffnet werden konnte.
+     */
+    int deleteFilesInDir(const char* dirname, size_t maxFiles) const;
+
+    /**
+     * @brief Löscht höchstens maxFiles Dateien in einem Verzeichnis und allen Unterverzeichnissen.
+     * Leere Unterverzeichnisse werden dabei entfernt, das Verzeichnis selbst bleibt erhalten. Ein Aufruf, der 0 liefert,
+     * hat alle leeren Unterverzeichnisse entfernt.
+     * @param dirname Der Pfad des Verzeichnisses (z.B. "/img").
+     * @param maxFiles Maximale Anzahl der Löschversuche.
+     * @return Anzahl der gelöschten Dateien, oder -1, wenn das Verzeichnis nicht geöffnet werden konnte.
+     */
+    int deleteFilesInTree(const char* dirname, size_t maxFiles);
+
+    // --- Bilder ---
+
+    /**
+     * @brief Bildet den Pfad eines Bildes aus seiner Aufnahmezeit: "/img/YYYY/MM/DD/HHMMSS.jpg".
+     * Pro Tag entsteht ein eigenes Verzeichnis, sodass kein Verzeichnis mit den Jahren unbegrenzt wächst (FAT sucht
+     * beim Öffnen und Anlegen linear durch das Verzeichnis).
+     * @param timeInfo Die Aufnahmezeit.
+     * @param path Ziel für den Pfad (mindestens IMAGE_PATH_LENGTH Zeichen).
+     * @param size Größe des Ziels.
+     */
+    static void formatImagePath(const tm& timeInfo, char* path, size_t size);
+
+    /**
+     * @brief Legt die Verzeichnisse für ein Bild an, soweit sie noch fehlen.
+     * Das zuletzt geprüfte Verzeichnis wird gemerkt, die Karte wird daher nur beim ersten Bild eines Tages gefragt.
+     * Der Aufrufer muss den SPI-Bus halten (schützt auch das gemerkte Verzeichnis).
+     * @param path Pfad des Bildes (z.B. "/img/2025/12/05/103000.jpg").
+     * @return true, wenn das Verzeichnis existiert.
+     */
+    bool prepareImagePath(const char* path);
+
+    /**
+     * @brief Löscht ein Bild und danach die Tages-, Monats- und Jahresverzeichnisse, die dadurch leer geworden sind.
+     * Der Aufrufer muss den SPI-Bus halten.
+     * @param path Pfad des Bildes (z.B. "/img/2025/12/05/103000.jpg").
+     * @return true, wenn die Datei danach nicht mehr existiert (auch wenn sie schon vorher fehlte).
+     */
+    bool removeImage(const char* path);
+
+    /**
+     * @brief Verschiebt höchstens maxFiles Bilder aus dem alten Layout ("/img_YYYYMMDD_HHMMSS.jpg" im
+     * Wurzelverzeichnis) in das Bilderverzeichnis. Bilder ohne Zeitstempel im Namen kommen nach "/img/undated".
+     * Der Aufrufer muss den SPI-Bus halten.
+     * @param maxFiles Maximale Anzahl der Versuche.
+     * @param moved Wird für jedes verschobene Bild mit altem und neuem Pfad aufgerufen (optional).
+     * @return Anzahl der verschobenen Bilder, oder -1, wenn das Wurzelverzeichnis nicht geöffnet werden konnte.
+     */
+    int migrateLegacyImages(size_t maxFiles, const std::function<void(const char* from, const char* to)>& moved = nullptr);
+
     // --- Dateioperationen ---
 
     /**
@@ -118,6 +185,16 @@ public:
      */
     static bool appendFile(const char* path, const char* message);
 
+    /**
+     * @brief Fügt Binärdaten am Ende einer Datei an.
+     * Erstellt die Datei, falls sie nicht existiert.
+     * @param path Der Pfad zur Datei.
+     * @param data Die Daten.
+     * @param size Anzahl der Bytes.
+     * @return true, wenn alle Bytes geschrieben wurden.
+     */
+    static bool appendFile(const char* path, const uint8_t* data, size_t size);
+
     /**
      * @brief Schreibt Daten aus einem Stream in eine Datei auf SD.
      *        Arbeitet nicht-blockierend mit Buffer und prüft optional auf ein Endezeichen.
@@ -171,6 +248,25 @@ public:
     static uint64_t getUsedSpaceMB();
 
 private:
+    /**
+     * @brief Löscht rekursiv Dateien in einem geöffneten Verzeichnis (siehe deleteFilesInTree()).
+     * @param dir Das Verzeichnis.
+     * @param maxFiles Maximale Anzahl der Löschversuche insgesamt.
+     * @param attempts Bisherige Löschversuche (wird erhöht).
+     * @return Anzahl der gelöschten Dateien.
+     */
+    static int deleteTree(File& dir, size_t maxFiles, size_t& attempts);
+
+    /**
+     * @brief Bildet den neuen Pfad für ein Bild im alten Layout.
+     * @param name Dateiname im Wurzelverzeichnis (z.B. "img_20251205_103000.jpg").
+     * @param path Ziel für den neuen Pfad.
+     * @param size Größe des Ziels.
+     * @return false, wenn der Name nicht zum alten Layout passt.
+     */
+    static bool legacyImagePath(const char* name, char* path, size_t size);
+
     uint8_t _csPin; // Speicher für den Chip Select Pin
     bool _isReady;
+    char _imageDir[IMAGE_PATH_LENGTH] = {}; // zuletzt von prepareImagePath() geprüftes Verzeichnis
 };
\ No newline at end of file
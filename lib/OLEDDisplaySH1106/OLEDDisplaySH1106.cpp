@@ -1,4 +1,5 @@
 #include "OLEDDisplaySH1106.h"
+#include "Hal.h"
 
 OLEDDisplaySH1106::OLEDDisplaySH1106(const uint8_t resetPin)
     : _u8g2(U8G2_R0, resetPin), _dashboardIconWidth{}, _dashboardIconHeight{} {
@@ -18,8 +19,9 @@ void OLEDDisplaySH1106::update() {
     // Diese Funktion soll in der Hauptschleife (loop) kontinuierlich aufgerufen werden.
     if (_currentMode == ALERT && _isBlinking) {
         // Blink-Logik: Alle 500ms den Sichtbarkeitsstatus wechseln
-        if (millis() - _lastBlinkTime > 500) {
-            _lastBlinkTime = millis();
+        const uint32_t now = Hal::get().millis();
+        if (now - _lastBlinkTime > 500) {
+            _lastBlinkTime = now;
             _alertVisible = !_alertVisible;
             _drawFullscreenAlert(); // Neuzeichnen mit geändertem Status
         }
@@ -119,7 +121,7 @@ void OLEDDisplaySH1106::showFullscreenAlert(const String &message, bool blink) {
     _alertMessage = message;
     _isBlinking = blink;
     _alertVisible = true; // Immer sichtbar beim ersten Aufruf
-    _lastBlinkTime = millis();
+    _lastBlinkTime = Hal::get().millis();
     _drawFullscreenAlert();
 }
 
@@ -131,7 +131,7 @@ private:
     String _alertMessage;             // Speichert die anzuzeigende Warnmeldung.
     bool _isBlinking = false;         // Flag, das steuert, ob die Warnmeldung blinken soll.
     bool _alertVisible = true;        // Internes Flag für den Blinkeffekt (an/aus).
-    unsigned long _lastBlinkTime = 0; // Zeitstempel des letzten Blink-Zustandswechsels.
+    uint32_t _lastBlinkTime = 0; // Zeitstempel (millis()) des letzten Blink-Zustandswechsels.
     
     /**
      * @brief Interne Funktion zum Zeichnen der Warnmeldung in den Display-Puffer.
@@ -0,0 +1,99 @@
+#include "Profiler.h"
+#include "Hal.h"
+
+float Profiler::Stats::avgUs() const {
+    return count > 0 ? static_cast<float>(totalUs) / static_cast<float>(count) : 0.0f;
+}
+
+uint32_t Profiler::Stats::percentileUs(const float fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+    // Rang der gesuchten Messung (1..count)
+    uint32_t rank = static_cast<uint32_t>(ceilf(fraction * static_cast<float>(count)));
+    rank = rank < 1 ? 1 : (rank > count ? count : rank);
+
+    uint32_t before = 0; // Messungen in den Bereichen davor
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+        if (before + histogram[b] < rank) {
+            before += histogram[b];
+            continue;
+        }
+        // Im Bereich b linear zwischen Unter- und Obergrenze interpolieren (der letzte Bereich endet bei maxUs)
+        const uint32_t low = b == 0 ? 0 : bucketLimitUs(b - 1);
+        const uint32_t high = b == BUCKETS - 1 ? maxUs : bucketLimitUs(b);
+        const float position = static_cast<float>(rank - before) / static_cast<float>(histogram[b]);
+        const uint32_t value = low + static_cast<uint32_t>(position * static_cast<float>(high - low));
+        return value < minUs ? minUs : (value > maxUs ? maxUs : value);
+    }
+    return maxUs; // nur, wenn sich Anzahl und Histogramm widersprechen
+}
+
+uint32_t Profiler::Stats::bucketLimitUs(const uint8_t bucket) {
+    return bucket >= BUCKETS - 1 ? UINT32_MAX : (1u << bucket);
+}
+
+Profiler::Profiler(const char* const* names, const uint8_t count)
+    : _count(count < MAX_SECTIONS ? count : MAX_SECTIONS) {
+    for (uint8_t i = 0; i < _count; i++) {
+        _sections[i].name = names[i];
+    }
+#if defined(ARDUINO_ARCH_ESP32)
+    _cyclesPerUs = getCpuFrequencyMhz();
+#endif
+}
+
+bool Profiler::getStats(const uint8_t section, Stats& stats) const {
+    if (section >= _count) {
+        return false;
+    }
+    const Section& s = _sections[section];
+    for (uint8_t attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        const uint32_t before = s.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue; // Schreibvorgang läuft
+        }
+        stats.count = s.count.load(std::memory_order_relaxed);
+        stats.minUs = s.minUs.load(std::memory_order_relaxed);
+        stats.maxUs = s.maxUs.load(std::memory_order_relaxed);
+        stats.totalUs = static_cast<uint64_t>(s.totalHigh.load(std::memory_order_relaxed)) << 32 |
+                        s.totalLow.load(std::memory_order_relaxed);
+        for (uint8_t b = 0; b < BUCKETS; b++) {
+            stats.histogram[b] = s.histogram[b].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Profiler::reset() {
+    for (uint8_t i = 0; i < _count; i++) {
+        _sections[i].resetRequested.store(true, std::memory_order_release);
+    }
+}
+
+uint8_t Profiler::getSectionCount() const {
+    return _count;
+}
+
+const char* Profiler::getName(const uint8_t section) const {
+    return section < _count ? _sections[section].name : nullptr;
+}
+
+uint32_t Profiler::hostMicros() {
+    return Hal::get().micros();
+}
+
+void Profiler::clear(Section& section) {
+    section.count.store(0, std::memory_order_relaxed);
+    section.minUs.store(0, std::memory_order_relaxed);
+    section.maxUs.store(0, std::memory_order_relaxed);
+    section.totalLow.store(0, std::memory_order_relaxed);
+    section.totalHigh.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint32_t>& bucket : section.histogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * Leichtgewichtiger Profiler für die heißen Pfade der Firmware (Steuerungszyklus, Sensoren, Display, Aufnahme, ...).
+ *
+ * Jeder Abschnitt (Section) sammelt Anzahl, Minimum, Summe, Maximum und ein log2-Histogramm seiner Laufzeiten in
+ * festen Arrays; es wird nie Speicher reserviert. Gemessen wird mit PROFILE_SCOPE(), das beim Verlassen des
+ * Blocks die Dauer einträgt:
+ *
+ *     void updateDisplay() {
+ *         PROFILE_SCOPE(profiler, PROFILE_UPDATE_DISPLAY);
+ *         ...
+ *     }
+ *
+ * Auf dem ESP32 zählt der Profiler CPU-Takte (ESP.getCycleCount(), ein einziger Befehl), im nativen Build nimmt er
+ * die virtuelle Uhr (Hal::get().micros()), damit Tests Laufzeiten gezielt vorgeben können.
+ *
+ * Ohne das Build-Flag PROFILER_ENABLED ist PROFILE_SCOPE() leer: Die Messpunkte verschwinden vollständig aus dem
+ * Programm, die Klasse bleibt aber nutzbar (alle Abschnitte melden dann count = 0).
+ *
+ * Jeden Abschnitt darf nur ein Task messen. Gelesen wird wie bei einem Seqlock: Der Schreiber wartet nie, ein Leser
+ * wiederholt das Lesen, wenn gleichzeitig geschrieben wurde.
+ */
+class Profiler {
+public:
+    static constexpr uint8_t MAX_SECTIONS = 16; // Maximale Anzahl der Abschnitte
+    static constexpr uint8_t BUCKETS = 24; // Bereiche im Histogramm (der letzte fasst alles ab 2^22 µs = 4,2 s)
+    static constexpr uint8_t READ_ATTEMPTS = 8; // Leseversuche in getStats(), bevor aufgegeben wird
+
+    /**
+     * @struct Stats
+     * @brief Laufzeiten eines Abschnitts seit dem Start bzw. seit reset().
+     *
+     * Bereich b des Histogramms zählt die Laufzeiten von 2^(b-1) bis unter 2^b µs (Bereich 0: unter 1 µs).
+     */
+    struct Stats {
+        uint32_t count = 0;    // Anzahl der Messungen
+        uint32_t minUs = 0;    // kürzeste Laufzeit in µs
+        uint32_t maxUs = 0;    // längste Laufzeit in µs
+        uint64_t totalUs = 0;  // Summe aller Laufzeiten in µs
+        uint32_t histogram[BUCKETS] = {};
+
+        /** @brief Gibt die mittlere Laufzeit in µs zurück (0 ohne Messung). */
+        float avgUs() const;
+
+        /**
+         * @brief Schätzt ein Perzentil aus dem Histogramm.
+         * Innerhalb eines Bereichs wird linear interpoliert; das Ergebnis liegt immer zwischen minUs und maxUs.
+         * @param fraction Anteil, z.B. 0.99 für das 99. Perzentil.
+         * @return Laufzeit in µs (0 ohne Messung).
+         */
+        uint32_t percentileUs(float fraction) const;
+
+        /** @brief Gibt die obere Grenze (ausschließlich) eines Bereichs in µs zurück. */
+        static uint32_t bucketLimitUs(uint8_t bucket);
+    };
+
+    /**
+     * Misst die Zeit vom Konstruktor bis zum Destruktor (siehe PROFILE_SCOPE()).
+     */
+    class Scope {
+    public:
+        Scope(Profiler& profiler, const uint8_t section) : _profiler(profiler), _section(section), _start(now()) {}
+        ~Scope() { _profiler.record(_section, elapsedUs(_profiler, _start)); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Profiler& _profiler;
+        const uint8_t _section;
+        const uint32_t _start;
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param names Namen der Abschnitte; der Index ist die Nummer für PROFILE_SCOPE() und record(). Die Zeichenketten
+     *              werden nicht kopiert.
+     * @param count Anzahl der Abschnitte (höchstens MAX_SECTIONS, weitere werden ignoriert).
+     */
+    Profiler(const char* const* names, uint8_t count);
+
+    /**
+     * @brief Trägt eine Laufzeit ein (nur von dem Task aufrufen, der den Abschnitt misst).
+     * Wartet nie. Unbekannte Abschnitte werden ignoriert.
+     * @param section Nummer des Abschnitts.
+     * @param us Laufzeit in µs.
+     */
+    void record(uint8_t section, uint32_t us) {
+        if (section >= _count) {
+            return;
+        }
+        Section& s = _sections[section];
+        const uint32_t sequence = s.sequence.load(std::memory_order_relaxed);
+        s.sequence.store(sequence + 1, std::memory_order_relaxed); // ungerade: Schreibvorgang läuft
+        std::atomic_thread_fence(std::memory_order_release);
+        if (s.resetRequested.load(std::memory_order_acquire)) {
+            s.resetRequested.store(false, std::memory_order_relaxed);
+            clear(s);
+        }
+        const uint32_t count = s.count.load(std::memory_order_relaxed);
+        if (count == 0 || us < s.minUs.load(std::memory_order_relaxed)) {
+            s.minUs.store(us, std::memory_order_relaxed);
+        }
+        if (us > s.maxUs.load(std::memory_order_relaxed)) {
+            s.maxUs.store(us, std::memory_order_relaxed);
+        }
+        s.count.store(count + 1, std::memory_order_relaxed);
+        const uint32_t low = s.totalLow.load(std::memory_order_relaxed);
+        s.totalLow.store(low + us, std::memory_order_relaxed);
+        if (low + us < low) {
+            s.totalHigh.store(s.totalHigh.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        std::atomic<uint32_t>& bucket = s.histogram[bucketOf(us)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        s.sequence.store(sequence + 2, std::memory_order_release); // gerade: Werte sind vollständig
+    }
+
+    /**
+     * @brief Liest eine in sich stimmige Kopie der Laufzeiten eines Abschnitts.
+     * Gibt nach READ_ATTEMPTS Versuchen auf, statt zu warten (z.B. wenn der AsyncTCP-Task einen schreibenden Task
+     * mit niedrigerer Priorität auf demselben Kern unterbrochen hat).
+     * @param section Nummer des Abschnitts.
+     * @param stats Ziel für die Kopie (wird nur bei Erfolg gültig).
+     * @return true bei Erfolg.
+     */
+    bool getStats(uint8_t section, Stats& stats) const;
+
+    /**
+     * @brief Setzt alle Abschnitte zurück.
+     * Der Task, der einen Abschnitt misst, leert ihn bei seiner nächsten Messung; bis dahin melden die Leser noch die
+     * alten Werte.
+     */
+    void reset();
+
+    /** @brief Gibt die Anzahl der Abschnitte zurück. */
+    uint8_t getSectionCount() const;
+
+    /** @brief Gibt den Namen eines Abschnitts zurück (nullptr bei unbekannter Nummer). */
+    const char* getName(uint8_t section) const;
+
+    /** @brief Gibt an, ob die Messpunkte einkompiliert sind (Build-Flag PROFILER_ENABLED). */
+    static constexpr bool isEnabled() {
+#if defined(PROFILER_ENABLED)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Gibt den Bereich des Histogramms für eine Laufzeit zurück.
+     */
+    static uint8_t bucketOf(const uint32_t us) {
+        const uint8_t bits = us == 0 ? 0 : static_cast<uint8_t>(32 - __builtin_clz(us));
+        return bits < BUCKETS ? bits : BUCKETS - 1;
+    }
+
+    /**
+     * @brief Gibt den aktuellen Stand des Zeitgebers zurück (CPU-Takte auf dem ESP32, µs im nativen Build).
+     */
+    static uint32_t now() {
+#if defined(ARDUINO_ARCH_ESP32)
+        return ESP.getCycleCount();
+#else
+        return hostMicros();
+#endif
+    }
+
+    /**
+     * @brief Rechnet die Zeit seit einem Stand von now() in µs um.
+     * Auf dem ESP32 läuft der Taktzähler nach 2^32 Takten über (17,9 s bei 240 MHz); längere Abschnitte werden
+     * daher falsch gemessen. Der Zähler gehört zum Kern, der Task muss an einen Kern gebunden sein.
+     */
+    static uint32_t elapsedUs(const Profiler& profiler, const uint32_t start) {
+#if defined(ARDUINO_ARCH_ESP32)
+        return (now() - start) / profiler._cyclesPerUs;
+#else
+        (void)profiler;
+        return now() - start;
+#endif
+    }
+
+private:
+    /**
+     * @struct Section
+     * @brief Werte eines Abschnitts, wortweise atomar (wie bei Seqlock).
+     */
+    struct Section {
+        const char* name = nullptr;
+        std::atomic<uint32_t> sequence{0}; // ungerade = Schreibvorgang läuft
+        std::atomic<bool> resetRequested{false};
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> minUs{0};
+        std::atomic<uint32_t> maxUs{0};
+        std::atomic<uint32_t> totalLow{0};  // Summe in µs, untere 32 Bit
+        std::atomic<uint32_t> totalHigh{0}; // Summe in µs, obere 32 Bit
+        std::atomic<uint32_t> histogram[BUCKETS] = {};
+    };
+
+    /**
+     * @brief Mikrosekunden-Zeitgeber im nativen Build (virtuelle Uhr der HAL).
+     */
+    static uint32_t hostMicros();
+
+    /**
+     * @brief Leert einen Abschnitt (nur vom schreibenden Task, während die Sequenznummer ungerade ist).
+     */
+    static void clear(Section& section);
+
+    Section _sections[MAX_SECTIONS];
+    uint8_t _count = 0;
+    uint32_t _cyclesPerUs = 1; // CPU-Takte pro µs (nur ESP32)
+};
+
+#if defined(PROFILER_ENABLED)
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+/**
+ * @brief Misst die Laufzeit des umgebenden Blocks als Abschnitt section von profiler.
+ */
+#define PROFILE_SCOPE(profiler, section) \
+    const Profiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)((profiler), (section))
+#else
+#define PROFILE_SCOPE(profiler, section) \
+    do {                                 \
+    } while (false)
+#endif
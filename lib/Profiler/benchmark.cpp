@@ -0,0 +1,66 @@
+/**
+ * Benchmark für die Profiler-Bibliothek: Kosten eines Messpunkts.
+ *
+ * Misst eine leere Schleife, dieselbe Schleife mit PROFILE_SCOPE() und die Zeit für getStats(). Die Differenz der
+ * ersten beiden ist der Aufwand pro Messpunkt (Ziel: unter 1 µs).
+ *
+ * Ausführen wie example.cpp (src_dir auf die Bibliothek umbiegen), dabei example.cpp ausschließen:
+ *   build_src_filter = +<benchmark.cpp>
+ * PROFILER_ENABLED muss gesetzt sein (steht in platformio.ini).
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "Profiler.h"
+
+constexpr uint32_t RUNS = 100000; // Durchläufe je Messung
+
+enum Section : uint8_t { SECTION_PROBE, SECTION_COUNT };
+const char* const SECTION_NAMES[SECTION_COUNT] = {"probe"};
+
+Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+volatile uint32_t sink = 0; // verhindert, dass der Compiler die Schleifen entfernt
+
+/**
+ * @brief Gibt die Dauer von RUNS leeren Durchläufen in µs zurück.
+ */
+int64_t measureEmpty() {
+    const int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < RUNS; i++) {
+        sink = sink + 1;
+    }
+    return esp_timer_get_time() - start;
+}
+
+/**
+ * @brief Gibt die Dauer von RUNS Durchläufen mit Messpunkt in µs zurück.
+ */
+int64_t measureProbe() {
+    const int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < RUNS; i++) {
+        PROFILE_SCOPE(profiler, SECTION_PROBE);
+        sink = sink + 1;
+    }
+    return esp_timer_get_time() - start;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+    Serial.printf("Profiler-Benchmark (%u MHz, %s)\n", getCpuFrequencyMhz(),
+        Profiler::isEnabled() ? "PROFILER_ENABLED" : "ohne Messpunkte");
+
+    const int64_t empty = measureEmpty();
+    const int64_t probe = measureProbe();
+    Serial.printf("  leer:         %8.3f µs pro Durchlauf\n", static_cast<double>(empty) / RUNS);
+    Serial.printf("  mit Messpunkt:%8.3f µs pro Durchlauf\n", static_cast<double>(probe) / RUNS);
+    Serial.printf("  Messpunkt:    %8.3f µs\n", static_cast<double>(probe - empty) / RUNS);
+
+    Profiler::Stats stats;
+    const int64_t start = esp_timer_get_time();
+    const bool ok = profiler.getStats(SECTION_PROBE, stats);
+    Serial.printf("  getStats():   %8lld µs (%s, %u Messungen)\n", esp_timer_get_time() - start, ok ? "ok" : "belegt",
+        stats.count);
+}
+
+void loop() {}
@@ -0,0 +1,43 @@
+/**
+ * Beispiel zur Nutzung der Profiler-Bibliothek
+ *
+ * Misst, wie lange analogRead() und ein kurzes delay() dauern, und gibt jede Sekunde Anzahl, Minimum, Mittelwert,
+ * 99. Perzentil und Maximum aus.
+ *
+ * Die Messpunkte gibt es nur mit dem Build-Flag PROFILER_ENABLED.
+ */
+
+#include <Arduino.h>
+#include "Profiler.h"
+
+enum Section : uint8_t { SECTION_ANALOG_READ, SECTION_DELAY, SECTION_COUNT };
+const char* const SECTION_NAMES[SECTION_COUNT] = {"analogRead", "delay"};
+
+Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+
+void setup() {
+    Serial.begin(115200);
+}
+
+void loop() {
+    const unsigned long start = millis();
+    while (millis() - start < 1000) {
+        {
+            PROFILE_SCOPE(profiler, SECTION_ANALOG_READ);
+            analogRead(34);
+        }
+        {
+            PROFILE_SCOPE(profiler, SECTION_DELAY);
+            delay(2);
+        }
+    }
+
+    for (uint8_t id = 0; id < profiler.getSectionCount(); id++) {
+        Profiler::Stats stats;
+        if (profiler.getStats(id, stats)) {
+            Serial.printf("%-10s %6u x  min %5u  avg %7.1f  p99 %5u  max %5u µs\n", profiler.getName(id), stats.count,
+                stats.minUs, stats.avgUs(), stats.percentileUs(0.99f), stats.maxUs);
+        }
+    }
+    profiler.reset();
+}
@@ -1,12 +1,19 @@
 #include "Relay.h"
+#include "Hal.h"
 
 Relay::Relay(uint8_t pin, bool activeHigh, bool safeState)
-    : _pin(pin), _activeHigh(activeHigh), _state(false), _hasPulse(false), _pulseStart(0), _pulseDur(0), _safeState(safeState) {}
+    : _pin(pin), _activeHigh(activeHigh), _state(false), _hasPulse(false), _pulseStart(0), _pulseDur(0), _safeState(safeState),
+      _switchCount(0), _onTimeMs(0), _onSince(0) {}
 
 void Relay::begin() {
-    pinMode(_pin, OUTPUT);
-    // Initialzustand: safeState (meistens AUS)
+    Hal::get().pinMode(_pin, OUTPUT);
+    // Initialzustand: safeState (meistens AUS); die Zähler laufen über ein erneutes begin() hinweg weiter
+    const uint32_t now = Hal::get().millis();
+    if (_state) {
+        _onTimeMs += now - _onSince;
+    }
     _state = _safeState;
+    _onSince = now;
     writePin(_state);
     _hasPulse = false;
     _pulseStart = 0;
@@ -15,47 +22,44 @@ void Relay::begin() {
 
 void Relay::on() {
     _hasPulse = false;
-    _state = true;
-    writePin(_state);
+    setState(true);
 }
 
 void Relay::off() {
     _hasPulse = false;
-    _state = false;
-    writePin(_state);
+    setState(false);
 }
 
 void Relay::toggle() {
     _hasPulse = false;
-    _state = !_state;
-    writePin(_state);
+    setState(!_state);
 }
 
-void Relay::pulse(unsigned long durationMs) {
+void Relay::pulse(uint32_t durationMs) {
     if (durationMs == 0) return;
     // Falls bereits ein Pulse läuft, verlängern wir ihn auf max(currentEnd, newEnd)
-    unsigned long now = millis();
+    const uint32_t now = Hal::get().millis();
     if (_hasPulse) {
-        unsigned long currentEnd = _pulseStart + _pulseDur;
-        unsigned long newEnd = now + durationMs;
-        if (newEnd > currentEnd) {
-            _pulseDur = (newEnd - _pulseStart);
+        // Restlaufzeiten vergleichen statt Endzeitpunkte, die über den Überlauf von millis() hinausreichen können
+        const uint32_t elapsed = now - _pulseStart;
+        const uint32_t remaining = elapsed < _pulseDur ? _pulseDur - elapsed : 0;
+        if (durationMs > remaining) {
+            _pulseDur = elapsed + durationMs;
         }
-        // falls newEnd <= currentEnd: nichts ändern
+        // sonst: nichts ändern
     } else {
         // Starte neuen Pulse: setze Relais EIN (temporär) und merke bisherigen Zustand
         _hasPulse = true;
         _pulseStart = now;
         _pulseDur = durationMs;
-        _state = true;
-        writePin(true);
+        setState(true);
     }
 }
 
 void Relay::update() {
     if (!_hasPulse) return;
-    unsigned long now = millis();
-    // Achte auf Overflow bei millis(): (now - start) ist sicher
+    const uint32_t now = Hal::get().millis();
+    // Achte auf Overflow bei millis(): (now - start) in uint32_t ist sicher
     if (now - _pulseStart >= _pulseDur) {
         // Pulse beendet: setze Relais zurück in safeState (oder false)
         _hasPulse = false;
@@ -63,8 +67,7 @@ void Relay::update() {
         _pulseStart = 0;
         // Rückfall auf safeState (oder false): hier entscheiden wir, dass Pulse temporär einschalten,
         // und danach ins safe(off)-Zustand zurückkehren. Falls anderes gewünscht, kann API erweitert werden.
-        _state = _safeState;
-        writePin(_state);
+        setState(_safeState);
     }
 }
 
@@ -76,12 +79,34 @@ uint8_t Relay::pin() const {
      return _pin;
 }
 
+uint32_t Relay::getSwitchCount() const {
+    return _switchCount;
+}
+
+uint64_t Relay::getOnTimeMs() const {
+    return _state ? _onTimeMs + (Hal::get().millis() - _onSince) : _onTimeMs;
+}
+
+void Relay::setState(const bool logicalOn) {
+    if (logicalOn != _state) {
+        const uint32_t now = Hal::get().millis();
+        if (_state) {
+            _onTimeMs += now - _onSince; // Differenz in uint32_t: sicher über den Überlauf von millis()
+        } else {
+            _onSince = now;
+        }
+        _switchCount++;
+        _state = logicalOn;
+    }
+    writePin(_state); // auch ohne Wechsel, wie bisher
+}
+
 void Relay::writePin(const bool logicalOn) const {
     // Mappe logisches "ON" auf physikalischen Pegel je nach activeHigh
     if (_activeHigh) {
-        digitalWrite(_pin, logicalOn ? HIGH : LOW);
+        Hal::get().digitalWrite(_pin, logicalOn ? HIGH : LOW);
     } else {
         // Invertierte Logik (häufig bei Relais-Boards mit opto): LOW = Relais EIN
-        digitalWrite(_pin, logicalOn ? LOW : HIGH);
+        Hal::get().digitalWrite(_pin, logicalOn ? LOW : HIGH);
     }
 }
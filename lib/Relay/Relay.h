@@ -30,9 +30,9 @@ public:
     /**
      * Startet einen nicht-blockierenden Pulse: Relais wird für durationMs eingeschaltet,
      * danach wieder in den vorherigen Zustand zurückgesetzt.
-     * @param durationMs Pulsdauer in Millisekunden (0 = kein Effekt)
+     * @param durationMs Pulsdauer in Millisekunden (0 = kein Effekt, höchstens 2^31 ms)
      */
-    void pulse(unsigned long durationMs);
+    void pulse(uint32_t durationMs);
 
     /**
      * Muss regelmäßig in loop() ausgeführt werden.
@@ -46,13 +46,26 @@ public:
     /** Liefert den physikalischen Ausgabepin. */
     uint8_t pin() const;
 
+    /**
+     * Liefert die Anzahl der Schaltvorgänge seit dem Start (jeder Wechsel AUS->EIN und EIN->AUS zählt einmal,
+     * begin() zählt nicht). Läuft erst nach 2^32 Schaltvorgängen über.
+     */
+    uint32_t getSwitchCount() const;
+
+    /** Liefert die gesamte Einschaltdauer seit dem Start in ms (inklusive der laufenden Einschaltphase). */
+    uint64_t getOnTimeMs() const;
+
 private:
     uint8_t _pin;
     bool _activeHigh;
     bool _state; // aktuell gesetzter Zustand (logical on/off)
     bool _hasPulse;
-    unsigned long _pulseStart; // millis() Startzeit des Pulses
-    unsigned long _pulseDur; // Dauer des Pulses in ms
+    uint32_t _pulseStart; // millis() Startzeit des Pulses
+    uint32_t _pulseDur; // Dauer des Pulses in ms
     bool _safeState; // Default-Zustand nach reset/begin
+    uint32_t _switchCount; // Anzahl der Zustandswechsel
+    uint64_t _onTimeMs; // Summe der abgeschlossenen Einschaltphasen in ms
+    uint32_t _onSince; // millis() beim letzten Einschalten
+    void setState(bool logicalOn);
     void writePin(bool logicalOn) const;
 };
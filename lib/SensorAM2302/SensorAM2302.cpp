@@ -1,4 +1,5 @@
 #include "SensorAM2302.h"
+#include "Hal.h"
 
 SensorAM2302::SensorAM2302(uint8_t pin)
     : _pin(pin), _sensor(pin), _temperature(NAN), _humidity(NAN), _lastError(SimpleDHTErrSuccess) {}
@@ -9,10 +10,10 @@ bool SensorAM2302::begin() {
     return read();
 }
 
-bool SensorAM2302::read() {
+bool SensorAM2302::read(const int retries) {
     // DHT-Sensoren können aufgrund von Timing-Problemen (Interrupts) fehlschlagen.
     // Ein "Retry"-Mechanismus ist die Standardlösung, um die Zuverlässigkeit zu erhöhen.
-    int retries = 20; // Wir versuchen es max. 20 * 50 ms = 1 Sekunde.
+    // Standardmäßig versuchen wir es max. 20 * 50 ms = 1 Sekunde.
     for (int i = 0; i < retries; i++) {
         _lastError = _sensor.read2(&_temperature, &_humidity, nullptr);
         
@@ -22,7 +23,9 @@ bool SensorAM2302::read() {
         }
         
         // Eine kurze Pause vor dem nächsten Versuch, damit der Sensor sich "erholen" kann.
-        delay(50); 
+        if (i + 1 < retries) {
+            Hal::get().delay(50);
+        }
     }
 
     // Wenn alle Versuche fehlgeschlagen sind, geben wir false zurück.
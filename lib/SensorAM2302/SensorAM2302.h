@@ -23,9 +23,14 @@ public:
     
     /**
      * @brief Liest die Raumtemperatur und Luftfeuchtigkeit vom Sensor.
+     *
+     * Bei einem Fehler wird der Leseversuch nach 50 ms wiederholt. Mit den Standardwerten blockiert der Aufruf
+     * im schlimmsten Fall also ca. 1 Sekunde. Ein einzelner Versuch dauert ca. 5 ms.
+     *
+     * @param retries Maximale Anzahl der Leseversuche (Standard: 20).
      * @return true bei erfolgreichem Auslesen, false bei Fehler.
      */
-    bool read();
+    bool read(int retries = 20);
 
     /**
      * @brief Gibt die zuletzt gemessene Temperatur in °C zurück.
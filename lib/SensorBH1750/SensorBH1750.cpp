@@ -1,15 +1,28 @@
 #include "SensorBH1750.h"
+#include "Hal.h"
+
+namespace {
+// Befehlscodes laut Datenblatt
+constexpr uint8_t CMD_POWER_ON = 0x01;
+
+// Umrechnung Rohwert -> Lux bei Standard-Messzeit (MTreg = 69)
+constexpr float COUNTS_PER_LUX = 1.2f;
+
+// Maximale Messdauer laut Datenblatt
+constexpr unsigned long HIGH_RES_MEASUREMENT_MS = 180;
+constexpr unsigned long LOW_RES_MEASUREMENT_MS = 24;
+}
 
 SensorBH1750::SensorBH1750(const uint8_t address)
-    : _drv(BH1750(address)),
+    : _address(address),
       _lux(NAN),
       _lastError(0),
-      _mode(BH1750::CONTINUOUS_HIGH_RES_MODE) {}
+      _mode(CONTINUOUS_HIGH_RES_MODE) {}
 
 bool SensorBH1750::begin() {
     // Die Initialisierung des I2C-Busses (Wire.begin()) sollte im Hauptprogramm erfolgen.
     // Wir prüfen hier, ob der Sensor auf dem Bus antwortet.
-    if (!_drv.begin(_mode)) {
+    if (!command(CMD_POWER_ON) || !command(_mode)) {
         _lastError = 1; // Initialisierung fehlgeschlagen
         return false;
     }
@@ -19,16 +32,30 @@ bool SensorBH1750::begin() {
 }
 
 bool SensorBH1750::read() {
-    float temp = _drv.readLightLevel();
+    if (isOneTime()) {
+        // Einzelmessung anstoßen und abwarten, danach schaltet sich der Sensor selbst ab
+        if (!command(_mode)) {
+            _lux = NAN;
+            _lastError = 2; // Lesen fehlgeschlagen
+            return false;
+        }
+        Hal::get().delay((_mode & 0x0F) == 0x03 ? LOW_RES_MEASUREMENT_MS : HIGH_RES_MEASUREMENT_MS);
+    }
 
-    // Die Bibliothek liefert negative Werte bei einem Lesefehler.
-    if (temp < 0) {
+    uint8_t data[2];
+    if (Hal::get().i2cRead(_address, data, sizeof(data)) != sizeof(data)) {
         _lux = NAN;
         _lastError = 2; // Lesen fehlgeschlagen
         return false;
     }
 
-    _lux = temp;
+    const uint16_t raw = static_cast<uint16_t>(data[0] << 8 | data[1]);
+    float lux = static_cast<float>(raw) / COUNTS_PER_LUX;
+    if ((_mode & 0x0F) == 0x01) {
+        lux /= 2; // Hohe Auflösung 2 zählt in halben Lux
+    }
+
+    _lux = lux;
     _lastError = 0;
     return true;
 }
@@ -50,9 +77,17 @@ const char* SensorBH1750::getErrorMessage() const {
     }
 }
 
-void SensorBH1750::setMode(BH1750::Mode mode) {
+void SensorBH1750::setMode(const Mode mode) {
     if (_mode != mode) {
         _mode = mode;
-        _drv.begin(_mode);
+        command(_mode);
     }
 }
+
+bool SensorBH1750::command(const uint8_t code) const {
+    return Hal::get().i2cWrite(_address, &code, 1);
+}
+
+bool SensorBH1750::isOneTime() const {
+    return (_mode & 0xF0) == 0x20;
+}
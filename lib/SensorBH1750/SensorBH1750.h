@@ -1,13 +1,27 @@
 #pragma once
 
 #include <Arduino.h>
-#include <BH1750.h>
 
 /**
  * @brief Klasse für den Lichtsensor GY-302 BH1750
+ *
+ * Spricht den Sensor direkt über die I2C-Funktionen von Hal an (kein externer Treiber), damit er im nativen Build
+ * simuliert werden kann.
  */
 class SensorBH1750 {
 public:
+    /**
+     * @brief Messmodi des BH1750 (die Werte sind die Befehlscodes laut Datenblatt).
+     */
+    enum Mode : uint8_t {
+        CONTINUOUS_HIGH_RES_MODE = 0x10,   // Kontinuierlich, 1 lx Auflösung, ~120 ms (Standard)
+        CONTINUOUS_HIGH_RES_MODE_2 = 0x11, // Kontinuierlich, 0,5 lx Auflösung, ~120 ms
+        CONTINUOUS_LOW_RES_MODE = 0x13,    // Kontinuierlich, 4 lx Auflösung, ~16 ms
+        ONE_TIME_HIGH_RES_MODE = 0x20,     // Einzelmessung, danach Power-Down
+        ONE_TIME_HIGH_RES_MODE_2 = 0x21,
+        ONE_TIME_LOW_RES_MODE = 0x23,
+    };
+
     /**
      * @brief Konstruktor.
      * @param address I2C-Adresse des Sensors: 0x23 (Standard) oder 0x5C.
@@ -15,7 +29,7 @@ public:
     explicit SensorBH1750(uint8_t address = 0x23);
 
     /**
-     * @brief Initialisiert das I2C-Interface und den BH1750-Treiber.
+     * @brief Schaltet den Sensor ein und stellt den Messmodus ein.
      * @return true bei erfolgreicher Initialisierung, false bei Fehler.
      */
     bool begin();
@@ -49,16 +63,28 @@ public:
      * 
      * Der BH1750 kann in verschiedenen Modi betrieben werden, die sich in Auflösung,
      * Messzeit und Stromverbrauch unterscheiden. Z.B.:
-     * - BH1750::CONTINUOUS_HIGH_RES_MODE (Standard): Kontinuierliche Messung, hohe Auflösung.
-     * - BH1750::ONE_TIME_HIGH_RES_MODE: Einzelmessung, danach geht der Sensor in den Power-Down-Modus.
+     * - CONTINUOUS_HIGH_RES_MODE (Standard): Kontinuierliche Messung, hohe Auflösung.
+     * - ONE_TIME_HIGH_RES_MODE: Einzelmessung, danach geht der Sensor in den Power-Down-Modus.
+     *   read() stößt dann jede Messung selbst an und wartet auf das Ergebnis.
      * 
-     * @param mode Der gewünschte Messmodus aus der BH1750-Bibliothek.
+     * @param mode Der gewünschte Messmodus.
      */
-    void setMode(BH1750::Mode mode);
+    void setMode(Mode mode);
 
 private:
-    BH1750 _drv;        // Die Instanz der zugrundeliegenden Bibliothek.
-    float _lux;         // Speichert den zuletzt erfolgreich gemessenen Lichtwert in Lux.
-    int _lastError;     // Speichert den Fehlercode der letzten Operation (0 = OK).
-    BH1750::Mode _mode; // Speichert den aktuell konfigurierten Messmodus des Sensors.
+    /**
+     * @brief Sendet einen einzelnen Befehl an den Sensor.
+     * @return true, wenn der Sensor den Befehl bestätigt hat.
+     */
+    bool command(uint8_t code) const;
+
+    /**
+     * @brief Ob der eingestellte Modus eine Einzelmessung ist.
+     */
+    bool isOneTime() const;
+
+    uint8_t _address; // I2C-Adresse des Sensors.
+    float _lux;       // Speichert den zuletzt erfolgreich gemessenen Lichtwert in Lux.
+    int _lastError;   // Speichert den Fehlercode der letzten Operation (0 = OK).
+    Mode _mode;       // Speichert den aktuell konfigurierten Messmodus des Sensors.
 };
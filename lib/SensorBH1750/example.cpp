@@ -6,6 +6,7 @@
  */
 
 #include <Arduino.h>
+#include <Wire.h>
 #include "SensorBH1750.h"
 
 SensorBH1750 sensor; // Standard-I2C-Adresse 0x23
@@ -1,4 +1,5 @@
 #include "SensorCapacitiveSoil.h"
+#include "Hal.h"
 
 SensorCapacitiveSoil::SensorCapacitiveSoil(uint8_t analogPin, int dryValue, int wetValue)
     : _pin(analogPin), _dry(dryValue), _wet(wetValue), _raw(-1), _percent(-1), _lastError(0) {}
@@ -19,7 +20,7 @@ bool SensorCapacitiveSoil::read() {
     }
 
     // analogRead Rückgabewerte können je nach Plattform variieren (0..4095 auf ESP32)
-    const int temp = analogRead(_pin);
+    const int temp = Hal::get().analogRead(_pin);
 
     // Liegt der Messwert im erwarteten Bereich? 
     // Falls der Sensor nicht angeschlossen ist, hängt der analoge Pin in der Luft und liefert zufällige Werte (wirkt wie eine Antenne).
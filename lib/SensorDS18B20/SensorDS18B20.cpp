@@ -1,7 +1,9 @@
 #include "SensorDS18B20.h"
+#include "Hal.h"
 
-SensorDS18B20::SensorDS18B20(uint8_t pin)
-    : _oneWire(pin), _sensor(&_oneWire), _addr{}, _temperature(NAN), _lastError(0) {
+SensorDS18B20::SensorDS18B20(uint8_t pin, uint8_t resolution)
+    : _oneWire(pin), _sensor(&_oneWire), _addr{}, _temperature(NAN), _lastError(0),
+      _resolution(static_cast<uint8_t>(constrain(resolution, 9, 12))), _converting(false), _conversionStart(0) {
 }
 
 bool SensorDS18B20::begin() {
@@ -20,16 +22,94 @@ bool SensorDS18B20::begin() {
         return false;
     }
 
+    // Auflösung setzen und requestTemperatures() nicht mehr auf das Ende der Wandlung warten lassen.
+    // Die Wartezeit übernimmt poll() (bzw. read()).
+    _sensor.setResolution(_addr, _resolution);
+    _sensor.setWaitForConversion(false);
+
+    _converting = false;
     _lastError = 0; // Alles ok
     return true;
 }
 
 bool SensorDS18B20::read() {
-    // Temperaturmessung anfordern (dieser Aufruf blockiert ca. 750ms!)
-    _sensor.requestTemperaturesByAddress(_addr); 
+    // Temperaturmessung anfordern und die Wandlungszeit abwarten (blockiert bis zu 750ms!)
+    _converting = false;
+    if (!startConversion()) {
+        return false;
+    }
+    Hal::get().delay(getConversionTime());
+    _converting = false;
 
     // Temperatur auslesen
-    float temp = _sensor.getTempC(_addr);
+    return fetchTemperature();
+}
+
+bool SensorDS18B20::startConversion() {
+    if (_converting) {
+        return true; // Messung läuft bereits
+    }
+
+    // Kehrt dank setWaitForConversion(false) sofort zurück.
+    if (!_sensor.requestTemperaturesByAddress(_addr)) {
+        _temperature = NAN;
+        _lastError = 3; // Sensor getrennt
+        return false;
+    }
+
+    _conversionStart = Hal::get().millis();
+    _converting = true;
+    return true;
+}
+
+bool SensorDS18B20::poll() {
+    if (!_converting) {
+        return false;
+    }
+
+    // Achte auf Overflow bei millis(): (now - start) ist sicher
+    if (Hal::get().millis() - _conversionStart < getConversionTime()) {
+        return false; // Wandlung läuft noch
+    }
+
+    _converting = false;
+    const bool success = fetchTemperature();
+    if (_callback) {
+        _callback(success, _temperature);
+    }
+    return true;
+}
+
+bool SensorDS18B20::isConverting() const {
+    return _converting;
+}
+
+void SensorDS18B20::setResolution(uint8_t bits) {
+    _resolution = static_cast<uint8_t>(constrain(bits, 9, 12));
+
+    // Ist der Sensor bereits initialisiert (Family-Code gesetzt), die Auflösung sofort übertragen.
+    if (_addr[0] != 0) {
+        _sensor.setResolution(_addr, _resolution);
+    }
+}
+
+uint8_t SensorDS18B20::getResolution() const {
+    return _resolution;
+}
+
+unsigned long SensorDS18B20::getConversionTime() const {
+    // Laut Datenblatt: 93.75 ms bei 9 Bit, jedes weitere Bit verdoppelt die Zeit. Die Bibliothek rundet auf
+    // (94/188/375/750 ms); abgerundet würde poll() das Scratchpad vor dem Ende der Wandlung lesen.
+    return static_cast<unsigned long>(_sensor.millisToWaitForConversion(_resolution));
+}
+
+void SensorDS18B20::onConversionComplete(ConversionCallback callback) {
+    _callback = std::move(callback);
+}
+
+bool SensorDS18B20::fetchTemperature() {
+    // Temperatur aus dem Scratchpad lesen (ohne erneute Wandlung)
+    const float temp = _sensor.getTempC(_addr);
 
     // Fehler beim Auslesen prüfen (z.B. wenn Sensor während des Betriebs getrennt wurde)
     if (temp == DEVICE_DISCONNECTED_C) {
@@ -2,34 +2,91 @@
 
 #include <Arduino.h>
 #include <DallasTemperature.h>
+#include <functional>
 
 /**
  * Klasse für den Bodentemperatursensor DS18B20
+ *
+ * Neben dem blockierenden read() gibt es eine nicht-blockierende Variante:
+ * startConversion() stößt die Messung an, poll() muss danach regelmäßig in loop() aufgerufen werden
+ * und liest den Messwert aus, sobald die Wandlungszeit (abhängig von der Auflösung) abgelaufen ist.
  */
 class SensorDS18B20 {
 public:
+    /**
+     * @brief Callback, der nach Abschluss einer nicht-blockierenden Messung aufgerufen wird.
+     * Format: (Erfolg, Temperatur in °C oder NAN)
+     */
+    using ConversionCallback = std::function<void(bool success, float temperature)>;
+
     /**
      * @brief Konstruktor mit Angabe des GPIO-Pins.
      * @param pin GPIO-Pin, an dem der Sensor angeschlossen ist.
+     * @param resolution Auflösung in Bit (9 bis 12, Standard: 12).
      */
-    explicit SensorDS18B20(uint8_t pin);
+    explicit SensorDS18B20(uint8_t pin, uint8_t resolution = 12);
 
     /**
      * @brief Initialisiert den Sensor.
-     * Führt eine erste Testmessung durch, um die Verbindung zu prüfen.
+     * Sucht den Sensor auf dem Bus, setzt die Auflösung und schaltet auf nicht-blockierende Messungen um.
      * @return true bei Erfolg, andernfalls false.
      */
     bool begin();
 
     /**
      * @brief Liest die Bodentemperatur vom Sensor.
-     * 
-     * Dieser Aufruf blockiert ca. 750ms!
-     * 
+     *
+     * Dieser Aufruf blockiert je nach Auflösung bis zu 750ms! In loop() besser startConversion() und poll() verwenden.
+     *
      * @return true bei erfolgreichem Auslesen, false bei Fehler.
      */
     bool read();
 
+    /**
+     * @brief Stößt eine Temperaturmessung an, ohne auf das Ergebnis zu warten.
+     * Läuft bereits eine Messung, passiert nichts.
+     * @return true, wenn eine Messung läuft, false bei Fehler.
+     */
+    bool startConversion();
+
+    /**
+     * @brief Muss regelmäßig in loop() aufgerufen werden, solange eine Messung läuft.
+     * Ist die Wandlungszeit abgelaufen, wird der Messwert ausgelesen und der Callback aufgerufen.
+     * @return true, wenn die Messung mit diesem Aufruf abgeschlossen wurde (erfolgreich oder nicht).
+     */
+    bool poll();
+
+    /**
+     * @brief Gibt an, ob gerade eine Messung läuft.
+     * @return true, wenn eine Messung angestoßen, aber noch nicht ausgelesen wurde.
+     */
+    bool isConverting() const;
+
+    /**
+     * @brief Setzt die Auflösung des Sensors.
+     * 9 Bit = 0.5 °C (94 ms), 10 Bit = 0.25 °C (188 ms), 11 Bit = 0.125 °C (375 ms), 12 Bit = 0.0625 °C (750 ms).
+     * @param bits Auflösung in Bit (wird auf 9 bis 12 begrenzt).
+     */
+    void setResolution(uint8_t bits);
+
+    /**
+     * @brief Gibt die eingestellte Auflösung zurück.
+     * @return Auflösung in Bit (9 bis 12).
+     */
+    uint8_t getResolution() const;
+
+    /**
+     * @brief Gibt die Wandlungszeit für die eingestellte Auflösung zurück.
+     * @return Wandlungszeit in Millisekunden.
+     */
+    unsigned long getConversionTime() const;
+
+    /**
+     * @brief Registriert einen Callback, der nach jeder nicht-blockierenden Messung aufgerufen wird.
+     * @param callback Die aufzurufende Funktion (nullptr zum Entfernen).
+     */
+    void onConversionComplete(ConversionCallback callback);
+
     /**
      * @brief Gibt die zuletzt gemessene Temperatur in °C.
      * @return Temperatur (float), oder NAN bei Fehler.
@@ -54,4 +111,14 @@ private:
     DeviceAddress _addr;           // Sensoradresse
     float _temperature;            // Letzte gemessene Temperatur
     int _lastError;                // Fehlercode
+    uint8_t _resolution;           // Auflösung in Bit (9 bis 12)
+    bool _converting;              // true, solange eine Messung läuft
+    uint32_t _conversionStart;     // millis() beim Anstoßen der Messung
+    ConversionCallback _callback;  // Callback nach Abschluss einer Messung
+
+    /**
+     * @brief Liest den Messwert aus dem Scratchpad und aktualisiert Temperatur und Fehlercode.
+     * @return true bei Erfolg, false bei Fehler.
+     */
+    bool fetchTemperature();
 };
@@ -2,6 +2,7 @@
  * Beispiel zur Nutzung der SensorDS18B20-Bibliothek
  * 
  * Das Beispiel liest alle zwei Sekunden die Bodentemperatur vom Sensor und sendet sie über die serielle Schnittstelle. 
+ * Die Messung läuft nicht-blockierend: startConversion() stößt sie an, poll() liefert das Ergebnis über den Callback.
  * 
  * Ein [Serial Plotter](https://github.com/badlogic/serial-plotter) könnte die Daten entgegennehmen und visualisieren.
  */
@@ -10,6 +11,7 @@
 #include "SensorDS18B20.h"
 
 SensorDS18B20 sensor(4); // GPIO4
+unsigned long lastRequest = 0;
 
 void setup() {
     Serial.begin(115200);
@@ -18,17 +20,23 @@ void setup() {
         Serial.print("Initialisierung fehlgeschlagen: ");
         Serial.println(sensor.getErrorMessage());
     }
+    sensor.onConversionComplete([](const bool success, const float temperature) {
+        if (success) {
+            Serial.print(">Temperatur:"); // °C
+            Serial.println(temperature);
+        } else {
+            Serial.print("Fehler ");
+            Serial.print(sensor.getLastError());
+            Serial.print(": ");
+            Serial.println(sensor.getErrorMessage());
+        }
+    });
 }
 
 void loop() {
-    if (sensor.read()) {
-        Serial.print(">Temperatur:"); // °C
-        Serial.println(sensor.getTemperature());
-    } else {
-        Serial.print("Fehler ");
-        Serial.print(sensor.getLastError());
-        Serial.print(": ");
-        Serial.println(sensor.getErrorMessage());
+    if (millis() - lastRequest >= 2000) {
+        lastRequest = millis();
+        sensor.startConversion();
     }
-    delay(2000);
+    sensor.poll(); // kehrt sofort zurück, solange die Wandlung läuft
 }
@@ -0,0 +1,250 @@
+#include "SensorHistory.h"
+#include <esp_heap_caps.h>
+
+SensorHistory::SensorHistory()
+    : _channels(0), _capacity(0), _interval(0), _memory(nullptr), _times(nullptr), _head(0), _size(0), _unsaved(0),
+      _lost(0), _mutex(nullptr) {}
+
+SensorHistory::~SensorHistory() {
+    heap_caps_free(_memory);
+    if (_mutex) {
+        vSemaphoreDelete(_mutex);
+    }
+}
+
+int SensorHistory::addChannel(const char* name, const float scale) {
+    if (_memory || _channels >= MAX_CHANNELS || scale <= 0) {
+        return -1;
+    }
+    _names[_channels] = name;
+    _scales[_channels] = scale;
+    return _channels++;
+}
+
+bool SensorHistory::begin(const uint16_t capacity, const uint32_t intervalSec) {
+    if (_memory || capacity == 0) {
+        return _memory != nullptr;
+    }
+
+    // Eine Spalte mit Zeitstempeln und je Kanal eine int16-Spalte, alles in einem Block (bevorzugt im PSRAM)
+    const size_t size = capacity * (sizeof(uint32_t) + _channels * sizeof(int16_t));
+    _memory = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!_memory) {
+        _memory = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    _mutex = xSemaphoreCreateMutex();
+    if (!_memory || !_mutex) {
+        return false;
+    }
+
+    _times = static_cast<uint32_t*>(_memory);
+    auto* column = reinterpret_cast<int16_t*>(_times + capacity);
+    for (uint8_t i = 0; i < _channels; i++) {
+        _columns[i] = column;
+        column += capacity;
+    }
+    _capacity = capacity;
+    _interval = intervalSec;
+    return true;
+}
+
+void SensorHistory::record(const uint32_t time, const float* values) {
+    if (!_memory) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _times[_head] = time;
+    for (uint8_t i = 0; i < _channels; i++) {
+        _columns[i][_head] = encode(i, values[i]);
+    }
+    _head = (_head + 1) % _capacity;
+    if (_size < _capacity) {
+        _size++;
+    }
+    if (_unsaved < _capacity) {
+        _unsaved++;
+    } else {
+        _lost++; // die älteste ungesicherte Zeile wurde gerade überschrieben
+    }
+    xSemaphoreGive(_mutex);
+}
+
+uint16_t SensorHistory::query(const int channel, const uint32_t from, const uint32_t to, const uint16_t buckets, Bucket* out) {
+    if (!_memory || channel < 0 || channel >= _channels || buckets == 0 || to <= from) {
+        return 0;
+    }
+
+    // Summen in Festkomma bilden, erst am Ende umrechnen
+    struct Sum {
+        int32_t min = INT16_MAX;
+        int32_t max = INT16_MIN;
+        int32_t total = 0;
+        uint16_t count = 0;
+    };
+    Sum* sums = new Sum[buckets];
+    const uint32_t span = to - from;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const int16_t* column = _columns[channel];
+    for (uint16_t i = 0; i < _size; i++) {
+        const uint16_t index = indexOf(i);
+        const uint32_t time = _times[index];
+        if (time < from) {
+            continue;
+        }
+        if (time >= to) {
+            break; // Zeitstempel sind aufsteigend
+        }
+        const int16_t value = column[index];
+        if (value == MISSING) {
+            continue;
+        }
+        Sum& sum = sums[static_cast<uint64_t>(time - from) * buckets / span];
+        if (value < sum.min) {
+            sum.min = value;
+        }
+        if (value > sum.max) {
+            sum.max = value;
+        }
+        sum.total += value;
+        sum.count++;
+    }
+    xSemaphoreGive(_mutex);
+
+    for (uint16_t b = 0; b < buckets; b++) {
+        out[b] = Bucket();
+        if (sums[b].count > 0) {
+            out[b].min = decode(channel, static_cast<int16_t>(sums[b].min));
+            out[b].max = decode(channel, static_cast<int16_t>(sums[b].max));
+            out[b].avg = static_cast<float>(sums[b].total) / static_cast<float>(sums[b].count) / _scales[channel];
+            out[b].count = sums[b].count;
+        }
+    }
+    delete[] sums;
+    return buckets;
+}
+
+size_t SensorHistory::getRowSize() const {
+    return sizeof(uint32_t) + _channels * sizeof(int16_t);
+}
+
+uint16_t SensorHistory::getUnsavedCount() {
+    if (!_memory) {
+        return 0;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const uint16_t unsaved = _unsaved;
+    xSemaphoreGive(_mutex);
+    return unsaved;
+}
+
+uint16_t SensorHistory::readUnsaved(uint8_t* buffer, const size_t size, uint32_t& firstTime) {
+    if (!_memory) {
+        return 0;
+    }
+    const size_t rowSize = getRowSize();
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    uint16_t rows = _unsaved;
+    if (rows > size / rowSize) {
+        rows = size / rowSize;
+    }
+    const uint16_t first = _size - _unsaved; // älteste ungesicherte Zeile
+    for (uint16_t r = 0; r < rows; r++) {
+        // Zeilenweise zusammensetzen (der ESP32 ist little endian, daher direkt kopieren)
+        const uint16_t index = indexOf(first + r);
+        uint8_t* row = buffer + r * rowSize;
+        memcpy(row, &_times[index], sizeof(uint32_t));
+        for (uint8_t c = 0; c < _channels; c++) {
+            memcpy(row + sizeof(uint32_t) + c * sizeof(int16_t), &_columns[c][index], sizeof(int16_t));
+        }
+    }
+    firstTime = rows > 0 ? _times[indexOf(first)] : 0;
+    xSemaphoreGive(_mutex);
+    return rows;
+}
+
+void SensorHistory::markSaved(const uint16_t rows) {
+    if (!_memory) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _unsaved = rows < _unsaved ? _unsaved - rows : 0;
+    xSemaphoreGive(_mutex);
+}
+
+uint32_t SensorHistory::getLostCount() const {
+    return _lost;
+}
+
+uint32_t SensorHistory::getOldestTime() {
+    if (!_memory) {
+        return 0;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const uint32_t time = _size > 0 ? _times[indexOf(0)] : 0;
+    xSemaphoreGive(_mutex);
+    return time;
+}
+
+uint32_t SensorHistory::getNewestTime() {
+    if (!_memory) {
+        return 0;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const uint32_t time = _size > 0 ? _times[indexOf(_size - 1)] : 0;
+    xSemaphoreGive(_mutex);
+    return time;
+}
+
+uint8_t SensorHistory::getChannelCount() const {
+    return _channels;
+}
+
+const char* SensorHistory::getChannelName(const int channel) const {
+    return channel >= 0 && channel < _channels ? _names[channel] : "";
+}
+
+int SensorHistory::getChannel(const char* name) const {
+    for (uint8_t i = 0; i < _channels; i++) {
+        if (strcmp(_names[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint16_t SensorHistory::getCapacity() const {
+    return _capacity;
+}
+
+uint16_t SensorHistory::getSize() const {
+    return _size;
+}
+
+uint32_t SensorHistory::getInterval() const {
+    return _interval;
+}
+
+int16_t SensorHistory::encode(const uint8_t channel, const float value) const {
+    if (isnan(value)) {
+        return MISSING;
+    }
+    // Auf den darstellbaren Bereich begrenzen (MISSING ist reserviert)
+    const float scaled = roundf(value * _scales[channel]);
+    if (scaled <= INT16_MIN) {
+        return INT16_MIN + 1;
+    }
+    if (scaled >= INT16_MAX) {
+        return INT16_MAX;
+    }
+    return static_cast<int16_t>(scaled);
+}
+
+float SensorHistory::decode(const uint8_t channel, const int16_t value) const {
+    return value == MISSING ? NAN : static_cast<float>(value) / _scales[channel];
+}
+
+uint16_t SensorHistory::indexOf(const uint16_t i) const {
+    // Bei vollem Ringpuffer ist _head die älteste Zeile, sonst Index 0
+    return _size < _capacity ? i : (_head + i) % _capacity;
+}
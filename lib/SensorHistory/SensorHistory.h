@@ -0,0 +1,157 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * Zeitreihenspeicher für Messwerte im RAM.
+ *
+ * Die Werte werden spaltenweise als Festkommazahl (int16) in einem Ringpuffer fester Größe abgelegt: eine Spalte je
+ * Kanal, dazu eine Spalte mit dem Zeitstempel. Der Speicher wird einmal in begin() reserviert.
+ *
+ * query() fasst einen Zeitraum zu Abschnitten (Buckets) mit Minimum, Maximum und Mittelwert zusammen, damit ein Diagramm
+ * nicht alle Rohwerte übertragen muss. Noch nicht gesicherte Zeilen können mit readUnsaved() im Dateiformat ausgelesen
+ * und z.B. an eine Datei auf der SD-Karte angehängt werden.
+ *
+ * record() und query() dürfen aus verschiedenen Tasks aufgerufen werden (geschützt durch einen Mutex).
+ */
+class SensorHistory {
+public:
+    static constexpr uint8_t MAX_CHANNELS = 8;         // Maximale Anzahl Kanäle
+    static constexpr int16_t MISSING = INT16_MIN;      // Gespeicherter Wert für "kein Messwert" (NAN)
+
+    /**
+     * @struct Bucket
+     * @brief Zusammenfassung eines Abschnitts (Ergebnis von query()).
+     */
+    struct Bucket {
+        float min = NAN;     // Kleinster Wert (NAN, wenn der Abschnitt keine Werte enthält)
+        float max = NAN;     // Größter Wert
+        float avg = NAN;     // Mittelwert
+        uint16_t count = 0;  // Anzahl der Werte im Abschnitt
+    };
+
+    SensorHistory();
+    ~SensorHistory();
+
+    SensorHistory(const SensorHistory&) = delete;
+    SensorHistory& operator=(const SensorHistory&) = delete;
+
+    /**
+     * @brief Meldet einen Kanal an (vor begin()).
+     * @param name Kurzer Name (z.B. "airTemp"), wird nicht kopiert.
+     * @param scale Faktor für die Festkommadarstellung (gespeichert wird round(value * scale)). Er bestimmt Auflösung
+     *              und Wertebereich, z.B. 100 für 0.01 °C (±327 °C) oder 0.5 für 2 lx (bis 65534 lx).
+     * @return ID des Kanals, oder -1, wenn kein Platz mehr frei ist oder begin() schon aufgerufen wurde.
+     */
+    int addChannel(const char* name, float scale);
+
+    /**
+     * @brief Reserviert den Speicher.
+     * @param capacity Anzahl der Zeilen im Ringpuffer.
+     * @param intervalSec Abstand zwischen zwei Zeilen in Sekunden (nur zur Information, record() prüft ihn nicht).
+     * @return true bei Erfolg, false, wenn der Speicher nicht reicht.
+     */
+    bool begin(uint16_t capacity, uint32_t intervalSec);
+
+    /**
+     * @brief Hängt eine Zeile an (überschreibt die älteste, wenn der Ringpuffer voll ist).
+     * @param time Zeitstempel (Unix-Zeit in Sekunden, muss aufsteigend sein).
+     * @param values Ein Wert je Kanal in der Reihenfolge von addChannel() (NAN = kein Messwert).
+     */
+    void record(uint32_t time, const float* values);
+
+    /**
+     * @brief Fasst einen Zeitraum zusammen.
+     * Der Zeitraum [from, to) wird in gleich lange Abschnitte geteilt; für jeden werden Minimum, Maximum und Mittelwert
+     * der darin liegenden Werte berechnet.
+     * @param channel ID des Kanals.
+     * @param from Beginn (Unix-Zeit in Sekunden).
+     * @param to Ende (Unix-Zeit in Sekunden, exklusiv).
+     * @param buckets Anzahl der Abschnitte.
+     * @param out Ziel-Array mit mindestens buckets Einträgen.
+     * @return Anzahl der Abschnitte (0 bei ungültigen Parametern).
+     */
+    uint16_t query(int channel, uint32_t from, uint32_t to, uint16_t buckets, Bucket* out);
+
+    /**
+     * @brief Gibt die Größe einer Zeile im Dateiformat zurück (Zeitstempel + ein int16 je Kanal).
+     */
+    size_t getRowSize() const;
+
+    /**
+     * @brief Gibt die Anzahl der Zeilen zurück, die noch nicht mit markSaved() gesichert wurden.
+     */
+    uint16_t getUnsavedCount();
+
+    /**
+     * @brief Kopiert die ältesten noch nicht gesicherten Zeilen im Dateiformat (little endian) in einen Puffer.
+     * Format einer Zeile: uint32 Zeitstempel, danach ein int16 je Kanal (Festkomma, MISSING = kein Wert).
+     * @param buffer Zielpuffer.
+     * @param size Größe des Zielpuffers in Byte.
+     * @param firstTime Zeitstempel der ersten kopierten Zeile (z.B. für den Dateinamen).
+     * @return Anzahl der kopierten Zeilen.
+     */
+    uint16_t readUnsaved(uint8_t* buffer, size_t size, uint32_t& firstTime);
+
+    /**
+     * @brief Markiert Zeilen als gesichert (nach erfolgreichem Schreiben der mit readUnsaved() gelesenen Zeilen).
+     * @param rows Anzahl der Zeilen.
+     */
+    void markSaved(uint16_t rows);
+
+    /**
+     * @brief Gibt die Anzahl der Zeilen zurück, die überschrieben wurden, bevor sie gesichert waren.
+     */
+    uint32_t getLostCount() const;
+
+    /**
+     * @brief Gibt den Zeitstempel der ältesten Zeile zurück (0 = leer).
+     */
+    uint32_t getOldestTime();
+
+    /**
+     * @brief Gibt den Zeitstempel der neuesten Zeile zurück (0 = leer).
+     */
+    uint32_t getNewestTime();
+
+    uint8_t getChannelCount() const;
+    const char* getChannelName(int channel) const;
+    int getChannel(const char* name) const;
+    uint16_t getCapacity() const;
+    uint16_t getSize() const;
+    uint32_t getInterval() const;
+
+private:
+    /**
+     * @brief Wandelt einen Messwert in die Festkommadarstellung um.
+     */
+    int16_t encode(uint8_t channel, float value) const;
+
+    /**
+     * @brief Wandelt einen gespeicherten Wert zurück.
+     */
+    float decode(uint8_t channel, int16_t value) const;
+
+    /**
+     * @brief Index der i-ten Zeile (0 = älteste).
+     */
+    uint16_t indexOf(uint16_t i) const;
+
+    const char* _names[MAX_CHANNELS] = {};
+    float _scales[MAX_CHANNELS] = {};
+    uint8_t _channels;
+    uint16_t _capacity;
+    uint32_t _interval;
+
+    void* _memory;          // Speicher für alle Spalten (ein Block)
+    uint32_t* _times;       // Spalte mit den Zeitstempeln
+    int16_t* _columns[MAX_CHANNELS] = {}; // Eine Spalte je Kanal
+
+    uint16_t _head;         // Index der nächsten zu schreibenden Zeile
+    uint16_t _size;         // Anzahl der belegten Zeilen
+    uint16_t _unsaved;      // Anzahl der neuesten Zeilen, die noch nicht gesichert sind
+    uint32_t _lost;         // Überschriebene, nicht gesicherte Zeilen
+    SemaphoreHandle_t _mutex;
+};
@@ -0,0 +1,36 @@
+/**
+ * Beispiel zur Nutzung der SensorHistory-Bibliothek
+ *
+ * Zeichnet jede Sekunde einen simulierten Temperaturverlauf auf und gibt alle 10 Sekunden eine Zusammenfassung der
+ * letzten Minute aus (6 Abschnitte zu je 10 Sekunden).
+ */
+
+#include <Arduino.h>
+#include "SensorHistory.h"
+
+SensorHistory history;
+
+void setup() {
+    Serial.begin(115200);
+    history.addChannel("temp", 100); // 0.01 °C
+    if (!history.begin(600, 1)) {
+        Serial.println("Zu wenig Speicher.");
+    }
+}
+
+void loop() {
+    // Messwert simulieren (Sinus um 22 °C)
+    const uint32_t now = millis() / 1000;
+    const float values[] = {22.0f + 2.0f * sinf(static_cast<float>(now) / 30.0f)};
+    history.record(now, values);
+
+    if (now % 10 == 0 && now >= 60) {
+        SensorHistory::Bucket buckets[6];
+        history.query(0, now - 60, now, 6, buckets);
+        for (const SensorHistory::Bucket& bucket : buckets) {
+            Serial.printf("min %.2f  max %.2f  avg %.2f  (%u Werte)\n", bucket.min, bucket.max, bucket.avg, bucket.count);
+        }
+        Serial.println();
+    }
+    delay(1000);
+}
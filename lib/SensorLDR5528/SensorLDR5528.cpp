@@ -1,4 +1,5 @@
 #include "SensorLDR5528.h"
+#include "Hal.h"
 #include <math.h>
 
 SensorLDR5528::SensorLDR5528(uint8_t analogPin, float fixedResistorOhm, uint16_t adcMax) 
@@ -16,8 +17,8 @@ bool SensorLDR5528::read() {
     uint32_t sum = 0;
     constexpr uint8_t samples = 5;
     for (uint8_t i = 0; i < samples; ++i) {
-        sum += analogRead(_pin);
-        delay(5); // Kurze Pause zwischen den Messungen
+        sum += Hal::get().analogRead(_pin);
+        Hal::get().delay(5); // Kurze Pause zwischen den Messungen
     }
     _raw = static_cast<uint16_t>(sum / samples);
 
@@ -0,0 +1,198 @@
+#include "SensorScheduler.h"
+#include "Hal.h"
+
+SensorScheduler::SensorScheduler(const unsigned long budgetUs)
+    : _count(0), _budgetUs(budgetUs), _lastRunDuration(0), _maxRunDuration(0) {}
+
+int SensorScheduler::addSensor(const char* name, const unsigned long periodMs, const unsigned long conversionMs,
+                               const unsigned long deadlineMs, StartFunction start, FinishFunction finish) {
+    if (_count >= MAX_SENSORS || !finish) {
+        return -1;
+    }
+
+    Task& task = _tasks[_count];
+    task.name = name;
+    task.period = periodMs;
+    task.conversion = conversionMs;
+    task.deadline = deadlineMs;
+    task.start = std::move(start);
+    task.finish = std::move(finish);
+    task.state = State::Idle;
+    task.dueAt = Hal::get().millis(); // sofort fällig
+    task.nextStepAt = task.dueAt;
+    return _count++;
+}
+
+void SensorScheduler::setErrorSource(const int id, ErrorFunction error) {
+    if (id >= 0 && id < _count) {
+        _tasks[id].error = std::move(error);
+    }
+}
+
+void SensorScheduler::onDeadlineMiss(MissCallback callback) {
+    _onMiss = std::move(callback);
+}
+
+void SensorScheduler::run() {
+    Hal& hal = Hal::get();
+    const uint32_t runStart = hal.micros();
+
+    do {
+        const uint32_t now = hal.millis();
+        const int index = pickNext(now);
+        if (index < 0) {
+            break; // nichts zu tun
+        }
+        Task& task = _tasks[index];
+        const uint32_t misses = task.deadlineMisses;
+        step(task, now);
+        if (task.deadlineMisses != misses && _onMiss) {
+            _onMiss(index);
+        }
+    } while (hal.micros() - runStart < _budgetUs);
+
+    _lastRunDuration = hal.micros() - runStart;
+    if (_lastRunDuration > _maxRunDuration) {
+        _maxRunDuration = _lastRunDuration;
+    }
+}
+
+bool SensorScheduler::isDue() const {
+    return pickNext(Hal::get().millis()) >= 0;
+}
+
+int SensorScheduler::pickNext(const uint32_t now) const {
+    int best = -1;
+    int32_t bestSlack = 0;
+    for (int i = 0; i < _count; i++) {
+        const Task& task = _tasks[i];
+
+        // Achte auf Overflow bei millis(): Differenzen als int32_t auswerten
+        if (static_cast<int32_t>(now - task.nextStepAt) < 0) {
+            continue; // noch nicht bereit
+        }
+
+        // Verbleibende Zeit bis zur Deadline (negativ = überfällig)
+        const auto slack = static_cast<int32_t>(task.dueAt + task.deadline - now);
+        if (best < 0 || slack < bestSlack) {
+            best = i;
+            bestSlack = slack;
+        }
+    }
+    return best;
+}
+
+void SensorScheduler::step(Task& task, const uint32_t now) {
+    if (task.state == State::Idle && task.start) {
+        // Schritt 1: Messung anstoßen
+        if (task.start()) {
+            task.state = State::Converting;
+            task.nextStepAt = now + task.conversion;
+            return;
+        }
+    } else {
+        // Schritt 2: Ergebnis lesen (Sensoren ohne start() landen direkt hier)
+        const Result result = task.finish();
+        if (result == Result::Pending) {
+            task.nextStepAt = now + 1; // im nächsten Durchlauf erneut versuchen
+            return;
+        }
+        task.state = State::Idle;
+        if (result == Result::Success) {
+            task.sampledAt.store(now, std::memory_order_relaxed);
+            task.hasSample.store(true, std::memory_order_release);
+
+            // Nächste Messung im festen Raster planen, damit das Intervall nicht wandert.
+            task.dueAt += task.period;
+            if (static_cast<int32_t>(now - task.dueAt) >= 0) {
+                task.dueAt = now + task.period; // zu weit im Rückstand, Raster neu ansetzen
+            }
+            task.nextStepAt = task.dueAt;
+            return;
+        }
+    }
+
+    // Fehler: bis zur Deadline nach kurzer Pause wiederholen, danach auf das nächste Intervall verschieben.
+    countFailure(task);
+    task.state = State::Idle;
+    if (static_cast<int32_t>(now + RETRY_DELAY - (task.dueAt + task.deadline)) < 0) {
+        task.nextStepAt = now + RETRY_DELAY;
+    } else {
+        task.deadlineMisses++;
+        task.dueAt = now + task.period;
+        task.nextStepAt = task.dueAt;
+    }
+}
+
+void SensorScheduler::countFailure(Task& task) {
+    task.failures++;
+    const int code = task.error ? task.error() : 0;
+    for (uint8_t i = 0; i < task.errorCodes; i++) {
+        if (task.errors[i].code == code) {
+            task.errors[i].count++;
+            return;
+        }
+    }
+    if (task.errorCodes < MAX_ERROR_CODES) {
+        task.errors[task.errorCodes] = {code, 1};
+        task.errorCodes++;
+    }
+}
+
+void SensorScheduler::setBudget(const unsigned long budgetUs) {
+    _budgetUs = budgetUs;
+}
+
+void SensorScheduler::triggerAll() {
+    const uint32_t now = Hal::get().millis();
+    for (int i = 0; i < _count; i++) {
+        if (_tasks[i].state == State::Idle) {
+            _tasks[i].dueAt = now;
+            _tasks[i].nextStepAt = now;
+        }
+    }
+}
+
+uint8_t SensorScheduler::getSensorCount() const {
+    return _count;
+}
+
+const char* SensorScheduler::getName(const int id) const {
+    return (id >= 0 && id < _count) ? _tasks[id].name : "";
+}
+
+bool SensorScheduler::hasSample(const int id) const {
+    return id >= 0 && id < _count && _tasks[id].hasSample.load(std::memory_order_acquire);
+}
+
+uint32_t SensorScheduler::getLastSampledAt(const int id) const {
+    return (id >= 0 && id < _count) ? _tasks[id].sampledAt.load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t SensorScheduler::getDeadlineMisses(const int id) const {
+    return (id >= 0 && id < _count) ? _tasks[id].deadlineMisses : 0;
+}
+
+uint32_t SensorScheduler::getFailures(const int id) const {
+    return (id >= 0 && id < _count) ? _tasks[id].failures : 0;
+}
+
+uint8_t SensorScheduler::getErrorCounts(const int id, ErrorCount* counts, const uint8_t maxCounts) const {
+    if (id < 0 || id >= _count) {
+        return 0;
+    }
+    const Task& task = _tasks[id];
+    const uint8_t n = task.errorCodes < maxCounts ? task.errorCodes : maxCounts;
+    for (uint8_t i = 0; i < n; i++) {
+        counts[i] = task.errors[i];
+    }
+    return n;
+}
+
+unsigned long SensorScheduler::getLastRunDuration() const {
+    return _lastRunDuration;
+}
+
+unsigned long SensorScheduler::getMaxRunDuration() const {
+    return _maxRunDuration;
+}
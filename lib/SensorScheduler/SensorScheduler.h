@@ -0,0 +1,241 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+
+/**
+ * Kooperativer Scheduler für die Sensoren.
+ *
+ * Jeder Sensor wird mit eigenem Messintervall, minimaler Wandlungszeit und Deadline registriert.
+ * Eine Messung besteht aus zwei kurzen Schritten: start() stößt die Messung an, finish() liest das Ergebnis
+ * (frühestens nach Ablauf der Wandlungszeit). run() muss in jedem loop()-Durchlauf aufgerufen werden und führt
+ * so viele Schritte aus, wie das Zeitbudget zulässt. Damit verteilt sich die Arbeit auf mehrere Durchläufe,
+ * statt alle Sensoren auf einmal zu lesen.
+ */
+class SensorScheduler {
+public:
+    /**
+     * @enum Result
+     * @brief Ergebnis des finish()-Schritts.
+     */
+    enum class Result : uint8_t {
+        Pending, // Messwert liegt noch nicht vor, finish() später erneut aufrufen
+        Success, // Messwert erfolgreich gelesen
+        Failed   // Messung fehlgeschlagen (wird bis zur Deadline wiederholt)
+    };
+
+    /**
+     * @brief Stößt eine Messung an.
+     * Format: () -> true bei Erfolg, false bei Fehler
+     */
+    using StartFunction = std::function<bool()>;
+
+    /**
+     * @brief Liest das Ergebnis einer Messung.
+     * Format: () -> Result
+     */
+    using FinishFunction = std::function<Result()>;
+
+    /**
+     * @brief Liefert den Fehlercode des Sensors nach einem fehlgeschlagenen Schritt (z.B. getLastError()).
+     * Format: () -> Fehlercode
+     */
+    using ErrorFunction = std::function<int()>;
+
+    /**
+     * @brief Wird aufgerufen, wenn ein Sensor seine Deadline verpasst hat (kein Messwert in diesem Intervall).
+     * Format: (ID des Sensors) -> void
+     */
+    using MissCallback = std::function<void(int id)>;
+
+    /**
+     * @struct ErrorCount
+     * @brief Anzahl der Fehlschläge mit einem bestimmten Fehlercode.
+     */
+    struct ErrorCount {
+        int code = 0;
+        uint32_t count = 0;
+    };
+
+    static constexpr uint8_t MAX_SENSORS = 8;       // Maximale Anzahl registrierter Sensoren
+    static constexpr uint8_t MAX_ERROR_CODES = 4;   // Maximale Anzahl getrennt gezählter Fehlercodes pro Sensor
+    static constexpr uint32_t RETRY_DELAY = 100;    // Wartezeit in ms vor einer Wiederholung nach einem Fehler
+
+    /**
+     * @brief Konstruktor.
+     * @param budgetUs Zeitbudget in Mikrosekunden pro run()-Aufruf (Standard: 5 ms).
+     */
+    explicit SensorScheduler(unsigned long budgetUs = 5000);
+
+    /**
+     * @brief Registriert einen Sensor.
+     * @param name Kurzer Name des Sensors (z.B. "air"), wird nicht kopiert.
+     * @param periodMs Messintervall in ms.
+     * @param conversionMs Minimale Zeit in ms zwischen start() und finish() (0 = sofort).
+     * @param deadlineMs Zeit in ms nach Fälligkeit, bis zu der die Messung abgeschlossen sein muss (inkl. Wiederholungen).
+     * @param start Stößt die Messung an (nullptr, wenn der Sensor keine Wandlungszeit hat).
+     * @param finish Liest das Ergebnis.
+     * @return ID des Sensors, oder -1, wenn kein Platz mehr frei ist.
+     */
+    int addSensor(const char* name, unsigned long periodMs, unsigned long conversionMs, unsigned long deadlineMs,
+                  StartFunction start, FinishFunction finish);
+
+    /**
+     * @brief Legt fest, woher der Scheduler den Fehlercode eines fehlgeschlagenen Schritts bekommt.
+     * Ohne Fehlerquelle werden alle Fehlschläge unter Code 0 gezählt.
+     * @param id ID des Sensors.
+     * @param error Liefert den Fehlercode (wird nur nach einem Fehlschlag aufgerufen).
+     */
+    void setErrorSource(int id, ErrorFunction error);
+
+    /**
+     * @brief Legt fest, was bei einer verpassten Deadline passiert (z.B. den alten Messwert ungültig machen).
+     * Der Callback läuft innerhalb von run().
+     * @param callback Wird mit der ID des Sensors aufgerufen (nullptr = keiner).
+     */
+    void onDeadlineMiss(MissCallback callback);
+
+    /**
+     * @brief Muss in jedem loop()-Durchlauf aufgerufen werden.
+     * Führt fällige Schritte nach Deadline sortiert aus (Earliest Deadline First), bis das Zeitbudget verbraucht ist.
+     * Mindestens ein Schritt wird immer ausgeführt, damit kein Sensor verhungert.
+     */
+    void run();
+
+    /**
+     * @brief Gibt an, ob ein Schritt fällig ist, d.h. der nächste run()-Aufruf einen Sensor liest.
+     */
+    bool isDue() const;
+
+    /**
+     * @brief Setzt das Zeitbudget pro run()-Aufruf.
+     * @param budgetUs Zeitbudget in Mikrosekunden.
+     */
+    void setBudget(unsigned long budgetUs);
+
+    /**
+     * @brief Macht alle Sensoren sofort fällig (z.B. nach dem Start).
+     */
+    void triggerAll();
+
+    /**
+     * @brief Gibt die Anzahl der registrierten Sensoren zurück.
+     */
+    uint8_t getSensorCount() const;
+
+    /**
+     * @brief Gibt den Namen eines Sensors zurück.
+     * @param id ID des Sensors.
+     * @return Name, oder "" bei ungültiger ID.
+     */
+    const char* getName(int id) const;
+
+    /**
+     * @brief Gibt an, ob der Sensor schon einmal erfolgreich gemessen hat.
+     * Darf (wie getLastSampledAt()) aus einem anderen Task als run() aufgerufen werden.
+     * @param id ID des Sensors.
+     */
+    bool hasSample(int id) const;
+
+    /**
+     * @brief Gibt den Zeitpunkt (millis()) der letzten erfolgreichen Messung zurück.
+     * @param id ID des Sensors.
+     * @return Zeitstempel in ms seit Start (nur gültig, wenn hasSample() true liefert).
+     */
+    uint32_t getLastSampledAt(int id) const;
+
+    /**
+     * @brief Gibt die Anzahl der verpassten Deadlines eines Sensors zurück.
+     * @param id ID des Sensors.
+     */
+    uint32_t getDeadlineMisses(int id) const;
+
+    /**
+     * @brief Gibt die Anzahl aller fehlgeschlagenen Schritte eines Sensors zurück (inkl. Wiederholungen).
+     * @param id ID des Sensors.
+     */
+    uint32_t getFailures(int id) const;
+
+    /**
+     * @brief Kopiert die Fehlschläge eines Sensors nach Fehlercode.
+     * Es werden höchstens MAX_ERROR_CODES verschiedene Codes getrennt gezählt; Fehlschläge mit weiteren Codes
+     * zählen nur in getFailures().
+     * @param id ID des Sensors.
+     * @param counts Ziel für die Zähler.
+     * @param maxCounts Platz in counts.
+     * @return Anzahl der kopierten Einträge.
+     */
+    uint8_t getErrorCounts(int id, ErrorCount* counts, uint8_t maxCounts) const;
+
+    /**
+     * @brief Gibt die Dauer des letzten run()-Aufrufs zurück.
+     * @return Dauer in Mikrosekunden.
+     */
+    unsigned long getLastRunDuration() const;
+
+    /**
+     * @brief Gibt die längste Dauer eines run()-Aufrufs zurück.
+     * @return Dauer in Mikrosekunden.
+     */
+    unsigned long getMaxRunDuration() const;
+
+private:
+    /**
+     * @enum State
+     * @brief Zustand eines Sensors im Scheduler.
+     */
+    enum class State : uint8_t { Idle, Converting };
+
+    /**
+     * @struct Task
+     * @brief Verwaltungsdaten eines registrierten Sensors.
+     */
+    struct Task {
+        const char* name = "";
+        uint32_t period = 0;           // Messintervall in ms
+        uint32_t conversion = 0;       // Wandlungszeit in ms
+        uint32_t deadline = 0;         // Deadline relativ zur Fälligkeit in ms
+        StartFunction start;
+        FinishFunction finish;
+        ErrorFunction error;
+        State state = State::Idle;
+        uint32_t dueAt = 0;            // Fälligkeit der aktuellen Messung (millis)
+        uint32_t nextStepAt = 0;       // frühester Zeitpunkt für den nächsten Schritt (millis)
+        // Zeitpunkt der letzten erfolgreichen Messung (millis). Atomar, da andere Tasks ihn lesen (z.B. für den Status);
+        // hasSample wird erst danach gesetzt.
+        std::atomic<uint32_t> sampledAt{0};
+        std::atomic<bool> hasSample{false};
+        uint32_t deadlineMisses = 0;
+        uint32_t failures = 0;         // fehlgeschlagene Schritte
+        ErrorCount errors[MAX_ERROR_CODES];
+        uint8_t errorCodes = 0;        // belegte Einträge in errors
+    };
+
+    /**
+     * @brief Sucht den bereiten Sensor mit der frühesten Deadline.
+     * @param now Aktuelle Zeit (millis).
+     * @return Index des Sensors, oder -1, wenn keiner bereit ist.
+     */
+    int pickNext(uint32_t now) const;
+
+    /**
+     * @brief Führt den nächsten Schritt (start oder finish) eines Sensors aus.
+     * @param task Der Sensor.
+     * @param now Aktuelle Zeit (millis).
+     */
+    static void step(Task& task, uint32_t now);
+
+    /**
+     * @brief Zählt einen fehlgeschlagenen Schritt unter dem Fehlercode des Sensors.
+     * @param task Der Sensor.
+     */
+    static void countFailure(Task& task);
+
+    Task _tasks[MAX_SENSORS];        // Registrierte Sensoren
+    MissCallback _onMiss;            // Callback bei verpasster Deadline
+    uint8_t _count;                  // Anzahl der registrierten Sensoren
+    unsigned long _budgetUs;         // Zeitbudget pro run() in µs
+    unsigned long _lastRunDuration;  // Dauer des letzten run() in µs
+    unsigned long _maxRunDuration;   // Längste Dauer eines run() in µs
+};
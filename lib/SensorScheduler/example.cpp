@@ -0,0 +1,40 @@
+/**
+ * Beispiel zur Nutzung der SensorScheduler-Bibliothek
+ *
+ * Zwei simulierte Sensoren: einer mit 300 ms Wandlungszeit (wie ein DS18B20 mit 11 Bit), einer ohne.
+ * Die Messwerte werden im Format des Serial Plotters ausgegeben, zusätzlich die Dauer des letzten run()-Aufrufs.
+ */
+
+#include <Arduino.h>
+#include "SensorScheduler.h"
+
+SensorScheduler scheduler(5000); // 5 ms Budget pro loop()-Durchlauf
+
+void setup() {
+    Serial.begin(115200);
+
+    scheduler.addSensor("slow", 2000, 300, 1000,
+        [] { return true; }, // Messung anstoßen
+        [] {
+            Serial.print(">Slow:");
+            Serial.println(random(200, 250) / 10.0f);
+            return SensorScheduler::Result::Success;
+        });
+
+    scheduler.addSensor("fast", 500, 0, 500, nullptr, [] {
+        Serial.print(">Fast:");
+        Serial.println(analogRead(34));
+        return SensorScheduler::Result::Success;
+    });
+}
+
+void loop() {
+    scheduler.run();
+
+    static unsigned long lastReport = 0;
+    if (millis() - lastReport >= 1000) {
+        lastReport = millis();
+        Serial.print(">RunUs:");
+        Serial.println(scheduler.getMaxRunDuration());
+    }
+}
@@ -0,0 +1,87 @@
+#include "SensorWiring.h"
+
+SensorWiring::Ids SensorWiring::addSensors(SensorScheduler& scheduler, const Sensors& sensors, const Intervals& intervals, const PublishFunction& publish) {
+    using Result = SensorScheduler::Result;
+    SensorAM2302* air = &sensors.air;
+    SensorDS18B20* soilTemp = &sensors.soilTemp;
+    SensorCapacitiveSoil* soilMoisture = &sensors.soilMoisture;
+    SensorXKCY25NPN* waterLevel = &sensors.waterLevel;
+    SensorBH1750* light = &sensors.light;
+    Ids ids;
+
+    // S1: ein einzelner Leseversuch dauert ca. 5 ms, Wiederholungen übernimmt der Scheduler.
+    ids.air = scheduler.addSensor("air", intervals.sensorMs, 0, intervals.deadlineMs, nullptr, [air, publish] {
+        if (!air->read(1)) {
+            return Result::Failed;
+        }
+        publish(FIELD_AIR_TEMP, air->getTemperature());
+        publish(FIELD_HUMIDITY, air->getHumidity());
+        return Result::Success;
+    });
+
+    // S2: Wandlung anstoßen, nach der Wandlungszeit auslesen (der Messwert kommt über den Callback).
+    soilTemp->onConversionComplete([publish](const bool success, const float temperature) {
+        if (success) {
+            publish(FIELD_SOIL_TEMP, temperature);
+        }
+    });
+    ids.soilTemp = scheduler.addSensor("soilTemp", intervals.sensorMs, soilTemp->getConversionTime(), intervals.deadlineMs,
+        [soilTemp] { return soilTemp->startConversion(); },
+        [soilTemp] {
+            if (!soilTemp->poll()) {
+                return Result::Pending;
+            }
+            return soilTemp->getLastError() == 0 ? Result::Success : Result::Failed;
+        });
+
+    // S3
+    ids.soilMoisture = scheduler.addSensor("soilMoisture", intervals.sensorMs, 0, intervals.deadlineMs, nullptr, [soilMoisture, publish] {
+        if (!soilMoisture->read()) {
+            return Result::Failed;
+        }
+        publish(FIELD_SOIL_MOISTURE, static_cast<float>(soilMoisture->getPercent()));
+        return Result::Success;
+    });
+
+    // S4: wird öfter gelesen, da die Pumpe nicht trocken laufen darf.
+    ids.waterLevel = scheduler.addSensor("waterLevel", intervals.waterLevelMs, 0, intervals.deadlineMs, nullptr, [waterLevel, publish] {
+        if (!waterLevel->read()) {
+            return Result::Failed;
+        }
+        publish(FIELD_WATER_LEVEL, waterLevel->isWaterDetected() ? 1.0f : 0.0f);
+        return Result::Success;
+    });
+
+    // S5
+    ids.light = scheduler.addSensor("light", intervals.sensorMs, 0, intervals.deadlineMs, nullptr, [light, publish] {
+        if (!light->read()) {
+            return Result::Failed;
+        }
+        publish(FIELD_LIGHT_LUX, light->getLux());
+        return Result::Success;
+    });
+
+    // Fehlercodes für die Fehlerzähler (SimpleDHT legt in den oberen Bits die Dauer ab, nur der Code zählt)
+    scheduler.setErrorSource(ids.air, [air] { return air->getLastError() & 0xFF; });
+    scheduler.setErrorSource(ids.soilTemp, [soilTemp] { return soilTemp->getLastError(); });
+    scheduler.setErrorSource(ids.soilMoisture, [soilMoisture] { return soilMoisture->getLastError(); });
+    scheduler.setErrorSource(ids.waterLevel, [] { return SensorXKCY25NPN::getLastError(); });
+    scheduler.setErrorSource(ids.light, [light] { return light->getLastError(); });
+
+    // Keine Messung bis zur Deadline: die Messwerte des Sensors als ungültig melden
+    scheduler.onDeadlineMiss([ids, publish](const int id) {
+        if (id == ids.air) {
+            publish(FIELD_AIR_TEMP, NAN);
+            publish(FIELD_HUMIDITY, NAN);
+        } else if (id == ids.soilTemp) {
+            publish(FIELD_SOIL_TEMP, NAN);
+        } else if (id == ids.soilMoisture) {
+            publish(FIELD_SOIL_MOISTURE, NAN);
+        } else if (id == ids.waterLevel) {
+            publish(FIELD_WATER_LEVEL, NAN);
+        } else if (id == ids.light) {
+            publish(FIELD_LIGHT_LUX, NAN);
+        }
+    });
+    return ids;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "SensorAM2302.h"
+#include "SensorBH1750.h"
+#include "SensorCapacitiveSoil.h"
+#include "SensorDS18B20.h"
+#include "SensorScheduler.h"
+#include "SensorSnapshot.h"
+#include "SensorXKCY25NPN.h"
+
+/**
+ * Meldet die fünf Sensoren des Gewächshauses (S1 bis S5) beim SensorScheduler an.
+ *
+ * Firmware (main.cpp) und Prüfstand (GreenhouseRig) benutzen dieselbe Verdrahtung: welche Messwerte ein Sensor
+ * liefert, welche Sensoren in zwei Schritten gelesen werden, welche Fehlercodes gezählt werden und welche Messwerte
+ * bei einer verpassten Deadline ungültig werden. Nur das Ziel der Messwerte unterscheidet sich (Queue zum
+ * Steuerungs-Task bzw. direkt der SensorSnapshot) und wird als Funktion übergeben.
+ */
+class SensorWiring {
+public:
+    /**
+     * @struct Sensors
+     * @brief Die Sensor-Objekte (müssen so lange leben wie der Scheduler).
+     */
+    struct Sensors {
+        SensorAM2302& air;                 // S1: Raumtemperatur und Luftfeuchtigkeit
+        SensorDS18B20& soilTemp;           // S2: Bodentemperatur
+        SensorCapacitiveSoil& soilMoisture; // S3: Bodenfeuchte
+        SensorXKCY25NPN& waterLevel;       // S4: Wasserstand
+        SensorBH1750& light;               // S5: Tageslicht
+    };
+
+    /**
+     * @struct Intervals
+     * @brief Zeitverhalten in ms (in der Firmware aus config.h).
+     */
+    struct Intervals {
+        unsigned long sensorMs;     // SENSOR_READ_INTERVAL
+        unsigned long waterLevelMs; // WATER_LEVEL_READ_INTERVAL (die Pumpe darf nicht trocken laufen)
+        unsigned long deadlineMs;   // SENSOR_READ_DEADLINE
+    };
+
+    /**
+     * @struct Ids
+     * @brief IDs der Sensoren beim Scheduler.
+     */
+    struct Ids {
+        int air;
+        int soilTemp;
+        int soilMoisture;
+        int waterLevel;
+        int light;
+    };
+
+    /**
+     * @brief Nimmt einen Messwert entgegen.
+     * Format: (Messwert, Wert) -> void; NAN = ungültig (verpasste Deadline)
+     */
+    using PublishFunction = std::function<void(SensorField field, float value)>;
+
+    /**
+     * @brief Meldet die Sensoren an und setzt Fehlerquellen, Deadline-Callback und den Callback des DS18B20.
+     * Die begin()-Methoden der Sensoren ruft der Aufrufer vorher selbst auf.
+     * @param scheduler Der Scheduler (sollte noch keine Sensoren haben, die IDs beginnen sonst nicht bei 0).
+     * @param sensors Die Sensor-Objekte.
+     * @param intervals Das Zeitverhalten.
+     * @param publish Nimmt die Messwerte entgegen (wird aus SensorScheduler::run() aufgerufen).
+     * @return Die IDs der Sensoren.
+     */
+    static Ids addSensors(SensorScheduler& scheduler, const Sensors& sensors, const Intervals& intervals, const PublishFunction& publish);
+};
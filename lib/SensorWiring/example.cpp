@@ -0,0 +1,34 @@
+/**
+ * Beispiel zur Nutzung der SensorWiring-Bibliothek
+ *
+ * Meldet die fünf Sensoren beim Scheduler an und gibt jeden Messwert im Format des Serial Plotters aus.
+ */
+
+#include <Arduino.h>
+#include "SensorWiring.h"
+
+SensorAM2302 airSensor(16);
+SensorDS18B20 soilTempSensor(17);
+SensorCapacitiveSoil soilMoistureSensor(34, 2800, 1200);
+SensorXKCY25NPN waterLevelSensor(35);
+SensorBH1750 lightSensor;
+SensorScheduler scheduler;
+
+void setup() {
+    Serial.begin(115200);
+    airSensor.begin();
+    soilTempSensor.begin();
+    soilMoistureSensor.begin();
+    waterLevelSensor.begin();
+    lightSensor.begin();
+
+    const SensorWiring::Sensors sensors{airSensor, soilTempSensor, soilMoistureSensor, waterLevelSensor, lightSensor};
+    SensorWiring::addSensors(scheduler, sensors, {5000, 1000, 2000}, [](const SensorField field, const float value) {
+        Serial.printf(">Field%u:%.2f\n", __builtin_ctz(field), value);
+    });
+}
+
+void loop() {
+    scheduler.run();
+    delay(10);
+}
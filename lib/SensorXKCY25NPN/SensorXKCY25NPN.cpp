@@ -1,13 +1,14 @@
 #include "SensorXKCY25NPN.h"
+#include "Hal.h"
 
 SensorXKCY25NPN::SensorXKCY25NPN(uint8_t pin, bool useInternalPullup)
     : _pin(pin), _useInternalPullup(useInternalPullup), _waterDetected(false) {}
 
 bool SensorXKCY25NPN::begin() {
     if (_useInternalPullup) {
-        pinMode(_pin, INPUT_PULLUP);
+        Hal::get().pinMode(_pin, INPUT_PULLUP);
     } else {
-        pinMode(_pin, INPUT);
+        Hal::get().pinMode(_pin, INPUT);
     }
 
     // Eine erste Messung durchführen, um einen Startwert zu haben.
@@ -18,7 +19,7 @@ bool SensorXKCY25NPN::read() {
     // Der Sensor-Ausgang ist ein NPN Open-Collector.
     // Er zieht den Pin auf LOW, wenn Wasser erkannt wird.
     // Mit einem Pull-Up-Widerstand ist der Pin HIGH, wenn kein Wasser da ist.
-    int pinState = digitalRead(_pin);
+    int pinState = Hal::get().digitalRead(_pin);
 
     // Wasser wird erkannt, wenn der Pin LOW ist.
     _waterDetected = (pinState == LOW);
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Seqlock für genau einen Schreiber und beliebig viele Leser.
+ *
+ * Der Schreiber veröffentlicht mit write() einen neuen Wert, ohne jemals zu warten. Leser erhalten mit read() eine
+ * konsistente Kopie, ebenfalls ohne Mutex: Sie lesen den Wert und prüfen anschließend anhand der Sequenznummer, ob
+ * währenddessen geschrieben wurde. Falls ja, wird das Lesen wiederholt.
+ *
+ * Die Sequenznummer ist während eines Schreibvorgangs ungerade und danach gerade.
+ * Der Wert wird wortweise in atomaren Variablen abgelegt, damit gleichzeitiges Lesen und Schreiben kein Data Race ist.
+ *
+ * @tparam T Typ des Werts (muss trivial kopierbar sein, z.B. ein struct aus Zahlen).
+ */
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock benoetigt einen trivial kopierbaren Typ");
+
+public:
+    /**
+     * @brief Konstruktor. Der Anfangswert ist ein standardkonstruiertes T.
+     */
+    Seqlock() {
+        store(T{});
+    }
+
+    /**
+     * @brief Veröffentlicht einen neuen Wert (nur von einem einzigen Task aufrufen).
+     * Kehrt immer sofort zurück.
+     * @param value Der neue Wert.
+     */
+    void write(const T& value) {
+        const uint32_t seq = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(seq + 1, std::memory_order_relaxed); // ungerade: Schreibvorgang läuft
+        std::atomic_thread_fence(std::memory_order_release);
+        store(value);
+        _sequence.store(seq + 2, std::memory_order_release); // gerade: Wert ist vollständig
+    }
+
+    /**
+     * @brief Liest eine konsistente Kopie des Werts.
+     *
+     * Wiederholt das Lesen, solange gleichzeitig geschrieben wird. Der Schreiber darf den Leser daher nicht
+     * dauerhaft unterbrechen können (Schreiber mit höherer Priorität oder auf einem anderen Kern).
+     *
+     * @return Kopie des zuletzt veröffentlichten Werts.
+     */
+    T read() const {
+        T value;
+        while (!tryRead(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * @brief Versucht einmal, eine konsistente Kopie zu lesen.
+     * @param value Ziel für die Kopie (wird nur bei Erfolg gültig).
+     * @return true bei Erfolg, false wenn gleichzeitig geschrieben wurde.
+     */
+    bool tryRead(T& value) const {
+        const uint32_t before = _sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false; // Schreibvorgang läuft
+        }
+        load(value);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+     * @brief Gibt die Anzahl der bisherigen write()-Aufrufe zurück.
+     * Damit kann ein Leser billig prüfen, ob sich der Wert seit dem letzten Lesen geändert hat.
+     */
+    uint32_t getVersion() const {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    /**
+     * @brief Kopiert den Wert wortweise in den atomaren Speicher.
+     */
+    void store(const T& value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; i++) {
+            _data[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Kopiert den Wert wortweise aus dem atomaren Speicher.
+     */
+    void load(T& value) const {
+        uint32_t words[WORDS];
+        for (size_t i = 0; i < WORDS; i++) {
+            words[i] = _data[i].load(std::memory_order_relaxed);
+        }
+        memcpy(&value, words, sizeof(T));
+    }
+
+    std::atomic<uint32_t> _sequence{0};  // Sequenznummer (ungerade = Schreibvorgang läuft)
+    std::atomic<uint32_t> _data[WORDS];  // Der Wert, wortweise
+};
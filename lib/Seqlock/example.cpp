@@ -0,0 +1,40 @@
+/**
+ * Beispiel zur Nutzung der Seqlock-Bibliothek
+ *
+ * Ein Task auf Kern 0 schreibt alle 10 ms einen Zählerstand samt Zeitstempel,
+ * loop() liest jede Sekunde eine konsistente Kopie und gibt sie im Format des Serial Plotters aus.
+ */
+
+#include <Arduino.h>
+#include "Seqlock.h"
+
+struct Counter {
+    uint32_t count;
+    unsigned long timestamp;
+};
+
+Seqlock<Counter> counter;
+
+void writerTask(void*) {
+    Counter value{};
+    for (;;) {
+        value.count++;
+        value.timestamp = millis();
+        counter.write(value);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    xTaskCreatePinnedToCore(writerTask, "writer", 2048, nullptr, 2, nullptr, 0);
+}
+
+void loop() {
+    const Counter value = counter.read();
+    Serial.print(">Count:");
+    Serial.println(value.count);
+    Serial.print(">Version:");
+    Serial.println(counter.getVersion());
+    delay(1000);
+}
@@ -1,12 +1,12 @@
 #include "SettingsManager.h"
-#include <LittleFS.h>
+#include "Hal.h"
 
 SettingsManager::SettingsManager(const char* filename)
     : _filename(filename) {}
 
 bool SettingsManager::begin() {
     // Versuche, die JSON-Datei zum Lesen zu öffnen.
-    File configFile = LittleFS.open(_filename, "r");
+    File configFile = Hal::get().fileSystem().open(_filename, "r");
 
     // Wenn die Datei nicht existiert, erstelle eine Standardkonfiguration.
     if (!configFile) {
@@ -35,7 +35,7 @@ bool SettingsManager::begin() {
 
 bool SettingsManager::save() const {
     // Öffne die JSON-Datei zum Schreiben.
-    File configFile = LittleFS.open(_filename, "w");
+    File configFile = Hal::get().fileSystem().open(_filename, "w");
     if (!configFile) {
         Serial.printf("FEHLER: Konnte JSON-Datei '%s' nicht zum Schreiben öffnen!\n", _filename);
         return false;
@@ -94,6 +94,12 @@ void SettingsManager::serialize(const JsonObject& doc) const {
     doc["cameraContrast"] = _settings.cameraContrast;
     doc["cameraSpecialEffect"] = _settings.cameraSpecialEffect;
 
+    // Aufräumen der SD-Karte
+    doc["imageMaxAgeDays"] = _settings.imageMaxAgeDays;
+    doc["imageThinAfterDays"] = _settings.imageThinAfterDays;
+    doc["imageMaxMB"] = _settings.imageMaxMB;
+    doc["sdMinFreePercent"] = _settings.sdMinFreePercent;
+
     // Konvertiere die ControlMode-Enums in Strings für JSON
     auto modeToString = [](const ControlMode mode) {
         if (mode == MODE_ON) return "on";
@@ -136,6 +142,12 @@ void SettingsManager::deserialize(const JsonObject& doc) {
     _settings.cameraContrast = doc["cameraContrast"] | _settings.cameraContrast;
     _settings.cameraSpecialEffect = doc["cameraSpecialEffect"] | _settings.cameraSpecialEffect;
 
+    // Aufräumen der SD-Karte
+    _settings.imageMaxAgeDays = doc["imageMaxAgeDays"] | _settings.imageMaxAgeDays;
+    _settings.imageThinAfterDays = doc["imageThinAfterDays"] | _settings.imageThinAfterDays;
+    _settings.imageMaxMB = doc["imageMaxMB"] | _settings.imageMaxMB;
+    _settings.sdMinFreePercent = doc["sdMinFreePercent"] | _settings.sdMinFreePercent;
+
     // Konvertiere die Strings aus JSON zurück in die ControlMode-Enums
     auto stringToMode = [](const char* str, const ControlMode defaultMode) {
         if (strcmp(str, "on") == 0) return MODE_ON;
@@ -0,0 +1,175 @@
+#include "SpiBusArbiter.h"
+
+// --- Lock ---
+
+SpiBusArbiter::Lock::Lock(SpiBusArbiter* bus, const int device, const uint32_t timeoutMs)
+    : _bus(bus), _device(device), _locked(bus == nullptr || bus->acquire(device, timeoutMs)) {}
+
+SpiBusArbiter::Lock::~Lock() {
+    if (_bus && _locked) {
+        _bus->release();
+    }
+}
+
+SpiBusArbiter::Lock::operator bool() const {
+    return _locked;
+}
+
+// --- SpiBusArbiter ---
+
+SpiBusArbiter::SpiBusArbiter(SPIClass& spi)
+    : _spi(spi), _mutex(nullptr), _statsMutex(nullptr), _count(0), _stack{}, _depth(0), _selected(NO_DEVICE) {}
+
+bool SpiBusArbiter::begin() {
+    // Alle Geräte abwählen, bevor irgendein Treiber auf den Bus zugreift. Ein nach einem Soft-Reset noch
+    // ausgewähltes Gerät (CS auf LOW) würde sonst die MISO-Leitung blockieren.
+    for (int i = 0; i < _count; i++) {
+        pinMode(_devices[i].csPin, OUTPUT);
+        digitalWrite(_devices[i].csPin, HIGH);
+    }
+
+    if (!_mutex) {
+        _mutex = xSemaphoreCreateRecursiveMutex();
+    }
+    if (!_statsMutex) {
+        _statsMutex = xSemaphoreCreateMutex();
+    }
+    return _mutex != nullptr && _statsMutex != nullptr;
+}
+
+int SpiBusArbiter::addDevice(const char* name, const uint8_t csPin, const uint32_t clock, const uint8_t mode, const bool ownTransaction) {
+    if (_count >= MAX_DEVICES) {
+        return -1;
+    }
+
+    Device& device = _devices[_count];
+    device.name = name;
+    device.csPin = csPin;
+    device.clock = clock;
+    device.settings = SPISettings(clock, MSBFIRST, mode);
+    device.ownTransaction = ownTransaction;
+    return _count++;
+}
+
+bool SpiBusArbiter::acquire(const int device, const uint32_t timeoutMs) {
+    if (device != NO_DEVICE && (device < 0 || device >= _count)) {
+        return false;
+    }
+
+    if (_mutex) {
+        // Hält der Task den Bus bereits (gebündelter Zugriff), muss nicht gewartet werden.
+        const bool nested = xSemaphoreGetMutexHolder(_mutex) == xTaskGetCurrentTaskHandle();
+        if (!nested) {
+            const unsigned long start = micros();
+            bool acquired = xSemaphoreTakeRecursive(_mutex, 0) == pdTRUE;
+            const bool contended = !acquired;
+            if (contended) {
+                const TickType_t ticks = timeoutMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+                acquired = xSemaphoreTakeRecursive(_mutex, ticks) == pdTRUE;
+            }
+            recordWait(device, contended, acquired, micros() - start);
+            if (!acquired) {
+                return false;
+            }
+        } else {
+            xSemaphoreTakeRecursive(_mutex, 0);
+        }
+    }
+
+    if (_depth >= MAX_DEPTH) {
+        if (_mutex) {
+            xSemaphoreGiveRecursive(_mutex);
+        }
+        return false; // zu tief verschachtelt
+    }
+    _stack[_depth++] = device;
+    select(device);
+    return true;
+}
+
+void SpiBusArbiter::release() {
+    if (_depth == 0) {
+        return;
+    }
+
+    // Auf das Gerät des äußeren acquire() zurückschalten (bzw. keins, wenn der Bus ganz freigegeben wird)
+    _depth--;
+    select(_depth > 0 ? _stack[_depth - 1] : NO_DEVICE);
+
+    if (_mutex) {
+        xSemaphoreGiveRecursive(_mutex);
+    }
+}
+
+void SpiBusArbiter::select(const int device) {
+    if (device == _selected) {
+        return; // Transaktion läuft bereits (z.B. bei verschachteltem Zugriff auf dasselbe Gerät)
+    }
+
+    // Laufende Transaktion beenden. Den Chip Select steuert der Treiber des Geräts selbst.
+    if (_selected != NO_DEVICE && _devices[_selected].ownTransaction) {
+        _spi.endTransaction();
+    }
+    _selected = NO_DEVICE;
+
+    // Neue Transaktion mit Takt und Modus des Geräts starten. Geräte, deren Treiber die Transaktion selbst startet
+    // (SD), dürfen hier keine bekommen: SPIClass::beginTransaction() ist nicht verschachtelbar.
+    if (device != NO_DEVICE && _devices[device].ownTransaction) {
+        _spi.beginTransaction(_devices[device].settings);
+        _selected = device;
+    }
+}
+
+void SpiBusArbiter::recordWait(const int device, const bool contended, const bool acquired, const uint32_t waitedUs) {
+    xSemaphoreTake(_statsMutex, portMAX_DELAY);
+    WaitStats& stats = _stats[statsIndex(device)];
+    if (contended) {
+        stats.contended++;
+    }
+    if (acquired) {
+        stats.acquisitions++;
+        stats.totalWaitUs += waitedUs;
+        if (waitedUs > stats.maxWaitUs) {
+            stats.maxWaitUs = waitedUs;
+        }
+    } else {
+        stats.timeouts++;
+    }
+    xSemaphoreGive(_statsMutex);
+}
+
+int SpiBusArbiter::statsIndex(const int device) {
+    return device == NO_DEVICE ? MAX_DEVICES : device;
+}
+
+SPIClass& SpiBusArbiter::getSPI() const {
+    return _spi;
+}
+
+uint32_t SpiBusArbiter::getClock(const int device) const {
+    return (device >= 0 && device < _count) ? _devices[device].clock : 0;
+}
+
+uint8_t SpiBusArbiter::getDeviceCount() const {
+    return _count;
+}
+
+const char* SpiBusArbiter::getName(const int device) const {
+    if (device == NO_DEVICE) {
+        return "batch";
+    }
+    return (device >= 0 && device < _count) ? _devices[device].name : "";
+}
+
+SpiBusArbiter::WaitStats SpiBusArbiter::getStats(const int device) const {
+    if (device != NO_DEVICE && (device < 0 || device >= _count)) {
+        return {};
+    }
+    if (!_statsMutex) {
+        return _stats[statsIndex(device)]; // vor begin() wird nichts gezählt
+    }
+    xSemaphoreTake(_statsMutex, portMAX_DELAY);
+    const WaitStats stats = _stats[statsIndex(device)];
+    xSemaphoreGive(_statsMutex);
+    return stats;
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * Verwaltet einen SPI-Bus, an dem mehrere Geräte hängen (hier: Kamera und SD-Karte).
+ *
+ * Jedes Gerät wird mit eigenem Chip-Select, Takt und SPI-Modus angemeldet. Wer auf ein Gerät zugreifen will, holt sich
+ * vorher den Bus mit acquire() (oder besser mit einem Lock-Objekt). Der Bus wird durch einen rekursiven FreeRTOS-Mutex
+ * geschützt, sodass immer nur ein Task gleichzeitig auf den Bus zugreift.
+ *
+ * Mehrere kurze Zugriffe können gebündelt werden: Ein äußerer Lock ohne Gerät (NO_DEVICE) reserviert den Bus einmal,
+ * innere Locks desselben Tasks schalten dann nur noch zwischen den Geräten um, ohne erneut auf den Mutex zu warten.
+ */
+class SpiBusArbiter {
+public:
+    static constexpr int NO_DEVICE = -1;    // Bus reservieren, ohne ein Gerät auszuwählen
+    static constexpr uint8_t MAX_DEVICES = 4; // Maximale Anzahl angemeldeter Geräte
+    static constexpr uint8_t MAX_DEPTH = 8;   // Maximale Verschachtelungstiefe von acquire()
+
+    /**
+     * @struct WaitStats
+     * @brief Statistik über die Wartezeiten beim Holen des Busses.
+     */
+    struct WaitStats {
+        uint32_t acquisitions = 0; // Anzahl der Zugriffe, bei denen der Mutex geholt werden musste
+        uint32_t contended = 0;    // davon: Anzahl der Zugriffe, bei denen ein anderer Task den Bus hatte
+        uint32_t timeouts = 0;     // Anzahl der Zugriffe, die wegen Zeitüberschreitung abgebrochen wurden
+        uint64_t totalWaitUs = 0;  // Summe der Wartezeiten in µs
+        uint32_t maxWaitUs = 0;    // Längste Wartezeit in µs
+    };
+
+    /**
+     * @brief Hält den Bus für die Lebensdauer des Objekts (RAII).
+     *
+     * Beispiel:
+     * @code
+     * SpiBusArbiter::Lock lock(&spiBus, cameraDevice);
+     * if (lock) { ... }
+     * @endcode
+     */
+    class Lock {
+    public:
+        /**
+         * @brief Holt den Bus.
+         * @param bus Der Arbiter (nullptr = kein Arbiter, dann passiert nichts und der Lock gilt als erfolgreich).
+         * @param device ID des Geräts oder NO_DEVICE.
+         * @param timeoutMs Maximale Wartezeit in ms (Standard: unbegrenzt).
+         */
+        Lock(SpiBusArbiter* bus, int device, uint32_t timeoutMs = UINT32_MAX);
+
+        /**
+         * @brief Gibt den Bus wieder frei.
+         */
+        ~Lock();
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+        /**
+         * @brief Gibt an, ob der Bus geholt wurde.
+         */
+        explicit operator bool() const;
+
+    private:
+        SpiBusArbiter* _bus;
+        int _device;
+        bool _locked;
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param spi Der SPI-Bus (Standard: SPI, also VSPI).
+     */
+    explicit SpiBusArbiter(SPIClass& spi = SPI);
+
+    /**
+     * @brief Legt die Mutexe an und setzt die Chip-Select-Leitungen aller angemeldeten Geräte auf HIGH.
+     * Die Geräte sollten vorher mit addDevice() angemeldet werden.
+     * @return true bei Erfolg, false wenn ein Mutex nicht angelegt werden konnte.
+     */
+    bool begin();
+
+    /**
+     * @brief Meldet ein Gerät an.
+     * @param name Kurzer Name (z.B. "sd"), wird nicht kopiert.
+     * @param csPin GPIO-Pin für den Chip Select.
+     * @param clock SPI-Takt in Hz.
+     * @param mode SPI-Modus (Standard: SPI_MODE0).
+     * @param ownTransaction true: acquire() startet eine SPI-Transaktion mit Takt und Modus des Geräts.
+     *                       false: Die Treiber-Bibliothek startet ihre Transaktionen selbst (z.B. SD), acquire()
+     *                       schützt dann nur den Bus.
+     * @return ID des Geräts, oder -1, wenn kein Platz mehr frei ist.
+     */
+    int addDevice(const char* name, uint8_t csPin, uint32_t clock, uint8_t mode = SPI_MODE0, bool ownTransaction = true);
+
+    /**
+     * @brief Holt den Bus für ein Gerät.
+     *
+     * Hat der aufrufende Task den Bus bereits, wird nicht gewartet, sondern nur auf das Gerät umgeschaltet.
+     * Jeder erfolgreiche Aufruf muss mit release() abgeschlossen werden (oder Lock verwenden).
+     *
+     * @param device ID des Geräts oder NO_DEVICE (nur reservieren, z.B. zum Bündeln mehrerer Zugriffe).
+     * @param timeoutMs Maximale Wartezeit in ms.
+     * @return true bei Erfolg, false bei Zeitüberschreitung.
+     */
+    bool acquire(int device, uint32_t timeoutMs = UINT32_MAX);
+
+    /**
+     * @brief Gibt den Bus frei und schaltet auf das Gerät des äußeren acquire() zurück.
+     */
+    void release();
+
+    /**
+     * @brief Gibt den SPI-Bus zurück.
+     */
+    SPIClass& getSPI() const;
+
+    /**
+     * @brief Gibt den Takt eines Geräts zurück.
+     * @param device ID des Geräts.
+     * @return Takt in Hz, oder 0 bei ungültiger ID.
+     */
+    uint32_t getClock(int device) const;
+
+    /**
+     * @brief Gibt die Anzahl der angemeldeten Geräte zurück.
+     */
+    uint8_t getDeviceCount() const;
+
+    /**
+     * @brief Gibt den Namen eines Geräts zurück.
+     * @param device ID des Geräts oder NO_DEVICE.
+     * @return Name, oder "" bei ungültiger ID.
+     */
+    const char* getName(int device) const;
+
+    /**
+     * @brief Gibt die Wartezeit-Statistik eines Geräts zurück.
+     * @param device ID des Geräts oder NO_DEVICE (gebündelte Zugriffe).
+     */
+    WaitStats getStats(int device) const;
+
+private:
+    /**
+     * @struct Device
+     * @brief Daten eines angemeldeten Geräts.
+     */
+    struct Device {
+        const char* name = "";
+        uint8_t csPin = 0;
+        uint32_t clock = 0;
+        SPISettings settings;
+        bool ownTransaction = true;
+    };
+
+    /**
+     * @brief Schaltet auf ein anderes Gerät um (beendet die laufende Transaktion und startet ggf. eine neue).
+     * @param device ID des Geräts oder NO_DEVICE.
+     */
+    void select(int device);
+
+    /**
+     * @brief Trägt einen Warteversuch in die Statistik eines Geräts ein (unter _statsMutex, da auch Tasks ohne den Bus
+     * zählen: belegt und Zeitüberschreitung).
+     * @param device ID des Geräts oder NO_DEVICE.
+     * @param contended true, wenn ein anderer Task den Bus hatte.
+     * @param acquired true, wenn der Bus geholt wurde, false bei Zeitüberschreitung.
+     * @param waitedUs Wartezeit in µs.
+     */
+    void recordWait(int device, bool contended, bool acquired, uint32_t waitedUs);
+
+    /**
+     * @brief Gibt den Index in _stats für ein Gerät zurück (NO_DEVICE hat den letzten Platz).
+     */
+    static int statsIndex(int device);
+
+    SPIClass& _spi;                         // Der verwaltete SPI-Bus
+    SemaphoreHandle_t _mutex;               // Rekursiver Mutex (nullptr vor begin())
+    SemaphoreHandle_t _statsMutex;          // Schützt _stats (nullptr vor begin())
+    Device _devices[MAX_DEVICES];           // Angemeldete Geräte
+    uint8_t _count;                         // Anzahl der angemeldeten Geräte
+    int _stack[MAX_DEPTH];                  // Geräte der verschachtelten acquire()-Aufrufe
+    uint8_t _depth;                         // Aktuelle Verschachtelungstiefe
+    int _selected;                          // Gerät mit laufender Transaktion (oder NO_DEVICE)
+    WaitStats _stats[MAX_DEVICES + 1];      // Wartezeiten je Gerät, zuletzt NO_DEVICE
+};
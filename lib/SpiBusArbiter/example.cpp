@@ -0,0 +1,65 @@
+/**
+ * Beispiel zur Nutzung der SpiBusArbiter-Bibliothek
+ *
+ * Zwei Tasks greifen gleichzeitig auf die SD-Karte zu: loop() schreibt eine Log-Datei, ein zweiter Task auf Kern 0
+ * liest sie. Die Wartezeiten auf den Bus werden im Format des Serial Plotters ausgegeben.
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include "SpiBusArbiter.h"
+
+constexpr uint8_t SD_CS_PIN = 16;
+constexpr uint8_t CAM_CS_PIN = 17;
+
+SpiBusArbiter spiBus;
+int sdDevice = SpiBusArbiter::NO_DEVICE;
+
+void readerTask(void*) {
+    uint8_t buffer[512];
+    for (;;) {
+        {
+            SpiBusArbiter::Lock lock(&spiBus, sdDevice, 100);
+            if (lock) {
+                File file = SD.open("/log.txt", FILE_READ);
+                while (file && file.read(buffer, sizeof(buffer)) > 0) {
+                }
+                file.close();
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+
+    // Auch die Kamera anmelden, damit ihr CS-Pin auf HIGH gesetzt wird
+    sdDevice = spiBus.addDevice("sd", SD_CS_PIN, 20000000, SPI_MODE0, false);
+    spiBus.addDevice("camera", CAM_CS_PIN, 8000000);
+    spiBus.begin();
+    SPI.begin();
+
+    if (!SD.begin(SD_CS_PIN, SPI, spiBus.getClock(sdDevice))) {
+        Serial.println("SD-Karte nicht gefunden.");
+        return;
+    }
+
+    xTaskCreatePinnedToCore(readerTask, "reader", 4096, nullptr, 1, nullptr, 0);
+}
+
+void loop() {
+    {
+        SpiBusArbiter::Lock lock(&spiBus, sdDevice);
+        File file = SD.open("/log.txt", FILE_APPEND, true);
+        file.printf("%lu\n", millis());
+        file.close();
+    }
+
+    const SpiBusArbiter::WaitStats stats = spiBus.getStats(sdDevice);
+    Serial.print(">MaxWaitUs:");
+    Serial.println(stats.maxWaitUs);
+    Serial.print(">Contended:");
+    Serial.println(stats.contended);
+    delay(20);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Lock-freie Warteschlange für genau einen Erzeuger und genau einen Verbraucher (Single Producer, Single Consumer).
+ *
+ * Erzeuger und Verbraucher dürfen in unterschiedlichen Tasks (auch auf unterschiedlichen Kernen) laufen, ohne dass
+ * ein Mutex nötig ist. push() darf nur vom Erzeuger, pop() nur vom Verbraucher aufgerufen werden.
+ * Der Speicher ist fest reserviert, es wird nie dynamisch allokiert.
+ *
+ * @tparam T Typ der Elemente (sollte trivial kopierbar sein).
+ * @tparam N Kapazität (muss eine Zweierpotenz sein). Es passen N - 1 Elemente gleichzeitig in die Warteschlange.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Kapazitaet muss eine Zweierpotenz sein");
+
+public:
+    /**
+     * @brief Hängt ein Element an (nur vom Erzeuger aufrufen).
+     * @param item Das Element.
+     * @return true bei Erfolg, false wenn die Warteschlange voll ist (das Element wird verworfen).
+     */
+    bool push(const T& item) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        const size_t next = (head + 1) & (N - 1);
+        if (next == _tail.load(std::memory_order_acquire)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false; // voll
+        }
+        _items[head] = item;
+        _head.store(next, std::memory_order_release); // Element erst nach dem Schreiben sichtbar machen
+        return true;
+    }
+
+    /**
+     * @brief Entnimmt das älteste Element (nur vom Verbraucher aufrufen).
+     * @param item Ziel für das Element.
+     * @return true bei Erfolg, false wenn die Warteschlange leer ist.
+     */
+    bool pop(T& item) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false; // leer
+        }
+        item = _items[tail];
+        _tail.store((tail + 1) & (N - 1), std::memory_order_release); // Platz erst nach dem Lesen freigeben
+        return true;
+    }
+
+    /**
+     * @brief Gibt an, ob die Warteschlange leer ist (nur eine Momentaufnahme).
+     */
+    bool empty() const {
+        return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gibt die Anzahl der Elemente zurück (nur eine Momentaufnahme).
+     */
+    size_t size() const {
+        return (_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire)) & (N - 1);
+    }
+
+    /**
+     * @brief Gibt die Anzahl der Elemente zurück, die wegen einer vollen Warteschlange verworfen wurden.
+     */
+    uint32_t getDropped() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    T _items[N] = {};                  // Ringpuffer
+    std::atomic<size_t> _head{0};      // nächste Schreibposition (gehört dem Erzeuger)
+    std::atomic<size_t> _tail{0};      // nächste Leseposition (gehört dem Verbraucher)
+    std::atomic<uint32_t> _dropped{0}; // Anzahl verworfener Elemente
+};
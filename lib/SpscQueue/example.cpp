@@ -0,0 +1,40 @@
+/**
+ * Beispiel zur Nutzung der SpscQueue-Bibliothek
+ *
+ * Ein Task auf Kern 0 erzeugt Zufallswerte, loop() (Kern 1) liest sie aus und gibt sie
+ * im Format des Serial Plotters aus.
+ */
+
+#include <Arduino.h>
+#include "SpscQueue.h"
+
+struct Sample {
+    float value;
+    unsigned long timestamp;
+};
+
+SpscQueue<Sample, 16> queue;
+
+void producerTask(void*) {
+    for (;;) {
+        queue.push({random(0, 1000) / 10.0f, millis()});
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    xTaskCreatePinnedToCore(producerTask, "producer", 2048, nullptr, 1, nullptr, 0);
+}
+
+void loop() {
+    Sample sample;
+    while (queue.pop(sample)) {
+        Serial.print(">Value:");
+        Serial.println(sample.value);
+    }
+
+    Serial.print(">Dropped:");
+    Serial.println(queue.getDropped());
+    delay(500);
+}
@@ -0,0 +1,74 @@
+#include "StateDelta.h"
+#include <cmath>
+#include <cstdlib>
+
+StateDelta::StateDelta(const Deadbands& deadbands) : _deadbands(deadbands) {}
+
+StateDelta::Changes StateDelta::getChanges(const StateFrame& now, const bool full) const {
+    Changes changes;
+    if (full) {
+        changes.sensors = ALL;
+        changes.actuators = ALL;
+        return changes;
+    }
+    const StateFrame& last = _published;
+    const float lightDeadband = std::fmax(LIGHT_MIN_DEADBAND, std::fabs(last.lightLux) * _deadbands.lightRelative);
+
+    uint8_t sensors = last.valid ^ now.valid; // gültig geworden (oder umgekehrt)
+    if (exceedsDeadband(last.airTemp, now.airTemp, _deadbands.temp)) sensors |= FIELD_AIR_TEMP;
+    if (exceedsDeadband(last.humidity, now.humidity, _deadbands.humidity)) sensors |= FIELD_HUMIDITY;
+    if (exceedsDeadband(last.soilTemp, now.soilTemp, _deadbands.temp)) sensors |= FIELD_SOIL_TEMP;
+    if (std::abs(now.soilMoisture - last.soilMoisture) >= _deadbands.soilMoisture) sensors |= FIELD_SOIL_MOISTURE;
+    if ((last.flags ^ now.flags) & STATE_WATER_LEVEL_OK) sensors |= FIELD_WATER_LEVEL;
+    if (exceedsDeadband(last.lightLux, now.lightLux, lightDeadband)) sensors |= FIELD_LIGHT_LUX;
+    changes.sensors = sensors;
+    changes.actuators = last.actuators ^ now.actuators;
+    return changes;
+}
+
+void StateDelta::markSent(const StateFrame& frame, const Changes& changes) {
+    if (changes.sensors == ALL && changes.actuators == ALL) {
+        _published = frame;
+        return;
+    }
+    const uint8_t sensors = changes.sensors;
+    _published.sequence = frame.sequence;
+    _published.valid = (_published.valid & ~sensors) | (frame.valid & sensors);
+    _published.actuators = frame.actuators;
+    if (sensors & FIELD_AIR_TEMP) _published.airTemp = frame.airTemp;
+    if (sensors & FIELD_HUMIDITY) _published.humidity = frame.humidity;
+    if (sensors & FIELD_SOIL_TEMP) _published.soilTemp = frame.soilTemp;
+    if (sensors & FIELD_SOIL_MOISTURE) _published.soilMoisture = frame.soilMoisture;
+    if (sensors & FIELD_WATER_LEVEL) _published.flags = frame.flags;
+    if (sensors & FIELD_LIGHT_LUX) _published.lightLux = frame.lightLux;
+}
+
+const StateFrame& StateDelta::getPublished() const {
+    return _published;
+}
+
+bool StateDelta::exceedsDeadband(const float last, const float now, const float deadband) {
+    if (std::isnan(last) || std::isnan(now)) {
+        return std::isnan(last) != std::isnan(now);
+    }
+    return std::fabs(now - last) >= deadband;
+}
+
+void StateDelta::fillJson(const JsonObject values, const StateFrame& frame, const Changes& changes) {
+    const uint8_t sensors = changes.sensors;
+    const uint8_t actuators = changes.actuators;
+    values["seq"] = frame.sequence;
+    values["valid"] = frame.valid;
+    if (sensors & FIELD_AIR_TEMP) values["airTemp"] = frame.airTemp;
+    if (sensors & FIELD_HUMIDITY) values["humidity"] = frame.humidity;
+    if (sensors & FIELD_SOIL_TEMP) values["soilTemp"] = frame.soilTemp;
+    if (sensors & FIELD_SOIL_MOISTURE) values["soilMoisture"] = frame.soilMoisture;
+    if (sensors & FIELD_WATER_LEVEL) values["waterLevelOk"] = (frame.flags & STATE_WATER_LEVEL_OK) != 0;
+    if (sensors & FIELD_LIGHT_LUX) values["lightLux"] = frame.lightLux;
+    if (actuators & ACTUATOR_LAMP1) values["lamp1On"] = (frame.actuators & ACTUATOR_LAMP1) != 0;
+    if (actuators & ACTUATOR_LAMP2) values["lamp2On"] = (frame.actuators & ACTUATOR_LAMP2) != 0;
+    if (actuators & ACTUATOR_HEATER) values["heaterOn"] = (frame.actuators & ACTUATOR_HEATER) != 0;
+    if (actuators & ACTUATOR_FAN) values["fanOn"] = (frame.actuators & ACTUATOR_FAN) != 0;
+    if (actuators & ACTUATOR_PUMP) values["pumpOn"] = (frame.actuators & ACTUATOR_PUMP) != 0;
+    if (actuators & ACTUATOR_MISTER) values["misterOn"] = (frame.actuators & ACTUATOR_MISTER) != 0;
+}
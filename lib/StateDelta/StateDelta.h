@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "SensorSnapshot.h"
+#include "StateFrame.h"
+
+/**
+ * Änderungserkennung für die Statusnachricht (StateFrame bzw. JSON-Nachricht "state").
+ *
+ * Merkt sich den zuletzt gesendeten Status und ermittelt, welche Messwerte sich seitdem um mindestens ihre Schwelle
+ * (Deadband) geändert haben und welche Aktoren umgeschaltet wurden. Übernommen werden mit markSent() nur die
+ * tatsächlich gesendeten Felder, damit sich langsame Änderungen unterhalb der Schwelle aufsummieren:
+ *
+ *     const StateDelta::Changes changes = stateDelta.getChanges(frame, full);
+ *     if (changes.any()) {
+ *         // senden, z.B. mit StateDelta::fillJson(payload, frame, changes)
+ *         stateDelta.markSent(frame, changes);
+ *     }
+ *
+ * Wechsel zwischen gültig und ungültig zählen immer als Änderung (Bitmaske valid, NAN bei den Messwerten).
+ */
+class StateDelta {
+public:
+    static constexpr uint8_t ALL = 0xFF;           // Bitmaske für "alle Felder" (vollständiger Status)
+    static constexpr float LIGHT_MIN_DEADBAND = 1; // Kleinste Schwelle für das Tageslicht in Lux
+
+    /**
+     * @struct Deadbands
+     * @brief Schwellen, ab denen ein Messwert als geändert gilt (in der Firmware aus config.h).
+     */
+    struct Deadbands {
+        float temp;          // Raum- und Bodentemperatur in °C
+        float humidity;      // Luftfeuchtigkeit in %
+        int soilMoisture;    // Bodenfeuchte in %
+        float lightRelative; // Tageslicht, relativ zum zuletzt gesendeten Wert (mindestens LIGHT_MIN_DEADBAND)
+    };
+
+    /**
+     * @struct Changes
+     * @brief Geänderte Felder.
+     */
+    struct Changes {
+        uint8_t sensors = 0;   // Bitmaske aus SensorField
+        uint8_t actuators = 0; // Bitmaske aus ActuatorField
+
+        /** @brief Gibt an, ob sich überhaupt etwas geändert hat. */
+        bool any() const { return sensors != 0 || actuators != 0; }
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param deadbands Die Schwellen.
+     */
+    explicit StateDelta(const Deadbands& deadbands);
+
+    /**
+     * @brief Ermittelt die Felder, die sich seit dem zuletzt gesendeten Status geändert haben.
+     * @param now Der aktuelle Status.
+     * @param full true = vollständiger Status, alle Felder gelten als geändert.
+     */
+    Changes getChanges(const StateFrame& now, bool full = false) const;
+
+    /**
+     * @brief Übernimmt die gesendeten Felder in den zuletzt gesendeten Status.
+     * @param frame Der gesendete Status.
+     * @param changes Die gesendeten Felder (Ergebnis von getChanges()).
+     */
+    void markSent(const StateFrame& frame, const Changes& changes);
+
+    /**
+     * @brief Gibt den zuletzt gesendeten Status zurück (nur die gesendeten Felder sind aktuell).
+     */
+    const StateFrame& getPublished() const;
+
+    /**
+     * @brief Prüft, ob sich ein Messwert um mindestens die Schwelle geändert hat.
+     * Wechsel zwischen gültig und ungültig (NAN) zählen immer als Änderung.
+     */
+    static bool exceedsDeadband(float last, float now, float deadband);
+
+    /**
+     * @brief Füllt ein JSON-Objekt nur mit den geänderten Feldern des Status.
+     * Der Browser übernimmt die Felder in seinen letzten Stand; seq und valid stehen immer darin.
+     * @param values Das Objekt (Payload der Nachricht).
+     * @param frame Der aktuelle Status.
+     * @param changes Die geänderten Felder.
+     */
+    static void fillJson(JsonObject values, const StateFrame& frame, const Changes& changes);
+
+private:
+    Deadbands _deadbands;
+    StateFrame _published;
+};
@@ -0,0 +1,34 @@
+/**
+ * Beispiel zur Nutzung der StateDelta-Bibliothek
+ *
+ * Misst jede Sekunde die Temperatur am internen Sensor und gibt sie nur aus, wenn sie sich seit der letzten Ausgabe
+ * um mindestens 0,5 °C geändert hat (alle 30 Sekunden vollständig).
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "StateDelta.h"
+
+StateDelta stateDelta({0.5f, 1.0f, 1, 0.05f});
+uint32_t sequence = 0;
+
+void setup() {
+    Serial.begin(115200);
+}
+
+void loop() {
+    StateFrame frame;
+    frame.sequence = ++sequence;
+    frame.valid = FIELD_AIR_TEMP;
+    frame.airTemp = temperatureRead();
+
+    const StateDelta::Changes changes = stateDelta.getChanges(frame, sequence % 30 == 1);
+    if (changes.any()) {
+        JsonDocument doc;
+        StateDelta::fillJson(doc.to<JsonObject>(), frame, changes);
+        serializeJson(doc, Serial);
+        Serial.println();
+        stateDelta.markSent(frame, changes);
+    }
+    delay(1000);
+}
@@ -1,11 +1,41 @@
 #include "WebUI.h"
 #include <LittleFS.h>
+#include <memory>
+#include <esp_heap_caps.h>
+
+// Bilder auf der SD-Karte werden nur einmal geschrieben und nie geändert: ein Jahr im Browser-Cache, ohne Nachfrage
+static constexpr char IMAGE_CACHE_CONTROL[] = "public, max-age=31536000, immutable";
+// Web-Dateien mit Hash im Namen (/assets/, siehe scripts/build_assets.py) ändern sich ebenfalls nie
+static constexpr char ASSET_CACHE_CONTROL[] = "public, max-age=31536000, immutable";
+// index.html verweist auf die aktuellen Namen und wird daher bei jedem Aufruf geprüft (meist nur 304)
+static constexpr char INDEX_CACHE_CONTROL[] = "no-cache";
+// Übrige Dateien aus dem LittleFS (Icons, favicon.ico) haben keinen Hash im Namen
+static constexpr char STATIC_CACHE_CONTROL[] = "public, max-age=86400";
+// Text-Format von OpenMetrics für /metrics (versteht Prometheus ab 2.5)
+static constexpr char METRICS_CONTENT_TYPE[] = "application/openmetrics-text; version=1.0.0; charset=utf-8";
 
 WebUI::WebUI(uint16_t port)
     : _server(port), _ws("/ws") {}
 
-bool WebUI::begin(FS* sd) {
+bool WebUI::begin(FS* sd, SpiBusArbiter* bus, const int sdDevice, FrameRing* frames, FrameRing* streamFrames) {
     _sd = sd;
+    _bus = bus;
+    _sdDevice = sdDevice;
+    _frames = frames;
+    _streamFrames = streamFrames ? streamFrames : frames;
+
+    // Arenen für ausgehende Nachrichten (einmalig, danach kein Heap mehr pro Nachricht)
+    for (JsonArena& arena : _arenas) {
+        arena.begin(JSON_ARENA_SIZE);
+    }
+
+    // Puffer für eingehende Nachrichten, die in mehreren Teilen ankommen (ebenfalls einmalig)
+    if (!_rxMemory) {
+        _rxMemory = static_cast<char*>(heap_caps_malloc(RX_BUFFER_COUNT * RX_BUFFER_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+        for (uint8_t i = 0; i < RX_BUFFER_COUNT && _rxMemory; i++) {
+            _rx[i].data = _rxMemory + i * RX_BUFFER_SIZE;
+        }
+    }
 
     // WebSocket-Events an unsere interne Handler-Funktion binden
     _ws.onEvent([this](AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, const uint8_t *data, size_t len) {
@@ -13,6 +43,9 @@ bool WebUI::begin(FS* sd) {
     });
     _server.addHandler(&_ws);
 
+    // ETag der Startseite (ändert sich nur mit einem neuen Dateisystem-Abbild)
+    _indexETag = readIndexETag();
+
     // Routen registrieren
     registerRoutes();
 
@@ -39,19 +72,76 @@ void WebUI::registerRoutes() {
     //     request->send(LittleFS, "/script.js", "application/javascript");
     // });
 
-    // Registriere einen Handler, der ALLE statischen Dateien aus dem LittleFS ausliefert.
-    // Dieser eine Befehl kümmert sich um "/", "/style.css", "/script.js" UND alle Anfragen an "/icons/...".
-    _server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html");
+    // Startseite: wird bei jedem Aufruf geprüft, ist aber meist mit 304 erledigt
+    _server.on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendIndex(request);
+    });
+    _server.on("/index.html", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendIndex(request);
+    });
+
+    // CSS und JavaScript mit Hash im Namen (gzip-komprimiert, die .gz-Datei wird automatisch gewählt)
+    _server.serveStatic("/assets/", LittleFS, "/assets/").setCacheControl(ASSET_CACHE_CONTROL);
+
+    // Registriere einen Handler, der alle übrigen statischen Dateien aus dem LittleFS ausliefert.
+    // Dieser eine Befehl kümmert sich um "/favicon.ico" UND alle Anfragen an "/icons/...".
+    _server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html").setCacheControl(STATIC_CACHE_CONTROL);
+
+    // Handler für Bilder aus dem RAM: "/img/latest" bzw. "/img/<seq>" (muss vor "/img" registriert werden).
+    // Pfade mit Unterverzeichnis ("/img/2025/12/05/103000.jpg") liegen auf der SD-Karte.
+    _server.on("/img/*", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        const String name = request->url().substring(5); // hinter "/img/"
+        if (name.indexOf('/') >= 0) {
+            if (_sd) {
+                sendFromSD(request, request->url(), "image/jpeg", IMAGE_CACHE_CONTROL);
+            } else {
+                request->send(404, "text/plain", "Keine SD-Karte.");
+            }
+            return;
+        }
+        FrameRing::Ref frame;
+        if (_frames) {
+            frame = name == "latest" ? _frames->latest() : _frames->get(strtoul(name.c_str(), nullptr, 10));
+        }
+        if (!frame) {
+            request->send(404, "text/plain", "Bild nicht (mehr) im Speicher.");
+            return;
+        }
+        sendFrame(request, frame);
+    });
+
+    // Live-Stream (MJPEG) aus dem Ringpuffer
+    _server.on("/stream", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        startStream(request);
+    });
+
+    // Kennzahlen für Prometheus, die Werte liefert die Hauptanwendung (onMetrics). Der Text entsteht erst beim Senden,
+    // Stück für Stück in die Sendepuffer von AsyncTCP, und liegt nie am Stück im Speicher.
+    _server.on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        if (!onMetrics) {
+            request->send(404, "text/plain", "Keine Kennzahlen.");
+            return;
+        }
+        std::shared_ptr<MetricsWriter> writer = onMetrics();
+        if (!writer) {
+            AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", "Kennzahlen werden gerade abgefragt.");
+            response->addHeader("Retry-After", "1");
+            request->send(response);
+            return;
+        }
+        AsyncWebServerResponse* response = request->beginChunkedResponse(
+            METRICS_CONTENT_TYPE,
+            [writer](uint8_t* buffer, const size_t maxLen, size_t) -> size_t {
+                return writer->fill(buffer, maxLen);
+            });
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response);
+    });
 
     // Handler zur Anzeige eines einzelnen Bildes von der SD-Karte
     _server.on("/img", HTTP_GET, [this](AsyncWebServerRequest* request) {
         if (request->hasParam("path") && _sd) {
-            String path = request->getParam("path")->value();
-            if (_sd->exists(path)) {
-                request->send(*_sd, path, "image/jpeg");
-            } else {
-                request->send(404, "text/plain", "Bild nicht gefunden.");
-            }
+            sendFromSD(request, request->getParam("path")->value(), "image/jpeg", IMAGE_CACHE_CONTROL);
         } else {
             request->send(400, "text/plain", "Fehlender 'path'-Parameter oder keine SD-Karte.");
         }
@@ -63,65 +153,636 @@ void WebUI::registerRoutes() {
     });
 }
 
+void WebUI::sendIndex(AsyncWebServerRequest* request) const {
+    if (_indexETag.length() > 0 && request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match").indexOf(_indexETag) >= 0) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", _indexETag);
+        response->addHeader("Cache-Control", INDEX_CACHE_CONTROL);
+        request->send(response);
+        return;
+    }
+    if (!LittleFS.exists("/index.html.gz") && !LittleFS.exists("/index.html")) {
+        request->send(404, "text/plain", "index.html fehlt im Dateisystem.");
+        return;
+    }
+    // Fehlt "/index.html", nimmt die Bibliothek "/index.html.gz" und setzt Content-Encoding: gzip
+    AsyncWebServerResponse* response = request->beginResponse(LittleFS, "/index.html", "text/html");
+    if (_indexETag.length() > 0) {
+        response->addHeader("ETag", _indexETag);
+    }
+    response->addHeader("Cache-Control", INDEX_CACHE_CONTROL);
+    request->send(response);
+}
+
+String WebUI::readIndexETag() {
+    // Die letzten 8 Byte einer gzip-Datei sind CRC32 und Länge des Inhalts, ohne die ganze Datei zu lesen
+    File file = LittleFS.open("/index.html.gz", FILE_READ);
+    if (!file || file.size() < 8 || !file.seek(file.size() - 8)) {
+        return ""; // unkomprimiert hochgeladen: ohne ETag
+    }
+    uint8_t trailer[8];
+    const size_t bytesRead = file.read(trailer, sizeof(trailer));
+    file.close();
+    if (bytesRead != sizeof(trailer)) {
+        return "";
+    }
+    uint32_t crc = 0;
+    uint32_t length = 0;
+    for (int i = 3; i >= 0; i--) {
+        crc = crc << 8 | trailer[i];
+        length = length << 8 | trailer[4 + i];
+    }
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08lx-%lx\"", static_cast<unsigned long>(crc), static_cast<unsigned long>(length));
+    return etag;
+}
+
+void WebUI::sendFromSD(AsyncWebServerRequest* request, const String& path, const char* contentType, const char* cacheControl) {
+    // Datei öffnen und die Bedingungen der Anfrage prüfen (kurz auf den Bus warten, der AsyncTCP-Task darf nicht
+    // lange blockieren)
+    File file;
+    size_t size = 0;
+    String etag;
+    String lastModified;
+    bool notModified = false;
+    RangeResult range = RangeResult::Full;
+    size_t first = 0;
+    size_t last = 0;
+    {
+        const SpiBusArbiter::Lock lock(_bus, _sdDevice, SD_LOCK_TIMEOUT);
+        if (!lock) {
+            AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", "SD-Karte belegt.");
+            response->addHeader("Retry-After", "1");
+            request->send(response);
+            return;
+        }
+        if (_sd->exists(path)) {
+            file = _sd->open(path, FILE_READ);
+        }
+        if (file) {
+            size = file.size();
+            last = size > 0 ? size - 1 : 0;
+            etag = makeETag(path, size);
+            lastModified = formatHttpDate(file.getLastWrite());
+
+            // Hat der Browser die Datei schon (If-None-Match hat Vorrang vor If-Modified-Since), reicht 304 ohne Inhalt
+            if (request->hasHeader("If-None-Match")) {
+                const String& match = request->header("If-None-Match");
+                notModified = match == "*" || match.indexOf(etag) >= 0;
+            } else if (request->hasHeader("If-Modified-Since")) {
+                notModified = lastModified.length() > 0 && request->header("If-Modified-Since") == lastModified;
+            }
+
+            // Bereich auswerten; If-Range mit anderem ETag heißt: die ganze (geänderte) Datei senden
+            if (!notModified && request->hasHeader("Range") &&
+                (!request->hasHeader("If-Range") || request->header("If-Range") == etag)) {
+                range = parseRange(request->header("Range"), size, first, last);
+                if (range == RangeResult::Partial && !file.seek(first)) {
+                    range = RangeResult::Unsatisfiable;
+                }
+            }
+            if (notModified || range == RangeResult::Unsatisfiable) {
+                file.close(); // wird nicht gesendet
+            }
+        }
+    }
+    if (notModified) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        return;
+    }
+    if (range == RangeResult::Unsatisfiable) {
+        AsyncWebServerResponse* response = request->beginResponse(416, "text/plain", "Bereich liegt außerhalb der Datei.");
+        response->addHeader("Content-Range", "bytes */" + String(size));
+        request->send(response);
+        return;
+    }
+    if (!file) {
+        request->send(404, "text/plain", "Bild nicht gefunden.");
+        return;
+    }
+
+    // Blockweise lesen (ab first). Die Datei lebt im Lambda weiter und wird nach dem letzten Block geschlossen.
+    const size_t length = size > 0 ? last - first + 1 : 0;
+    AsyncWebServerResponse* response = request->beginResponse(contentType, length,
+        [this, file, length](uint8_t* buffer, const size_t maxLen, const size_t index) mutable -> size_t {
+            const SpiBusArbiter::Lock lock(_bus, _sdDevice, 0);
+            if (!lock) {
+                return RESPONSE_TRY_AGAIN; // Bus belegt, später erneut versuchen
+            }
+            const size_t bytesRead = file.read(buffer, min(maxLen, length - index));
+            if (bytesRead == 0 || index + bytesRead >= length) {
+                file.close();
+            }
+            return bytesRead;
+        });
+    if (range == RangeResult::Partial) {
+        response->setCode(206);
+        response->addHeader("Content-Range", "bytes " + String(first) + "-" + String(last) + "/" + String(size));
+    }
+    response->addHeader("Accept-Ranges", "bytes");
+    response->addHeader("ETag", etag);
+    if (lastModified.length() > 0) {
+        response->addHeader("Last-Modified", lastModified);
+    }
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+}
+
+WebUI::RangeResult WebUI::parseRange(const String& header, const size_t size, size_t& first, size_t& last) {
+    if (!header.startsWith("bytes=") || header.indexOf(',') >= 0) {
+        return RangeResult::Full; // andere Einheit oder mehrere Bereiche
+    }
+    const int dash = header.indexOf('-', 6);
+    if (dash < 0) {
+        return RangeResult::Full;
+    }
+    const String from = header.substring(6, dash);
+    const String to = header.substring(dash + 1);
+    char* end = nullptr;
+    if (from.length() == 0) {
+        // "bytes=-500": die letzten 500 Byte
+        const unsigned long suffix = strtoul(to.c_str(), &end, 10);
+        if (to.length() == 0 || *end != '\0') {
+            return RangeResult::Full;
+        }
+        if (suffix == 0 || size == 0) {
+            return RangeResult::Unsatisfiable;
+        }
+        first = suffix < size ? size - suffix : 0;
+        last = size - 1;
+        return RangeResult::Partial;
+    }
+
+    first = strtoul(from.c_str(), &end, 10);
+    if (*end != '\0') {
+        return RangeResult::Full;
+    }
+    last = size > 0 ? size - 1 : 0;
+    if (to.length() > 0) {
+        const unsigned long requested = strtoul(to.c_str(), &end, 10);
+        if (*end != '\0' || requested < first) {
+            return RangeResult::Full; // ungültig: wie ohne Range
+        }
+        last = min<size_t>(requested, last);
+    }
+    return first < size ? RangeResult::Partial : RangeResult::Unsatisfiable;
+}
+
+String WebUI::makeETag(const String& path, const size_t size) {
+    // FNV-1a über den Pfad, dazu die Größe
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < path.length(); i++) {
+        hash = (hash ^ static_cast<uint8_t>(path[i])) * 16777619u;
+    }
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08lx-%lx\"", static_cast<unsigned long>(hash), static_cast<unsigned long>(size));
+    return etag;
+}
+
+String WebUI::formatHttpDate(const time_t time) {
+    if (time <= 0) {
+        return "";
+    }
+    tm utc{};
+    gmtime_r(&time, &utc);
+    char date[32];
+    strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+    return date;
+}
+
+void WebUI::sendFrame(AsyncWebServerRequest* request, const FrameRing::Ref& frame) {
+    // Die Daten werden direkt aus dem Slot in den Sendepuffer kopiert. Die Ref im Lambda hält das Bild fest, bis die
+    // Antwort zerstört wird.
+    AsyncWebServerResponse* response = request->beginResponse("image/jpeg", frame.size(),
+        [frame](uint8_t* buffer, const size_t maxLen, const size_t index) -> size_t {
+            const size_t remaining = frame.size() - index;
+            const size_t length = remaining < maxLen ? remaining : maxLen;
+            memcpy(buffer, frame.data() + index, length);
+            return length;
+        });
+    response->addHeader("X-Frame-Seq", String(frame.seq()));
+    response->addHeader("Cache-Control", "no-cache"); // die Nummern beginnen nach einem Neustart wieder bei 1
+    request->send(response);
+}
+
+// --- Live-Stream ---
+
+static constexpr char STREAM_BOUNDARY[] = "frame"; // Trennzeichen zwischen den Bildern im Multipart-Stream
+static constexpr char STREAM_CONTENT_TYPE[] = "multipart/x-mixed-replace; boundary=frame";
+
+WebUI::StreamClient::~StreamClient() {
+    if (!owner) {
+        return; // wurde abgelehnt und nie eingetragen
+    }
+    // Platz freigeben (die Ref auf das Bild gibt ihr eigener Destruktor frei)
+    portENTER_CRITICAL(&owner->_streamMux);
+    owner->_streams[slot] = nullptr;
+    owner->_streamCount--;
+    portEXIT_CRITICAL(&owner->_streamMux);
+}
+
+void WebUI::startStream(AsyncWebServerRequest* request) {
+    if (!_streamFrames) {
+        request->send(503, "text/plain", "Keine Kamera.");
+        return;
+    }
+
+    // Freien Platz suchen
+    auto client = std::make_shared<StreamClient>();
+    bool first = false;
+    int slot = -1;
+    portENTER_CRITICAL(&_streamMux);
+    for (uint8_t i = 0; i < MAX_STREAM_CLIENTS; i++) {
+        if (!_streams[i]) {
+            slot = i;
+            _streams[i] = client.get();
+            first = _streamCount++ == 0;
+            client->stats.id = ++_streamIds;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_streamMux);
+    if (slot < 0) {
+        client->owner = nullptr; // nie eingetragen, Destruktor darf nichts freigeben
+        AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", "Zu viele Clients am Live-Stream.");
+        response->addHeader("Retry-After", "5");
+        request->send(response);
+        return;
+    }
+    client->owner = this;
+    client->slot = slot;
+    client->windowStart = millis();
+
+    // Die Antwort läuft, bis der Client die Verbindung trennt. Das Lambda hält den Zustand des Clients.
+    AsyncWebServerResponse* response = request->beginChunkedResponse(
+        STREAM_CONTENT_TYPE,
+        [client](uint8_t* buffer, const size_t maxLen, size_t) -> size_t {
+            return client->owner->fillStream(*client, buffer, maxLen);
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+
+    Serial.printf("Live-Stream: Client #%u verbunden\n", client->stats.id);
+    if (first && onStreamStart) {
+        onStreamStart(); // Kamera wecken
+    }
+}
+
+size_t WebUI::fillStream(StreamClient& client, uint8_t* buffer, const size_t maxLen) {
+    if (!client.frame) {
+        // Immer das neueste Bild nehmen. Ältere, die der Client nicht mehr bekommen hat, gelten als übersprungen.
+        FrameRing::Ref frame = _streamFrames->latest();
+        if (!frame || frame.seq() == client.lastSeq) {
+            return RESPONSE_TRY_AGAIN; // noch kein neues Bild
+        }
+        const uint32_t skipped = client.lastSeq > 0 && frame.seq() > client.lastSeq ? frame.seq() - client.lastSeq - 1 : 0;
+        client.lastSeq = frame.seq();
+        client.headerLength = snprintf(client.header, sizeof(client.header),
+            "--%s\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n",
+            STREAM_BOUNDARY, static_cast<unsigned>(frame.size()));
+        client.offset = 0;
+        client.frame = std::move(frame);
+
+        portENTER_CRITICAL(&_streamMux);
+        client.stats.dropped += skipped;
+        portEXIT_CRITICAL(&_streamMux);
+    }
+
+    // Ein Teil besteht aus Kopf, JPEG-Daten und abschließendem CRLF
+    const size_t imageEnd = client.headerLength + client.frame.size();
+    const size_t partEnd = imageEnd + 2;
+    size_t written = 0;
+    while (written < maxLen && client.offset < partEnd) {
+        const uint8_t* source;
+        size_t available;
+        if (client.offset < client.headerLength) {
+            source = reinterpret_cast<const uint8_t*>(client.header) + client.offset;
+            available = client.headerLength - client.offset;
+        } else if (client.offset < imageEnd) {
+            source = client.frame.data() + (client.offset - client.headerLength);
+            available = imageEnd - client.offset;
+        } else {
+            source = reinterpret_cast<const uint8_t*>("\r\n") + (client.offset - imageEnd);
+            available = partEnd - client.offset;
+        }
+        const size_t length = available < maxLen - written ? available : maxLen - written;
+        memcpy(buffer + written, source, length);
+        written += length;
+        client.offset += length;
+    }
+
+    if (client.offset >= partEnd) {
+        // Bild komplett gesendet: freigeben und Bildrate messen
+        client.frame.reset();
+        const unsigned long now = millis();
+        portENTER_CRITICAL(&_streamMux);
+        client.stats.frames++;
+        client.windowFrames++;
+        if (now - client.windowStart >= STREAM_FPS_WINDOW) {
+            client.stats.fps = static_cast<float>(client.windowFrames) * 1000.0f / static_cast<float>(now - client.windowStart);
+            client.windowFrames = 0;
+            client.windowStart = now;
+        }
+        portEXIT_CRITICAL(&_streamMux);
+    }
+    return written;
+}
+
+uint8_t WebUI::getStreamClientCount() const {
+    return _streamCount;
+}
+
+uint8_t WebUI::getStreamStats(StreamStats* stats, const uint8_t max) {
+    const unsigned long now = millis();
+    uint8_t count = 0;
+    portENTER_CRITICAL(&_streamMux);
+    for (uint8_t i = 0; i < MAX_STREAM_CLIENTS && count < max; i++) {
+        const StreamClient* client = _streams[i];
+        if (client) {
+            stats[count] = client->stats;
+            if (now - client->windowStart >= 2 * STREAM_FPS_WINDOW) {
+                stats[count].fps = 0; // seit zwei Messfenstern kein Bild mehr gesendet
+            }
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&_streamMux);
+    return count;
+}
+
 void WebUI::cleanupClients() {
     _ws.cleanupClients();
 }
 
+// --- Dokumente aus dem Arena-Pool ---
+
+namespace {
+/**
+ * Schreibt die serialisierte Nachricht direkt in den Sendepuffer (ohne Zwischen-String).
+ */
+struct BufferWriter {
+    uint8_t* data;
+    size_t size;
+    size_t length = 0;
+
+    size_t write(const uint8_t c) {
+        if (length >= size) {
+            return 0;
+        }
+        data[length++] = c;
+        return 1;
+    }
+
+    size_t write(const uint8_t* s, size_t n) {
+        if (n > size - length) {
+            n = size - length;
+        }
+        memcpy(data + length, s, n);
+        length += n;
+        return n;
+    }
+};
+}
+
+WebUI::PooledDocument::PooledDocument(WebUI& owner)
+    : _owner(owner), _arena(owner.acquireArena()),
+      _doc(_arena ? static_cast<ArduinoJson::Allocator*>(_arena) : JsonArena::heap()) {
+    if (!_arena) {
+        _owner._arenaFallbacks++;
+    }
+}
+
+WebUI::PooledDocument::~PooledDocument() {
+    if (_arena) {
+        _doc.clear(); // alle Blöcke an die Arena zurückgeben, bevor sie zurückgesetzt wird
+        _arena->release();
+    }
+}
+
+JsonDocument& WebUI::PooledDocument::doc() {
+    return _doc;
+}
+
+JsonArena* WebUI::acquireArena() {
+    for (JsonArena& arena : _arenas) {
+        if (arena.tryAcquire()) {
+            return &arena;
+        }
+    }
+    return nullptr;
+}
+
+AsyncWebSocketSharedBuffer WebUI::serialize(const JsonDocument& doc) {
+    const size_t length = measureJson(doc);
+    auto buffer = std::make_shared<std::vector<uint8_t>>(length);
+    BufferWriter writer{buffer->data(), length};
+    serializeJson(doc, writer);
+    return buffer;
+}
+
+size_t WebUI::getJsonArenaHighWaterMark() const {
+    size_t highWaterMark = 0;
+    for (const JsonArena& arena : _arenas) {
+        if (arena.getHighWaterMark() > highWaterMark) {
+            highWaterMark = arena.getHighWaterMark();
+        }
+    }
+    return highWaterMark;
+}
+
+uint32_t WebUI::getJsonArenaFallbacks() const {
+    return _arenaFallbacks;
+}
+
+uint32_t WebUI::getJsonOverflows() const {
+    return _jsonOverflows;
+}
+
+bool WebUI::isComplete(const JsonDocument& doc) {
+    if (doc.overflowed()) {
+        _jsonOverflows++; // Arena (JSON_ARENA_SIZE) oder Heap zu klein: lieber verwerfen als abgeschnitten senden
+        return false;
+    }
+    return true;
+}
+
 // --- Broadcast Methoden ---
 
 void WebUI::broadcast(const JsonDocument& doc) {
-    String jsonString;
-    serializeJson(doc, jsonString);
-    _ws.textAll(jsonString);
+    if (isComplete(doc)) {
+        _ws.textAll(serialize(doc));
+    }
 }
 
 void WebUI::broadcast(const char* type) {
-    JsonDocument doc;
-    doc["type"] = type;
-    broadcast(doc);
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    broadcast(message.doc());
 }
 
 void WebUI::broadcast(const char* type, const JsonObject& payload) {
-    JsonDocument doc;
-    doc["type"] = type;
-    doc["payload"] = payload;
-    broadcast(doc);
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    message.doc()["payload"] = payload;
+    broadcast(message.doc());
+}
+
+void WebUI::broadcast(const char* type, const PayloadBuilder& build) {
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    build(message.doc()["payload"].to<JsonObject>());
+    broadcast(message.doc());
 }
 
 void WebUI::broadcast(const char* type, const char* key, const String& value) {
-    JsonDocument doc;
-    doc["type"] = type;
-    doc["payload"][key] = value;
-    broadcast(doc);
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    message.doc()["payload"][key] = value;
+    broadcast(message.doc());
+}
+
+// --- Status (JSON oder binär je Client) ---
+
+size_t WebUI::broadcastStateJson(const PayloadBuilder& build) {
+    PooledDocument message(*this);
+    message.doc()["type"] = "state";
+    build(message.doc()["payload"].to<JsonObject>());
+    if (!isComplete(message.doc())) {
+        return 0;
+    }
+    const AsyncWebSocketSharedBuffer buffer = serialize(message.doc());
+
+    if (_binaryCount == 0) {
+        _ws.textAll(buffer);
+    } else {
+        for (AsyncWebSocketClient& client : _ws.getClients()) {
+            if (client.status() == WS_CONNECTED && !isBinaryState(client.id())) {
+                client.text(buffer);
+            }
+        }
+    }
+    return buffer->size();
+}
+
+uint8_t WebUI::broadcastStateBinary(const uint8_t* data, const size_t len) {
+    // IDs kopieren, damit das Senden nicht im kritischen Abschnitt läuft
+    uint32_t ids[MAX_BINARY_CLIENTS];
+    uint8_t count = 0;
+    portENTER_CRITICAL(&_binaryMux);
+    for (const uint32_t id : _binaryClients) {
+        if (id != 0) {
+            ids[count++] = id;
+        }
+    }
+    portEXIT_CRITICAL(&_binaryMux);
+
+    uint8_t sent = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (_ws.binary(ids[i], data, len)) {
+            sent++;
+        }
+    }
+    return sent;
+}
+
+bool WebUI::setBinaryState(const AsyncWebSocketClient* client, const bool enabled) {
+    if (!client) {
+        return false;
+    }
+    const uint32_t id = client->id();
+    int slot = -1;     // Eintrag des Clients
+    int freeSlot = -1; // erster freier Eintrag
+    portENTER_CRITICAL(&_binaryMux);
+    for (uint8_t i = 0; i < MAX_BINARY_CLIENTS; i++) {
+        if (_binaryClients[i] == id) {
+            slot = i;
+        } else if (_binaryClients[i] == 0 && freeSlot < 0) {
+            freeSlot = i;
+        }
+    }
+    if (enabled && slot < 0 && freeSlot >= 0) {
+        _binaryClients[freeSlot] = id;
+        _binaryCount++;
+        slot = freeSlot;
+    } else if (!enabled && slot >= 0) {
+        _binaryClients[slot] = 0;
+        _binaryCount--;
+    }
+    portEXIT_CRITICAL(&_binaryMux);
+    return !enabled || slot >= 0;
+}
+
+bool WebUI::isBinaryState(const uint32_t clientId) {
+    bool found = false;
+    portENTER_CRITICAL(&_binaryMux);
+    for (const uint32_t id : _binaryClients) {
+        if (id == clientId) {
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_binaryMux);
+    return found;
+}
+
+uint8_t WebUI::getBinaryStateClientCount() const {
+    return _binaryCount;
+}
+
+size_t WebUI::getClientCount() const {
+    return _ws.count();
 }
 
 // --- SendTo Methoden (Unicast) ---
 
 void WebUI::sendTo(const AsyncWebSocketClient* client, const JsonDocument& doc) {
     if (!client || client->status() != WS_CONNECTED) return;
-    String jsonString;
-    serializeJson(doc, jsonString);
-    _ws.text(client->id(), jsonString);
+    sendTo(client->id(), doc);
+}
+
+void WebUI::sendTo(const uint32_t clientId, const JsonDocument& doc) {
+    AsyncWebSocketClient* target = _ws.client(clientId);
+    if (target && target->status() == WS_CONNECTED && isComplete(doc)) {
+        target->text(serialize(doc));
+    }
 }
 
 void WebUI::sendTo(const AsyncWebSocketClient* client, const char* type) {
-    JsonDocument doc;
-    doc["type"] = type;
-    sendTo(client, doc);
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    sendTo(client, message.doc());
 }
 
 void WebUI::sendTo(const AsyncWebSocketClient* client, const char* type, const JsonObject& payload) {
-    JsonDocument doc;
-    doc["type"] = type;
-    doc["payload"] = payload;
-    sendTo(client, doc);
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    message.doc()["payload"] = payload;
+    sendTo(client, message.doc());
+}
+
+void WebUI::sendTo(const AsyncWebSocketClient* client, const char* type, const PayloadBuilder& build) {
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    build(message.doc()["payload"].to<JsonObject>());
+    sendTo(client, message.doc());
+}
+
+void WebUI::sendTo(const uint32_t clientId, const char* type, const PayloadBuilder& build) {
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    build(message.doc()["payload"].to<JsonObject>());
+    sendTo(clientId, message.doc());
 }
 
 void WebUI::sendTo(const AsyncWebSocketClient* client, const char* type, const char* key, const String& value) {
-    JsonDocument doc;
-    doc["type"] = type;
-    doc["payload"][key] = value;
-    sendTo(client, doc);
+    PooledDocument message(*this);
+    message.doc()["type"] = type;
+    message.doc()["payload"][key] = value;
+    sendTo(client, message.doc());
 }
 
 // --- Console Log Methode ---
@@ -150,21 +811,86 @@ void WebUI::onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
     } else if (type == WS_EVT_DISCONNECT) {
         // Client hat die Verbindung getrennt
         Serial.printf("WebSocket Client #%u getrennt\n", client->id());
+        setBinaryState(client, false);
+        releaseRxBuffer(client->id());
         if (onClientDisconnect) {
             onClientDisconnect(client->id());
         }
     } else if (type == WS_EVT_DATA) {
         // Daten vom Client empfangen
-        // Wir wandeln die empfangenen Bytes in einen String um, um sie zu vergleichen.
-        String msg = "";
-        for (size_t i = 0; i < len; i++) {
-            msg += static_cast<char>(data[i]);
-        }
-        Serial.printf("Nachricht von Client #%u empfangen: %s\n", client->id(), msg.c_str());
+        handleData(client, *static_cast<const AwsFrameInfo*>(arg), data, len);
+    }
+}
+
+void WebUI::handleData(AsyncWebSocketClient* client, const AwsFrameInfo& info, const uint8_t* data, const size_t len) {
+    if (info.message_opcode != WS_TEXT) {
+        return; // der Browser sendet nur JSON
+    }
 
-        // Wenn ein Callback registriert ist, rufe ihn mit der Nachricht auf.
+    // Häufigster Fall: die Nachricht steckt vollständig in diesem Paket, ohne Kopie weiterreichen
+    if (info.final && info.num == 0 && info.index == 0 && info.len == len) {
         if (onMessage) {
-            onMessage(client, msg);
+            onMessage(client, reinterpret_cast<const char*>(data), len);
+        }
+        return;
+    }
+
+    // Sonst im Puffer des Clients zusammensetzen. Das erste Paket des ersten Frames beginnt eine neue Nachricht.
+    const bool first = info.num == 0 && info.index == 0;
+    RxBuffer* buffer = getRxBuffer(client->id(), first);
+    if (!buffer) {
+        if (first) {
+            Serial.printf("WebSocket: kein Puffer frei, Nachricht von Client #%u verworfen\n", client->id());
+        }
+        return;
+    }
+    if (first) {
+        buffer->length = 0; // Rest einer abgebrochenen Nachricht verwerfen
+        buffer->overflow = false;
+    }
+    if (len > RX_BUFFER_SIZE - buffer->length) {
+        buffer->overflow = true;
+    } else if (!buffer->overflow) {
+        memcpy(buffer->data + buffer->length, data, len);
+        buffer->length += len;
+    }
+
+    // Letztes Paket des letzten Frames: Nachricht vollständig
+    if (info.final && info.index + len >= info.len) {
+        if (buffer->overflow) {
+            Serial.printf("WebSocket: Nachricht von Client #%u länger als %u Byte, verworfen\n", client->id(), static_cast<unsigned>(RX_BUFFER_SIZE));
+        } else if (onMessage) {
+            onMessage(client, buffer->data, buffer->length);
+        }
+        releaseRxBuffer(client->id());
+    }
+}
+
+WebUI::RxBuffer* WebUI::getRxBuffer(const uint32_t clientId, const bool create) {
+    RxBuffer* freeBuffer = nullptr;
+    for (RxBuffer& buffer : _rx) {
+        if (buffer.clientId == clientId) {
+            return &buffer;
+        }
+        if (buffer.clientId == 0 && buffer.data && !freeBuffer) {
+            freeBuffer = &buffer;
+        }
+    }
+    if (create && freeBuffer) {
+        freeBuffer->clientId = clientId;
+        freeBuffer->length = 0;
+        freeBuffer->overflow = false;
+        return freeBuffer;
+    }
+    return nullptr;
+}
+
+void WebUI::releaseRxBuffer(const uint32_t clientId) {
+    for (RxBuffer& buffer : _rx) {
+        if (buffer.clientId == clientId) {
+            buffer.clientId = 0;
+            buffer.length = 0;
+            buffer.overflow = false;
         }
     }
 }
@@ -3,8 +3,14 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <ESPAsyncWebServer.h>
+#include <atomic>
 #include <functional> // Notwendig für Callbacks
+#include <memory>
 #include <FS.h> // Notwendig für den FS-Pointer
+#include "SpiBusArbiter.h"
+#include "FrameRing.h"
+#include "JsonArena.h"
+#include "MetricsWriter.h"
 
 /**
  * Stellt ein Webinterface zur Steuerung via WebSocket bereit.
@@ -21,12 +27,44 @@ public:
      */
     explicit WebUI(uint16_t port = 80);
 
+    static constexpr uint32_t SD_LOCK_TIMEOUT = 100; // Maximale Wartezeit in ms auf den SPI-Bus beim Öffnen einer Datei
+    static constexpr uint8_t MAX_STREAM_CLIENTS = 2; // Maximale Anzahl gleichzeitiger Clients am Live-Stream (/stream)
+    static constexpr unsigned long STREAM_FPS_WINDOW = 2000; // Zeitfenster in ms für die Messung der Bildrate
+    static constexpr uint8_t MAX_BINARY_CLIENTS = 8; // Maximale Anzahl Clients, die den Status binär empfangen
+    static constexpr uint8_t JSON_ARENA_COUNT = 2; // Anzahl der Arenen für ausgehende Nachrichten (gleichzeitig erstellte Nachrichten)
+    static constexpr size_t JSON_ARENA_SIZE = 6144; // Größe einer Arena in Byte (reicht für den vollständigen Status)
+    static constexpr uint8_t RX_BUFFER_COUNT = 2; // Anzahl der Puffer für eingehende Nachrichten, die in mehreren Teilen ankommen
+    static constexpr size_t RX_BUFFER_SIZE = 2048; // Maximale Länge einer solchen Nachricht in Byte (längere werden verworfen)
+
+    /**
+     * @brief Füllt das Payload-Objekt einer Nachricht.
+     * Das Objekt liegt bereits im Dokument der Nachricht, es wird also nichts kopiert.
+     * Format: (Payload-Objekt)
+     */
+    using PayloadBuilder = std::function<void(JsonObject payload)>;
+
+    /**
+     * @struct StreamStats
+     * @brief Messwerte eines Clients am Live-Stream.
+     */
+    struct StreamStats {
+        uint32_t id = 0;       // Laufende Nummer des Clients
+        float fps = 0;         // Tatsächlich gesendete Bilder pro Sekunde
+        uint32_t frames = 0;   // Gesendete Bilder
+        uint32_t dropped = 0;  // Übersprungene Bilder (Client zu langsam)
+    };
+
     /**
      * @brief Initialisiert den Server und registriert die Routen.
      * @param sd Ein Pointer auf das SD-Karten-Dateisystem (optional, für SD-Funktionen).
+     * @param bus Arbiter für den SPI-Bus der SD-Karte (optional). Alle Zugriffe auf die SD-Karte holen dann den Bus.
+     * @param sdDevice ID der SD-Karte beim Arbiter.
+     * @param frames Ringpuffer mit den letzten Kamerabildern (optional, für /img/latest und /img/<seq>).
+     * @param streamFrames Eigener Ringpuffer für den Live-Stream (optional, sonst teilt er sich frames).
      * @return true bei Erfolg.
      */
-    bool begin(FS* sd = nullptr);
+    bool begin(FS* sd = nullptr, SpiBusArbiter* bus = nullptr, int sdDevice = SpiBusArbiter::NO_DEVICE,
+               FrameRing* frames = nullptr, FrameRing* streamFrames = nullptr);
 
     /**
      * @brief Sendet eine Nachricht nur mit Typ (ohne Nutzdaten).
@@ -42,11 +80,52 @@ public:
      */
     void broadcast(const char* type, const JsonObject& payload);
 
+    /**
+     * @brief Sendet eine Nachricht an alle Clients und lässt das Payload direkt im Dokument der Nachricht erstellen.
+     * @param type Der Nachrichtentyp.
+     * @param build Füllt das Payload-Objekt.
+     */
+    void broadcast(const char* type, const PayloadBuilder& build);
+
     /**
      * @brief Sendet Schlüssel-Wert-Paare als Payload ("payload": {key: value})
      */
     void broadcast(const char* type, const char* key, const String& value);
 
+    /**
+     * @brief Sendet den Status als JSON ("state") an alle Clients, die ihn nicht binär empfangen.
+     * @param build Füllt das Payload-Objekt mit dem Status.
+     * @return Länge der Nachricht in Byte.
+     */
+    size_t broadcastStateJson(const PayloadBuilder& build);
+
+    /**
+     * @brief Sendet den Status als binären Frame an alle Clients, die das mit setBinaryState() gewählt haben.
+     * @param data Der Frame (z.B. ein StateFrame).
+     * @param len Länge in Byte.
+     * @return Anzahl der Clients, an die gesendet wurde.
+     */
+    uint8_t broadcastStateBinary(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Legt fest, ob ein Client den Status binär statt als JSON empfängt.
+     * Beim Trennen der Verbindung wird der Client automatisch wieder ausgetragen.
+     * @param client Der Client.
+     * @param enabled true = binär, false = JSON.
+     * @return false, wenn bereits MAX_BINARY_CLIENTS Clients den Status binär empfangen.
+     */
+    bool setBinaryState(const AsyncWebSocketClient* client, bool enabled);
+
+    /**
+     * @brief Gibt die Anzahl der Clients zurück, die den Status binär empfangen.
+     */
+    uint8_t getBinaryStateClientCount() const;
+
+    /**
+     * @brief Gibt die Anzahl der verbundenen WebSocket-Clients zurück.
+     */
+    size_t getClientCount() const;
+
     /**
      * @brief Sendet eine Nachricht an einen bestimmten Client.
      * @param client Der Ziel-Client.
@@ -62,6 +141,31 @@ public:
      */
     void sendTo(const AsyncWebSocketClient* client, const char* type, const JsonObject& payload);
 
+    /**
+     * @brief Sendet eine Nachricht an einen bestimmten Client und lässt das Payload direkt im Dokument erstellen.
+     * @param client Der Ziel-Client.
+     * @param type Der Nachrichtentyp.
+     * @param build Füllt das Payload-Objekt.
+     */
+    void sendTo(const AsyncWebSocketClient* client, const char* type, const PayloadBuilder& build);
+
+    /**
+     * @brief Sendet eine Nachricht an einen Client, der nur über seine ID bekannt ist.
+     * Für andere Tasks (z.B. Hintergrundaufträge): Hat sich der Client inzwischen getrennt, wird nichts gesendet.
+     * @param clientId ID des Ziel-Clients.
+     * @param type Der Nachrichtentyp.
+     * @param build Füllt das Payload-Objekt.
+     */
+    void sendTo(uint32_t clientId, const char* type, const PayloadBuilder& build);
+
+    /**
+     * @brief Sendet ein fertiges JSON-Dokument an einen Client, der nur über seine ID bekannt ist.
+     * Für große Nachrichten, die nicht in eine Arena passen (z.B. die Bildliste).
+     * @param clientId ID des Ziel-Clients.
+     * @param doc Das zu sendende JSON-Dokument (mit "type" und "payload").
+     */
+    void sendTo(uint32_t clientId, const JsonDocument& doc);
+
     /**
      * @brief Sendet ein Schlüssel-Wert-Paar an einen bestimmten Client.
      * @param client Der Ziel-Client.
@@ -79,6 +183,37 @@ public:
      */
     void consoleLog(const AsyncWebSocketClient* client, const char *format, ...);
 
+    /**
+     * @brief Gibt die Anzahl der Clients am Live-Stream zurück.
+     */
+    uint8_t getStreamClientCount() const;
+
+    /**
+     * @brief Gibt die Messwerte der Clients am Live-Stream zurück.
+     * @param stats Ziel-Array.
+     * @param max Größe des Arrays.
+     * @return Anzahl der eingetragenen Clients.
+     */
+    uint8_t getStreamStats(StreamStats* stats, uint8_t max);
+
+    /**
+     * @brief Gibt den höchsten belegten Speicher einer Arena für ausgehende Nachrichten zurück.
+     * @return Größe in Byte (zum Abgleich mit JSON_ARENA_SIZE).
+     */
+    size_t getJsonArenaHighWaterMark() const;
+
+    /**
+     * @brief Gibt zurück, wie oft eine Nachricht auf dem Heap erstellt werden musste (alle Arenen belegt).
+     */
+    uint32_t getJsonArenaFallbacks() const;
+
+    /**
+     * @brief Gibt zurück, wie viele Nachrichten verworfen wurden, weil sie nicht in ihr Dokument passten.
+     * Solche Nachrichten wären abgeschnitten beim Client angekommen; steigt der Wert, JSON_ARENA_SIZE erhöhen oder die
+     * Nachricht aufteilen.
+     */
+    uint32_t getJsonOverflows() const;
+
     /**
      * @brief Diese Funktion entfernt "tote" Clients aus der internen Liste des Servers.
      * Sie sollte regelmäßig in der Haupt-loop() aufgerufen werden, um Speicherlecks zu vermeiden.
@@ -87,11 +222,12 @@ public:
 
     /**
      * @property onMessage
-     * @brief Callback, der aufgerufen wird, wenn eine Nachricht über WebSocket empfangen wird.
+     * @brief Callback, der aufgerufen wird, wenn eine vollständige Textnachricht über WebSocket empfangen wurde.
      * Die Hauptanwendung (main.cpp) muss diesen Callback definieren, um auf Befehle vom Browser zu reagieren.
-     * Format: (Zeiger auf den Client, Nachricht als String)
+     * Die Daten sind nicht nullterminiert und nur während des Aufrufs gültig.
+     * Format: (Zeiger auf den Client, Daten, Länge in Byte)
      */
-    std::function<void(AsyncWebSocketClient* client, const String& msg)> onMessage;
+    std::function<void(AsyncWebSocketClient* client, const char* data, size_t length)> onMessage;
 
     /**
          * @property onClientConnect
@@ -108,7 +244,146 @@ public:
      */
     std::function<void(uint32_t clientId)> onClientDisconnect;
 
+    /**
+     * @property onStreamStart
+     * @brief Callback, der aufgerufen wird, wenn sich der erste Client mit dem Live-Stream verbindet.
+     * Die Hauptanwendung muss dann laufend Bilder in den FrameRing des Streams aufnehmen, solange
+     * getStreamClientCount() > 0 ist.
+     * Läuft im AsyncTCP-Task, darf also nicht blockieren.
+     */
+    std::function<void()> onStreamStart;
+
+    /**
+     * @property onMetrics
+     * @brief Callback, der zu Beginn einer Abfrage von GET /metrics den MetricsWriter für die Antwort liefert.
+     * Die Antwort wird als Chunked-Antwort (OpenMetrics-Text) gesendet und hält den Writer, bis sie fertig ist.
+     * Ohne Callback antwortet /metrics mit 404, liefert er nullptr (z.B. weil schon eine Abfrage läuft), mit 503.
+     * Läuft im AsyncTCP-Task, darf also nicht blockieren.
+     * Format: () -> Writer
+     */
+    std::function<std::shared_ptr<MetricsWriter>()> onMetrics;
+
 private:
+    /**
+     * Dokument für eine ausgehende Nachricht.
+     *
+     * Nimmt eine freie Arena aus dem Pool und gibt sie im Destruktor zurück. Sind alle Arenen vergeben, liegt das
+     * Dokument wie bisher auf dem Heap.
+     */
+    class PooledDocument {
+    public:
+        explicit PooledDocument(WebUI& owner);
+        ~PooledDocument();
+
+        PooledDocument(const PooledDocument&) = delete;
+        PooledDocument& operator=(const PooledDocument&) = delete;
+
+        /**
+         * @brief Gibt das Dokument zurück.
+         */
+        JsonDocument& doc();
+
+    private:
+        WebUI& _owner;
+        JsonArena* _arena; // nullptr = Heap
+        JsonDocument _doc;
+    };
+
+    /**
+     * @struct RxBuffer
+     * @brief Puffer, in dem eine Nachricht zusammengesetzt wird, die in mehreren Teilen (Frames oder TCP-Paketen)
+     * ankommt.
+     */
+    struct RxBuffer {
+        uint32_t clientId = 0; // Client, dessen Nachricht gerade zusammengesetzt wird (0 = frei)
+        char* data = nullptr;  // RX_BUFFER_SIZE Byte (Teil von _rxMemory)
+        size_t length = 0;     // Bisher empfangene Bytes
+        bool overflow = false; // Nachricht ist länger als RX_BUFFER_SIZE und wird verworfen
+    };
+
+    /**
+     * @brief Verarbeitet empfangene Daten: vollständige Nachrichten werden direkt weitergereicht, alle anderen im
+     * Puffer des Clients zusammengesetzt.
+     * @param client Der Client.
+     * @param info Angaben zum Frame (Position der Daten im Frame und in der Nachricht).
+     * @param data Empfangene Daten.
+     * @param len Länge der Daten.
+     */
+    void handleData(AsyncWebSocketClient* client, const AwsFrameInfo& info, const uint8_t* data, size_t len);
+
+    /**
+     * @brief Gibt den Puffer eines Clients zurück.
+     * @param clientId ID des Clients.
+     * @param create true = freien Puffer reservieren, wenn der Client noch keinen hat.
+     * @return Der Puffer, oder nullptr.
+     */
+    RxBuffer* getRxBuffer(uint32_t clientId, bool create);
+
+    /**
+     * @brief Gibt den Puffer eines Clients frei (z.B. beim Trennen der Verbindung).
+     * @param clientId ID des Clients.
+     */
+    void releaseRxBuffer(uint32_t clientId);
+
+    /**
+     * @brief Prüft, ob ein Dokument vollständig ist, und zählt es sonst als verworfen (siehe getJsonOverflows()).
+     * @param doc Das Dokument.
+     * @return false, wenn beim Erstellen der Speicher ausging.
+     */
+    bool isComplete(const JsonDocument& doc);
+
+    /**
+     * @brief Reserviert eine freie Arena aus dem Pool.
+     * @return Die Arena, oder nullptr, wenn alle vergeben sind.
+     */
+    JsonArena* acquireArena();
+
+    /**
+     * @brief Serialisiert ein Dokument in einen Puffer, den sich alle Empfänger teilen.
+     * Der Puffer wird genau in der benötigten Größe angelegt und nicht mehr kopiert; die Clients halten ihn per
+     * Referenzzählung, bis er gesendet ist.
+     * @param doc Das Dokument.
+     * @return Der Puffer.
+     */
+    static AsyncWebSocketSharedBuffer serialize(const JsonDocument& doc);
+
+    /**
+     * @struct StreamClient
+     * @brief Zustand eines Clients am Live-Stream.
+     * Gehört dem Lambda der Antwort und wird mit ihr zerstört (auch, wenn der Client die Verbindung trennt).
+     */
+    struct StreamClient {
+        WebUI* owner = nullptr;
+        uint8_t slot = 0;              // Index in _streams
+        FrameRing::Ref frame;          // Bild, das gerade gesendet wird (gepinnt)
+        char header[96] = {};          // Kopf des aktuellen Teils (Boundary, Content-Type, Content-Length)
+        size_t headerLength = 0;
+        size_t offset = 0;             // Bereits gesendete Bytes des aktuellen Teils
+        uint32_t lastSeq = 0;          // Nummer des zuletzt gesendeten Bildes
+        unsigned long windowStart = 0; // Beginn des Messfensters (millis)
+        uint16_t windowFrames = 0;     // Bilder im Messfenster
+        StreamStats stats;
+
+        ~StreamClient();
+    };
+
+    /**
+     * @brief Startet den Live-Stream für eine Anfrage (oder lehnt sie ab, wenn zu viele Clients verbunden sind).
+     * @param request Die Anfrage.
+     */
+    void startStream(AsyncWebServerRequest* request);
+
+    /**
+     * @brief Füllt den Sendepuffer eines Stream-Clients mit dem nächsten Stück des aktuellen Bildes.
+     * Liegt kein neues Bild vor, wird RESPONSE_TRY_AGAIN zurückgegeben. Bilder, die zwischen zwei Aufrufen aufgenommen
+     * wurden, werden übersprungen – ein langsamer Client bekommt weniger Bilder, bremst aber die Kamera nicht.
+     * @param client Der Client.
+     * @param buffer Sendepuffer.
+     * @param maxLen Größe des Sendepuffers.
+     * @return Anzahl geschriebener Bytes oder RESPONSE_TRY_AGAIN.
+     */
+    size_t fillStream(StreamClient& client, uint8_t* buffer, size_t maxLen);
+
     /**
      * @brief Interner Handler, der WebSocket-Events verarbeitet.
      * @param server Pointer auf den WebSocket-Server.
@@ -126,6 +401,74 @@ private:
      */
     void registerRoutes();
 
+    /**
+     * @enum RangeResult
+     * @brief Ergebnis von parseRange().
+     */
+    enum class RangeResult : uint8_t {
+        Full,         // Kein (unterstützter) Range-Header: die ganze Datei senden
+        Partial,      // Gültiger Bereich: nur diesen senden (206)
+        Unsatisfiable // Bereich liegt hinter dem Dateiende (416)
+    };
+
+    /**
+     * @brief Liefert die Startseite aus dem LittleFS aus (gzip-komprimiert, wenn vorhanden).
+     * Sie verweist auf die aktuellen Namen von CSS und JavaScript und wird deshalb mit "no-cache" gesendet: der Browser
+     * fragt jedes Mal nach, bekommt aber bei unverändertem ETag nur 304.
+     */
+    void sendIndex(AsyncWebServerRequest* request) const;
+
+    /**
+     * @brief Bildet das ETag der Startseite aus CRC32 und Länge am Ende von "/index.html.gz".
+     * @return Das ETag, oder einen leeren String, wenn die Startseite nicht komprimiert vorliegt.
+     */
+    static String readIndexETag();
+
+    /**
+     * @brief Liefert eine Datei von der SD-Karte aus, mit ETag, Last-Modified und Range.
+     * Stimmt das ETag aus If-None-Match (bzw. das Datum aus If-Modified-Since), antwortet sie mit 304 ohne die Datei zu
+     * lesen. Mit einem Range-Header wird nur der angefragte Bereich gesendet (206), z.B. um einen abgebrochenen
+     * Download fortzusetzen.
+     * Jeder Block wird unter dem Bus-Lock gelesen. Ist der Bus gerade belegt (z.B. durch eine Aufnahme), wird der
+     * Block später erneut angefordert, statt den AsyncTCP-Task zu blockieren.
+     * @param request Die Anfrage.
+     * @param path Pfad der Datei.
+     * @param contentType MIME-Typ.
+     * @param cacheControl Wert für den Cache-Control-Header.
+     */
+    void sendFromSD(AsyncWebServerRequest* request, const String& path, const char* contentType, const char* cacheControl);
+
+    /**
+     * @brief Wertet einen Range-Header aus ("bytes=0-499", "bytes=500-" oder "bytes=-500").
+     * Mehrere Bereiche in einem Header werden nicht unterstützt, dann wird die ganze Datei gesendet.
+     * @param header Wert des Range-Headers.
+     * @param size Größe der Datei.
+     * @param first Ziel für das erste Byte des Bereichs.
+     * @param last Ziel für das letzte Byte des Bereichs (einschließlich).
+     * @return Siehe RangeResult.
+     */
+    static RangeResult parseRange(const String& header, size_t size, size_t& first, size_t& last);
+
+    /**
+     * @brief Bildet ein starkes ETag aus Pfad und Größe einer Datei (z.B. "\"9f2c1a3b-bc45\"").
+     * Bilder werden nur einmal geschrieben, Pfad und Größe kennzeichnen den Inhalt daher eindeutig.
+     */
+    static String makeETag(const String& path, size_t size);
+
+    /**
+     * @brief Formatiert eine Zeit als HTTP-Datum (z.B. "Fri, 05 Dec 2025 10:30:00 GMT").
+     * @return Das Datum, oder einen leeren String bei unbekannter Zeit.
+     */
+    static String formatHttpDate(time_t time);
+
+    /**
+     * @brief Liefert ein Bild aus dem Ringpuffer aus.
+     * Das Bild bleibt gepinnt, bis die Antwort vollständig gesendet (oder abgebrochen) wurde.
+     * @param request Die Anfrage.
+     * @param frame Das Bild.
+     */
+    static void sendFrame(AsyncWebServerRequest* request, const FrameRing::Ref& frame);
+
     /**
      * @brief Sendet ein JSON-Objekt an alle Clients.
      * Ersetzt die alte broadcast(String) Methode für mehr Typsicherheit.
@@ -139,8 +482,31 @@ private:
      */
     void sendTo(const AsyncWebSocketClient* client, const JsonDocument& doc);
 
+    /**
+     * @brief Gibt an, ob ein Client den Status binär empfängt.
+     * @param clientId ID des Clients.
+     */
+    bool isBinaryState(uint32_t clientId);
+
     AsyncWebServer _server; // Die Instanz des Webservers.
     AsyncWebSocket _ws; // Die Instanz des WebSocket-Servers am Endpunkt "/ws".
     FS* _sd = nullptr; // Pointer auf die SD-Karte, wenn vorhanden
+    SpiBusArbiter* _bus = nullptr; // Arbiter für den SPI-Bus der SD-Karte, wenn vorhanden
+    int _sdDevice = SpiBusArbiter::NO_DEVICE; // ID der SD-Karte beim Arbiter
+    String _indexETag; // ETag der Startseite (leer = unbekannt)
+    FrameRing* _frames = nullptr; // Ringpuffer mit den letzten Kamerabildern, wenn vorhanden
+    FrameRing* _streamFrames = nullptr; // Ringpuffer des Live-Streams (= _frames, wenn er keinen eigenen hat)
+    StreamClient* _streams[MAX_STREAM_CLIENTS] = {}; // Clients am Live-Stream (nullptr = frei)
+    uint8_t _streamCount = 0; // Anzahl der Clients am Live-Stream
+    uint32_t _streamIds = 0; // Zähler für die laufende Nummer der Stream-Clients
+    portMUX_TYPE _streamMux = portMUX_INITIALIZER_UNLOCKED; // Schützt _streams und die Messwerte
+    uint32_t _binaryClients[MAX_BINARY_CLIENTS] = {}; // IDs der Clients, die den Status binär empfangen (0 = frei)
+    uint8_t _binaryCount = 0; // Anzahl der Clients, die den Status binär empfangen
+    portMUX_TYPE _binaryMux = portMUX_INITIALIZER_UNLOCKED; // Schützt _binaryClients
+    JsonArena _arenas[JSON_ARENA_COUNT]; // Pool für die Dokumente ausgehender Nachrichten
+    std::atomic<uint32_t> _arenaFallbacks{0}; // Nachrichten, die auf dem Heap erstellt werden mussten
+    std::atomic<uint32_t> _jsonOverflows{0};  // Nachrichten, die nicht in ihr Dokument passten und verworfen wurden
+    RxBuffer _rx[RX_BUFFER_COUNT]; // Puffer für eingehende Nachrichten in mehreren Teilen (nur im AsyncTCP-Task benutzt)
+    char* _rxMemory = nullptr; // Speicher aller Puffer (einmal in begin() reserviert)
     //String _lastStateJson;
 };
\ No newline at end of file
@@ -0,0 +1,112 @@
+"""
+Bereitet die Web-Dateien aus data/ für das LittleFS vor (PlatformIO extra_script, läuft vor jedem Build).
+
+- index.html, style.css und script.js werden verkleinert (Kommentare, Einrückung und Leerzeilen entfernt).
+- style.css und script.js bekommen einen Hash ihres Inhalts in den Dateinamen und landen in /assets/
+  (z.B. /assets/script.3f2a91c0.js). Die Verweise in index.html werden entsprechend angepasst.
+- Diese Dateien werden nur gzip-komprimiert abgelegt (*.gz). Der Webserver liefert sie mit Content-Encoding: gzip aus.
+- Alle übrigen Dateien (Icons, favicon.ico) werden unverändert kopiert.
+
+Das Ergebnis liegt in .pio/build/<env>/data und wird statt data/ als Dateisystem-Abbild gebaut und hochgeladen
+(buildfs / uploadfs). In data/ wird weiterhin der lesbare Quelltext bearbeitet.
+"""
+
+import gzip
+import hashlib
+import io
+import os
+import re
+import shutil
+
+Import("env")  # noqa: F821 (von PlatformIO bereitgestellt)
+
+HASHED_ASSETS = ("style.css", "script.js")  # bekommen einen Hash im Namen, im Browser unbegrenzt gültig
+ASSET_DIR = "assets"
+HASH_LENGTH = 8
+
+
+def minify_js(text):
+    # Bewusst zurückhaltend: nur ganze Kommentarzeilen und Kommentarblöcke am Zeilenanfang, keine Umformung von Code
+    lines = []
+    in_block = False
+    for line in text.splitlines():
+        stripped = line.strip()
+        if in_block:
+            in_block = "*/" not in stripped
+            continue
+        if stripped.startswith("/*"):
+            in_block = "*/" not in stripped
+            continue
+        if not stripped or stripped.startswith("//"):
+            continue
+        lines.append(stripped)
+    return "\n".join(lines) + "\n"
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};,])\s*", r"\1", text)
+    return text.strip() + "\n"
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    lines = [line.strip() for line in text.splitlines()]
+    return "\n".join(line for line in lines if line) + "\n"
+
+
+MINIFIERS = {".js": minify_js, ".css": minify_css, ".html": minify_html}
+
+
+def write_gzip(path, data):
+    # mtime=0, damit gleicher Inhalt auch eine gleiche Datei ergibt
+    buffer = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", fileobj=buffer, compresslevel=9, mtime=0) as f:
+        f.write(data)
+    with open(path + ".gz", "wb") as f:
+        f.write(buffer.getvalue())
+    return len(buffer.getvalue())
+
+
+def build_assets(source, target):
+    if os.path.isdir(target):
+        shutil.rmtree(target)
+    os.makedirs(os.path.join(target, ASSET_DIR))
+
+    renamed = {}
+    for name in HASHED_ASSETS:
+        with open(os.path.join(source, name), encoding="utf-8") as f:
+            data = MINIFIERS[os.path.splitext(name)[1]](f.read()).encode("utf-8")
+        digest = hashlib.sha1(data).hexdigest()[:HASH_LENGTH]
+        base, extension = os.path.splitext(name)
+        hashed = "%s/%s.%s%s" % (ASSET_DIR, base, digest, extension)
+        size = write_gzip(os.path.join(target, hashed), data)
+        renamed[name] = hashed
+        print("Web-Dateien: %s -> /%s.gz (%d Byte)" % (name, hashed, size))
+
+    with open(os.path.join(source, "index.html"), encoding="utf-8") as f:
+        html = minify_html(f.read())
+    for name, hashed in renamed.items():
+        reference = '"/%s"' % name
+        if reference not in html:
+            raise RuntimeError("build_assets: index.html verweist nicht auf %s" % reference)
+        html = html.replace(reference, '"/%s"' % hashed)
+    size = write_gzip(os.path.join(target, "index.html"), html.encode("utf-8"))
+    print("Web-Dateien: index.html -> /index.html.gz (%d Byte)" % size)
+
+    # Alles andere unverändert übernehmen
+    for root, _, files in os.walk(source):
+        for name in files:
+            relative = os.path.relpath(os.path.join(root, name), source)
+            if relative in HASHED_ASSETS or relative == "index.html":
+                continue
+            destination = os.path.join(target, relative)
+            os.makedirs(os.path.dirname(destination), exist_ok=True)
+            shutil.copy2(os.path.join(root, name), destination)
+
+
+source_dir = env.subst("$PROJECT_DATA_DIR")  # noqa: F821
+target_dir = os.path.join(env.subst("$BUILD_DIR"), "data")  # noqa: F821
+build_assets(source_dir, target_dir)
+env.Replace(PROJECT_DATA_DIR=target_dir)  # noqa: F821
@@ -18,8 +18,12 @@
 // #include <ArduinoOTA.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <Preferences.h>
 #include <SD.h>
 #include <Wire.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <atomic>
 
 // -- Einbinden der Konfiguration und der lokalen Bibliotheken --
 #include "config.h"
@@ -28,16 +32,36 @@
 #include "SettingsManager.h"
 #include "WebUI.h"
 #include "ArduCamOV2640.h"
+#include "CaptureSchedule.h"
+#include "CommandRouter.h"
+#include "Controller.h"
+#include "FrameRing.h"
+#include "Hal.h"
+#include "ImageIndex.h"
+#include "ImageRetention.h"
+#include "JobQueue.h"
+#include "JsonArena.h"
 #include "LED.h"
+#include "MetricsWriter.h"
 #include "MicroSDCard.h"
 #include "OLEDDisplaySH1106.h"
 #include "OTA.h"
+#include "Profiler.h"
 #include "Relay.h"
 #include "SensorAM2302.h"
 #include "SensorBH1750.h"
 #include "SensorCapacitiveSoil.h"
 #include "SensorDS18B20.h"
+#include "SensorHistory.h"
+#include "SensorScheduler.h"
+#include "SensorSnapshot.h"
+#include "SensorWiring.h"
 #include "SensorXKCY25NPN.h"
+#include "Seqlock.h"
+#include "SpiBusArbiter.h"
+#include "SpscQueue.h"
+#include "StateDelta.h"
+#include "StateFrame.h"
 
 // Splash Screen
 #include "xbm/frank_128x64_xbm.h" // definiert das C-Array frank_128x64_bits[]
@@ -61,6 +85,9 @@ SettingsManager settingsManager;
 
 // --- Webinterface ---
 WebUI webInterface;
+JsonArena inboxArena; // Speicher zum Parsen eingehender WebSocket-Nachrichten (nur AsyncTCP-Task)
+CommandRouter<AsyncWebSocketClient*> commandRouter; // ordnet eingehende Nachrichten anhand von "type" ihrem Handler zu
+JobQueue jobQueue; // langsame Befehle (SD-Karte, Aufnahme) laufen im eigenen Task statt im AsyncTCP-Task
 
 OTA ota(HOSTNAME, OTA_PASSWORD);
 
@@ -70,6 +97,7 @@ SensorDS18B20 soilTempSensor(PIN_SOIL_TEMPERATUR_SENSOR); // Bodentemperatursens
 SensorCapacitiveSoil soilMoistureSensor(PIN_SOIL_MOISTURE_SENSOR, SOIL_MOISTURE_ADC_DRY, SOIL_MOISTURE_ADC_WET); // Kapazitiver Bodenfeuchtigkeitssensor v1.2 (S3)
 SensorXKCY25NPN waterLevelSensor(PIN_WATER_LEVEL_SENSOR); // Berührungsloser Füllstandsensor XKC-Y25-NPN (S4)
 SensorBH1750 lightSensor; // Lichtsensor GY-302 BH1750 (S5)
+SensorScheduler sensorScheduler(SENSOR_LOOP_BUDGET_US); // verteilt die Sensormessungen auf mehrere loop()-Durchläufe
 
 // --- Aktoren (Relais) ---
 // Die Relais sind active-low, d.h. LOW schaltet sie ein.
@@ -80,6 +108,41 @@ Relay fanRelay(PIN_FAN_RELAY);        // Lüfter (A4)
 Relay pumpRelay(PIN_PUMP_RELAY);      // Wasserpumpe (A5)
 Relay misterRelay(PIN_MISTER_RELAY);  // Vernebler (A6)
 
+// Steuerungslogik
+Controller controller(lamp1Relay, lamp2Relay, heaterRelay, fanRelay, pumpRelay, misterRelay);
+
+/**
+ * Aktor, wie ihn das Webinterface anspricht.
+ */
+struct Actuator {
+    Relay* relay;                // Das Relais
+    ControlMode Settings::*mode; // Zugehöriger Modus in den Einstellungen
+    uint8_t bit;                 // Bit in StateFrame::actuators
+};
+
+// Namen der Aktoren in den WebSocket-Nachrichten ("target")
+constexpr NamedValue<Actuator> ACTUATORS[] = {
+    {"lamp1", {&lamp1Relay, &Settings::lamp1Mode, ACTUATOR_LAMP1}},
+    {"lamp2", {&lamp2Relay, &Settings::lamp2Mode, ACTUATOR_LAMP2}},
+    {"heater", {&heaterRelay, &Settings::heaterMode, ACTUATOR_HEATER}},
+    {"fan", {&fanRelay, &Settings::fanMode, ACTUATOR_FAN}},
+    {"pump", {&pumpRelay, &Settings::pumpMode, ACTUATOR_PUMP}},
+    {"mister", {&misterRelay, &Settings::misterMode, ACTUATOR_MISTER}},
+};
+
+// Namen der Modi in den WebSocket-Nachrichten ("mode")
+constexpr NamedValue<ControlMode> CONTROL_MODES[] = {
+    {"auto", MODE_AUTO},
+    {"on", MODE_ON},
+    {"off", MODE_OFF},
+};
+
+// --- SPI-Bus ---
+// Kamera und SD-Karte teilen sich den SPI-Bus. Jeder Zugriff läuft über den Arbiter.
+SpiBusArbiter spiBus;
+int spiSdDevice = SpiBusArbiter::NO_DEVICE;     // ID der SD-Karte beim Arbiter
+int spiCameraDevice = SpiBusArbiter::NO_DEVICE; // ID der Kamera beim Arbiter
+
 // --- Sonstige Peripherie ---
 OLEDDisplaySH1106 display;            // 1.3 Zoll OLED Display, SSH1106 (Z1)
 MicroSDCard sdCard(PIN_SPI_SD_CS);    // MicroSD SPI Kartenleser (Z2)
@@ -88,38 +151,307 @@ LED debugLed(PIN_DEBUG_LED);          // LED (Z4)
 
 // === Globale Variablen zur Zustandsspeicherung ===
 
+// --- Kamerabilder ---
+// Die letzten Aufnahmen liegen im RAM und werden von dort ausgeliefert (/img/latest, /img/<seq>). Auf die SD-Karte
+// schreibt der Kamera-Task sie erst danach (siehe persistPendingImage()). Der Live-Stream hat eigene, kleinere Slots,
+// damit seine Bilder die letzten Aufnahmen nicht verdrängen.
+FrameRing frameRing;
+FrameRing streamRing;
+
+struct PendingImage {
+    FrameRing::Ref frame; // Aufnahme im frameRing, gepinnt bis sie auf der SD-Karte liegt (leer = keine offen)
+    uint32_t time;        // Aufnahmezeit (Unix-Zeit in s, 0 = unbekannt)
+    char path[MicroSDCard::IMAGE_PATH_LENGTH]; // Zieldatei auf der SD-Karte
+    uint8_t attempts;     // fehlgeschlagene Versuche (siehe IMAGE_SAVE_ATTEMPTS)
+    uint32_t retryAt;     // Zeitpunkt des nächsten Versuchs (millis)
+};
+PendingImage pendingImage{}; // Aufnahme, die noch auf die SD-Karte muss (nur im Kamera-Task)
+
+// Verzeichnis aller Bilder auf der SD-Karte. capture() bzw. persistPendingImage() tragen neue Bilder ein, die
+// Bilderliste im Webinterface wird seitenweise daraus gelesen, ohne das Verzeichnis zu durchsuchen.
+ImageIndex imageIndex(SD, IMAGE_INDEX_PATH);
+
+// Löscht alte Bilder nach den Einstellungen (Höchstalter, Ausdünnen, Speichergrenze, freier Speicher). Läuft als
+// Auftrag "imageRetention" alle RETENTION_INTERVAL ms in kurzen Zeitscheiben (siehe runImageRetention()).
+ImageRetention imageRetention(imageIndex, [](const char* path) { return sdCard.removeImage(path); });
+
 // --- Sensorwerte ---
-// Diese Variablen speichern die zuletzt gemessenen Werte, um sie im Programmablauf zu verwenden.
-// Sie werden mit "Not a Number" (NAN) oder -1 initialisiert, um anzuzeigen, dass noch keine gültige Messung stattgefunden hat.
-float currentAirTemp = NAN;         // Aktuelle Raumtemperatur in °C (S1)
-float currentHumidity = NAN;        // Aktuelle Luftfeuchtigkeit in % (S1)
-float currentSoilTemp = NAN;        // Aktuelle Bodentemperatur in °C (S2)
-int currentSoilMoisture = -1;       // Aktuelle Bodenfeuchte in % (S3), -1 bedeutet "ungültig/nicht gemessen"
-bool isWaterLevelOk = false;        // Zustand des Wasserfüllstands (S4), startet mit 'false' (kein Wasser), bis erste Messung erfolgt.
-float currentLightLux = NAN;        // Aktuelle Lichtstärke in Lux (S5)
+// Der Steuerungs-Task sammelt die Messwerte aus der sensorQueue in einem SensorSnapshot und veröffentlicht ihn über
+// einen Seqlock. Alle anderen Tasks (Display, Webinterface, AsyncTCP) lesen nur konsistente Kopien davon.
+Seqlock<SensorSnapshot> sensorSnapshot;
+
+// --- Einstellungen ---
+// Geändert werden die Einstellungen nur im AsyncTCP-Task (Befehle "setMode" und "saveSettings"). Er veröffentlicht
+// sie danach über einen Seqlock, aus dem Steuerungs-Task und Aufträge je Durchlauf eine konsistente Kopie lesen.
+Seqlock<Settings> settingsSnapshot;
+
+// --- Zähler der Aktoren ---
+// Die Relais schaltet nur der Steuerungs-Task. Er veröffentlicht ihre Zustände und Zähler nach jedem Zyklus, damit
+// /metrics (AsyncTCP) die 64-Bit-Einschaltdauer nie halb geschrieben liest.
+constexpr uint8_t ACTUATOR_COUNT = sizeof(ACTUATORS) / sizeof(ACTUATORS[0]);
+struct ActuatorCounters {
+    uint8_t bits = 0;                       // Zustände als Bitmaske aus ActuatorField
+    uint32_t switches[ACTUATOR_COUNT] = {}; // Schaltvorgänge seit dem Start (Reihenfolge wie ACTUATORS)
+    uint64_t onTimeMs[ACTUATOR_COUNT] = {}; // Einschaltdauer seit dem Start in ms
+};
+Seqlock<ActuatorCounters> actuatorCounters;
+
+// --- Messwert-Verlauf ---
+// Der Netzwerk-Task schreibt alle HISTORY_INTERVAL Sekunden die Messwerte in den feinen Verlauf (1 Stunde) und jede
+// Minute deren Mittelwert in den groben Verlauf (24 Stunden). Der feine Verlauf wird zusätzlich blockweise an eine
+// Datei pro Tag auf der SD-Karte angehängt.
+SensorHistory history;    // fein (HISTORY_INTERVAL)
+SensorHistory dayHistory; // grob (HISTORY_DAY_INTERVAL)
 
 // --- Zeitsteuerung für nicht-blockierende Operationen ---
-// Diese Variablen speichern den Zeitpunkt (in Millisekunden seit Start) der letzten Ausführung,
+// Diese Variablen speichern den Zeitpunkt (Hal::get().millis()) der letzten Ausführung,
 // um Aktionen in festen Intervallen ohne blockierende delay()-Aufrufe durchzuführen.
-unsigned long lastSensorRead = 0;     // Zeitpunkt der letzten Sensormessung
-unsigned long lastDisplayUpdate = 0;  // Zeitpunkt der letzten Display-Aktualisierung
-unsigned long lastCameraCapture = 0;  // Zeitpunkt der letzten Kameraaufnahme
-unsigned long lastBroadcastTime = 0;  // Zeitpunkt der letzten Broadcast-Nachricht
+// Als uint32_t, damit "now - last" auch über den Überlauf von millis() nach 49,7 Tagen stimmt.
+uint32_t lastDisplayUpdate = 0;  // Zeitpunkt der letzten Display-Aktualisierung (Sensor-Task)
+uint32_t lastCameraCapture = 0;  // Zeitpunkt der letzten Kameraaufnahme (Steuerungs-Task)
+uint32_t lastBroadcastTime = 0;  // Zeitpunkt der letzten Broadcast-Nachricht (Netzwerk-Task)
+uint32_t lastKeyframeTime = 0;   // Zeitpunkt des letzten vollständigen Status (Netzwerk-Task)
+uint32_t lastRetentionTime = 0;  // Zeitpunkt, zu dem das Aufräumen zuletzt eingereiht wurde (Netzwerk-Task)
+CaptureSchedule captureSchedule; // Zeitplan der Kamera (cameraCapturesPerDay, Steuerungs-Task)
+
+// === FreeRTOS-Tasks ===
+//
+// Steuerung (Kern 1, hohe Priorität): wertet neue Messwerte aus und schaltet die Relais
+// Sensoren   (Kern 1): liest die Sensoren über den Scheduler und aktualisiert das Display
+// Kamera     (Kern 0): nimmt Bilder auf und schreibt sie auf die SD-Karte, liefert Bilder für den Live-Stream
+// Netzwerk   (Kern 0): OTA, WebSocket-Aufräumen und periodischer Broadcast
+
+/**
+ * @enum SensorChannel
+ * @brief Kennzeichnet, zu welchem Messwert ein SensorReading gehört.
+ * Die Reihenfolge entspricht den Bits von SensorField (1 << channel).
+ */
+enum SensorChannel : uint8_t { CH_AIR_TEMP, CH_HUMIDITY, CH_SOIL_TEMP, CH_SOIL_MOISTURE, CH_WATER_LEVEL, CH_LIGHT_LUX };
+
+/**
+ * @struct SensorReading
+ * @brief Ein Messwert, den der Sensor-Task an den Steuerungs-Task übergibt.
+ */
+struct SensorReading {
+    SensorChannel channel; // Welcher Messwert
+    float value;           // Der Messwert (Wasserstand: 1 = ok, 0 = leer), NAN = ungültig
+    int64_t timestamp;     // esp_timer_get_time() bei der Messung, für die Latenzmessung
+};
+
+SpscQueue<SensorReading, 32> sensorQueue; // Sensor-Task -> Steuerungs-Task (lock-frei)
+
+TaskHandle_t controlTaskHandle = nullptr; // Steuerungs-Task (wird bei neuen Messwerten oder Befehlen geweckt)
+TaskHandle_t cameraTaskHandle = nullptr;  // Kamera-Task (wird für eine Aufnahme geweckt)
+TaskHandle_t networkTaskHandle = nullptr; // Netzwerk-Task (wird geweckt, wenn ein Aktor geschaltet wurde)
+
+// Gründe, den Kamera-Task zu wecken (Bits der Task-Notification)
+constexpr uint32_t CAMERA_NOTIFY_CAPTURE = 1 << 0; // Einzelaufnahme angefordert (requestCapture())
+constexpr uint32_t CAMERA_NOTIFY_STREAM = 1 << 1;  // erster Client am Live-Stream
+
+// --- Live-Stream ---
+uint8_t stillResolution = 0; // Auflösung für Einzelaufnahmen (die von camera.begin(), wird in setup() gesetzt)
+std::atomic<uint32_t> streamFramesSkipped{0}; // Stream-Bilder, die mangels freiem Slot nicht aufgenommen wurden
+
+// --- Reaktionszeit der Steuerung ---
+// Zeit von der Messung bis zum Schalten der Relais, und Dauer eines Steuerungszyklus (jeweils in µs).
+std::atomic<uint32_t> controlLatencyLastUs{0};
+std::atomic<uint32_t> controlLatencyMaxUs{0};
+std::atomic<uint32_t> controlCycleMaxUs{0};
+
+// --- Laufzeiten der heißen Pfade (Nachricht "stats" und /metrics) ---
+// Jeder Abschnitt wird nur von einem Task gemessen. Ohne Build-Flag PROFILER_ENABLED entfallen die Messpunkte.
+enum ProfileSection : uint8_t {
+    PROFILE_CONTROL_CYCLE,   // ein Zyklus des Steuerungs-Tasks
+    PROFILE_CONTROL_ACTORS,  // controlActors()
+    PROFILE_SENSOR_PASS,     // ein Durchlauf des Sensor-Tasks (ohne Pause)
+    PROFILE_READ_SENSORS,    // sensorScheduler.run()
+    PROFILE_UPDATE_DISPLAY,  // updateDisplay()
+    PROFILE_CAPTURE,         // capture()
+    PROFILE_NETWORK_PASS,    // ein Durchlauf des Netzwerk-Tasks
+    PROFILE_BROADCAST_STATE, // broadcastState()
+    PROFILE_SECTION_COUNT
+};
+const char* const PROFILE_SECTION_NAMES[PROFILE_SECTION_COUNT] = {
+    "controlCycle", "controlActors", "sensorPass", "readSensors", "updateDisplay", "capture", "networkPass",
+    "broadcastState"};
+Profiler profiler(PROFILE_SECTION_NAMES, PROFILE_SECTION_COUNT);
+
+// --- Kennzahlen für Prometheus (GET /metrics) ---
+// Zu Beginn einer Abfrage werden alle Werte in metricsSnapshot kopiert (nur Seqlocks, Atomics und Zähler, kein Bus),
+// der Text entsteht danach zeilenweise beim Senden. Es läuft höchstens eine Abfrage zur Zeit, weitere erhalten 503.
+enum MetricFamily : uint8_t {
+    METRIC_AIR_TEMP,
+    METRIC_HUMIDITY,
+    METRIC_SOIL_TEMP,
+    METRIC_SOIL_MOISTURE,
+    METRIC_WATER_LEVEL,
+    METRIC_LIGHT,
+    METRIC_SENSOR_VALID,
+    METRIC_SENSOR_ERRORS,
+    METRIC_SENSOR_DEADLINE_MISSES,
+    METRIC_RELAY_ON,
+    METRIC_RELAY_ON_TIME,
+    METRIC_RELAY_SWITCHES,
+    METRIC_HEAP_FREE,
+    METRIC_HEAP_MIN_FREE,
+    METRIC_HEAP_LARGEST_BLOCK,
+    METRIC_SECTION_DURATION,
+    METRIC_SECTION_MAX,
+    METRIC_SECTION_P99,
+    METRIC_WIFI_RSSI,
+    METRIC_SD_USED,
+    METRIC_SD_TOTAL,
+    METRIC_UPTIME,
+    METRIC_FAMILY_COUNT
+};
+using MetricType = MetricsWriter::Type;
+const MetricsWriter::Family METRIC_FAMILIES[METRIC_FAMILY_COUNT] = {
+    {"biodom_air_temperature_celsius", MetricType::Gauge, "celsius", "Raumtemperatur (S1), NaN ohne gültige Messung."},
+    {"biodom_air_humidity_percent", MetricType::Gauge, "percent", "Luftfeuchtigkeit (S1), NaN ohne gültige Messung."},
+    {"biodom_soil_temperature_celsius", MetricType::Gauge, "celsius", "Bodentemperatur (S2), NaN ohne gültige Messung."},
+    {"biodom_soil_moisture_percent", MetricType::Gauge, "percent", "Bodenfeuchte (S3), NaN ohne gültige Messung."},
+    {"biodom_water_level_ok", MetricType::Gauge, nullptr, "Wasserstand ausreichend (S4): 1 = ja, 0 = nein."},
+    {"biodom_light_lux", MetricType::Gauge, "lux", "Tageslicht (S5), NaN ohne gültige Messung."},
+    {"biodom_sensor_valid", MetricType::Gauge, nullptr, "1, wenn der Messwert schon gültig gemessen wurde."},
+    {"biodom_sensor_errors", MetricType::Counter, nullptr, "Fehlgeschlagene Messungen je Fehlercode (getLastError())."},
+    {"biodom_sensor_deadline_misses", MetricType::Counter, nullptr, "Messintervalle ohne gültige Messung."},
+    {"biodom_relay_on", MetricType::Gauge, nullptr, "Zustand des Relais: 1 = ein, 0 = aus."},
+    {"biodom_relay_on_seconds", MetricType::Counter, "seconds", "Einschaltdauer des Relais seit dem Start."},
+    {"biodom_relay_switches", MetricType::Counter, nullptr, "Schaltvorgänge des Relais seit dem Start."},
+    {"biodom_heap_free_bytes", MetricType::Gauge, "bytes", "Freier Heap."},
+    {"biodom_heap_min_free_bytes", MetricType::Gauge, "bytes", "Kleinster freier Heap seit dem Start."},
+    {"biodom_heap_largest_free_block_bytes", MetricType::Gauge, "bytes", "Größter zusammenhängender freier Block."},
+    {"biodom_section_duration_seconds", MetricType::Histogram, "seconds", "Laufzeit eines Abschnitts (siehe ProfileSection)."},
+    {"biodom_section_duration_max_seconds", MetricType::Gauge, "seconds", "Längste Laufzeit eines Abschnitts."},
+    {"biodom_section_duration_p99_seconds", MetricType::Gauge, "seconds", "99. Perzentil der Laufzeit (aus dem Histogramm geschätzt)."},
+    {"biodom_wifi_rssi_dbm", MetricType::Gauge, "dbm", "Empfangsstärke des WLANs."},
+    {"biodom_sd_used_bytes", MetricType::Gauge, "bytes", "Belegter Speicher der SD-Karte (Stand des letzten Aufräumens, auf ganze MB abgerundet)."},
+    {"biodom_sd_total_bytes", MetricType::Gauge, "bytes", "Größe der SD-Karte (auf ganze MB abgerundet)."},
+    {"biodom_uptime_seconds", MetricType::Gauge, "seconds", "Zeit seit dem Start."},
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Alle Werte einer Abfrage von /metrics, kopiert zu Beginn der Abfrage.
+ */
+struct MetricsSnapshot {
+    SensorSnapshot sensors;
+    ActuatorCounters actuators;
+    uint8_t sensorCount = 0;                                   // beim SensorScheduler registrierte Sensoren
+    uint32_t sensorFailures[SensorScheduler::MAX_SENSORS] = {}; // alle Fehlschläge
+    SensorScheduler::ErrorCount sensorErrors[SensorScheduler::MAX_SENSORS][SensorScheduler::MAX_ERROR_CODES];
+    uint8_t sensorErrorCodes[SensorScheduler::MAX_SENSORS] = {}; // belegte Einträge in sensorErrors
+    uint32_t deadlineMisses[SensorScheduler::MAX_SENSORS] = {};
+    Profiler::Stats sections[PROFILE_SECTION_COUNT];
+    bool sectionValid[PROFILE_SECTION_COUNT] = {};
+    uint32_t heapFree = 0;
+    uint32_t heapMinFree = 0;
+    uint32_t heapLargestBlock = 0;
+    bool wifiConnected = false;
+    int8_t rssi = 0;
+    uint32_t sdUsedMB = 0;
+    uint32_t sdTotalMB = 0; // 0 = noch nicht abgefragt
+    uint32_t uptimeMs = 0;
+};
+MetricsSnapshot metricsSnapshot;
+std::atomic<bool> metricsBusy{false}; // true, solange eine Abfrage metricsSnapshot und metricsWriter benutzt
+bool sampleMetric(uint8_t family, uint16_t index, MetricsWriter::Sample& sample);
+MetricsWriter metricsWriter(METRIC_FAMILIES, METRIC_FAMILY_COUNT, sampleMetric);
+
+// --- Belegung der SD-Karte ---
+// Das Abfragen dauert (FAT zählt die freien Cluster) und braucht den SPI-Bus. Es läuft daher im Auftrag
+// "imageRetention" (Task "jobs"), /metrics liest nur den letzten Stand (in MB, 0 = noch nicht abgefragt).
+std::atomic<uint32_t> sdUsedMB{0};
+std::atomic<uint32_t> sdTotalMB{0};
+
+// --- Aufwand je Status-Broadcast (JSON und binär im Vergleich) ---
+// Länge der Nachricht in Byte und Dauer von Erstellen bis Einreihen in die Sendepuffer in µs (jeweils der letzte Wert).
+std::atomic<uint32_t> stateJsonBytes{0};
+std::atomic<uint32_t> stateJsonUs{0};
+std::atomic<uint32_t> stateBinaryBytes{0};
+std::atomic<uint32_t> stateBinaryUs{0};
+std::atomic<uint32_t> stateSkipped{0}; // Broadcasts, die mangels Änderung entfallen sind
+
+// --- Zuletzt gesendeter Status (Netzwerk-Task) ---
+// Grundlage für die Änderungserkennung. Es werden nur die tatsächlich gesendeten Felder übernommen, damit sich auch
+// langsame Änderungen unterhalb der Schwelle aufsummieren.
+StateDelta stateDelta({STATE_DEADBAND_TEMP, STATE_DEADBAND_HUMIDITY, STATE_DEADBAND_SOIL_MOISTURE, STATE_DEADBAND_LIGHT});
+
+// --- Kamera-Status für das Display ---
+// Der Kamera-Task schreibt, der Sensor-Task zeigt an (so greift nur ein Task auf das Display zu).
+enum CameraStatus : uint8_t { CAMERA_IDLE, CAMERA_BUSY, CAMERA_OK, CAMERA_FAILED };
+std::atomic<CameraStatus> cameraStatus{CAMERA_IDLE};
+std::atomic<uint32_t> cameraStatusSince{0}; // millis() der letzten Statusänderung
+// Anforderungen von Aufnahmen tragen fortlaufende Nummern (requestCapture()). Der Kamera-Task meldet nach jeder
+// Aufnahme, bis zu welcher Nummer sie alle Anforderungen bedient hat, zusammen mit dem Ergebnis.
+std::atomic<uint32_t> captureRequests{0}; // zuletzt vergebene Nummer
+std::atomic<uint32_t> captureServed{0};   // (Nummer << 1) | 1 bei Erfolg, der letzten abgeschlossenen Aufnahme
+
+// --- Start-Zähler ---
+// Wird bei jedem Start im NVS hochgezählt. Bilder ohne Aufnahmezeit tragen ihn im Namen, da sich millis() nach jedem
+// Neustart wiederholt.
+uint16_t bootCount = 0;
 
 // === Funktionsprototypen ===
 
 void printFileSystemInfo();
-bool readSensors();
-void controlActors();
-void controlCamera();
+void countBoot();
+void setupSensorScheduler();
+void publishReading(SensorChannel channel, float value);
+void startTasks();
+void controlTask(void* parameter);
+void sensorTask(void* parameter);
+void cameraTask(void* parameter);
+void networkTask(void* parameter);
+void requestControlUpdate();
+uint32_t requestCapture();
+void controlActors(const SensorSnapshot& sensors, const Settings& settings);
+void controlCamera(const Settings& settings);
 void updateDisplay();
 void applyCameraSettings();
+void setCameraStatus(CameraStatus status);
 bool capture();
-JsonObject getStateAsJson(JsonDocument& doc);
-void broadcastState();
+bool persistPendingImage();
+bool saveImageToSD(const char* path);
+void captureStreamFrame();
+void useResolution(uint8_t resolution);
+void setupHistory();
+void setupImageIndex();
+void recordHistory();
+void spillHistory();
+void fillStateJson(JsonObject values);
+void fillStateDiagnosticsJson(JsonObject values);
+void fillStatsJson(JsonObject values);
+void takeMetricsSnapshot(MetricsSnapshot& snapshot);
+std::shared_ptr<MetricsWriter> startMetrics();
+void publishActuatorCounters();
+StateFrame getStateFrame();
+uint8_t getActuatorBits();
+void broadcastState(bool full);
 void broadcastSettings();
 void handleWSClientConnect(AsyncWebSocketClient* client);
-void handleWSMessage(AsyncWebSocketClient* client, const String& msg);
+void handleWSMessage(AsyncWebSocketClient* client, const char* data, size_t length);
+void setupCommands();
+void handleHelloCommand(AsyncWebSocketClient* client, JsonObject payload);
+struct SetModeCommand;
+void handleSetModeCommand(AsyncWebSocketClient* client, const SetModeCommand& command);
+void handleSaveSettingsCommand(AsyncWebSocketClient* client, JsonObject payload);
+void handleCaptureNowCommand(AsyncWebSocketClient* client, JsonObject payload);
+struct ImageListQuery;
+void handleGetImageListCommand(AsyncWebSocketClient* client, const ImageListQuery& query);
+struct HistoryQuery;
+void handleGetHistoryCommand(AsyncWebSocketClient* client, const HistoryQuery& query);
+void handleDeleteAllImagesCommand(AsyncWebSocketClient* client, JsonObject payload);
+void handleGetStatsCommand(AsyncWebSocketClient* client, JsonObject payload);
+void submitJob(AsyncWebSocketClient* client, const char* name, JobQueue::Work work);
+void sendJobEvent(const JobQueue::Job& job);
+bool runCaptureJob();
+bool sendImageList(uint32_t clientId, uint32_t after, uint16_t limit);
+bool rebuildImageIndex(const JobQueue::Progress& progress);
+bool migrateImages(const JobQueue::Progress& progress);
+bool deleteAllImages(const JobQueue::Progress& progress);
+void scheduleImageRetention();
+bool runImageRetention(const JobQueue::Progress& progress);
 /**
  * Hält das Programm an.
  *
@@ -186,6 +518,10 @@ Wir müssen in der setup() zwei Dinge tun:
 Datenleitung (SDA) loslassen.
 2) SPI-Bus beruhigen: Zwischen der Initialisierung der SD-Karte und der Kamera fügen wir eine Zwangspause ein und
 stellen sicher, dass der Chip-Select (CS) der SD-Karte deaktiviert ist.
+
+Nachtrag: Den SPI-Bus verwaltet jetzt der SpiBusArbiter. Er setzt beim Start alle CS-Pins auf HIGH, und jedes Gerät
+bekommt bei jedem Zugriff wieder seinen eigenen Takt und Modus, sodass die Kamera nie mit den Einstellungen der
+SD-Karte angesprochen wird.
 */
 
 /**
@@ -219,11 +555,10 @@ void setup() {
     // Für den ESP32 ist es eine gute Praxis, die SDA- und SCL-Pins explizit anzugeben.
     Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL);
 
-    // Alle CS-Pins auf HIGH setzen und SPI-Bus initialisieren
-    pinMode(PIN_SPI_SD_CS, OUTPUT);
-    digitalWrite(PIN_SPI_SD_CS, HIGH);
-    pinMode(PIN_SPI_CAMERA_CS, OUTPUT);
-    digitalWrite(PIN_SPI_CAMERA_CS, HIGH);
+    // SPI-Geräte anmelden und SPI-Bus initialisieren (der Arbiter setzt alle CS-Pins auf HIGH)
+    spiSdDevice = spiBus.addDevice("sd", PIN_SPI_SD_CS, SPI_CLOCK_SD, SPI_MODE0, false); // SD-Bibliothek startet die Transaktionen selbst
+    spiCameraDevice = spiBus.addDevice("camera", PIN_SPI_CAMERA_CS, SPI_CLOCK_CAMERA);
+    spiBus.begin();
     SPI.begin();
 
     // Display (Z1) initialisieren
@@ -238,12 +573,14 @@ void setup() {
     if (!LittleFS.begin(true)) {
         halt("LittleFS FEHLER", "Dateisystem korrupt");
     }
+    countBoot();
     //printFileSystemInfo();
 
     // Einstellungen laden
     if (!settingsManager.begin()) {
         halt("Settings FEHLER", "Einstellungen korrupt");
     }
+    settingsSnapshot.write(settingsManager.get());
     log("Einstellungen geladen");
 
     // --- Netzwerkdienste starten ---
@@ -305,6 +642,7 @@ void setup() {
     if (!soilTempSensor.begin()) {
         halt("Bodentemp. FEHLER");
     }
+    // Die Messung läuft nicht-blockierend, den Callback für den Messwert setzt setupSensorScheduler().
     log("Bodentemperatur OK");
 
     // S3
@@ -328,16 +666,30 @@ void setup() {
     // Sonstige Peripheriegeräte
 
     // Z2
-    if (!sdCard.begin()) {
+    if (!sdCard.begin(&spiBus, spiSdDevice)) {
         halt("SD-Karte FEHLER");
     }
     log("SD-Karte OK");
 
+    // Messwert-Verlauf
+    setupHistory();
+
     // Z3 (I2C-Gerät)
-    if (!camera.begin()) {
+    if (!camera.begin(&spiBus, spiCameraDevice)) {
         halt("Kamera FEHLER");
     }
     log("Kamera OK");
+    stillResolution = camera.getResolution();
+
+    // Bildpuffer im RAM (ohne Puffer schreibt capture() wie bisher direkt auf die SD-Karte)
+    if (frameRing.begin(FRAME_RING_SLOTS, FRAME_RING_SLOT_SIZE) > 0) {
+        log("Bildpuffer OK");
+    } else {
+        log("Bildpuffer FEHLER");
+    }
+    if (streamRing.begin(STREAM_RING_SLOTS, STREAM_RING_SLOT_SIZE) == 0) {
+        log("Streampuffer FEHLER"); // ohne eigene Slots nimmt der Live-Stream keine Bilder auf
+    }
 
     // todo friert den Bootvorgang scheinbar ein!
     //applyCameraSettings();
@@ -354,7 +706,7 @@ void setup() {
 
     // --- Webinterface initialisieren ---
 
-    if (!webInterface.begin(&SD)) {
+    if (!webInterface.begin(&SD, &spiBus, spiSdDevice, &frameRing, &streamRing)) {
         halt("WebServer FEHLER", "WebServer nicht ok");
     }
 
@@ -362,8 +714,30 @@ void setup() {
     webInterface.onClientConnect = handleWSClientConnect;
 
     // Callback für eingehende Nachrichten
+    inboxArena.begin(WS_INBOX_ARENA_SIZE); // ohne Arena wird wie bisher der Heap benutzt
+    setupCommands();
     webInterface.onMessage = handleWSMessage;
 
+    // Der erste Client am Live-Stream weckt den Kamera-Task, der dann laufend Bilder aufnimmt
+    webInterface.onStreamStart = [] {
+        if (cameraTaskHandle) {
+            xTaskNotify(cameraTaskHandle, CAMERA_NOTIFY_STREAM, eSetBits);
+        }
+    };
+
+    // Laufzeiten für Prometheus (GET /metrics)
+    webInterface.onMetrics = startMetrics;
+
+    // Reicht der Speicher für WLAN und Webserver? (siehe Speicherbudget in config.h) Die Stacks der Tasks sind noch
+    // nicht reserviert; geprüft wird hier, solange das Display noch nicht dem Sensor-Task gehört.
+    const size_t freeHeap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    const size_t taskStacks = CONTROL_TASK_STACK + SENSOR_TASK_STACK + CAMERA_TASK_STACK + NETWORK_TASK_STACK + JOB_TASK_STACK;
+    Serial.printf("Freier Speicher: %u Byte, davon %u Byte für die Task-Stacks\n", static_cast<unsigned>(freeHeap),
+                  static_cast<unsigned>(taskStacks));
+    if (freeHeap < taskStacks + MIN_FREE_HEAP) {
+        log("WARNUNG: wenig RAM");
+    }
+
     // --- Initialisierung erfolgreich ---
 
     Serial.println("System gestartet.");
@@ -372,52 +746,249 @@ void setup() {
     display.showFullscreenXBM(128, 64, frank_128x64_xbm);
     delay(1000);
 
-    // Initiales Auslesen aller Sensoren
-    readSensors();
+    // Sensoren beim Scheduler anmelden (alle sind sofort fällig)
+    setupSensorScheduler();
+
+    // Ab hier übernehmen die Tasks
+    startTasks();
+
+    // Bilderverzeichnis laden (ein fehlendes wird im Hintergrund neu aufgebaut, daher erst nach startTasks())
+    setupImageIndex();
 }
 
 /**
- * @brief Hauptschleife, wird kontinuierlich ausgeführt.
+ * @brief Hauptschleife des Arduino-Frameworks.
+ * Wird nicht mehr gebraucht, die Arbeit erledigen die Tasks (siehe startTasks()).
  */
 void loop() {
-    ota.handle();
-    webInterface.cleanupClients();
-    const unsigned long currentTime = millis();
+    vTaskDelete(nullptr); // loopTask beenden
+}
+
+// --- Tasks ---
+
+/**
+ * @brief Startet die FreeRTOS-Tasks für Steuerung, Sensoren, Kamera, Netzwerk und Hintergrundaufträge.
+ */
+void startTasks() {
+    xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK, nullptr, CONTROL_TASK_PRIORITY, &controlTaskHandle, CONTROL_TASK_CORE);
+    xTaskCreatePinnedToCore(sensorTask, "sensor", SENSOR_TASK_STACK, nullptr, SENSOR_TASK_PRIORITY, nullptr, SENSOR_TASK_CORE);
+    xTaskCreatePinnedToCore(cameraTask, "camera", CAMERA_TASK_STACK, nullptr, CAMERA_TASK_PRIORITY, &cameraTaskHandle, CAMERA_TASK_CORE);
+    xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK, nullptr, NETWORK_TASK_PRIORITY, &networkTaskHandle, NETWORK_TASK_CORE);
+    jobQueue.onEvent = sendJobEvent;
+    jobQueue.begin("jobs", JOB_TASK_STACK, JOB_TASK_PRIORITY, JOB_TASK_CORE);
+}
+
+/**
+ * @brief Steuerungs-Task: übernimmt neue Messwerte und schaltet die Aktoren.
+ *
+ * Wacht spätestens alle CONTROL_INTERVAL ms auf, bei neuen Messwerten oder Befehlen aus dem Webinterface sofort.
+ * Da der Task die höchste Priorität hat, hängt seine Reaktionszeit nicht von Kamera oder Netzwerk ab.
+ */
+void controlTask(void* parameter) {
+    SensorSnapshot sensors; // Arbeitskopie, gehört nur diesem Task
+    uint8_t lastActuators = 0; // Aktor-Zustände nach dem letzten Zyklus (siehe ActuatorField)
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONTROL_INTERVAL));
+        PROFILE_SCOPE(profiler, PROFILE_CONTROL_CYCLE);
+        const int64_t cycleStart = esp_timer_get_time();
+
+        // Neue Messwerte übernehmen
+        int64_t oldestReading = 0;
+        SensorReading reading{};
+        while (sensorQueue.pop(reading)) {
+            // NAN (Deadline verpasst) löscht das Bit, damit kein alter Wert die Relais weiter schaltet
+            sensors.apply(static_cast<SensorField>(1 << reading.channel), reading.value);
+            if (oldestReading == 0 || reading.timestamp < oldestReading) {
+                oldestReading = reading.timestamp;
+            }
+        }
 
-    // Nicht-blockierende Handler aufrufen
+        // Neuen Stand für die anderen Tasks veröffentlichen
+        if (oldestReading != 0) {
+            sensors.sequence++;
+            sensors.updatedAt = esp_timer_get_time();
+            sensorSnapshot.write(sensors);
+        }
+
+        // Steuerungslogik in jedem Zyklus ausführen, um schnell reagieren zu können. Die Einstellungen werden einmal je
+        // Zyklus kopiert, damit ein gleichzeitiges "saveSettings" nie halb übernommen wird.
+        const Settings settings = settingsSnapshot.read();
+        controlActors(sensors, settings);
+        publishActuatorCounters();
+
+        // Geschaltete Aktoren sofort an das Webinterface melden, nicht erst mit dem nächsten Broadcast
+        const uint8_t actuators = getActuatorBits();
+        if (actuators != lastActuators) {
+            lastActuators = actuators;
+            if (networkTaskHandle) {
+                xTaskNotifyGive(networkTaskHandle);
+            }
+        }
 
-    if (currentTime - lastSensorRead >= SENSOR_READ_INTERVAL) {
-        lastSensorRead = currentTime;
-        readSensors();
+        // Kamera-Zeitplan prüfen (die Aufnahme selbst läuft im Kamera-Task)
+        controlCamera(settings);
+        const uint32_t currentTime = Hal::get().millis();
+        if (currentTime - lastCameraCapture >= CAMERA_CAPTURE_INTERVAL) {
+            lastCameraCapture = currentTime;
+            requestCapture();
+        }
+
+        // Reaktionszeit messen: von der ältesten neuen Messung bis zum Schalten der Relais
+        const int64_t cycleEnd = esp_timer_get_time();
+        if (oldestReading != 0) {
+            const auto latency = static_cast<uint32_t>(cycleEnd - oldestReading);
+            controlLatencyLastUs = latency;
+            if (latency > controlLatencyMaxUs) {
+                controlLatencyMaxUs = latency;
+            }
+        }
+        const auto cycle = static_cast<uint32_t>(cycleEnd - cycleStart);
+        if (cycle > controlCycleMaxUs) {
+            controlCycleMaxUs = cycle;
+        }
     }
+}
+
+/**
+ * @brief Sensor-Task: liest die Sensoren und aktualisiert das Display.
+ *
+ * Sensoren (BH1750) und Display hängen am selben I2C-Bus, daher laufen beide in diesem Task.
+ */
+void sensorTask(void* parameter) {
+    while (true) {
+        {
+            PROFILE_SCOPE(profiler, PROFILE_SENSOR_PASS);
+
+            // Sensoren lesen (höchstens SENSOR_LOOP_BUDGET_US pro Durchlauf)
+            {
+                PROFILE_SCOPE(profiler, PROFILE_READ_SENSORS);
+                const bool reading = sensorScheduler.isDue();
+                if (reading) {
+                    debugLed.on(); // LED an während des Lesens
+                }
+                sensorScheduler.run();
+                if (reading) {
+                    debugLed.off(); // LED aus nach dem Lesen
+                }
+            }
+
+            const uint32_t currentTime = Hal::get().millis();
+            if (currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
+                lastDisplayUpdate = currentTime;
+                updateDisplay();
+            }
+            display.update();
+            debugLed.update();
+        }
 
-    if (currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
-        lastDisplayUpdate = currentTime;
-        updateDisplay();
+        vTaskDelay(pdMS_TO_TICKS(5));
     }
+}
 
-    if (currentTime - lastCameraCapture >= CAMERA_CAPTURE_INTERVAL) {
-        lastCameraCapture = currentTime;
-        capture();
+/**
+ * @brief Kamera-Task: nimmt auf Anforderung (requestCapture()) ein Bild auf und schreibt es danach auf die SD-Karte.
+ * Solange Clients am Live-Stream hängen, nimmt er zusätzlich laufend Bilder in den RAM auf.
+ */
+void cameraTask(void* parameter) {
+    uint32_t lastStreamFrame = 0;
+    while (true) {
+        // Schlafen, bis eine Aufnahme angefordert wird oder das nächste Bild für den Live-Stream fällig ist.
+        // Mehrere Anforderungen während einer Aufnahme ergeben nur eine weitere.
+        // Ist noch eine Aufnahme offen, höchstens bis zum nächsten Versuch warten, sie auf die SD-Karte zu schreiben.
+        TickType_t wait = portMAX_DELAY;
+        const uint32_t now = Hal::get().millis();
+        if (pendingImage.frame) {
+            const auto untilRetry = static_cast<int32_t>(pendingImage.retryAt - now);
+            wait = untilRetry > 0 ? pdMS_TO_TICKS(untilRetry) : 0;
+        }
+        if (webInterface.getStreamClientCount() > 0) {
+            const uint32_t elapsed = now - lastStreamFrame;
+            wait = min(wait, elapsed < STREAM_FRAME_INTERVAL ? pdMS_TO_TICKS(STREAM_FRAME_INTERVAL - elapsed) : 0);
+        }
+        uint32_t reasons = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &reasons, wait);
+
+        persistPendingImage(); // vor der nächsten Aufnahme, damit pendingImage möglichst frei wird
+        if (reasons & CAMERA_NOTIFY_CAPTURE) {
+            // Die Aufnahme bedient alle bis jetzt vergebenen Nummern. Spätere Anforderungen haben das Bit erneut
+            // gesetzt und bekommen eine eigene Aufnahme.
+            const uint32_t ticket = captureRequests.load();
+            const bool success = capture();
+            captureServed.store(ticket << 1 | (success ? 1 : 0));
+        } else if (webInterface.getStreamClientCount() > 0 && Hal::get().millis() - lastStreamFrame >= STREAM_FRAME_INTERVAL) {
+            lastStreamFrame = Hal::get().millis();
+            captureStreamFrame();
+        }
     }
+}
 
-    // Periodischer Broadcast per WebSocket
-    if (currentTime - lastBroadcastTime >= BROADCAST_INTERVAL) {
-        lastBroadcastTime = currentTime;
-        broadcastState();
+/**
+ * @brief Netzwerk-Task: OTA, WebSocket-Clients aufräumen und den Status senden.
+ */
+void networkTask(void* parameter) {
+    while (true) {
+        // Höchstens 10 ms warten, schaltet der Steuerungs-Task einen Aktor, sofort weiter
+        const bool actuatorsChanged = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10)) > 0;
+        PROFILE_SCOPE(profiler, PROFILE_NETWORK_PASS);
+
+        ota.handle();
+        webInterface.cleanupClients();
+
+        // Status per WebSocket: regelmäßig vollständig, dazwischen nur Änderungen (Aktoren sofort)
+        const uint32_t currentTime = Hal::get().millis();
+        if (currentTime - lastKeyframeTime >= STATE_KEYFRAME_INTERVAL) {
+            lastKeyframeTime = currentTime;
+            lastBroadcastTime = currentTime;
+            broadcastState(true);
+            webInterface.broadcast("stats", fillStatsJson);
+        } else if (actuatorsChanged || currentTime - lastBroadcastTime >= BROADCAST_INTERVAL) {
+            lastBroadcastTime = currentTime;
+            broadcastState(false);
+        }
+
+        // Messwert-Verlauf fortschreiben und auf die SD-Karte auslagern
+        recordHistory();
+        spillHistory();
+
+        // Alte Bilder aufräumen (die Arbeit macht der Task "jobs")
+        if (currentTime - lastRetentionTime >= RETENTION_INTERVAL) {
+            lastRetentionTime = currentTime;
+            scheduleImageRetention();
+        }
     }
+}
 
-    // Steuerungslogik in jedem Zyklus ausführen, um schnell reagieren zu können
-    controlActors();
+/**
+ * @brief Übergibt einen Messwert an den Steuerungs-Task und weckt ihn.
+ * Darf nur vom Sensor-Task aufgerufen werden (die sensorQueue hat genau einen Erzeuger).
+ * @param channel Welcher Messwert.
+ * @param value Der Messwert.
+ */
+void publishReading(const SensorChannel channel, const float value) {
+    sensorQueue.push({channel, value, esp_timer_get_time()});
+    requestControlUpdate();
+}
 
-    // Kamera-Logik
-    controlCamera();
+/**
+ * @brief Weckt den Steuerungs-Task, damit er sofort einen Zyklus ausführt.
+ */
+void requestControlUpdate() {
+    if (controlTaskHandle) {
+        xTaskNotifyGive(controlTaskHandle);
+    }
+}
 
-    // Update-Funktionen für zeitgesteuerte Komponenten aufrufen
-    debugLed.update();
-    fanRelay.update();
-    pumpRelay.update();
-    display.update();
+/**
+ * @brief Fordert eine Aufnahme beim Kamera-Task an (kehrt sofort zurück).
+ * @return Nummer der Anforderung; bedient ist sie, sobald captureServed mindestens diese Nummer meldet.
+ */
+uint32_t requestCapture() {
+    const uint32_t ticket = captureRequests.fetch_add(1) + 1;
+    if (cameraTaskHandle) {
+        xTaskNotify(cameraTaskHandle, CAMERA_NOTIFY_CAPTURE, eSetBits);
+    }
+    return ticket;
 }
 
 // --- Händler ---
@@ -428,25 +999,26 @@ void loop() {
  */
 void handleWSClientConnect(AsyncWebSocketClient* client) {
     // Sende dem neuen Client sofort den letzten bekannten Live-Status (nur an diesen Client)
-    JsonDocument stateDoc;
-    webInterface.sendTo(client, "state", getStateAsJson(stateDoc));
+    webInterface.sendTo(client, "state", fillStateJson);
 
     // Sende dem neuen Client die aktuellen Einstellungen
-    JsonDocument settingsDoc;
-    const JsonObject values = settingsDoc.to<JsonObject>();
-    settingsManager.serialize(values);
-    webInterface.sendTo(client, "settings", values);
+    webInterface.sendTo(client, "settings", [](const JsonObject values) {
+        settingsManager.serialize(values);
+    });
 }
 
 /**
  * @brief Verarbeitet eingehende Nachrichten von einem WebSocket-Client.
  * @param client Ein Pointer auf den Client, der die Nachricht gesendet hat.
- * @param msg Die empfangene Nachricht als String.
+ * @param data Die empfangene Nachricht (nicht nullterminiert).
+ * @param length Länge der Nachricht in Byte.
  */
-void handleWSMessage(AsyncWebSocketClient* client, const String& msg) {
-    // Parse die empfangene Nachricht als JSON-Dokument.
-    JsonDocument doc;
-    const DeserializationError error = deserializeJson(doc, msg);
+void handleWSMessage(AsyncWebSocketClient* client, const char* data, const size_t length) {
+    // Parse die empfangene Nachricht als JSON-Dokument. Nachrichten kommen nur aus dem AsyncTCP-Task und nacheinander,
+    // daher genügt eine Arena, die vor jeder Nachricht zurückgesetzt wird (auch große "saveSettings" ohne Heap).
+    inboxArena.reset();
+    JsonDocument doc(inboxArena.getCapacity() > 0 ? static_cast<ArduinoJson::Allocator*>(&inboxArena) : JsonArena::heap());
+    const DeserializationError error = deserializeJson(doc, data, length);
     if (error) {
         webInterface.consoleLog(client, "WebSocket JSON-Fehler: %s", error.c_str());
         return;
@@ -459,116 +1031,511 @@ void handleWSMessage(AsyncWebSocketClient* client, const String& msg) {
         return;
     }
 
-    // --- Aktor schalten ---
+    // Handler suchen und aufrufen (siehe setupCommands())
+    switch (commandRouter.dispatch(type, client, doc["payload"])) {
+        case CommandRouter<AsyncWebSocketClient*>::Result::Handled:
+            break;
+        case CommandRouter<AsyncWebSocketClient*>::Result::InvalidPayload:
+            webInterface.consoleLog(client, "WebSocket-Fehler: '%s' mit fehlerhaften Daten.", type);
+            break;
+        case CommandRouter<AsyncWebSocketClient*>::Result::Unknown:
+            webInterface.consoleLog(client, "Unbekannter WebSocket-Nachrichtentyp: %s\n", type);
+            break;
+    }
+}
 
-    if (strcmp(type, "setMode") == 0) {
-        const JsonObject payload = doc["payload"];
-        const char* modeStr = payload["mode"];
-        ControlMode mode;
-        if (strcmp(modeStr, "auto") == 0) mode = MODE_AUTO;
-        else if (strcmp(modeStr, "on") == 0) mode = MODE_ON;
-        else if (strcmp(modeStr, "off") == 0) mode = MODE_OFF;
-        else {
-            webInterface.consoleLog(client, "WebSocket-Fehler: 'mode' fehlerhaft.");
-            return;
-        }
-        Settings& settings = settingsManager.getMutable();
-        const char* targetStr = payload["target"];
-        if (strcmp(targetStr, "lamp1") == 0) { settings.lamp1Mode = mode; }
-        else if (strcmp(targetStr, "lamp2") == 0) { settings.lamp2Mode = mode; }
-        else if (strcmp(targetStr, "heater") == 0) { settings.heaterMode = mode; }
-        else if (strcmp(targetStr, "fan") == 0) { settings.fanMode = mode; }
-        else if (strcmp(targetStr, "pump") == 0) { settings.pumpMode = mode; }
-        else if (strcmp(targetStr, "mister") == 0) { settings.misterMode = mode; }
-        settingsManager.save(); // Speichere die neuen Modi persistent
-        controlActors(); // Wende den neuen Zustand sofort an (Relais schalten)
-        broadcastSettings();
-        broadcastState();
-    }
-
-    // --- Einstellungen speichern ---
-
-    else if (strcmp(type, "saveSettings") == 0) {
-        webInterface.consoleLog(client, "Befehl 'saveSettings' empfangen.");
-        const JsonObject payload = doc["payload"].as<JsonObject>();
-        if (payload) {
-            settingsManager.deserialize(payload);
-            applyCameraSettings(); // Neue Kamera-Einstellungen sofort anwenden
-            if (settingsManager.save()) {
-                broadcastSettings();
-            } else {
-                webInterface.consoleLog(client, "FEHLER: Konnte nicht speichern.");
-            }
+// --- WebSocket-Befehle ---
+
+/**
+ * Nutzdaten von "setMode": {"target": "lamp1", "mode": "auto"}
+ */
+struct SetModeCommand {
+    const Actuator* actuator; // Der Aktor (aus ACTUATORS)
+    ControlMode mode;         // Der neue Modus
+
+    bool read(const JsonObject payload) {
+        actuator = findByName(ACTUATORS, payload["target"].as<const char*>());
+        const ControlMode* value = findByName(CONTROL_MODES, payload["mode"].as<const char*>());
+        if (!actuator || !value) {
+            return false;
         }
+        mode = *value;
+        return true;
     }
+};
 
-    // --- Bild aufnehmen ---
+/**
+ * Nutzdaten von "getImageList": {"after": 1234 (Cursor aus "next", fehlt = neueste Bilder), "limit": 50}
+ */
+struct ImageListQuery {
+    uint32_t after; // Cursor (ImageIndex::NO_CURSOR = mit dem neuesten Bild beginnen)
+    uint16_t limit; // Anzahl der Bilder
+
+    bool read(const JsonObject payload) {
+        after = payload["after"] | ImageIndex::NO_CURSOR;
+        limit = payload["limit"] | IMAGE_LIST_PAGE_SIZE;
+        limit = min(limit, IMAGE_LIST_MAX_PAGE);
+        return limit > 0;
+    }
+};
 
-    else if (strcmp(type, "captureNow") == 0) {
-        webInterface.consoleLog(client, "Manuelle Aufnahme...");
-        if (!capture()) {
-            webInterface.broadcast("captureFailed");
-        }
+/**
+ * Nutzdaten von "getHistory": {"channel": "airTemp", "range": 3600 (s), "buckets": 60}
+ */
+struct HistoryQuery {
+    const char* channel; // Name des Kanals (siehe SensorHistory::getChannel())
+    uint32_t range;      // Zeitraum in s bis jetzt
+    uint16_t buckets;    // Anzahl der Abschnitte
+
+    bool read(const JsonObject payload) {
+        channel = payload["channel"] | "";
+        range = payload["range"] | 3600;
+        buckets = payload["buckets"] | 60;
+        range = min(range, HISTORY_DAY_CAPACITY * HISTORY_DAY_INTERVAL); // weiter reicht der Verlauf im RAM nicht zurück
+        buckets = min(buckets, HISTORY_MAX_BUCKETS);
+        return range > 0 && buckets > 0;
     }
+};
 
-    // --- Bildliste anfordern ---
+/**
+ * @brief Registriert die Handler für alle WebSocket-Nachrichten.
+ * Neue Befehle werden hier eingetragen, die Suche bleibt unabhängig von ihrer Anzahl gleich schnell.
+ */
+void setupCommands() {
+    commandRouter.on("hello", handleHelloCommand);
+    commandRouter.on("setMode", handleSetModeCommand);
+    commandRouter.on("saveSettings", handleSaveSettingsCommand);
+    commandRouter.on("captureNow", handleCaptureNowCommand);
+    commandRouter.on("getImageList", handleGetImageListCommand);
+    commandRouter.on("getHistory", handleGetHistoryCommand);
+    commandRouter.on("deleteAllImages", handleDeleteAllImagesCommand);
+    commandRouter.on("getStats", handleGetStatsCommand);
+}
 
-    else if (strcmp(type, "getImageList") == 0) {
-        webInterface.consoleLog(client, "Befehl: Bildliste anfordern");
+/**
+ * @brief Wählt das Format der Statusnachricht ("hello").
+ * payload: {"stateFormat": "binary"} oder {"stateFormat": "json"}
+ */
+void handleHelloCommand(AsyncWebSocketClient* client, const JsonObject payload) {
+    const char* format = payload["stateFormat"] | "json";
+    const bool binary = strcmp(format, "binary") == 0;
+    if (!webInterface.setBinaryState(client, binary)) {
+        webInterface.consoleLog(client, "Zu viele Clients im Binärformat, Status weiter als JSON.");
+    }
+}
 
-        if (!sdCard.isReady()) {
-            webInterface.consoleLog(client, "Fehler: SD-Karte nicht bereit für Bildliste.");
-            // Optional: Eine Fehlermeldung an den Client senden
-            return;
+/**
+ * @brief Schaltet einen Aktor ("setMode").
+ */
+void handleSetModeCommand(AsyncWebSocketClient*, const SetModeCommand& command) {
+    Settings& settings = settingsManager.getMutable();
+    settings.*(command.actuator->mode) = command.mode;
+    settingsSnapshot.write(settings);
+    settingsManager.save(); // Speichere die neuen Modi persistent
+    requestControlUpdate(); // Wende den neuen Zustand sofort an (der Steuerungs-Task schaltet die Relais)
+    broadcastSettings();
+}
+
+/**
+ * @brief Speichert die Einstellungen ("saveSettings").
+ */
+void handleSaveSettingsCommand(AsyncWebSocketClient* client, const JsonObject payload) {
+    webInterface.consoleLog(client, "Befehl 'saveSettings' empfangen.");
+    if (payload) {
+        settingsManager.deserialize(payload);
+        settingsSnapshot.write(settingsManager.get());
+        applyCameraSettings(); // Neue Kamera-Einstellungen sofort anwenden
+        if (settingsManager.save()) {
+            broadcastSettings();
+            scheduleImageRetention(); // geänderte Regeln zum Aufräumen gleich anwenden
+        } else {
+            webInterface.consoleLog(client, "FEHLER: Konnte nicht speichern.");
         }
+    }
+}
+
+/**
+ * @brief Nimmt sofort ein Bild auf ("captureNow").
+ * Das Bild meldet capture() per "newImage" bzw. "captureFailed", den Auftrag selbst sendJobEvent().
+ */
+void handleCaptureNowCommand(AsyncWebSocketClient* client, JsonObject) {
+    submitJob(client, "captureNow", [](const JobQueue::Progress&) {
+        return runCaptureJob();
+    });
+}
 
-        JsonDocument doc2;
-        JsonArray images = doc2.to<JsonArray>();
+/**
+ * @brief Sendet eine Seite der Bilderliste ("getImageList").
+ * Läuft als Hintergrundauftrag, da eine Seite, die nicht im Cache des Index liegt, von der SD-Karte gelesen wird.
+ */
+void handleGetImageListCommand(AsyncWebSocketClient* client, const ImageListQuery& query) {
+    const uint32_t clientId = client->id();
+    submitJob(client, "getImageList", [clientId, query](const JobQueue::Progress&) {
+        return sendImageList(clientId, query.after, query.limit);
+    });
+}
 
-        sdCard.listDir("/", [&images](const String& filename, const size_t size) {
-            if (filename.endsWith(".jpg")) {
-                const JsonObject img = images.add<JsonObject>();
-                img["path"] = "/" + filename;
-                img["size"] = size;
+/**
+ * @brief Sendet einen Ausschnitt aus dem Messwert-Verlauf ("getHistory").
+ * Die Antwort kommt in Teilen zu höchstens HISTORY_CHUNK_BUCKETS Abschnitten, damit jeder Teil in eine JSON-Arena
+ * von WebUI passt (240 Abschnitte mit je drei Werten täten das nicht). Der Client setzt sie über "offset" und "total"
+ * wieder zusammen.
+ */
+void handleGetHistoryCommand(AsyncWebSocketClient* client, const HistoryQuery& query) {
+    // Der feine Verlauf, wenn er den Zeitraum abdeckt, sonst der grobe
+    const uint32_t to = time(nullptr) + 1;
+    const uint32_t from = to - query.range;
+    SensorHistory& source = history.getOldestTime() > 0 && history.getOldestTime() <= from ? history : dayHistory;
+    const int channel = source.getChannel(query.channel);
+    if (channel < 0) {
+        webInterface.consoleLog(client, "Unbekannter Kanal: %s", query.channel);
+        return;
+    }
+
+    auto* result = new SensorHistory::Bucket[query.buckets];
+    source.query(channel, from, to, query.buckets, result);
+
+    // Antwort: je Abschnitt Minimum, Maximum und Mittelwert (null = keine Werte)
+    for (uint16_t offset = 0; offset < query.buckets; offset += HISTORY_CHUNK_BUCKETS) {
+        const uint16_t end = query.buckets - offset > HISTORY_CHUNK_BUCKETS ? offset + HISTORY_CHUNK_BUCKETS : query.buckets;
+        webInterface.sendTo(client, "history", [&](const JsonObject data) {
+            data["channel"] = query.channel;
+            data["from"] = from; // Unix-Zeit in s
+            data["step"] = static_cast<float>(query.range) / query.buckets; // Länge eines Abschnitts in s
+            data["interval"] = source.getInterval(); // Auflösung der Quelle in s
+            data["offset"] = offset; // erster Abschnitt in diesem Teil
+            data["total"] = query.buckets; // Abschnitte in allen Teilen zusammen
+            const JsonArray minValues = data["min"].to<JsonArray>();
+            const JsonArray maxValues = data["max"].to<JsonArray>();
+            const JsonArray avgValues = data["avg"].to<JsonArray>();
+            for (uint16_t i = offset; i < end; i++) {
+                if (result[i].count > 0) {
+                    minValues.add(result[i].min);
+                    maxValues.add(result[i].max);
+                    avgValues.add(result[i].avg);
+                } else {
+                    minValues.add(nullptr);
+                    maxValues.add(nullptr);
+                    avgValues.add(nullptr);
+                }
             }
         });
+    }
+    delete[] result;
+}
 
-        // Sende die Liste als 'imageList'-Nachricht an den anfragenden Client
-        JsonDocument responseDoc;
-        responseDoc["type"] = "imageList";
-        responseDoc["payload"]["images"] = images;
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
+/**
+ * @brief Löscht alle Bilder auf der SD-Karte ("deleteAllImages").
+ * payload: {"password": "..."}
+ */
+void handleDeleteAllImagesCommand(AsyncWebSocketClient* client, const JsonObject payload) {
+    const char* password = payload["password"];
+    if (!password || strcmp(password, OTA_PASSWORD) != 0) {
+        webInterface.consoleLog(client, "Falsches Passwort!");
+        return;
     }
+    const uint32_t running = jobQueue.findPending("deleteAllImages");
+    if (running) {
+        webInterface.consoleLog(client, "Bilder werden bereits gelöscht (Auftrag %u).", running);
+        return;
+    }
+    submitJob(client, "deleteAllImages", deleteAllImages);
+}
 
-    // --- Alle Bilder löschen ---
+/**
+ * @brief Sendet die Laufzeiten der heißen Pfade ("getStats", Antwort "stats").
+ * payload: {"reset": true} beginnt danach eine neue Messung (optional)
+ */
+void handleGetStatsCommand(AsyncWebSocketClient* client, const JsonObject payload) {
+    webInterface.sendTo(client, "stats", fillStatsJson);
+    if (payload["reset"] | false) {
+        profiler.reset();
+    }
+}
 
-    else if (strcmp(type, "deleteAllImages") == 0) {
-        webInterface.consoleLog(client, "Befehl: Bilder löschen");
-        // Payload extrahieren
-        const JsonObject payload = doc["payload"];
-        const char* password = payload["password"];
+// --- Hintergrundaufträge ---
 
-        if (password && strcmp(password, OTA_PASSWORD) == 0) {
-            if (sdCard.deleteAllFilesInDir("/")) {
-                webInterface.consoleLog(client, "SD-Karte bereinigt.");
-                webInterface.broadcast("imageListCleared");
-            } else {
-                webInterface.consoleLog(client, "Fehler beim Löschen.");
+/**
+ * @brief Reiht einen Befehl als Hintergrundauftrag ein (kehrt sofort zurück).
+ * Der Client erhält die Auftragsnummer und alle weiteren Zustände per "job"-Nachricht (siehe sendJobEvent()).
+ * @param client Der Client, der den Befehl gesendet hat.
+ * @param name Name des Auftrags (der Nachrichtentyp).
+ * @param work Die Arbeit, läuft im Task "jobs".
+ */
+void submitJob(AsyncWebSocketClient* client, const char* name, JobQueue::Work work) {
+    if (jobQueue.submit(name, client->id(), std::move(work)) == 0) {
+        webInterface.consoleLog(client, "Zu viele Aufträge, '%s' bitte später erneut senden.", name);
+    }
+}
+
+/**
+ * @brief Meldet den Zustand eines Auftrags an den Client, der ihn erteilt hat.
+ * payload: {"id": 7, "name": "deleteAllImages", "state": "running", "done": 120, "total": 480}
+ */
+void sendJobEvent(const JobQueue::Job& job) {
+    static const char* const STATES[] = {"queued", "running", "done", "failed"};
+    webInterface.sendTo(job.owner, "job", [&job](const JsonObject payload) {
+        payload["id"] = job.id;
+        payload["name"] = job.name;
+        payload["state"] = STATES[static_cast<uint8_t>(job.state)];
+        if (job.done > 0 || job.total > 0) {
+            payload["done"] = job.done;
+            payload["total"] = job.total; // 0 = unbekannt
+        }
+        if (job.finishedAt) {
+            payload["durationMs"] = job.finishedAt - job.startedAt;
+        }
+    });
+}
+
+/**
+ * @brief Fordert eine Aufnahme beim Kamera-Task an und wartet, bis sie abgeschlossen ist.
+ * Läuft im Task "jobs". Die Aufnahme selbst macht weiterhin der Kamera-Task (capture()).
+ * @return true, wenn die Aufnahme gelungen ist.
+ */
+bool runCaptureJob() {
+    const uint32_t ticket = requestCapture();
+
+    // Auf die Aufnahme zu dieser Anforderung warten, nicht auf eine bereits laufende (z.B. nach Zeitplan)
+    const unsigned long start = millis();
+    uint32_t served = captureServed;
+    while ((served >> 1) < ticket) {
+        if (millis() - start >= CAPTURE_JOB_TIMEOUT) {
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(20));
+        served = captureServed;
+    }
+    return (served & 1) != 0;
+}
+
+/**
+ * @brief Sendet eine Seite der Bilderliste ("imageList") an einen Client, die neuesten Bilder zuerst.
+ * Läuft im Task "jobs". Die Bilder kommen aus dem imageIndex, der Aufwand hängt nur von der Seitengröße ab.
+ * payload: {"images": [{"path": "/img/2025/12/05/103000.jpg", "size": 48213, "time": 1764930600}], "after": null,
+ *           "next": 1234 (Cursor für die nächste Seite, null = keine älteren Bilder), "total": 480}
+ * @param clientId ID des Clients.
+ * @param after Cursor aus der vorherigen Seite (ImageIndex::NO_CURSOR = erste Seite).
+ * @param limit Maximale Anzahl der Bilder.
+ * @return true bei Erfolg.
+ */
+bool sendImageList(const uint32_t clientId, const uint32_t after, const uint16_t limit) {
+    if (!sdCard.isReady()) {
+        return false;
+    }
+
+    auto* entries = new ImageIndex::Entry[limit];
+    uint32_t next = ImageIndex::NO_CURSOR;
+    const uint16_t count = imageIndex.getPage(after, limit, entries, next);
+
+    webInterface.sendTo(clientId, "imageList", [&](const JsonObject payload) {
+        const JsonArray images = payload["images"].to<JsonArray>();
+        for (uint16_t i = 0; i < count; i++) {
+            const JsonObject img = images.add<JsonObject>();
+            img["path"] = entries[i].path;
+            img["size"] = entries[i].size;
+            if (entries[i].time > 0) {
+                img["time"] = entries[i].time;
             }
+        }
+        if (after == ImageIndex::NO_CURSOR) {
+            payload["after"] = nullptr; // erste Seite: der Client ersetzt seine Liste
+        } else {
+            payload["after"] = after;
+        }
+        if (next == ImageIndex::NO_CURSOR) {
+            payload["next"] = nullptr;
         } else {
-            webInterface.consoleLog(client, "Falsches Passwort!");
+            payload["next"] = next;
+        }
+        payload["total"] = imageIndex.getCount();
+    });
+    delete[] entries;
+    return true;
+}
+
+/**
+ * @brief Baut das Bilderverzeichnis aus dem Inhalt der SD-Karte neu auf.
+ * Läuft im Task "jobs" (z.B. beim ersten Start oder wenn die Indexdatei beschädigt ist), in Zeitscheiben zu
+ * INDEX_REBUILD_SLICE_MS; dazwischen ist der SPI-Bus INDEX_REBUILD_PAUSE_MS lang frei, Kamera und Webinterface kommen
+ * also auch während einer langen Suche an die SD-Karte.
+ * @param progress Meldet die Anzahl der bisher eingetragenen Bilder.
+ * @return true bei Erfolg.
+ */
+bool rebuildImageIndex(const JobQueue::Progress& progress) {
+    // Rekursiv: Bilder im alten Layout (Wurzelverzeichnis) und in /img/YYYY/MM/DD
+    bool success = imageIndex.startRebuild("/", ".jpg");
+    if (success) {
+        while (!imageIndex.rebuildStep(INDEX_REBUILD_SLICE_MS, JOB_SD_LOCK_TIMEOUT)) {
+            progress(imageIndex.getCount(), 0);
+            vTaskDelay(pdMS_TO_TICKS(INDEX_REBUILD_PAUSE_MS));
+        }
+        success = imageIndex.isRebuildOk();
+    }
+    webInterface.broadcast("imageListChanged"); // die Clients laden die Liste neu
+    return success;
+}
+
+/**
+ * @brief Verschiebt die Bilder aus dem alten Layout in das Bilderverzeichnis ("/img/YYYY/MM/DD/HHMMSS.jpg").
+ * Läuft im Task "jobs", in Blöcken zu MIGRATE_BATCH_SIZE Bildern mit je einem Bus-Zugriff. Die Einträge im imageIndex
+ * behalten dabei ihre Position, nur der Pfad ändert sich.
+ * @param progress Meldet die Anzahl der bisher verschobenen Bilder.
+ * @return true, wenn das Wurzelverzeichnis gelesen werden konnte.
+ */
+bool migrateImages(const JobQueue::Progress& progress) {
+    uint32_t moved = 0;
+    while (true) {
+        int count;
+        {
+            const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice, JOB_SD_LOCK_TIMEOUT);
+            if (!lock) {
+                return false;
+            }
+            count = sdCard.migrateLegacyImages(MIGRATE_BATCH_SIZE, [](const char* from, const char* to) {
+                imageIndex.rename(from, to);
+            });
+        }
+        if (count < 0) {
+            return false;
+        }
+        if (count == 0) {
+            break; // keine Bilder mehr im alten Layout (oder nur solche, die sich nicht verschieben lassen)
         }
+        moved += count;
+        progress(moved, 0);
+        taskYIELD(); // Kamera-Task an den Bus lassen
     }
 
-    else {
-        webInterface.consoleLog(client, "Unbekannter WebSocket-Nachrichtentyp: %s\n", type);
+    if (moved > 0) {
+        Serial.printf("%u Bilder nach %s verschoben.\n", moved, MicroSDCard::IMAGE_DIR);
+        webInterface.broadcast("imageListChanged"); // die Pfade haben sich geändert
     }
+    return true;
+}
+
+/**
+ * @brief Löscht alle Bilder: das Bilderverzeichnis und alle Dateien im Wurzelverzeichnis (altes Layout).
+ * Läuft im Task "jobs". Zwischen den Blöcken zu DELETE_BATCH_SIZE Dateien wird der SPI-Bus freigegeben, sodass
+ * Aufnahmen nicht warten müssen, bis die ganze Karte leer ist.
+ * @param progress Meldet gelöschte und (laut imageIndex) vorhandene Bilder.
+ * @return true, wenn alle Bilder gelöscht wurden.
+ */
+bool deleteAllImages(const JobQueue::Progress& progress) {
+    const uint32_t total = imageIndex.getCount();
+    uint32_t deleted = 0;
+    for (const bool tree : {true, false}) {
+        while (true) {
+            int count;
+            {
+                const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice, JOB_SD_LOCK_TIMEOUT);
+                if (!lock) {
+                    return false;
+                }
+                count = tree ? sdCard.deleteFilesInTree(MicroSDCard::IMAGE_DIR, DELETE_BATCH_SIZE)
+                             : sdCard.deleteFilesInDir("/", DELETE_BATCH_SIZE);
+            }
+            if (count <= 0) {
+                break; // leer (oder nur noch Dateien, die sich nicht löschen lassen), -1: Verzeichnis fehlt
+            }
+            deleted += count;
+            progress(deleted, max(total, deleted));
+            taskYIELD(); // Kamera-Task an den Bus lassen
+        }
+    }
+
+    // Übrig gebliebene Bilder (ließen sich nicht löschen) wieder eintragen; bei leerer Karte geht das schnell
+    imageIndex.rebuild("/", ".jpg");
+    webInterface.broadcast(imageIndex.getCount() == 0 ? "imageListCleared" : "imageListChanged");
+    return imageIndex.getCount() == 0;
+}
+
+/**
+ * @brief Reiht das Aufräumen der Bilder ein, sofern es nicht schon eingereiht ist oder läuft.
+ */
+void scheduleImageRetention() {
+    if (sdCard.isReady() && jobQueue.findPending("imageRetention") == 0) {
+        jobQueue.submit("imageRetention", 0, runImageRetention); // kein Client, das Ergebnis geht an alle
+    }
+}
+
+/**
+ * @brief Löscht alte Bilder nach den Einstellungen (Höchstalter, Ausdünnen, Speichergrenze, freier Speicher).
+ * Läuft im Task "jobs" in Zeitscheiben zu RETENTION_SLICE_MS, dazwischen ist der SPI-Bus RETENTION_PAUSE_MS lang frei.
+ * Hat der Durchlauf Bilder gelöscht, erhalten alle Clients das Ergebnis:
+ * payload: {"deleted": 12, "failed": 0, "reclaimedBytes": 578304, "missingBytes": 0, "durationMs": 840}
+ * @param progress Meldet die Anzahl der bisher gelöschten Bilder.
+ * @return true, wenn der Durchlauf abgeschlossen wurde und sich alle Bilder löschen ließen.
+ */
+bool runImageRetention(const JobQueue::Progress& progress) {
+    const Settings settings = settingsSnapshot.read();
+    ImageRetention::Policy policy;
+    policy.maxAgeDays = constrain(settings.imageMaxAgeDays, 0, UINT16_MAX);
+    policy.thinAfterDays = constrain(settings.imageThinAfterDays, 0, UINT16_MAX);
+    policy.maxImageMB = max(settings.imageMaxMB, 0);
+    policy.minFreePercent = constrain(settings.sdMinFreePercent, 0, 100);
+
+    // Belegung der Karte für die Wasserlinie und /metrics abfragen (FAT zählt dafür die freien Cluster, das dauert etwas)
+    uint64_t usedBytes = 0;
+    uint64_t totalBytes = 0;
+    {
+        const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice, JOB_SD_LOCK_TIMEOUT);
+        if (!lock) {
+            return false;
+        }
+        const uint64_t usedMB = MicroSDCard::getUsedSpaceMB();
+        const uint64_t totalMB = MicroSDCard::getTotalSpaceMB();
+        sdUsedMB = static_cast<uint32_t>(usedMB);
+        sdTotalMB = static_cast<uint32_t>(totalMB);
+        if (policy.minFreePercent > 0) {
+            usedBytes = usedMB * 1024 * 1024;
+            totalBytes = totalMB * 1024 * 1024;
+        }
+    }
+
+    tm timeInfo{};
+    const uint32_t now = Hal::get().getLocalTime(timeInfo) ? static_cast<uint32_t>(Hal::get().time()) : 0; // ohne Uhrzeit nur Speicherplatz
+    imageRetention.start(policy, now, usedBytes, totalBytes);
+
+    const ImageRetention::Run& run = imageRetention.getRun();
+    uint32_t checked = 0;
+    while (!imageRetention.step(RETENTION_SLICE_MS, JOB_SD_LOCK_TIMEOUT)) {
+        if (run.checked == checked) {
+            return false; // SPI-Bus war zu lange belegt, der nächste Durchlauf beginnt von vorne
+        }
+        checked = run.checked;
+        progress(run.deleted, 0);
+        vTaskDelay(pdMS_TO_TICKS(RETENTION_PAUSE_MS)); // Kamera und Webinterface an den Bus lassen
+    }
+
+    if (run.deleted > 0 || run.failed > 0) {
+        Serial.printf("Aufräumen: %u Bilder gelöscht (%llu KB), %u fehlgeschlagen, %lu ms\n",
+            run.deleted, run.reclaimedBytes / 1024, run.failed, run.durationMs);
+        JsonDocument doc;
+        const JsonObject payload = doc.to<JsonObject>();
+        payload["deleted"] = run.deleted;
+        payload["failed"] = run.failed;
+        payload["reclaimedBytes"] = run.reclaimedBytes;
+        payload["missingBytes"] = run.missingBytes; // > 0: Wasserlinie bzw. Speichergrenze trotzdem nicht erreicht
+        payload["durationMs"] = run.durationMs;
+        webInterface.broadcast("imageRetention", payload); // die Clients laden die Bilderliste neu
+    }
+    return run.failed == 0;
 }
 
 // --- Hilfsfunktionen ---
 
+/**
+ * @brief Zählt den Start-Zähler im NVS hoch (siehe bootCount).
+ */
+void countBoot() {
+    Preferences preferences;
+    preferences.begin("biodom");
+    bootCount = static_cast<uint16_t>(preferences.getUShort("boots", 0) + 1);
+    preferences.putUShort("boots", bootCount);
+    preferences.end();
+}
+
 /**
  * @brief Gibt Informationen über das Dateisystem (LittleFS) auf der seriellen Konsole aus.
  * Zeigt Gesamtgröße, belegten/freien Speicher und eine Liste der Dateien.
@@ -595,42 +1562,43 @@ void printFileSystemInfo() {
 }
 
 /**
- * @brief Liest alle Sensoren aus und speichert die Werte in globalen Variablen.
+ * @brief Meldet alle Sensoren beim Scheduler an (siehe SensorWiring, dieselbe Verdrahtung wie im Prüfstand).
+ *
+ * Jeder Sensor bekommt sein eigenes Intervall. Die Messwerte gehen über die sensorQueue an den Steuerungs-Task.
+ * Sensoren mit Wandlungszeit (DS18B20) werden in zwei Schritten gelesen: Messung anstoßen und später auslesen.
  */
-bool readSensors() {
-    debugLed.on(); // LED an während des Lesens
-
-    if (airSensor.read()) {
-        currentAirTemp = airSensor.getTemperature();
-        currentHumidity = airSensor.getHumidity();
-    }
-
-    if (soilTempSensor.read()) {
-        currentSoilTemp = soilTempSensor.getTemperature();
-    }
-
-    if (soilMoistureSensor.read()) {
-        currentSoilMoisture = soilMoistureSensor.getPercent();
-    }
-
-    if (lightSensor.read()) {
-        currentLightLux = lightSensor.getLux();
-    }
-
-    if (waterLevelSensor.read()) {
-        isWaterLevelOk = waterLevelSensor.isWaterDetected();
-    }
-
-    debugLed.off(); // LED aus nach dem Lesen
-    return true;
+void setupSensorScheduler() {
+    const SensorWiring::Sensors sensors{airSensor, soilTempSensor, soilMoistureSensor, waterLevelSensor, lightSensor};
+    const SensorWiring::Intervals intervals{SENSOR_READ_INTERVAL, WATER_LEVEL_READ_INTERVAL, SENSOR_READ_DEADLINE};
+    SensorWiring::addSensors(sensorScheduler, sensors, intervals, [](const SensorField field, const float value) {
+        publishReading(static_cast<SensorChannel>(__builtin_ctz(field)), value); // Bit 1 << channel
+    });
 }
 
 /**
  * @brief Aktualisiert das OLED-Display mit den aktuellen Sensorwerten.
  */
 void updateDisplay() {
+    PROFILE_SCOPE(profiler, PROFILE_UPDATE_DISPLAY);
+    // Status der Kamera anzeigen (während der Aufnahme und CAMERA_STATUS_DURATION ms danach)
+    const CameraStatus status = cameraStatus;
+    if (status == CAMERA_BUSY) {
+        display.showFullscreenAlert("FOTO...", false);
+        return;
+    }
+    if (status != CAMERA_IDLE) {
+        if (Hal::get().millis() - cameraStatusSince < CAMERA_STATUS_DURATION) {
+            display.showFullscreenAlert(status == CAMERA_OK ? "FOTO OK" : "KAMERA FEHLER", status == CAMERA_FAILED);
+            return;
+        }
+        CameraStatus expected = status; // nur zurücksetzen, wenn nicht inzwischen eine neue Aufnahme läuft
+        cameraStatus.compare_exchange_strong(expected, CAMERA_IDLE);
+    }
+
+    const SensorSnapshot sensors = sensorSnapshot.read();
+
     // Wenn der Wasserstand niedrig ist, hat die Warnung absolute Priorität.
-    if (!isWaterLevelOk) {
+    if (!sensors.waterLevelOk) {
         display.showFullscreenAlert("WASSER\nNACHFUELLEN", true);
         return;
     }
@@ -646,8 +1614,8 @@ void updateDisplay() {
     }
 
     // Messwert anzeigen
-    if (!isnan(currentAirTemp)) {
-        display.setDashboardText(OLEDDisplaySH1106::TOP_LEFT, String(currentAirTemp, 1) + "C");
+    if (!isnan(sensors.airTemp)) {
+        display.setDashboardText(OLEDDisplaySH1106::TOP_LEFT, String(sensors.airTemp, 1) + "C");
     } else {
         display.setDashboardText(OLEDDisplaySH1106::TOP_LEFT, "FEHLER");
     }
@@ -666,8 +1634,8 @@ void updateDisplay() {
     }
 
     // Messwert anzeigen
-    if (!isnan(currentHumidity)) {
-        display.setDashboardText(OLEDDisplaySH1106::TOP_RIGHT, String(currentHumidity, 0) + "%");
+    if (!isnan(sensors.humidity)) {
+        display.setDashboardText(OLEDDisplaySH1106::TOP_RIGHT, String(sensors.humidity, 0) + "%");
     } else {
         display.setDashboardText(OLEDDisplaySH1106::TOP_RIGHT, "FEHLER");
     }
@@ -683,8 +1651,8 @@ void updateDisplay() {
     }
 
     // Messwert anzeigen
-    if (!isnan(currentSoilTemp)) {
-        display.setDashboardText(OLEDDisplaySH1106::BOTTOM_LEFT, String(currentSoilTemp, 1) + "C");
+    if (!isnan(sensors.soilTemp)) {
+        display.setDashboardText(OLEDDisplaySH1106::BOTTOM_LEFT, String(sensors.soilTemp, 1) + "C");
     } else {
         display.setDashboardText(OLEDDisplaySH1106::BOTTOM_LEFT, "FEHLER");
     }
@@ -700,8 +1668,8 @@ void updateDisplay() {
     }
 
     // Messwert anzeigen
-    if (currentSoilMoisture != -1) {
-        display.setDashboardText(OLEDDisplaySH1106::BOTTOM_RIGHT, String(currentSoilMoisture) + "%");
+    if (sensors.soilMoisture != -1) {
+        display.setDashboardText(OLEDDisplaySH1106::BOTTOM_RIGHT, String(sensors.soilMoisture) + "%");
     } else {
         display.setDashboardText(OLEDDisplaySH1106::BOTTOM_RIGHT, "FEHLER");
     }
@@ -711,202 +1679,353 @@ void updateDisplay() {
 }
 
 /**
- * @brief Implementiert die Steuerungslogik für alle Aktoren.
+ * @brief Implementiert die Steuerungslogik für alle Aktoren (siehe Controller).
  */
-void controlActors() {
-    // Verweis auf die aktuellen Einstellungen holen
-    const Settings& settings = settingsManager.get();
-
-    // Aktuelle Stunde ermitteln
+void controlActors(const SensorSnapshot& sensors, const Settings& settings) {
+    PROFILE_SCOPE(profiler, PROFILE_CONTROL_ACTORS);
+    // Aktuelle Stunde ermitteln (ohne auf NTP zu warten, der Task darf nicht blockieren)
+    int currentHour = Controller::UNKNOWN_HOUR;
     tm timeInfo{};
-    if (!getLocalTime(&timeInfo)) {
+    if (Hal::get().getLocalTime(timeInfo)) {
+        currentHour = timeInfo.tm_hour;
+    } else {
         Serial.println("Fehler beim Abrufen der Zeit."); // dürfte nie vorkommen, da im Setup die Zeit synchronisiert wurde
-        return;
     }
-    const int currentHour = timeInfo.tm_hour;
 
-    // -- Steuerung für die Lampe 1 (A1) --
+    controller.update(sensors, settings, currentHour);
+}
 
-    if (settings.lamp1Mode == MODE_AUTO) {
-        if (currentHour >= settings.light1OnHour && currentHour < settings.light1OffHour) {
-            // Tageszeit
-            if (!isnan(currentLightLux)) {
-                if (currentLightLux < settings.light1LuxThresholdDark) {
-                    // Zu dunkel -> Lampe AN
-                    lamp1Relay.on();
-                } else if (currentLightLux > settings.light1LuxThresholdBright) {
-                    // Hell genug -> Lampe AUS
-                    lamp1Relay.off();
-                }
-                // Dazwischen (im Hysterese-Bereich): Zustand beibehalten, nichts tun!
-                // Dies verhindert das Oszillieren.
-            } else {
-                // Sensorausfall: Lampe im Zweifel AN
-                lamp1Relay.on();
-            }
-        } else {
-            // Nachtzeit
-            lamp1Relay.off();
-        }
-    } else if (settings.lamp1Mode == MODE_ON) {
-        lamp1Relay.on();
-    } else {
-        lamp1Relay.off();
+/**
+ * @brief Implementiert die Steuerungslogik für die Kamera (siehe CaptureSchedule).
+ * Läuft im Steuerungs-Task und fordert Aufnahmen nur an.
+ */
+void controlCamera(const Settings& settings) {
+    tm timeInfo{};
+    if (Hal::get().getLocalTime(timeInfo) && captureSchedule.isDue(timeInfo, settings.cameraCapturesPerDay)) {
+        requestCapture(); // die Aufnahme läuft im Kamera-Task
     }
+}
 
-    // -- Steuerung für die Lampe 2 (A2) --
+/**
+ * @brief Setzt den Kamera-Status, den updateDisplay() anzeigt.
+ * @param status Der neue Status.
+ */
+void setCameraStatus(const CameraStatus status) {
+    cameraStatusSince = Hal::get().millis();
+    cameraStatus = status;
+}
 
-    if (settings.lamp2Mode == MODE_AUTO) {
-        if (currentHour >= settings.light2OnHour && currentHour < settings.light2OffHour) {
-            // Tageszeit
-            if (!isnan(currentLightLux)) {
-                if (currentLightLux < settings.light2LuxThresholdDark) {
-                    // Zu dunkel -> Lampe AN
-                    lamp2Relay.on();
-                } else if (currentLightLux > settings.light2LuxThresholdBright) {
-                    // Hell genug -> Lampe AUS
-                    lamp2Relay.off();
-                }
-                // Dazwischen (im Hysterese-Bereich): Zustand beibehalten, nichts tun!
-                // Dies verhindert das Oszillieren.
-            } else {
-                // Sensorausfall: Lampe im Zweifel AN
-                lamp2Relay.on();
-            }
+/**
+ * @brief Nimmt ein Bild auf.
+ * Läuft im Kamera-Task (siehe requestCapture()). Das Bild landet im frameRing und wird sofort an alle Clients gemeldet,
+ * auf die SD-Karte schreibt es persistPendingImage() anschließend. Passt es nicht in den RAM, wird es wie bisher direkt
+ * auf die SD-Karte geschrieben.
+ * @return true bei Erfolg, false bei Fehler.
+ */
+bool capture() {
+    PROFILE_SCOPE(profiler, PROFILE_CAPTURE);
+    setCameraStatus(CAMERA_BUSY);
+    useResolution(stillResolution); // falls zuletzt der Live-Stream lief
+
+    char filename[sizeof(PendingImage::path)];
+    tm timeInfo{};
+    const bool hasTime = Hal::get().getLocalTime(timeInfo);
+    if (hasTime) {
+        // Ein Verzeichnis pro Tag (z.B. "/img/2025/12/05/103000.jpg")
+        MicroSDCard::formatImagePath(timeInfo, filename, sizeof(filename));
+    } else {
+        // Fallback, wenn Zeit nicht verfügbar ist: Start-Zähler und millis() hexadezimal (z.B. "/img/undated/002a0001d4c0.jpg"),
+        // damit ein Bild nach einem Neustart kein älteres überschreibt
+        snprintf(filename, sizeof(filename), "%s/%04x%08lx.jpg", MicroSDCard::UNDATED_DIR, bootCount,
+                 static_cast<unsigned long>(Hal::get().millis()));
+    }
+
+    const uint32_t captureTime = hasTime ? static_cast<uint32_t>(Hal::get().time()) : 0; // für den imageIndex
+
+    // Zuerst in den RAM (nur wenn die letzte Aufnahme schon auf der SD-Karte liegt, pendingImage hat nur einen Platz)
+    uint32_t seq = 0;
+    uint8_t* buffer = pendingImage.frame ? nullptr : frameRing.beginWrite();
+    if (buffer) {
+        const size_t size = camera.captureToBuffer(buffer, frameRing.getSlotSize());
+        if (size > 0) {
+            seq = frameRing.commit(size);
+            pendingImage.frame = frameRing.get(seq); // gepinnt, bis persistPendingImage() es geschrieben hat
+            pendingImage.time = captureTime;
+            strcpy(pendingImage.path, filename);
+            pendingImage.attempts = 0;
+            pendingImage.retryAt = Hal::get().millis();
         } else {
-            // Nachtzeit
-            lamp2Relay.off();
+            frameRing.abort();
         }
-    } else if (settings.lamp2Mode == MODE_ON) {
-        lamp2Relay.on();
-    } else {
-        lamp2Relay.off();
     }
 
-    // -- Steuerung für den Heizer (A3) --
+    // Kein Slot frei, noch eine Aufnahme offen oder Bild zu groß für den RAM: direkt auf die SD-Karte
+    if (seq == 0 && !saveImageToSD(filename)) {
+        setCameraStatus(CAMERA_FAILED); // Fehlermeldung wird kurz im Display angezeigt
+        webInterface.broadcast("captureFailed");
+        return false;
+    }
 
-    if (settings.heaterMode == MODE_AUTO) {
-        if (currentSoilTemp < settings.soilTempTarget) {
-            heaterRelay.on();
-        }
-        else if (currentSoilTemp > settings.soilTempTarget + 0.5f) {
-            heaterRelay.off();
+    setCameraStatus(CAMERA_OK); // Erfolgsmeldung wird kurz im Display angezeigt
+
+    // Pfad und Übertragungswerte melden
+    const ArduCamOV2640::TransferStats& stats = camera.getLastTransferStats();
+    if (seq == 0) {
+        imageIndex.add(filename, captureTime, stats.bytes); // liegt bereits auf der SD-Karte
+    }
+    JsonDocument doc;
+    const JsonObject payload = doc.to<JsonObject>();
+    payload["path"] = filename;
+    if (seq > 0) {
+        payload["seq"] = seq; // Nummer im RAM
+        payload["url"] = "/img/" + String(seq); // sofort abrufbar, auch bevor die Datei auf der SD-Karte liegt
+    }
+    payload["bytes"] = stats.bytes; // Größe des Bildes in Byte
+    payload["captureMs"] = stats.captureMs; // Dauer der Aufnahme in ms
+    payload["transferMs"] = stats.transferUs / 1000; // Dauer vom Auslesen bis zum Ablegen des Bildes in ms
+    payload["mbPerSec"] = stats.getThroughput(); // Durchsatz in MB/s
+    webInterface.broadcast("newImage", payload);
+    return true;
+}
+
+/**
+ * @brief Lädt das Bilderverzeichnis von der SD-Karte.
+ * Fehlt die Indexdatei oder ist sie beschädigt, wird sie im Hintergrund aus dem Inhalt der SD-Karte neu aufgebaut.
+ */
+void setupImageIndex() {
+    {
+        const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice);
+        if (!SD.exists(IMAGE_INDEX_DIR)) {
+            MicroSDCard::createDir(IMAGE_INDEX_DIR); // eigenes Verzeichnis, damit "deleteAllImages" die Datei nicht löscht
         }
-    } else if (settings.heaterMode == MODE_ON) {
-        heaterRelay.on();
+    }
+    if (imageIndex.begin(&spiBus, spiSdDevice)) {
+        Serial.printf("Bilderverzeichnis: %u Bilder\n", imageIndex.getCount());
     } else {
-        heaterRelay.off();
+        Serial.println("Bilderverzeichnis fehlt, wird neu aufgebaut.");
+        jobQueue.submit("rebuildImageIndex", 0, rebuildImageIndex); // kein Client, der Fortschritt wird nicht gemeldet
     }
 
-    // -- Steuerung für den Lüfter (A4) --
+    // Bilder aus dem alten Layout (alle im Wurzelverzeichnis) nach /img/YYYY/MM/DD verschieben, danach nur noch ein
+    // kurzer Blick ins Wurzelverzeichnis
+    jobQueue.submit("migrateImages", 0, migrateImages);
 
-    if (settings.fanMode == MODE_AUTO) {
-        if (currentAirTemp > settings.airTempThresholdHigh && !fanRelay.isOn()) {
-            fanRelay.pulse(settings.fanCooldownDurationMs);
-        }
-    } else if (settings.fanMode == MODE_ON) {
-        fanRelay.on();
-    } else {
-        fanRelay.off();
+    // Danach gleich aufräumen, falls die Karte beim Start schon fast voll ist
+    imageRetention.begin(&spiBus, spiSdDevice);
+    scheduleImageRetention();
+}
+
+/**
+ * @brief Meldet die Kanäle des Messwert-Verlaufs an und reserviert den Speicher.
+ * Die Namen entsprechen den Feldern im Status (fillStateJson()).
+ */
+void setupHistory() {
+    for (SensorHistory* h : {&history, &dayHistory}) {
+        h->addChannel("airTemp", 100);      // 0.01 °C
+        h->addChannel("humidity", 100);     // 0.01 %
+        h->addChannel("soilTemp", 100);     // 0.01 °C
+        h->addChannel("soilMoisture", 100); // 0.01 %
+        h->addChannel("waterLevelOk", 1);   // 0 oder 1
+        h->addChannel("lightLux", 0.5f);    // 2 lx (bis 65534 lx)
+    }
+    if (!history.begin(HISTORY_CAPACITY, HISTORY_INTERVAL) || !dayHistory.begin(HISTORY_DAY_CAPACITY, HISTORY_DAY_INTERVAL)) {
+        log("Verlauf FEHLER");
+        return;
     }
 
-    // Steuerung für die Pumpe (A5)
+    const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice);
+    if (!SD.exists(HISTORY_DIR)) {
+        MicroSDCard::createDir(HISTORY_DIR);
+    }
+}
 
-    if (settings.pumpMode == MODE_AUTO) {
-        if (isWaterLevelOk && !pumpRelay.isOn()) {
-            if (currentSoilMoisture < settings.soilMoistureTarget && currentSoilMoisture != -1) {
-                pumpRelay.pulse(settings.wateringDurationMs);
-            }
-        }
-    } else if (settings.pumpMode == MODE_ON) {
-        if (isWaterLevelOk) {
-            pumpRelay.on();
+/**
+ * @brief Schreibt die aktuellen Messwerte in den Messwert-Verlauf, wenn ein Eintrag fällig ist.
+ * Läuft im Netzwerk-Task. Solange die Uhrzeit noch nicht per NTP gestellt ist, wird nichts aufgezeichnet.
+ */
+void recordHistory() {
+    static uint32_t lastRecord = 0;
+    static uint32_t lastDayRecord = 0;
+
+    tm timeInfo{};
+    if (!Hal::get().getLocalTime(timeInfo)) {
+        return; // Uhrzeit noch nicht gestellt
+    }
+    const auto now = static_cast<uint32_t>(Hal::get().time());
+
+    // Feiner Verlauf: im Raster von HISTORY_INTERVAL Sekunden
+    if (now / HISTORY_INTERVAL != lastRecord / HISTORY_INTERVAL) {
+        lastRecord = now;
+        const SensorSnapshot sensors = sensorSnapshot.read();
+        const float values[] = {
+            sensors.isValid(FIELD_AIR_TEMP) ? sensors.airTemp : NAN,
+            sensors.isValid(FIELD_HUMIDITY) ? sensors.humidity : NAN,
+            sensors.isValid(FIELD_SOIL_TEMP) ? sensors.soilTemp : NAN,
+            sensors.isValid(FIELD_SOIL_MOISTURE) ? static_cast<float>(sensors.soilMoisture) : NAN,
+            sensors.isValid(FIELD_WATER_LEVEL) ? (sensors.waterLevelOk ? 1.0f : 0.0f) : NAN,
+            sensors.isValid(FIELD_LIGHT_LUX) ? sensors.lightLux : NAN,
+        };
+        history.record(now, values);
+    }
+
+    // Grober Verlauf: Mittelwert der letzten Minute aus dem feinen Verlauf
+    if (now / HISTORY_DAY_INTERVAL != lastDayRecord / HISTORY_DAY_INTERVAL) {
+        const bool first = lastDayRecord == 0;
+        lastDayRecord = now;
+        if (first) {
+            return; // angebrochene erste Minute auslassen
         }
-        else {
-            pumpRelay.off();
+        const uint32_t to = now - now % HISTORY_DAY_INTERVAL;
+        float values[SensorHistory::MAX_CHANNELS];
+        for (uint8_t channel = 0; channel < history.getChannelCount(); channel++) {
+            SensorHistory::Bucket bucket;
+            history.query(channel, to - HISTORY_DAY_INTERVAL, to, 1, &bucket);
+            values[channel] = bucket.avg;
         }
-    } else {
-        pumpRelay.off();
+        dayHistory.record(to - HISTORY_DAY_INTERVAL, values);
     }
+}
 
-    // -- Steuerung für den Vernebler (A6) --
+/**
+ * @brief Hängt die noch nicht gesicherten Einträge des feinen Verlaufs an die Tagesdateien auf der SD-Karte an.
+ * Läuft im Netzwerk-Task. Geschrieben wird erst, wenn HISTORY_SPILL_ROWS Einträge zusammengekommen sind. Ist der
+ * SPI-Bus belegt, wird es beim nächsten Durchlauf erneut versucht.
+ */
+void spillHistory() {
+    if (history.getUnsavedCount() < HISTORY_SPILL_ROWS) {
+        return;
+    }
+    const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice, WebUI::SD_LOCK_TIMEOUT);
+    if (!lock || !sdCard.isReady()) {
+        return;
+    }
 
-    if (settings.misterMode == MODE_AUTO) {
-        if (isWaterLevelOk) {
-            if (currentHumidity < settings.humidityTarget) {
-                misterRelay.on();
-            }
-            else if (currentHumidity > settings.humidityTarget + 5.0f) {
-                misterRelay.off();
+    uint8_t buffer[HISTORY_SPILL_ROWS * (sizeof(uint32_t) + SensorHistory::MAX_CHANNELS * sizeof(int16_t))];
+    uint32_t firstTime = 0;
+    const uint16_t rows = history.readUnsaved(buffer, sizeof(buffer), firstTime);
+    const size_t rowSize = history.getRowSize();
+
+    // Tag (Ortszeit) einer Zeile, der Zeitstempel steht am Anfang der Zeile
+    const auto dayOf = [&](const uint16_t row, tm& timeInfo) {
+        uint32_t time;
+        memcpy(&time, buffer + row * rowSize, sizeof(time));
+        const time_t t = time;
+        localtime_r(&t, &timeInfo);
+    };
+
+    // Eine Datei pro Tag (z.B. "/history/20251205.bin"); ein Block über Mitternacht wird an der Tagesgrenze geteilt
+    uint16_t first = 0;
+    while (first < rows) {
+        tm day{};
+        dayOf(first, day);
+        uint16_t end = first + 1;
+        for (tm next{}; end < rows; end++) {
+            dayOf(end, next);
+            if (next.tm_yday != day.tm_yday || next.tm_year != day.tm_year) {
+                break;
             }
-        } else {
-            misterRelay.off();
         }
-    } else if (settings.misterMode == MODE_ON) {
-        if (isWaterLevelOk) {
-            misterRelay.on();
-        } else {
-            misterRelay.off();
+        char path[32];
+        snprintf(path, sizeof(path), "%s/%04d%02d%02d.bin", HISTORY_DIR, day.tm_year + 1900, day.tm_mon + 1, day.tm_mday);
+        if (!MicroSDCard::appendFile(path, buffer + first * rowSize, (end - first) * rowSize)) {
+            return; // der Rest bleibt ungesichert und wird beim nächsten Mal versucht
         }
+        history.markSaved(end - first);
+        first = end;
+    }
+}
+
+/**
+ * @brief Nimmt ein Bild für den Live-Stream auf (nur in den streamRing, nicht auf die SD-Karte).
+ * Läuft im Kamera-Task. Ist kein Slot frei, weil alle Bilder gerade gesendet werden, wird das Bild ausgelassen.
+ */
+void captureStreamFrame() {
+    useResolution(STREAM_RESOLUTION);
+    uint8_t* buffer = streamRing.beginWrite();
+    if (!buffer) {
+        streamFramesSkipped++;
+        return;
+    }
+    const size_t size = camera.captureToBuffer(buffer, streamRing.getSlotSize());
+    if (size > 0) {
+        streamRing.commit(size);
     } else {
-        misterRelay.off();
+        streamRing.abort();
+        streamFramesSkipped++;
     }
 }
 
 /**
- * @brief Implementiert die Steuerungslogik für die Kamera.
+ * @brief Stellt die Auflösung der Kamera um, falls nötig (dauert ca. 200 ms).
+ * @param resolution Die gewünschte Auflösung.
  */
-void controlCamera() {
-    static uint32_t lastCaptureDay = 0;
-    static int capturesToday = 0;
-    tm timeInfo{};
-    if (getLocalTime(&timeInfo)) {
-        // Prüfe, ob ein neuer Tag begonnen hat
-        if (timeInfo.tm_yday != lastCaptureDay) {
-            lastCaptureDay = timeInfo.tm_yday;
-            capturesToday = 0;
-        }
-        const auto& settings = settingsManager.get();
-        if (settings.cameraCapturesPerDay > 0 && capturesToday < settings.cameraCapturesPerDay) {
-            // Berechne das Intervall für heute
-            uint32_t intervalSeconds = 86400 / settings.cameraCapturesPerDay;
-            if (timeInfo.tm_hour * 3600 + timeInfo.tm_min * 60 >= capturesToday * intervalSeconds) {
-                capture();
-                capturesToday++;
-            }
-        }
+void useResolution(const uint8_t resolution) {
+    if (camera.getResolution() != resolution) {
+        camera.setResolution(resolution);
     }
 }
 
 /**
- * @brief Nimmt ein Bild auf und speichert es auf der SD-Karte.
- * @return true bei Erfolg, false bei Fehler.
+ * @brief Schreibt die zuletzt in den RAM aufgenommene Aufnahme auf die SD-Karte.
+ * Läuft im Kamera-Task. Das Bild bleibt gepinnt und kann weiter ausgeliefert werden, bis es geschrieben ist. Schlägt
+ * das Schreiben fehl, wird es im Abstand von IMAGE_SAVE_RETRY_INTERVAL erneut versucht. Nach IMAGE_SAVE_ATTEMPTS
+ * Versuchen wird das Bild verworfen und allen Clients gemeldet, damit sie nicht auf eine fehlende Datei zeigen:
+ * payload: {"path": "/img/2025/12/05/103000.jpg", "seq": 7}
+ * @return true bei Erfolg oder wenn nichts zu tun ist, false bei Fehler oder wenn der nächste Versuch noch nicht fällig ist.
  */
-bool capture() {
-    display.showFullscreenAlert("FOTO...", false);
+bool persistPendingImage() {
+    if (!pendingImage.frame) {
+        return true;
+    }
+    if (static_cast<int32_t>(Hal::get().millis() - pendingImage.retryAt) < 0) {
+        return false; // nächster Versuch noch nicht fällig
+    }
 
-    char filename[30];
-    tm timeInfo{};
-    if (getLocalTime(&timeInfo)) {
-        // Erzeuge einen Namen mit Zeitstempel (z.B. "/img_20251205_103000.jpg")
-        sprintf(filename, "/img_%04d%02d%02d_%02d%02d%02d.jpg",
-            timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday,
-            timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
-    } else {
-        // Fallback, wenn Zeit nicht verfügbar ist
-        sprintf(filename, "/img_%lu.jpg", millis());
+    const FrameRing::Ref& frame = pendingImage.frame;
+    const bool giveUp = pendingImage.attempts + 1 >= IMAGE_SAVE_ATTEMPTS;
+    {
+        const SpiBusArbiter::Lock lock(&spiBus, spiSdDevice);
+        File file = sdCard.prepareImagePath(pendingImage.path) ? SD.open(pendingImage.path, FILE_WRITE) : File();
+        const bool success = file && file.write(frame.data(), frame.size()) == frame.size();
+        file.close();
+        if (success) {
+            imageIndex.add(pendingImage.path, pendingImage.time, frame.size());
+            pendingImage.frame.reset();
+            return true;
+        }
+        if (giveUp && SD.exists(pendingImage.path)) {
+            SD.remove(pendingImage.path); // keine halb geschriebene Datei zurücklassen
+        }
     }
 
-    if (!camera.saveToSD(filename)) {
-        display.showFullscreenAlert("KAMERA FEHLER", true);
-        delay(2000); // Fehlermeldung kurz anzeigen
+    pendingImage.attempts++;
+    if (!giveUp) {
+        Serial.printf("Bild %s konnte nicht gespeichert werden (Versuch %u von %u).\n", pendingImage.path,
+                      pendingImage.attempts, IMAGE_SAVE_ATTEMPTS);
+        pendingImage.retryAt = Hal::get().millis() + IMAGE_SAVE_RETRY_INTERVAL;
         return false;
     }
 
-    display.showFullscreenAlert("FOTO OK", false);
-    webInterface.broadcast("newImage", "path", filename);
-    delay(2000); // Erfolgsmeldung kurz anzeigen
-    return true;
+    Serial.printf("Bild %s konnte nicht gespeichert werden, wird verworfen.\n", pendingImage.path);
+    JsonDocument doc;
+    const JsonObject payload = doc.to<JsonObject>();
+    payload["path"] = pendingImage.path;
+    payload["seq"] = frame.seq();
+    webInterface.broadcast("imageSaveFailed", payload);
+    pendingImage.frame.reset();
+    return false;
+}
+
+/**
+ * @brief Nimmt ein Bild auf und schreibt es direkt auf die SD-Karte (wenn es nicht in den RAM passt).
+ * Läuft im Kamera-Task.
+ * @param path Zieldatei, fehlende Verzeichnisse werden angelegt.
+ * @return true bei Erfolg.
+ */
+bool saveImageToSD(const char* path) {
+    // Ein Bus-Zugriff für Verzeichnis und Datei, damit "deleteAllImages" das Verzeichnis nicht dazwischen entfernt
+    const SpiBusArbiter::Lock batch(&spiBus, SpiBusArbiter::NO_DEVICE);
+    return sdCard.prepareImagePath(path) && camera.saveToSD(path);
 }
 
 /**
@@ -925,44 +2044,447 @@ void applyCameraSettings() {
 }
 
 /**
- * @brief Erstellt ein JSON-Objekt mit dem aktuellen Status aller Sensoren und Aktoren.
- * @param doc Das JsonDocument, in dem das Objekt erstellt werden soll.
- * @return Ein JsonObject, das den aktuellen Systemstatus enthält.
+ * @brief Füllt ein JSON-Objekt mit dem aktuellen Status aller Sensoren und Aktoren.
+ * Messwerte und Aktoren stammen aus einer einzigen konsistenten Kopie (getStateFrame()), dahinter folgen die Diagnosewerte.
+ * @param values Das Objekt (Payload der Nachricht).
+ */
+void fillStateJson(const JsonObject values) {
+    StateDelta::fillJson(values, getStateFrame(), {StateDelta::ALL, StateDelta::ALL});
+    fillStateDiagnosticsJson(values);
+}
+
+/**
+ * @brief Füllt ein JSON-Objekt mit den Diagnosewerten des vollständigen Status (Reaktionszeit, Broadcasts, SPI-Bus,
+ * Live-Stream, Aufträge, Bilder, Zeitpunkte der Messungen).
+ * @param values Das Objekt (Payload der Nachricht).
  */
-JsonObject getStateAsJson(JsonDocument& doc) {
-    const JsonObject values = doc.to<JsonObject>();
+void fillStateDiagnosticsJson(const JsonObject values) {
+    // Reaktionszeit der Steuerung in µs (Messung bis Schalten der Relais)
+    values["controlLatencyUs"] = controlLatencyLastUs.load();
+    values["controlLatencyMaxUs"] = controlLatencyMaxUs.load();
+    values["controlCycleMaxUs"] = controlCycleMaxUs.load();
+
+    // Aufwand des letzten Status-Broadcasts je Format
+    const JsonObject broadcast = values["broadcast"].to<JsonObject>();
+    broadcast["jsonBytes"] = stateJsonBytes.load();
+    broadcast["jsonUs"] = stateJsonUs.load();
+    broadcast["binaryBytes"] = stateBinaryBytes.load();
+    broadcast["binaryUs"] = stateBinaryUs.load();
+    broadcast["binaryClients"] = webInterface.getBinaryStateClientCount();
+    broadcast["skipped"] = stateSkipped.load(); // entfallen, weil sich nichts geändert hat
+    broadcast["arenaPeak"] = webInterface.getJsonArenaHighWaterMark(); // höchste Belegung einer Arena in Byte
+    broadcast["arenaFallbacks"] = webInterface.getJsonArenaFallbacks(); // Nachrichten, die auf dem Heap erstellt wurden
+    broadcast["overflows"] = webInterface.getJsonOverflows(); // verworfen, weil die Nachricht nicht in ihr Dokument passte
+
+    // Wartezeiten auf den SPI-Bus je Gerät ("batch" = gebündelte Zugriffe, z.B. eine ganze Aufnahme)
+    const JsonObject spiWait = values["spiWait"].to<JsonObject>();
+    for (int id = SpiBusArbiter::NO_DEVICE; id < spiBus.getDeviceCount(); id++) {
+        const SpiBusArbiter::WaitStats stats = spiBus.getStats(id);
+        const JsonObject device = spiWait[spiBus.getName(id)].to<JsonObject>();
+        device["count"] = stats.acquisitions; // Anzahl der Zugriffe
+        device["contended"] = stats.contended; // davon: Bus war belegt
+        device["timeouts"] = stats.timeouts; // abgebrochen wegen Zeitüberschreitung
+        device["maxUs"] = stats.maxWaitUs; // längste Wartezeit in µs
+    }
 
-    values["airTemp"] = currentAirTemp; // Raumtemperatur in °C (S1)
-    values["humidity"] = currentHumidity; // Luftfeuchtigkeit in % (S1)
-    values["soilTemp"] = currentSoilTemp; // Bodentemperatur in °C (S2)
-    values["soilMoisture"] = currentSoilMoisture; // Bodenfeuchtigkeit in % (S3)
-    values["waterLevelOk"] = isWaterLevelOk; // Wasserstand (S4)
-    values["lightLux"] = currentLightLux; // Tageslicht in Lux (S5)
+    // Live-Stream: tatsächliche Bildrate je Client, übersprungene Bilder
+    const JsonObject stream = values["stream"].to<JsonObject>();
+    stream["skipped"] = streamFramesSkipped.load(); // nicht aufgenommen (kein Slot frei)
+    const JsonArray streamClients = stream["clients"].to<JsonArray>();
+    WebUI::StreamStats streamStats[WebUI::MAX_STREAM_CLIENTS];
+    const uint8_t streamCount = webInterface.getStreamStats(streamStats, WebUI::MAX_STREAM_CLIENTS);
+    for (uint8_t i = 0; i < streamCount; i++) {
+        const JsonObject client = streamClients.add<JsonObject>();
+        client["id"] = streamStats[i].id;
+        client["fps"] = streamStats[i].fps; // gesendete Bilder pro Sekunde
+        client["frames"] = streamStats[i].frames; // gesendete Bilder
+        client["dropped"] = streamStats[i].dropped; // für diesen Client übersprungen (zu langsam)
+    }
 
-    // Aktor-Zustände
-    values["lamp1On"] = lamp1Relay.isOn(); // Lampe 1 (A1)
-    values["lamp2On"] = lamp2Relay.isOn(); // Lampe 2 (A2)
-    values["heaterOn"] = heaterRelay.isOn(); // Heizer (A3)
-    values["fanOn"] = fanRelay.isOn(); // Lüfter (A4)
-    values["pumpOn"] = pumpRelay.isOn(); // Pumpe (A5)
-    values["misterOn"] = misterRelay.isOn(); // Vernebler (A6)
-    return values;
+    // Hintergrundaufträge (siehe submitJob())
+    const JsonObject jobs = values["jobs"].to<JsonObject>();
+    jobs["pending"] = jobQueue.getPendingCount(); // eingereiht oder laufend
+    jobs["finished"] = jobQueue.getFinishedCount(); // abgeschlossen (erfolgreich oder nicht)
+    jobs["failed"] = jobQueue.getFailedCount(); // fehlgeschlagen
+    jobs["rejected"] = jobQueue.getRejectedCount(); // abgelehnt (Warteschlange voll)
+    jobs["maxRunMs"] = jobQueue.getMaxRunTime(); // längste Laufzeit eines Auftrags in ms
+
+    // Bilderverzeichnis (siehe sendImageList())
+    const JsonObject images = values["imageIndex"].to<JsonObject>();
+    const ImageIndex::Stats indexStats = imageIndex.getStats(); // Kopie, Kamera- und jobs-Task ändern den Index
+    images["count"] = indexStats.count; // Bilder auf der SD-Karte
+    images["entries"] = indexStats.size; // Einträge in der Indexdatei (inkl. gelöschter)
+    images["cacheHits"] = indexStats.cacheHits; // Blöcke aus dem RAM
+    images["cacheMisses"] = indexStats.cacheMisses; // Blöcke von der SD-Karte
+    images["bytes"] = indexStats.bytes; // Speicher aller Bilder in Byte
+
+    // Aufräumen der Bilder (siehe runImageRetention())
+    const JsonObject retention = values["retention"].to<JsonObject>();
+    const ImageRetention::Stats retentionStats = imageRetention.getStats(); // Kopie, der Auftrag läuft im Task "jobs"
+    const ImageRetention::Run& retentionRun = retentionStats.run;
+    retention["runs"] = retentionStats.runs; // abgeschlossene Durchläufe
+    retention["deleted"] = retentionRun.deleted; // letzter Durchlauf: gelöschte Bilder
+    retention["reclaimedBytes"] = retentionRun.reclaimedBytes; // letzter Durchlauf: frei gewordener Speicher in Byte
+    retention["missingBytes"] = retentionRun.missingBytes; // letzter Durchlauf: noch fehlender Speicher in Byte
+    retention["busyMs"] = retentionRun.busyMs; // letzter Durchlauf: Summe der Zeitscheiben in ms
+    retention["totalReclaimedBytes"] = retentionStats.totalReclaimedBytes; // alle Durchläufe
+
+    // Zeitpunkt der letzten erfolgreichen Messung je Sensor (Unix-Zeit in Sekunden, null = noch keine Messung).
+    // Solange die Uhrzeit nicht per NTP gestellt ist, stattdessen Sekunden seit dem Start (sampledAtSynced = false).
+    const JsonObject sampledAt = values["sampledAt"].to<JsonObject>();
+    const uint32_t uptime = Hal::get().millis();
+    tm timeInfo{};
+    const bool timeSynced = Hal::get().getLocalTime(timeInfo);
+    const time_t now = timeSynced ? Hal::get().time() : static_cast<time_t>(uptime / 1000);
+    values["sampledAtSynced"] = timeSynced;
+    for (int id = 0; id < sensorScheduler.getSensorCount(); id++) {
+        if (sensorScheduler.hasSample(id)) {
+            sampledAt[sensorScheduler.getName(id)] = now - static_cast<time_t>((uptime - sensorScheduler.getLastSampledAt(id)) / 1000);
+        } else {
+            sampledAt[sensorScheduler.getName(id)] = nullptr;
+        }
+    }
 }
 
 /**
- * @brief Sendet den Status aller Sensoren und Aktoren an alle Clients
+ * @brief Füllt ein JSON-Objekt mit den Laufzeiten der heißen Pfade (Nachricht "stats", siehe Profiler).
+ * @param values Das Objekt (Payload der Nachricht).
  */
-void broadcastState() {
-    JsonDocument doc;
-    webInterface.broadcast("state", getStateAsJson(doc));
+void fillStatsJson(const JsonObject values) {
+    values["enabled"] = Profiler::isEnabled(); // false = ohne PROFILER_ENABLED gebaut, alle Abschnitte leer
+    const JsonArray sections = values["sections"].to<JsonArray>();
+    for (uint8_t id = 0; id < profiler.getSectionCount(); id++) {
+        Profiler::Stats stats;
+        if (!profiler.getStats(id, stats)) {
+            continue; // wird gerade beschrieben, fehlt nur in dieser Nachricht
+        }
+        const JsonObject section = sections.add<JsonObject>();
+        section["name"] = profiler.getName(id);
+        section["count"] = stats.count; // Messungen seit dem Start bzw. seit "getStats" mit "reset"
+        section["minUs"] = stats.minUs;
+        section["avgUs"] = stats.avgUs();
+        section["p99Us"] = stats.percentileUs(0.99f); // aus dem Histogramm geschätzt
+        section["maxUs"] = stats.maxUs;
+
+        // log2-Histogramm bis zum letzten belegten Bereich: Eintrag b zählt die Laufzeiten von 2^(b-1) bis unter 2^b µs
+        uint8_t used = 0;
+        for (uint8_t b = 0; b < Profiler::BUCKETS; b++) {
+            if (stats.histogram[b] > 0) {
+                used = b + 1;
+            }
+        }
+        const JsonArray histogram = section["histogram"].to<JsonArray>();
+        for (uint8_t b = 0; b < used; b++) {
+            histogram.add(stats.histogram[b]);
+        }
+    }
+}
+
+/**
+ * @brief Veröffentlicht Zustände, Schaltvorgänge und Einschaltdauer aller Relais (nur im Steuerungs-Task aufrufen).
+ */
+void publishActuatorCounters() {
+    ActuatorCounters counters;
+    for (uint8_t i = 0; i < ACTUATOR_COUNT; i++) {
+        const Relay& relay = *ACTUATORS[i].value.relay;
+        if (relay.isOn()) {
+            counters.bits |= ACTUATORS[i].value.bit;
+        }
+        counters.switches[i] = relay.getSwitchCount();
+        counters.onTimeMs[i] = relay.getOnTimeMs();
+    }
+    actuatorCounters.write(counters);
+}
+
+/**
+ * @brief Kopiert alle Werte für eine Abfrage von /metrics.
+ * Läuft im AsyncTCP-Task und liest nur veröffentlichte Stände (Seqlocks, Atomics, Zähler); kein Task wird dabei
+ * angehalten und kein Bus belegt. Die Belegung der SD-Karte stammt vom letzten Aufräumen.
+ * @param snapshot Ziel.
+ */
+void takeMetricsSnapshot(MetricsSnapshot& snapshot) {
+    snapshot.sensors = sensorSnapshot.read();
+    snapshot.actuators = actuatorCounters.read();
+
+    snapshot.sensorCount = sensorScheduler.getSensorCount();
+    for (uint8_t id = 0; id < snapshot.sensorCount; id++) {
+        snapshot.sensorFailures[id] = sensorScheduler.getFailures(id);
+        snapshot.sensorErrorCodes[id] = sensorScheduler.getErrorCounts(id, snapshot.sensorErrors[id],
+            SensorScheduler::MAX_ERROR_CODES);
+        snapshot.deadlineMisses[id] = sensorScheduler.getDeadlineMisses(id);
+    }
+
+    for (uint8_t id = 0; id < PROFILE_SECTION_COUNT; id++) {
+        snapshot.sectionValid[id] = profiler.getStats(id, snapshot.sections[id]);
+    }
+
+    snapshot.heapFree = ESP.getFreeHeap();
+    snapshot.heapMinFree = ESP.getMinFreeHeap();
+    snapshot.heapLargestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    snapshot.wifiConnected = WiFi.isConnected();
+    snapshot.rssi = snapshot.wifiConnected ? WiFi.RSSI() : 0;
+    snapshot.sdUsedMB = sdUsedMB;
+    snapshot.sdTotalMB = sdTotalMB;
+    snapshot.uptimeMs = Hal::get().millis();
+}
+
+/**
+ * @brief Beginnt eine Abfrage von /metrics (Callback onMetrics des Webinterface, läuft im AsyncTCP-Task).
+ * Kopiert die Werte und gibt den Writer zurück; die Antwort gibt ihn frei, sobald sie gesendet oder abgebrochen ist.
+ * @return Der Writer, oder nullptr, wenn noch eine Abfrage läuft.
+ */
+std::shared_ptr<MetricsWriter> startMetrics() {
+    if (metricsBusy.exchange(true)) {
+        return nullptr;
+    }
+    takeMetricsSnapshot(metricsSnapshot);
+    metricsWriter.rewind();
+    return std::shared_ptr<MetricsWriter>(&metricsWriter, [](MetricsWriter*) { metricsBusy = false; });
+}
+
+/**
+ * @brief Liefert einen Wert für /metrics aus metricsSnapshot (SampleFunction von metricsWriter).
+ * @param family Familie (MetricFamily).
+ * @param index Laufende Nummer innerhalb der Familie.
+ * @param sample Ziel.
+ * @return false, wenn die Familie keine weiteren Werte hat.
+ */
+bool sampleMetric(const uint8_t family, const uint16_t index, MetricsWriter::Sample& sample) {
+    const MetricsSnapshot& m = metricsSnapshot;
+    const SensorSnapshot& sensors = m.sensors;
+
+    switch (family) {
+        // Familien mit genau einem Wert
+        case METRIC_AIR_TEMP:
+            sample.value = sensors.isValid(FIELD_AIR_TEMP) ? sensors.airTemp : NAN;
+            return index == 0;
+        case METRIC_HUMIDITY:
+            sample.value = sensors.isValid(FIELD_HUMIDITY) ? sensors.humidity : NAN;
+            return index == 0;
+        case METRIC_SOIL_TEMP:
+            sample.value = sensors.isValid(FIELD_SOIL_TEMP) ? sensors.soilTemp : NAN;
+            return index == 0;
+        case METRIC_SOIL_MOISTURE:
+            sample.value = sensors.isValid(FIELD_SOIL_MOISTURE) ? sensors.soilMoisture : NAN;
+            return index == 0;
+        case METRIC_WATER_LEVEL:
+            sample.value = sensors.isValid(FIELD_WATER_LEVEL) ? (sensors.waterLevelOk ? 1 : 0) : NAN;
+            return index == 0;
+        case METRIC_LIGHT:
+            sample.value = sensors.isValid(FIELD_LIGHT_LUX) ? sensors.lightLux : NAN;
+            return index == 0;
+        case METRIC_HEAP_FREE:
+            sample.value = m.heapFree;
+            return index == 0;
+        case METRIC_HEAP_MIN_FREE:
+            sample.value = m.heapMinFree;
+            return index == 0;
+        case METRIC_HEAP_LARGEST_BLOCK:
+            sample.value = m.heapLargestBlock;
+            return index == 0;
+        case METRIC_WIFI_RSSI:
+            sample.value = m.rssi;
+            sample.omit = !m.wifiConnected;
+            return index == 0;
+        case METRIC_SD_USED:
+            sample.value = static_cast<double>(m.sdUsedMB) * 1024 * 1024;
+            sample.omit = m.sdTotalMB == 0;
+            return index == 0;
+        case METRIC_SD_TOTAL:
+            sample.value = static_cast<double>(m.sdTotalMB) * 1024 * 1024;
+            sample.omit = m.sdTotalMB == 0;
+            return index == 0;
+        case METRIC_UPTIME:
+            sample.value = m.uptimeMs / 1000.0;
+            return index == 0;
+
+        // Familien mit einem Wert je Messwert, Sensor, Relais oder Abschnitt
+        case METRIC_SENSOR_VALID: {
+            // Ein Wert je Messwert, Reihenfolge wie SensorChannel
+            static const char* const FIELD_NAMES[] = {"airTemp", "humidity", "soilTemp", "soilMoisture", "waterLevel", "lightLux"};
+            if (index >= sizeof(FIELD_NAMES) / sizeof(FIELD_NAMES[0])) {
+                return false;
+            }
+            sample.label("reading", FIELD_NAMES[index]);
+            sample.value = sensors.isValid(static_cast<SensorField>(1 << index)) ? 1 : 0;
+            return true;
+        }
+        case METRIC_SENSOR_ERRORS: {
+            // Je Sensor MAX_ERROR_CODES Plätze für einzeln gezählte Codes und einer für alle übrigen ("other")
+            constexpr uint8_t SLOTS = SensorScheduler::MAX_ERROR_CODES + 1;
+            const uint8_t id = index / SLOTS;
+            const uint8_t slot = index % SLOTS;
+            if (id >= m.sensorCount) {
+                return false;
+            }
+            sample.label("sensor", sensorScheduler.getName(id));
+            if (slot < SensorScheduler::MAX_ERROR_CODES) {
+                sample.omit = slot >= m.sensorErrorCodes[id];
+                sample.label("code", static_cast<double>(m.sensorErrors[id][slot].code));
+                sample.value = m.sensorErrors[id][slot].count;
+            } else {
+                uint32_t counted = 0;
+                for (uint8_t i = 0; i < m.sensorErrorCodes[id]; i++) {
+                    counted += m.sensorErrors[id][i].count;
+                }
+                sample.omit = m.sensorFailures[id] <= counted;
+                sample.label("code", "other");
+                sample.value = m.sensorFailures[id] - counted;
+            }
+            return true;
+        }
+        case METRIC_SENSOR_DEADLINE_MISSES:
+            if (index >= m.sensorCount) {
+                return false;
+            }
+            sample.label("sensor", sensorScheduler.getName(index));
+            sample.value = m.deadlineMisses[index];
+            return true;
+        case METRIC_RELAY_ON:
+        case METRIC_RELAY_ON_TIME:
+        case METRIC_RELAY_SWITCHES:
+            if (index >= ACTUATOR_COUNT) {
+                return false;
+            }
+            sample.label("relay", ACTUATORS[index].name);
+            if (family == METRIC_RELAY_ON) {
+                sample.value = (m.actuators.bits & ACTUATORS[index].value.bit) != 0 ? 1 : 0;
+            } else if (family == METRIC_RELAY_ON_TIME) {
+                sample.value = m.actuators.onTimeMs[index] / 1000.0;
+            } else {
+                sample.value = m.actuators.switches[index];
+            }
+            return true;
+        case METRIC_SECTION_DURATION: {
+            // Je Abschnitt die Grenzen 0 µs bis 2^22 - 1 µs, dann +Inf, Summe und Anzahl
+            constexpr uint8_t SAMPLES = Profiler::BUCKETS + 2;
+            const uint8_t id = index / SAMPLES;
+            const uint8_t position = index % SAMPLES;
+            if (id >= PROFILE_SECTION_COUNT) {
+                return false;
+            }
+            const Profiler::Stats& stats = m.sections[id];
+            sample.omit = !m.sectionValid[id];
+            sample.label("section", profiler.getName(id));
+            if (position < Profiler::BUCKETS - 1) {
+                uint32_t cumulative = 0;
+                for (uint8_t b = 0; b <= position; b++) {
+                    cumulative += stats.histogram[b];
+                }
+                // bucketLimitUs() ist ausschließlich, "le" schließt die Grenze ein: bei ganzen µs also 2^b - 1
+                sample.suffix = "_bucket";
+                sample.label("le", (Profiler::Stats::bucketLimitUs(position) - 1) * 1e-6);
+                sample.value = cumulative;
+            } else if (position == Profiler::BUCKETS - 1) {
+                sample.suffix = "_bucket";
+                sample.label("le", INFINITY);
+                sample.value = stats.count;
+            } else if (position == Profiler::BUCKETS) {
+                sample.suffix = "_sum";
+                sample.value = stats.totalUs * 1e-6;
+            } else {
+                sample.suffix = "_count";
+                sample.value = stats.count;
+            }
+            return true;
+        }
+        case METRIC_SECTION_MAX:
+        case METRIC_SECTION_P99:
+            if (index >= PROFILE_SECTION_COUNT) {
+                return false;
+            }
+            sample.omit = !m.sectionValid[index];
+            sample.label("section", profiler.getName(index));
+            sample.value = (family == METRIC_SECTION_MAX ? m.sections[index].maxUs
+                                                         : m.sections[index].percentileUs(0.99f)) * 1e-6;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Erstellt die binäre Statusnachricht (nur die Werte für das Dashboard, ohne Diagnosewerte).
+ * @return Der Frame (Layout siehe StateFrame.h).
+ */
+StateFrame getStateFrame() {
+    const SensorSnapshot sensors = sensorSnapshot.read();
+    StateFrame frame;
+    frame.valid = sensors.valid;
+    frame.sequence = sensors.sequence;
+    frame.airTemp = sensors.airTemp;
+    frame.humidity = sensors.humidity;
+    frame.soilTemp = sensors.soilTemp;
+    frame.soilMoisture = sensors.soilMoisture;
+    frame.lightLux = sensors.lightLux;
+    frame.flags = sensors.waterLevelOk ? STATE_WATER_LEVEL_OK : 0;
+
+    frame.actuators = getActuatorBits();
+
+    frame.controlLatencyUs = controlLatencyLastUs.load();
+    frame.controlLatencyMaxUs = controlLatencyMaxUs.load();
+    frame.controlCycleMaxUs = controlCycleMaxUs.load();
+    return frame;
+}
+
+/**
+ * @brief Gibt die Zustände aller Aktoren als Bitmaske zurück.
+ * @return Bitmaske aus ActuatorField.
+ */
+uint8_t getActuatorBits() {
+    uint8_t bits = 0;
+    for (const NamedValue<Actuator>& actuator : ACTUATORS) {
+        if (actuator.value.relay->isOn()) {
+            bits |= actuator.value.bit;
+        }
+    }
+    return bits;
+}
+
+/**
+ * @brief Sendet den Status aller Sensoren und Aktoren an alle Clients.
+ * Clients, die sich mit "hello" für das Binärformat angemeldet haben, bekommen einen StateFrame, alle anderen JSON.
+ * Das JSON-Dokument wird nur erstellt, wenn es auch jemand empfängt.
+ * @param full true = vollständiger Status inkl. Diagnosewerte, false = nur geänderte Felder (oder gar nichts).
+ */
+void broadcastState(const bool full) {
+    PROFILE_SCOPE(profiler, PROFILE_BROADCAST_STATE);
+    const StateFrame frame = getStateFrame();
+    const StateDelta::Changes changes = stateDelta.getChanges(frame, full);
+    if (!changes.any()) {
+        stateSkipped++;
+        return; // nichts geändert
+    }
+
+    // Binär immer der ganze Frame (40 Byte, kleiner als jede JSON-Änderung)
+    if (webInterface.getBinaryStateClientCount() > 0) {
+        const int64_t start = esp_timer_get_time();
+        webInterface.broadcastStateBinary(reinterpret_cast<const uint8_t*>(&frame), sizeof(frame));
+        stateBinaryUs = static_cast<uint32_t>(esp_timer_get_time() - start);
+        stateBinaryBytes = sizeof(frame);
+    }
+
+    if (webInterface.getClientCount() > webInterface.getBinaryStateClientCount()) {
+        const int64_t start = esp_timer_get_time();
+        stateJsonBytes = webInterface.broadcastStateJson([&](const JsonObject payload) {
+            // Messwerte und Aktoren aus demselben Frame, den markSent() übernimmt (beim vollständigen Status alle Felder)
+            StateDelta::fillJson(payload, frame, changes);
+            if (full) {
+                fillStateDiagnosticsJson(payload);
+            }
+        });
+        stateJsonUs = static_cast<uint32_t>(esp_timer_get_time() - start);
+    }
+
+    // Nur die gesendeten Felder übernehmen
+    stateDelta.markSent(frame, changes);
 }
 
 /**
  * @brief Sendet die Einstellungen an alle Clients.
  */
 void broadcastSettings() {
-    JsonDocument doc;
-    const JsonObject values = doc.to<JsonObject>(); // JsonDocument in ein JsonObject umwandeln
-    settingsManager.serialize(values); // settingsManager füllt dieses Objekt
-    webInterface.broadcast("settings", values);
+    webInterface.broadcast("settings", [](const JsonObject values) {
+        settingsManager.serialize(values); // settingsManager füllt das Payload direkt im Dokument der Nachricht
+    });
 }
@@ -0,0 +1,142 @@
+/**
+ * Unit-Test für die CaptureSchedule-Bibliothek (Zeitplan der Kamera)
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "CaptureSchedule.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+/**
+ * @brief Baut eine lokale Zeit (year = Jahre seit 1900, yday = Tag im Jahr ab 0).
+ */
+tm makeTime(const int year, const int yday, const int hour, const int minute, const int second = 0) {
+    tm timeInfo{};
+    timeInfo.tm_year = year;
+    timeInfo.tm_yday = yday;
+    timeInfo.tm_hour = hour;
+    timeInfo.tm_min = minute;
+    timeInfo.tm_sec = second;
+    return timeInfo;
+}
+
+/**
+ * @brief Spielt einen Tag in Minutenschritten durch und trägt die Minuten mit fälliger Aufnahme ein.
+ * @return Anzahl der Aufnahmen.
+ */
+int runDay(CaptureSchedule& schedule, const int yday, const int capturesPerDay, int* minutes, const int maxMinutes) {
+    int count = 0;
+    for (int minute = 0; minute < 24 * 60; minute++) {
+        if (schedule.isDue(makeTime(125, yday, minute / 60, minute % 60), capturesPerDay)) {
+            if (count < maxMinutes) {
+                minutes[count] = minute;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+void test_captures_are_spread_over_the_day() {
+    CaptureSchedule schedule;
+    int minutes[8] = {};
+    TEST_ASSERT_EQUAL_INT(4, runDay(schedule, 10, 4, minutes, 8));
+    TEST_ASSERT_EQUAL_INT(0, minutes[0]);
+    TEST_ASSERT_EQUAL_INT(6 * 60, minutes[1]);
+    TEST_ASSERT_EQUAL_INT(12 * 60, minutes[2]);
+    TEST_ASSERT_EQUAL_INT(18 * 60, minutes[3]);
+    TEST_ASSERT_EQUAL_INT(4, schedule.getCapturesToday());
+
+    // Der nächste Tag beginnt wieder um Mitternacht
+    TEST_ASSERT_EQUAL_INT(4, runDay(schedule, 11, 4, minutes, 8));
+    TEST_ASSERT_EQUAL_INT(0, minutes[0]);
+}
+
+void test_restart_does_not_catch_up() {
+    CaptureSchedule schedule;
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 10, 18, 30), 4)); // Neustart: ein Bild sofort
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 10, 18, 30, 1), 4)); // nicht die verpassten von 0, 6 und 12 Uhr
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 10, 23, 59, 59), 4));
+    TEST_ASSERT_EQUAL_INT(1, schedule.getCapturesToday());
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 11, 0, 0), 4));
+}
+
+void test_clock_jump_gives_one_capture() {
+    CaptureSchedule schedule;
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 10, 1, 0), 4));
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 10, 19, 0), 4)); // Uhr springt über drei Abschnitte
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 10, 19, 1), 4));
+}
+
+void test_new_year_starts_a_new_day() {
+    CaptureSchedule schedule;
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 364, 23, 0), 1));
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 364, 23, 59), 1));
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(126, 0, 0, 0), 1)); // 1. Januar, tm_yday = 0
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(126, 0, 12, 0), 1));
+}
+
+void test_zero_disables_captures() {
+    CaptureSchedule schedule;
+    int minutes[1] = {};
+    TEST_ASSERT_EQUAL_INT(0, runDay(schedule, 10, 0, minutes, 1));
+    TEST_ASSERT_EQUAL_INT(0, schedule.getCapturesToday());
+}
+
+void test_changed_count_applies_from_next_slot() {
+    CaptureSchedule schedule;
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 10, 0, 0), 1));
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 10, 13, 0), 1));
+
+    // 1 -> 4 pro Tag um 13 Uhr: kein Nachholen von 6 und 12 Uhr, nächste Aufnahme um 18 Uhr
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 10, 13, 1), 4));
+    TEST_ASSERT_FALSE(schedule.isDue(makeTime(125, 10, 17, 59, 59), 4));
+    TEST_ASSERT_TRUE(schedule.isDue(makeTime(125, 10, 18, 0), 4));
+    TEST_ASSERT_EQUAL_INT(2, schedule.getCapturesToday());
+}
+
+#if defined(NATIVE)
+void test_schedule_with_virtual_wall_clock() {
+    HostHal& hal = HostHal::instance();
+    hal.reset();
+    CaptureSchedule schedule;
+    tm timeInfo{};
+    TEST_ASSERT_FALSE(Hal::get().getLocalTime(timeInfo)); // noch nicht synchronisiert
+
+    hal.setWallClock(1735689600); // 2025-01-01 00:00:00 UTC
+    TEST_ASSERT_TRUE(Hal::get().getLocalTime(timeInfo));
+    TEST_ASSERT_EQUAL_INT(125, timeInfo.tm_year);
+    TEST_ASSERT_EQUAL_INT(0, timeInfo.tm_yday);
+    TEST_ASSERT_EQUAL_INT(0, timeInfo.tm_hour);
+
+    // Zwei Tage im Takt des Steuerungs-Tasks (50 ms), zusammen nur einige Millisekunden Rechenzeit
+    int captures = 0;
+    for (uint32_t cycle = 0; cycle < 2 * 86400 * 20; cycle++) {
+        if (Hal::get().getLocalTime(timeInfo) && schedule.isDue(timeInfo, 6)) {
+            captures++;
+        }
+        delay(50);
+    }
+    TEST_ASSERT_EQUAL_INT(12, captures);
+    TEST_ASSERT_EQUAL_INT(1735689600 + 2 * 86400, static_cast<int>(Hal::get().time()));
+}
+#endif
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_captures_are_spread_over_the_day);
+    RUN_TEST(test_restart_does_not_catch_up);
+    RUN_TEST(test_clock_jump_gives_one_capture);
+    RUN_TEST(test_new_year_starts_a_new_day);
+    RUN_TEST(test_zero_disables_captures);
+    RUN_TEST(test_changed_count_applies_from_next_slot);
+#if defined(NATIVE)
+    RUN_TEST(test_schedule_with_virtual_wall_clock);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
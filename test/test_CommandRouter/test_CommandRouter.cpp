@@ -0,0 +1,123 @@
+/**
+ * Unit-Test für die CommandRouter-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <unity.h>
+#include "CommandRouter.h"
+
+struct Calls {
+    int count = 0;
+    int value = 0;
+};
+
+struct LevelCommand {
+    int level;
+
+    bool read(const JsonObject payload) {
+        level = payload["level"] | -1;
+        return level >= 0 && level <= 100;
+    }
+};
+
+void handleLevel(Calls* calls, const LevelCommand& command) {
+    calls->count++;
+    calls->value = command.level;
+}
+
+constexpr NamedValue<int> MODES[] = {
+    {"auto", 0},
+    {"on", 1},
+    {"off", 2},
+};
+
+void test_fnv1a() {
+    static_assert(fnv1a("") == 2166136261u, "FNV-1a Startwert");
+    static_assert(fnv1a("a") == 0xE40C292Cu, "FNV-1a Referenzwert");
+    TEST_ASSERT_EQUAL_HEX32(0xE40C292C, fnv1a("a"));
+}
+
+void test_dispatch() {
+    CommandRouter<Calls*> router;
+    TEST_ASSERT_TRUE(router.on("ping", [](Calls* calls, JsonObject) { calls->count++; }));
+    TEST_ASSERT_TRUE(router.on("echo", [](Calls* calls, const JsonObject payload) {
+        calls->count++;
+        calls->value = payload["value"] | 0;
+    }));
+    TEST_ASSERT_EQUAL_UINT8(2, router.getCount());
+
+    JsonDocument doc;
+    deserializeJson(doc, R"({"type":"echo","payload":{"value":42}})");
+    Calls calls;
+    TEST_ASSERT_TRUE(router.dispatch(doc["type"], &calls, doc["payload"]) == CommandRouter<Calls*>::Result::Handled);
+    TEST_ASSERT_EQUAL_INT(1, calls.count);
+    TEST_ASSERT_EQUAL_INT(42, calls.value);
+
+    // Nachricht ohne Nutzdaten
+    TEST_ASSERT_TRUE(router.dispatch("ping", &calls, JsonObject()) == CommandRouter<Calls*>::Result::Handled);
+    TEST_ASSERT_EQUAL_INT(2, calls.count);
+}
+
+void test_unknown_type() {
+    CommandRouter<Calls*> router;
+    router.on("ping", [](Calls* calls, JsonObject) { calls->count++; });
+
+    Calls calls;
+    TEST_ASSERT_TRUE(router.dispatch("pong", &calls, JsonObject()) == CommandRouter<Calls*>::Result::Unknown);
+    TEST_ASSERT_TRUE(router.dispatch(nullptr, &calls, JsonObject()) == CommandRouter<Calls*>::Result::Unknown);
+    TEST_ASSERT_FALSE(router.contains("pin"));
+    TEST_ASSERT_EQUAL_INT(0, calls.count);
+}
+
+void test_typed_payload() {
+    CommandRouter<Calls*> router;
+    TEST_ASSERT_TRUE(router.on("level", handleLevel));
+
+    JsonDocument doc;
+    Calls calls;
+    deserializeJson(doc, R"({"level":75})");
+    TEST_ASSERT_TRUE(router.dispatch("level", &calls, doc.as<JsonObject>()) == CommandRouter<Calls*>::Result::Handled);
+    TEST_ASSERT_EQUAL_INT(75, calls.value);
+
+    // Ungültige Nutzdaten erreichen den Handler nicht
+    deserializeJson(doc, R"({"level":150})");
+    TEST_ASSERT_TRUE(router.dispatch("level", &calls, doc.as<JsonObject>()) ==
+                     CommandRouter<Calls*>::Result::InvalidPayload);
+    TEST_ASSERT_EQUAL_INT(1, calls.count);
+}
+
+void test_duplicate_and_capacity() {
+    CommandRouter<Calls*, 3> router;
+    TEST_ASSERT_TRUE(router.on("a", [](Calls*, JsonObject) {}));
+    TEST_ASSERT_FALSE(router.on("a", [](Calls*, JsonObject) {})); // doppelt
+    TEST_ASSERT_TRUE(router.on("b", [](Calls*, JsonObject) {}));
+    TEST_ASSERT_TRUE(router.on("c", [](Calls*, JsonObject) {}));
+    TEST_ASSERT_FALSE(router.on("d", [](Calls*, JsonObject) {})); // voll
+    TEST_ASSERT_EQUAL_UINT8(3, router.getCount());
+    TEST_ASSERT_TRUE(router.contains("a"));
+    TEST_ASSERT_TRUE(router.contains("c"));
+    TEST_ASSERT_FALSE(router.contains("d"));
+}
+
+void test_find_by_name() {
+    const int* mode = findByName(MODES, "off");
+    TEST_ASSERT_NOT_NULL(mode);
+    TEST_ASSERT_EQUAL_INT(2, *mode);
+    TEST_ASSERT_NULL(findByName(MODES, "of"));
+    TEST_ASSERT_NULL(findByName(MODES, nullptr));
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_fnv1a);
+    RUN_TEST(test_dispatch);
+    RUN_TEST(test_unknown_type);
+    RUN_TEST(test_typed_payload);
+    RUN_TEST(test_duplicate_and_capacity);
+    RUN_TEST(test_find_by_name);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,221 @@
+/**
+ * Unit-Test für die Controller-Bibliothek (Steuerungslogik der Aktoren)
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "config.h"
+#include "Controller.h"
+
+Relay lamp1(PIN_LAMP1_RELAY);
+Relay lamp2(PIN_LAMP2_RELAY);
+Relay heater(PIN_HEATER_RELAY);
+Relay fan(PIN_FAN_RELAY);
+Relay pump(PIN_PUMP_RELAY);
+Relay mister(PIN_MISTER_RELAY);
+
+Controller controller(lamp1, lamp2, heater, fan, pump, mister);
+
+/**
+ * @brief Messwerte, bei denen im Automatikbetrieb nichts schaltet (Tag, hell, alles im Zielbereich).
+ */
+SensorSnapshot calmSensors() {
+    SensorSnapshot sensors;
+    sensors.airTemp = 22.0f;
+    sensors.humidity = 72.0f;
+    sensors.soilTemp = 24.2f;
+    sensors.soilMoisture = 60;
+    sensors.waterLevelOk = true;
+    sensors.lightLux = 500.0f;
+    return sensors;
+}
+
+void setUp() {
+    for (Relay* relay : {&lamp1, &lamp2, &heater, &fan, &pump, &mister}) {
+        relay->begin();
+    }
+}
+
+void tearDown() {}
+
+void test_calm_sensors_switch_nothing() {
+    controller.update(calmSensors(), Settings(), 12);
+    TEST_ASSERT_FALSE(lamp1.isOn());
+    TEST_ASSERT_FALSE(lamp2.isOn());
+    TEST_ASSERT_FALSE(heater.isOn());
+    TEST_ASSERT_FALSE(fan.isOn());
+    TEST_ASSERT_FALSE(pump.isOn());
+    TEST_ASSERT_FALSE(mister.isOn());
+}
+
+void test_lamp_follows_hours_and_lux_hysteresis() {
+    const Settings settings;
+    SensorSnapshot sensors = calmSensors();
+
+    sensors.lightLux = 2.0f; // dunkler als light1LuxThresholdDark
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(lamp1.isOn());
+    TEST_ASSERT_TRUE(lamp2.isOn());
+
+    sensors.lightLux = 10.0f; // im Hysterese-Bereich: bleibt an
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(lamp1.isOn());
+
+    sensors.lightLux = 20.0f; // heller als light1LuxThresholdBright
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(lamp1.isOn());
+
+    sensors.lightLux = 10.0f; // im Hysterese-Bereich: bleibt aus
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(lamp1.isOn());
+
+    sensors.lightLux = NAN; // Sensorausfall: im Zweifel an
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(lamp1.isOn());
+
+    controller.update(sensors, settings, settings.light1OffHour); // Nachtzeit
+    TEST_ASSERT_FALSE(lamp1.isOn());
+}
+
+void test_heater_hysteresis() {
+    Settings settings;
+    SensorSnapshot sensors = calmSensors();
+
+    sensors.soilTemp = settings.soilTempTarget - 0.1f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(heater.isOn());
+
+    sensors.soilTemp = settings.soilTempTarget + 0.3f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(heater.isOn());
+
+    sensors.soilTemp = settings.soilTempTarget + 0.6f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(heater.isOn());
+}
+
+void test_missing_readings_switch_off() {
+    Settings settings;
+    SensorSnapshot sensors = calmSensors();
+    sensors.soilTemp = settings.soilTempTarget - 1.0f;
+    sensors.humidity = settings.humidityTarget - 1.0f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(heater.isOn());
+    TEST_ASSERT_TRUE(mister.isOn());
+
+    // Deadline verpasst: der alte Wert darf Heizung und Vernebler nicht eingeschaltet lassen
+    sensors.apply(FIELD_SOIL_TEMP, NAN);
+    sensors.apply(FIELD_HUMIDITY, NAN);
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(heater.isOn());
+    TEST_ASSERT_FALSE(mister.isOn());
+}
+
+void test_fan_pulses_when_too_warm() {
+    Settings settings;
+    settings.fanCooldownDurationMs = 100;
+    SensorSnapshot sensors = calmSensors();
+
+    sensors.airTemp = settings.airTempThresholdHigh + 1.0f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(fan.isOn());
+
+    sensors.airTemp = settings.airTempThresholdHigh - 1.0f;
+    delay(150);
+    controller.update(sensors, settings, 12); // Puls abgelaufen
+    TEST_ASSERT_FALSE(fan.isOn());
+}
+
+void test_pump_needs_water_and_valid_moisture() {
+    Settings settings;
+    settings.wateringDurationMs = 100;
+    SensorSnapshot sensors = calmSensors();
+
+    sensors.soilMoisture = -1; // ungültig: nicht gießen
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(pump.isOn());
+
+    sensors.soilMoisture = settings.soilMoistureTarget - 10;
+    sensors.waterLevelOk = false; // Tank leer: nicht gießen
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(pump.isOn());
+
+    sensors.waterLevelOk = true;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(pump.isOn());
+
+    delay(150);
+    controller.update(sensors, settings, Controller::UNKNOWN_HOUR); // Pulse enden auch ohne Uhrzeit
+    TEST_ASSERT_FALSE(pump.isOn());
+
+    settings.pumpMode = MODE_ON;
+    sensors.waterLevelOk = false; // auch "immer an" nur mit Wasser
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(pump.isOn());
+}
+
+void test_mister_hysteresis_and_water() {
+    Settings settings;
+    SensorSnapshot sensors = calmSensors();
+
+    sensors.humidity = settings.humidityTarget - 1.0f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(mister.isOn());
+
+    sensors.humidity = settings.humidityTarget + 4.0f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_TRUE(mister.isOn());
+
+    sensors.humidity = settings.humidityTarget + 6.0f;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(mister.isOn());
+
+    sensors.humidity = settings.humidityTarget - 1.0f;
+    sensors.waterLevelOk = false;
+    controller.update(sensors, settings, 12);
+    TEST_ASSERT_FALSE(mister.isOn());
+}
+
+void test_manual_modes() {
+    Settings settings;
+    settings.lamp1Mode = MODE_ON;
+    settings.heaterMode = MODE_ON;
+    settings.fanMode = MODE_ON;
+    settings.misterMode = MODE_OFF;
+    SensorSnapshot sensors = calmSensors();
+    sensors.humidity = 10.0f;
+
+    controller.update(sensors, settings, 3);
+    TEST_ASSERT_TRUE(lamp1.isOn());
+    TEST_ASSERT_TRUE(heater.isOn());
+    TEST_ASSERT_TRUE(fan.isOn());
+    TEST_ASSERT_FALSE(mister.isOn());
+}
+
+void test_unknown_hour_keeps_state() {
+    Settings settings;
+    settings.lamp1Mode = MODE_ON;
+    controller.update(calmSensors(), settings, 12);
+    TEST_ASSERT_TRUE(lamp1.isOn());
+
+    settings.lamp1Mode = MODE_OFF;
+    controller.update(calmSensors(), settings, Controller::UNKNOWN_HOUR);
+    TEST_ASSERT_TRUE(lamp1.isOn());
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_calm_sensors_switch_nothing);
+    RUN_TEST(test_lamp_follows_hours_and_lux_hysteresis);
+    RUN_TEST(test_heater_hysteresis);
+    RUN_TEST(test_missing_readings_switch_off);
+    RUN_TEST(test_fan_pulses_when_too_warm);
+    RUN_TEST(test_pump_needs_water_and_valid_moisture);
+    RUN_TEST(test_mister_hysteresis_and_water);
+    RUN_TEST(test_manual_modes);
+    RUN_TEST(test_unknown_hour_keeps_state);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,103 @@
+/**
+ * Unit-Test für die FrameRing-Bibliothek
+ *
+ * Es muss keine Kamera angeschlossen sein, die Bilder werden mit Testdaten gefüllt.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "FrameRing.h"
+
+constexpr uint8_t SLOTS = 3;
+constexpr size_t SLOT_SIZE = 1024;
+
+FrameRing frames;
+
+/**
+ * @brief Schreibt ein Testbild (Inhalt = fill) in den Ringpuffer.
+ * @return Laufende Nummer, oder 0, wenn kein Slot frei war.
+ */
+uint32_t writeFrame(const uint8_t fill, const size_t size) {
+    uint8_t* buffer = frames.beginWrite();
+    if (!buffer) {
+        return 0;
+    }
+    memset(buffer, fill, size);
+    return frames.commit(size);
+}
+
+void test_begin() {
+    TEST_ASSERT_EQUAL_UINT8(SLOTS, frames.getSlotCount());
+    TEST_ASSERT_EQUAL(SLOT_SIZE, frames.getSlotSize());
+    TEST_ASSERT_FALSE(static_cast<bool>(frames.latest())); // noch kein Bild
+}
+
+void test_commit_and_latest() {
+    const uint32_t seq = writeFrame(0xAA, 100);
+    TEST_ASSERT_EQUAL_UINT32(1, seq);
+
+    const FrameRing::Ref frame = frames.latest();
+    TEST_ASSERT_TRUE(static_cast<bool>(frame));
+    TEST_ASSERT_EQUAL_UINT32(seq, frame.seq());
+    TEST_ASSERT_EQUAL(100, frame.size());
+    TEST_ASSERT_EQUAL_HEX8(0xAA, frame.data()[99]);
+}
+
+void test_oldest_frame_is_overwritten() {
+    const uint32_t first = frames.getLatestSeq();
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        writeFrame(i, 10);
+    }
+    TEST_ASSERT_FALSE(static_cast<bool>(frames.get(first))); // überschrieben
+    TEST_ASSERT_TRUE(static_cast<bool>(frames.get(first + 1)));
+}
+
+void test_pinned_frame_survives() {
+    const FrameRing::Ref pinned = frames.latest();
+    const uint32_t seq = pinned.seq();
+
+    // Mehr Bilder schreiben als Slots vorhanden sind
+    for (uint8_t i = 0; i < SLOTS * 2; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, writeFrame(0x55, 20));
+    }
+    TEST_ASSERT_TRUE(static_cast<bool>(frames.get(seq)));
+    TEST_ASSERT_EQUAL_UINT32(seq, pinned.seq());
+}
+
+void test_all_pinned() {
+    FrameRing::Ref refs[SLOTS];
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        refs[i] = frames.get(writeFrame(i, 10));
+        TEST_ASSERT_TRUE(static_cast<bool>(refs[i]));
+    }
+    TEST_ASSERT_NULL(frames.beginWrite());
+
+    // Nach dem Freigeben ist wieder ein Slot frei
+    refs[0].reset();
+    TEST_ASSERT_NOT_NULL(frames.beginWrite());
+    frames.abort();
+}
+
+void test_abort() {
+    const uint32_t latest = frames.getLatestSeq();
+    TEST_ASSERT_NOT_NULL(frames.beginWrite());
+    frames.abort();
+    TEST_ASSERT_EQUAL_UINT32(latest, frames.getLatestSeq());
+    TEST_ASSERT_EQUAL_UINT32(latest, frames.latest().seq());
+}
+
+void setup() {
+    delay(2000);
+    frames.begin(SLOTS, SLOT_SIZE);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_begin);
+    RUN_TEST(test_commit_and_latest);
+    RUN_TEST(test_oldest_frame_is_overwritten);
+    RUN_TEST(test_pinned_frame_survives);
+    RUN_TEST(test_all_pinned);
+    RUN_TEST(test_abort);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,205 @@
+/**
+ * Unit-Test für die GreenhouseSim-Bibliothek (nur im nativen Build: pio test -e native -f test_GreenhouseSim)
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "GreenhouseRig.h"
+
+constexpr uint8_t LAMP1_PIN = 14;
+constexpr uint8_t HEATER_PIN = 26;
+constexpr uint8_t PUMP_PIN = 33;
+
+/**
+ * @brief Stellt die virtuelle Uhr vor und führt das Modell nach.
+ */
+void runFor(GreenhouseSim& sim, const double seconds) {
+    HostHal::instance().advance(static_cast<uint64_t>(seconds * 1e6));
+    sim.update();
+}
+
+void setUp() {
+    HostHal::instance().reset();
+}
+
+void tearDown() {}
+
+void test_daylight_follows_day_curve() {
+    const Settings settings;
+    GreenhouseSim sim(settings);
+    sim.begin();
+    TEST_ASSERT_EQUAL_INT(0, sim.getHour());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, sim.getState().lux);
+
+    runFor(sim, 13 * 3600.0); // Mittag
+    TEST_ASSERT_EQUAL_INT(13, sim.getHour());
+    TEST_ASSERT_FLOAT_WITHIN(50.0f, 2000.0f, sim.getState().lux);
+
+    runFor(sim, 8 * 3600.0); // 21 Uhr
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, sim.getState().lux);
+}
+
+void test_sensors_read_model_values() {
+    const Settings settings;
+    GreenhouseSim sim(settings);
+    sim.begin();
+
+    SensorAM2302 air(13);
+    SensorDS18B20 soilTemp(4);
+    SensorCapacitiveSoil soilMoisture(34);
+    SensorXKCY25NPN waterLevel(35);
+    TEST_ASSERT_TRUE(air.begin());
+    TEST_ASSERT_TRUE(soilTemp.begin());
+    TEST_ASSERT_TRUE(soilMoisture.begin());
+    TEST_ASSERT_TRUE(waterLevel.begin());
+
+    TEST_ASSERT_TRUE(air.read(1));
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, sim.getState().airTemp, air.getTemperature());
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, sim.getState().humidity, air.getHumidity());
+    TEST_ASSERT_TRUE(soilTemp.read());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, sim.getState().soilTemp, soilTemp.getTemperature());
+    TEST_ASSERT_TRUE(soilMoisture.read());
+    TEST_ASSERT_INT_WITHIN(1, static_cast<int>(sim.getState().soilMoisture), soilMoisture.getPercent());
+    TEST_ASSERT_TRUE(waterLevel.read());
+    TEST_ASSERT_TRUE(waterLevel.isWaterDetected());
+}
+
+void test_heater_warms_soil() {
+    const Settings settings;
+    Relay heater(HEATER_PIN);
+    heater.begin();
+    GreenhouseSim sim(settings);
+    sim.begin();
+    const float before = sim.getState().soilTemp;
+
+    heater.on();
+    runFor(sim, 2 * 3600.0);
+    const float heated = sim.getState().soilTemp;
+    TEST_ASSERT_GREATER_THAN(before + 3.0f, heated);
+
+    heater.off();
+    runFor(sim, 4 * 3600.0);
+    TEST_ASSERT_LESS_THAN(heated - 2.0f, sim.getState().soilTemp);
+}
+
+void test_soil_dries_and_pump_waters() {
+    const Settings settings;
+    Relay pump(PUMP_PIN);
+    pump.begin();
+    GreenhouseSim sim(settings);
+    sim.begin();
+    const float start = sim.getState().soilMoisture;
+
+    runFor(sim, 86400.0);
+    const float dried = sim.getState().soilMoisture;
+    TEST_ASSERT_LESS_THAN(start - 8.0f, dried);
+
+    pump.on();
+    runFor(sim, 10.0); // 250 ml
+    pump.off();
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 4000.0f - 250.0f, sim.getState().tankMl);
+    runFor(sim, 1800.0); // versickern lassen
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, dried + 10.0f, sim.getState().soilMoisture);
+}
+
+void test_report_counts_duty_and_switches() {
+    const Settings settings;
+    Relay lamp1(LAMP1_PIN);
+    lamp1.begin();
+    GreenhouseSim sim(settings);
+    sim.begin();
+
+    runFor(sim, 6 * 3600.0);
+    lamp1.on();
+    runFor(sim, 6 * 3600.0);
+    lamp1.off();
+    TEST_ASSERT_EQUAL_UINT32(0, sim.getReports().size());
+    runFor(sim, 12 * 3600.0);
+
+    TEST_ASSERT_EQUAL_UINT32(1, sim.getReports().size());
+    const GreenhouseSim::DayReport& report = sim.getReports()[0];
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.25f, report.duty(GreenhouseSim::LAMP1));
+    TEST_ASSERT_EQUAL_UINT32(2, report.switches[GreenhouseSim::LAMP1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, report.duty(GreenhouseSim::HEATER));
+    TEST_ASSERT_EQUAL_UINT32(0, report.switches[GreenhouseSim::PUMP]);
+}
+
+void test_closed_loop_holds_targets() {
+    GreenhouseRig rig;
+    TEST_ASSERT_TRUE(rig.begin());
+    rig.runDays(2);
+
+    const std::vector<GreenhouseSim::DayReport>& reports = rig.getSim().getReports();
+    TEST_ASSERT_EQUAL_UINT32(2, reports.size());
+    const GreenhouseSim::DayReport& day = reports[1]; // Tag 1 enthält das Aufheizen nach dem Start
+    GreenhouseSim::printReport(day);
+
+    TEST_ASSERT_LESS_THAN(0.5f, day.soilTempUndershoot);
+    TEST_ASSERT_LESS_THAN(1.0f, day.airTempOvershoot);
+    TEST_ASSERT_LESS_THAN(2.0f, day.soilMoistureUndershoot);
+    TEST_ASSERT_GREATER_THAN(0u, day.switches[GreenhouseSim::HEATER]);
+    TEST_ASSERT_GREATER_THAN(0u, day.switches[GreenhouseSim::PUMP]);
+    TEST_ASSERT_GREATER_THAN(0.0f, day.pumpWaterMl);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, day.tankEmptySeconds);
+
+    // Die Lampen brennen nur morgens und abends, wenn es dunkel und noch "Tag" ist (6-7 Uhr und 19-20 Uhr)
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, 2.0f / 24.0f, day.duty(GreenhouseSim::LAMP1));
+    TEST_ASSERT_EQUAL_UINT32(4, day.switches[GreenhouseSim::LAMP1]);
+}
+
+void test_empty_tank_stops_pump_and_mister() {
+    GreenhouseSim::Params params;
+    params.tankCapacity = 600.0f; // 200 ml über dem Füllstandsensor
+    GreenhouseRig rig(Settings(), params);
+    TEST_ASSERT_TRUE(rig.begin());
+    rig.runDays(1);
+
+    const GreenhouseSim::DayReport& day = rig.getSim().getReports()[0];
+    TEST_ASSERT_GREATER_THAN(0.0f, day.tankEmptySeconds);
+    // Nach der letzten Meldung "Wasser da" läuft höchstens noch ein Gießpuls (5 s * 25 ml/s)
+    TEST_ASSERT_GREATER_THAN(400.0f - 125.0f - 1.0f, rig.getSim().getState().tankMl);
+}
+
+void test_failed_sensor_becomes_invalid() {
+    GreenhouseRig rig;
+    TEST_ASSERT_TRUE(rig.begin());
+    rig.run(10.0);
+    TEST_ASSERT_TRUE(rig.getSensors().isValid(FIELD_SOIL_TEMP));
+
+    // Intervall (5 s) plus Deadline (2 s) ohne Messwert: der alte Wert darf die Heizung nicht weiter steuern
+    rig.getSim().setSoilTempConnected(false);
+    rig.run(8.0);
+    TEST_ASSERT_FALSE(rig.getSensors().isValid(FIELD_SOIL_TEMP));
+    TEST_ASSERT_TRUE(isnan(rig.getSensors().soilTemp));
+    TEST_ASSERT_TRUE(rig.getSensors().isValid(FIELD_AIR_TEMP));
+
+    rig.getSim().setSoilTempConnected(true);
+    rig.run(6.0);
+    TEST_ASSERT_TRUE(rig.getSensors().isValid(FIELD_SOIL_TEMP));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, rig.getSim().getState().soilTemp, rig.getSensors().soilTemp);
+}
+
+void test_runs_much_faster_than_real_time() {
+    GreenhouseRig rig;
+    TEST_ASSERT_TRUE(rig.begin());
+    const GreenhouseRig::RunResult result = rig.run(6 * 3600.0);
+    TEST_ASSERT_EQUAL_UINT32(6 * 3600 * 1000 / 50, result.cycles);
+    TEST_ASSERT_GREATER_THAN(1000.0, result.speedup());
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_daylight_follows_day_curve);
+    RUN_TEST(test_sensors_read_model_values);
+    RUN_TEST(test_heater_warms_soil);
+    RUN_TEST(test_soil_dries_and_pump_waters);
+    RUN_TEST(test_report_counts_duty_and_switches);
+    RUN_TEST(test_closed_loop_holds_targets);
+    RUN_TEST(test_empty_tank_stops_pump_and_mister);
+    RUN_TEST(test_failed_sensor_becomes_invalid);
+    RUN_TEST(test_runs_much_faster_than_real_time);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,229 @@
+/**
+ * Unit-Test für die ImageIndex-Bibliothek
+ *
+ * Der Index liegt für den Test im LittleFS (keine SD-Karte nötig).
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "ImageIndex.h"
+
+const char* INDEX_PATH = "/test_images.idx";
+
+ImageIndex imageIndex(LittleFS, INDEX_PATH);
+
+/**
+ * @brief Legt einen leeren Index mit count Bildern an ("/img_000.jpg" mit Zeit 1000 bis ...).
+ */
+void fillIndex(const int count) {
+    TEST_ASSERT_TRUE(imageIndex.clear());
+    char path[ImageIndex::PATH_LENGTH];
+    for (int i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "/img_%03d.jpg", i);
+        TEST_ASSERT_TRUE(imageIndex.add(path, 1000 + i, 100 + i));
+    }
+}
+
+void test_begin_creates_missing_file() {
+    LittleFS.remove(INDEX_PATH);
+    TEST_ASSERT_FALSE(imageIndex.begin());
+    TEST_ASSERT_TRUE(LittleFS.exists(INDEX_PATH));
+    TEST_ASSERT_EQUAL_UINT32(0, imageIndex.getCount());
+}
+
+void test_first_page_is_newest() {
+    fillIndex(40);
+    ImageIndex::Entry page[10];
+    uint32_t next = 0;
+    const uint16_t count = imageIndex.getPage(ImageIndex::NO_CURSOR, 10, page, next);
+    TEST_ASSERT_EQUAL_UINT16(10, count);
+    TEST_ASSERT_EQUAL_STRING("/img_039.jpg", page[0].path);
+    TEST_ASSERT_EQUAL_UINT32(1039, page[0].time);
+    TEST_ASSERT_EQUAL_UINT32(139, page[0].size);
+    TEST_ASSERT_EQUAL_STRING("/img_030.jpg", page[9].path);
+    TEST_ASSERT_NOT_EQUAL(ImageIndex::NO_CURSOR, next);
+}
+
+void test_cursor_walks_all_pages() {
+    fillIndex(40);
+    ImageIndex::Entry page[15];
+    uint32_t cursor = ImageIndex::NO_CURSOR;
+    int total = 0;
+    int pages = 0;
+    uint32_t lastTime = UINT32_MAX;
+    do {
+        const uint16_t count = imageIndex.getPage(cursor, 15, page, cursor);
+        for (uint16_t i = 0; i < count; i++) {
+            TEST_ASSERT_TRUE(page[i].time < lastTime); // lückenlos absteigend
+            lastTime = page[i].time;
+        }
+        total += count;
+        pages++;
+    } while (cursor != ImageIndex::NO_CURSOR);
+    TEST_ASSERT_EQUAL_INT(40, total);
+    TEST_ASSERT_EQUAL_INT(3, pages);
+    TEST_ASSERT_EQUAL_UINT32(1000, lastTime);
+}
+
+void test_remove_skips_entry() {
+    fillIndex(20);
+    TEST_ASSERT_TRUE(imageIndex.remove("/img_019.jpg"));
+    TEST_ASSERT_FALSE(imageIndex.remove("/img_019.jpg")); // bereits gelöscht
+    TEST_ASSERT_EQUAL_UINT32(19, imageIndex.getCount());
+    TEST_ASSERT_EQUAL_UINT32(20, imageIndex.getSize());
+
+    ImageIndex::Entry page[5];
+    uint32_t next = 0;
+    imageIndex.getPage(ImageIndex::NO_CURSOR, 5, page, next);
+    TEST_ASSERT_EQUAL_STRING("/img_018.jpg", page[0].path);
+}
+
+void test_oldest_skips_removed() {
+    fillIndex(40);
+    ImageIndex::Entry batch[10];
+    uint32_t positions[10];
+    uint32_t next = 0;
+    TEST_ASSERT_EQUAL_UINT16(10, imageIndex.getOldest(ImageIndex::NO_CURSOR, 10, batch, positions, next));
+    TEST_ASSERT_EQUAL_STRING("/img_000.jpg", batch[0].path);
+    TEST_ASSERT_TRUE(imageIndex.removeAt(positions[0], batch[0].path));
+    TEST_ASSERT_TRUE(imageIndex.removeAt(positions[1], batch[1].path));
+    TEST_ASSERT_FALSE(imageIndex.removeAt(positions[1], batch[1].path)); // bereits gelöscht
+    TEST_ASSERT_FALSE(imageIndex.removeAt(positions[3], "/img_999.jpg")); // anderes Bild an der Position
+
+    // Nächster Block ab dem Cursor, danach wieder von vorne ohne die gelöschten
+    TEST_ASSERT_EQUAL_UINT16(10, imageIndex.getOldest(next, 10, batch, positions, next));
+    TEST_ASSERT_EQUAL_STRING("/img_010.jpg", batch[0].path);
+    TEST_ASSERT_EQUAL_UINT16(10, imageIndex.getOldest(ImageIndex::NO_CURSOR, 10, batch, positions, next));
+    TEST_ASSERT_EQUAL_STRING("/img_002.jpg", batch[0].path);
+    TEST_ASSERT_EQUAL_UINT32(38, imageIndex.getCount());
+}
+
+void test_bytes_follow_changes() {
+    fillIndex(3); // 100 + 101 + 102 Byte
+    TEST_ASSERT_EQUAL_UINT64(303, imageIndex.getBytes());
+    imageIndex.remove("/img_001.jpg");
+    TEST_ASSERT_EQUAL_UINT64(202, imageIndex.getBytes());
+
+    // Die veröffentlichte Kopie folgt jeder Änderung
+    const ImageIndex::Stats stats = imageIndex.getStats();
+    TEST_ASSERT_EQUAL_UINT64(202, stats.bytes);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.size);
+
+    ImageIndex reopened(LittleFS, INDEX_PATH);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT64(202, reopened.getBytes());
+}
+
+void test_reopen_keeps_entries() {
+    fillIndex(25);
+    imageIndex.remove("/img_000.jpg");
+
+    ImageIndex reopened(LittleFS, INDEX_PATH);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(24, reopened.getCount());
+    TEST_ASSERT_EQUAL_UINT32(25, reopened.getSize());
+
+    ImageIndex::Entry page[1];
+    uint32_t next = 0;
+    TEST_ASSERT_EQUAL_UINT16(1, reopened.getPage(ImageIndex::NO_CURSOR, 1, page, next));
+    TEST_ASSERT_EQUAL_STRING("/img_024.jpg", page[0].path);
+}
+
+void test_truncated_file_is_rejected() {
+    fillIndex(3);
+    File file = LittleFS.open(INDEX_PATH, "a");
+    file.write(reinterpret_cast<const uint8_t*>("abc"), 3); // halber Eintrag, z.B. nach Stromausfall
+    file.close();
+
+    ImageIndex reopened(LittleFS, INDEX_PATH);
+    TEST_ASSERT_FALSE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(0, reopened.getCount());
+}
+
+void test_first_page_comes_from_cache() {
+    fillIndex(40);
+    ImageIndex::Entry page[10];
+    uint32_t next = 0;
+    imageIndex.getPage(ImageIndex::NO_CURSOR, 10, page, next);
+    const uint32_t misses = imageIndex.getCacheMisses();
+    imageIndex.add("/img_new.jpg", 2000, 1);
+    imageIndex.getPage(ImageIndex::NO_CURSOR, 10, page, next);
+    TEST_ASSERT_EQUAL_UINT32(misses, imageIndex.getCacheMisses());
+    TEST_ASSERT_EQUAL_STRING("/img_new.jpg", page[0].path);
+}
+
+void test_rebuild_from_directory() {
+    LittleFS.mkdir("/test_images");
+    for (const char* path : {"/test_images/a.jpg", "/test_images/b.JPG", "/test_images/c.txt"}) {
+        File file = LittleFS.open(path, "w");
+        file.print("data");
+        file.close();
+    }
+    TEST_ASSERT_TRUE(imageIndex.rebuild("/test_images", ".jpg"));
+    TEST_ASSERT_EQUAL_UINT32(2, imageIndex.getCount());
+}
+
+void test_page_ends_at_oldest() {
+    fillIndex(20);
+    ImageIndex::Entry batch[10];
+    uint32_t positions[10];
+    uint32_t next = 0;
+    imageIndex.getOldest(ImageIndex::NO_CURSOR, 10, batch, positions, next);
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(imageIndex.removeAt(positions[i], batch[i].path)); // die ersten 10 Einträge sind gelöscht
+    }
+
+    // Die zweite Seite endet genau beim ältesten Bild, danach folgt keine (leere) Seite mehr
+    ImageIndex::Entry page[5];
+    TEST_ASSERT_EQUAL_UINT16(5, imageIndex.getPage(ImageIndex::NO_CURSOR, 5, page, next));
+    TEST_ASSERT_EQUAL_UINT16(5, imageIndex.getPage(next, 5, page, next));
+    TEST_ASSERT_EQUAL_STRING("/img_010.jpg", page[4].path);
+    TEST_ASSERT_EQUAL_UINT32(ImageIndex::NO_CURSOR, next);
+}
+
+void test_rebuild_in_steps_skips_added_images() {
+    LittleFS.mkdir("/test_steps");
+    LittleFS.mkdir("/test_steps/sub");
+    for (const char* path : {"/test_steps/a.jpg", "/test_steps/sub/b.jpg", "/test_steps/sub/c.jpg"}) {
+        File file = LittleFS.open(path, "w");
+        file.print("data");
+        file.close();
+    }
+    TEST_ASSERT_TRUE(imageIndex.startRebuild("/test_steps", ".jpg"));
+    TEST_ASSERT_FALSE(imageIndex.rebuildStep(0)); // je Zeitscheibe mindestens eine Datei
+
+    // Die Kamera trägt ein Bild ein, das die Suche noch vor sich hat
+    TEST_ASSERT_TRUE(imageIndex.add("/test_steps/sub/c.jpg", 3000, 4));
+    int steps = 1;
+    while (!imageIndex.rebuildStep(0)) {
+        steps++;
+    }
+    TEST_ASSERT_TRUE(steps > 2);
+    TEST_ASSERT_TRUE(imageIndex.isRebuildOk());
+    TEST_ASSERT_EQUAL_UINT32(3, imageIndex.getCount());
+    TEST_ASSERT_EQUAL_UINT32(3, imageIndex.getSize());
+}
+
+void setup() {
+    delay(2000);
+    LittleFS.begin(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_creates_missing_file);
+    RUN_TEST(test_first_page_is_newest);
+    RUN_TEST(test_cursor_walks_all_pages);
+    RUN_TEST(test_remove_skips_entry);
+    RUN_TEST(test_oldest_skips_removed);
+    RUN_TEST(test_bytes_follow_changes);
+    RUN_TEST(test_reopen_keeps_entries);
+    RUN_TEST(test_truncated_file_is_rejected);
+    RUN_TEST(test_first_page_comes_from_cache);
+    RUN_TEST(test_rebuild_from_directory);
+    RUN_TEST(test_page_ends_at_oldest);
+    RUN_TEST(test_rebuild_in_steps_skips_added_images);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,164 @@
+/**
+ * Unit-Test für die ImageRetention-Bibliothek
+ *
+ * Der Index liegt für den Test im LittleFS, die Bilddateien gibt es nicht (die Löschfunktion merkt sich nur die Pfade).
+ * Die Zeitzone ist UTC, damit die Tage im Test feststehen.
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <set>
+#include <string>
+#include "ImageIndex.h"
+#include "ImageRetention.h"
+
+constexpr uint32_t DAY = 86400;
+const uint32_t START = 1733356800; // 05.12.2024 0:00 UTC
+const uint32_t NOW = START + 10 * DAY;
+
+ImageIndex imageIndex(LittleFS, "/test_retention.idx");
+std::set<std::string> removed;
+std::set<std::string> locked; // Bilder, die sich nicht löschen lassen
+ImageRetention retention(imageIndex, [](const char* path) {
+    if (locked.count(path)) {
+        return false;
+    }
+    removed.insert(path);
+    return true;
+});
+
+/**
+ * @brief Legt 10 Tage mit je 4 Bildern (0, 6, 12 und 18 Uhr) zu 1000 Byte an ("/img/<Tag>/<Stunde>.jpg").
+ */
+void fillIndex() {
+    TEST_ASSERT_TRUE(imageIndex.clear());
+    removed.clear();
+    locked.clear();
+    char path[ImageIndex::PATH_LENGTH];
+    for (int day = 0; day < 10; day++) {
+        for (int hour = 0; hour < 24; hour += 6) {
+            snprintf(path, sizeof(path), "/img/%d/%02d.jpg", day, hour);
+            TEST_ASSERT_TRUE(imageIndex.add(path, START + day * DAY + hour * 3600, 1000));
+        }
+    }
+}
+
+/**
+ * @brief Führt einen Durchlauf in Zeitscheiben von 0 ms (ein Bild pro Aufruf) aus.
+ */
+void runToEnd() {
+    int slices = 0;
+    while (!retention.step(0)) {
+        TEST_ASSERT_LESS_THAN(1000, ++slices);
+    }
+}
+
+void test_max_age_deletes_old_days() {
+    fillIndex();
+    ImageRetention::Policy policy;
+    policy.maxAgeDays = 8; // Tage 0 und 1
+    retention.start(policy, NOW, 0, 0);
+    runToEnd();
+    TEST_ASSERT_EQUAL_UINT32(8, retention.getRun().deleted);
+    TEST_ASSERT_EQUAL_UINT64(8000, retention.getRun().reclaimedBytes);
+    TEST_ASSERT_EQUAL_UINT32(32, imageIndex.getCount());
+
+    // Kopie für andere Tasks
+    const ImageRetention::Stats stats = retention.getStats();
+    TEST_ASSERT_TRUE(stats.run.finished);
+    TEST_ASSERT_EQUAL_UINT32(8, stats.run.deleted);
+    TEST_ASSERT_EQUAL_UINT32(retention.getRunCount(), stats.runs);
+    TEST_ASSERT_EQUAL_UINT64(retention.getTotalReclaimedBytes(), stats.totalReclaimedBytes);
+    TEST_ASSERT_TRUE(removed.count("/img/1/18.jpg"));
+    TEST_ASSERT_FALSE(removed.count("/img/2/00.jpg"));
+}
+
+void test_thinning_keeps_noon_image() {
+    fillIndex();
+    ImageRetention::Policy policy;
+    policy.thinAfterDays = 5; // Tage 0 bis 4
+    retention.start(policy, NOW, 0, 0);
+    runToEnd();
+    TEST_ASSERT_EQUAL_UINT32(15, retention.getRun().deleted);
+    TEST_ASSERT_FALSE(removed.count("/img/3/12.jpg"));
+    TEST_ASSERT_TRUE(removed.count("/img/3/00.jpg"));
+    TEST_ASSERT_TRUE(removed.count("/img/3/18.jpg"));
+    TEST_ASSERT_FALSE(removed.count("/img/5/00.jpg"));
+}
+
+void test_thinning_keeps_image_that_cannot_be_deleted() {
+    fillIndex();
+    locked.insert("/img/0/00.jpg");
+    ImageRetention::Policy policy;
+    policy.thinAfterDays = 9; // nur Tag 0
+    retention.start(policy, NOW, 0, 0);
+    runToEnd();
+    // 0 Uhr bleibt ohnehin, daher ist es das Bild des Tages und wird nur einmal versucht
+    TEST_ASSERT_EQUAL_UINT32(1, retention.getRun().failed);
+    TEST_ASSERT_EQUAL_UINT32(3, retention.getRun().deleted);
+    TEST_ASSERT_TRUE(removed.count("/img/0/12.jpg"));
+    TEST_ASSERT_EQUAL_UINT32(37, imageIndex.getCount());
+}
+
+void test_second_run_stops_early() {
+    fillIndex();
+    ImageRetention::Policy policy;
+    policy.maxAgeDays = 8;
+    policy.thinAfterDays = 5;
+    retention.start(policy, NOW, 0, 0);
+    runToEnd();
+    retention.start(policy, NOW, 0, 0);
+    runToEnd();
+    TEST_ASSERT_EQUAL_UINT32(0, retention.getRun().deleted);
+    TEST_ASSERT_LESS_OR_EQUAL(4, retention.getRun().checked); // 3 ausgedünnte Tage und das erste neuere Bild
+}
+
+void test_watermark_deletes_oldest() {
+    fillIndex();
+    ImageRetention::Policy policy;
+    policy.minFreePercent = 10;
+    retention.start(policy, 0, 92500, 100000); // 7500 Byte frei, 10000 gewünscht
+    runToEnd();
+    TEST_ASSERT_EQUAL_UINT32(3, retention.getRun().deleted);
+    TEST_ASSERT_EQUAL_UINT64(0, retention.getRun().missingBytes);
+    TEST_ASSERT_TRUE(removed.count("/img/0/12.jpg"));
+    TEST_ASSERT_FALSE(removed.count("/img/0/18.jpg"));
+}
+
+void test_missing_bytes() {
+    ImageRetention::Policy policy;
+    TEST_ASSERT_EQUAL_UINT64(0, ImageRetention::getMissingBytes(policy, 1 << 30, 99, 100));
+    policy.maxImageMB = 1;
+    TEST_ASSERT_EQUAL_UINT64(10, ImageRetention::getMissingBytes(policy, 1048576 + 10, 0, 0));
+    policy.minFreePercent = 50;
+    TEST_ASSERT_EQUAL_UINT64(30, ImageRetention::getMissingBytes(policy, 0, 80, 100));
+}
+
+void test_no_policy_checks_one_image() {
+    fillIndex();
+    retention.start(ImageRetention::Policy(), NOW, 0, 0);
+    runToEnd();
+    TEST_ASSERT_EQUAL_UINT32(1, retention.getRun().checked);
+    TEST_ASSERT_EQUAL_UINT32(0, retention.getRun().deleted);
+}
+
+void setup() {
+    delay(2000);
+    LittleFS.begin(true);
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    imageIndex.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_max_age_deletes_old_days);
+    RUN_TEST(test_thinning_keeps_noon_image);
+    RUN_TEST(test_thinning_keeps_image_that_cannot_be_deleted);
+    RUN_TEST(test_second_run_stops_early);
+    RUN_TEST(test_watermark_deletes_oldest);
+    RUN_TEST(test_missing_bytes);
+    RUN_TEST(test_no_policy_checks_one_image);
+    UNITY_END();
+}
+
+void loop() {}
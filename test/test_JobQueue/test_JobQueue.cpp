@@ -0,0 +1,127 @@
+/**
+ * Unit-Test für die JobQueue-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "JobQueue.h"
+
+JobQueue jobQueue;
+
+// Zuletzt gemeldete Ereignisse (der Callback läuft im Worker-Task bzw. im Test selbst)
+constexpr int MAX_EVENTS = 32;
+JobQueue::Job events[MAX_EVENTS];
+volatile int eventCount = 0;
+
+void recordEvent(const JobQueue::Job& job) {
+    if (eventCount < MAX_EVENTS) {
+        events[eventCount] = job;
+        eventCount = eventCount + 1;
+    }
+}
+
+/**
+ * @brief Wartet, bis alle Aufträge abgeschlossen sind (höchstens timeoutMs).
+ */
+bool waitIdle(const unsigned long timeoutMs = 2000) {
+    const unsigned long start = millis();
+    while (jobQueue.getPendingCount() > 0) {
+        if (millis() - start > timeoutMs) {
+            return false;
+        }
+        delay(5);
+    }
+    return true;
+}
+
+void test_submit_returns_immediately() {
+    eventCount = 0;
+    const unsigned long start = millis();
+    const uint32_t id = jobQueue.submit("slow", 42, [](const JobQueue::Progress&) {
+        vTaskDelay(pdMS_TO_TICKS(200));
+        return true;
+    });
+    TEST_ASSERT_LESS_THAN_UINT32(20, millis() - start);
+    TEST_ASSERT_NOT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL_UINT32(id, jobQueue.findPending("slow"));
+
+    TEST_ASSERT_TRUE(waitIdle());
+    TEST_ASSERT_EQUAL_UINT32(0, jobQueue.findPending("slow"));
+
+    // eingereiht -> gestartet -> fertig, jeweils mit Nummer und Besitzer
+    TEST_ASSERT_EQUAL_INT(3, eventCount);
+    TEST_ASSERT_TRUE(events[0].state == JobQueue::State::Queued);
+    TEST_ASSERT_TRUE(events[1].state == JobQueue::State::Running);
+    TEST_ASSERT_TRUE(events[2].state == JobQueue::State::Done);
+    TEST_ASSERT_EQUAL_UINT32(id, events[2].id);
+    TEST_ASSERT_EQUAL_UINT32(42, events[2].owner);
+    TEST_ASSERT_EQUAL_STRING("slow", events[2].name);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(190, events[2].finishedAt - events[2].startedAt);
+}
+
+void test_progress_is_throttled() {
+    eventCount = 0;
+    const uint32_t failedBefore = jobQueue.getFailedCount();
+    jobQueue.submit("progress", 1, [](const JobQueue::Progress& progress) {
+        for (uint32_t i = 1; i <= 60; i++) {
+            progress(i, 60);
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        return false; // fehlgeschlagen
+    });
+    TEST_ASSERT_TRUE(waitIdle());
+
+    // 60 Schritte in ca. 600 ms ergeben nur zwei Fortschrittsmeldungen (alle 250 ms)
+    int progressEvents = 0;
+    for (int i = 0; i < eventCount; i++) {
+        if (events[i].state == JobQueue::State::Running && events[i].done > 0) {
+            progressEvents++;
+        }
+    }
+    TEST_ASSERT_INT_WITHIN(1, 2, progressEvents);
+    TEST_ASSERT_TRUE(events[eventCount - 1].state == JobQueue::State::Failed);
+    TEST_ASSERT_EQUAL_UINT32(60, events[eventCount - 1].done);
+    TEST_ASSERT_EQUAL_UINT32(failedBefore + 1, jobQueue.getFailedCount());
+}
+
+static SemaphoreHandle_t gate = nullptr;
+
+void test_reject_when_full() {
+    gate = xSemaphoreCreateBinary();
+    const uint32_t rejectedBefore = jobQueue.getRejectedCount();
+
+    // Der erste Auftrag blockiert den Worker, die übrigen bleiben eingereiht
+    for (uint8_t i = 0; i < JobQueue::MAX_JOBS; i++) {
+        const uint32_t id = jobQueue.submit("blocked", i, [](const JobQueue::Progress&) {
+            xSemaphoreTake(gate, pdMS_TO_TICKS(1000));
+            xSemaphoreGive(gate); // die nächsten dürfen direkt durch
+            return true;
+        });
+        TEST_ASSERT_NOT_EQUAL(0, id);
+    }
+    TEST_ASSERT_EQUAL_UINT8(JobQueue::MAX_JOBS, jobQueue.getPendingCount());
+    TEST_ASSERT_EQUAL_UINT32(0, jobQueue.submit("tooMany", 0, [](const JobQueue::Progress&) { return true; }));
+    TEST_ASSERT_EQUAL_UINT32(rejectedBefore + 1, jobQueue.getRejectedCount());
+
+    xSemaphoreGive(gate);
+    TEST_ASSERT_TRUE(waitIdle());
+    vSemaphoreDelete(gate);
+
+    // Danach ist wieder Platz
+    TEST_ASSERT_NOT_EQUAL(0, jobQueue.submit("again", 0, [](const JobQueue::Progress&) { return true; }));
+    TEST_ASSERT_TRUE(waitIdle());
+}
+
+void setup() {
+    delay(2000);
+    jobQueue.onEvent = recordEvent;
+    jobQueue.begin("jobs", 4096, 1, 0);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_submit_returns_immediately);
+    RUN_TEST(test_progress_is_throttled);
+    RUN_TEST(test_reject_when_full);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,140 @@
+/**
+ * Unit-Test für die JsonArena-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <unity.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include "JsonArena.h"
+
+constexpr int RUNS = 200; // Durchläufe für die Vergleichsmessung
+
+JsonArena arena;
+
+/**
+ * @brief Füllt ein Dokument ungefähr wie die Statusnachricht des Webinterfaces.
+ */
+void fillState(JsonDocument& doc) {
+    doc["type"] = "state";
+    const JsonObject values = doc["payload"].to<JsonObject>();
+    values["seq"] = 4711;
+    values["airTemp"] = 23.4;
+    values["humidity"] = 61.5;
+    values["soilTemp"] = 19.8;
+    values["soilMoisture"] = 42;
+    values["waterLevelOk"] = true;
+    values["lightLux"] = 1520.0;
+    const JsonObject spiWait = values["spiWait"].to<JsonObject>();
+    for (const char* name : {"camera", "sd", "batch"}) {
+        const JsonObject device = spiWait[name].to<JsonObject>();
+        device["count"] = 123;
+        device["contended"] = 4;
+        device["maxUs"] = 5678;
+    }
+}
+
+void test_allocate_and_reset() {
+    TEST_ASSERT_TRUE(arena.tryAcquire());
+    TEST_ASSERT_FALSE(arena.tryAcquire()); // schon vergeben
+
+    void* block = arena.allocate(10);
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT_EQUAL(0, reinterpret_cast<uintptr_t>(block) % JsonArena::ALIGNMENT);
+    TEST_ASSERT_EQUAL(JsonArena::ALIGNMENT + 16, arena.getUsed());
+
+    // Der letzte Block wächst an Ort und Stelle
+    TEST_ASSERT_EQUAL_PTR(block, arena.reallocate(block, 100));
+
+    arena.release();
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+    TEST_ASSERT_TRUE(arena.tryAcquire());
+    arena.release();
+}
+
+void test_overflow() {
+    TEST_ASSERT_TRUE(arena.tryAcquire());
+    const uint32_t failed = arena.getFailedCount();
+    TEST_ASSERT_NULL(arena.allocate(arena.getCapacity()));
+    TEST_ASSERT_EQUAL_UINT32(failed + 1, arena.getFailedCount());
+
+    {
+        JsonDocument doc(&arena);
+        const JsonArray array = doc.to<JsonArray>();
+        for (int i = 0; i < 2000; i++) {
+            array.add(i);
+        }
+        TEST_ASSERT_TRUE(doc.overflowed()); // kein Absturz, das Dokument meldet den Überlauf
+    }
+    arena.release();
+}
+
+void test_no_heap_while_serializing() {
+    // Während das Dokument lebt, darf sich der freie Heap nicht ändern
+    TEST_ASSERT_TRUE(arena.tryAcquire());
+    const size_t freeBefore = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    size_t freeDuring;
+    char buffer[512];
+    {
+        JsonDocument doc(&arena);
+        fillState(doc);
+        TEST_ASSERT_FALSE(doc.overflowed());
+        TEST_ASSERT_GREATER_THAN(0, serializeJson(doc, buffer, sizeof(buffer)));
+        freeDuring = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    }
+    arena.release();
+    TEST_ASSERT_EQUAL(freeBefore, freeDuring);
+    TEST_ASSERT_LESS_OR_EQUAL(arena.getCapacity(), arena.getHighWaterMark());
+}
+
+void test_benchmark_heap_vs_arena() {
+    char buffer[512];
+    uint32_t minFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    const int64_t heapStart = esp_timer_get_time();
+    for (int i = 0; i < RUNS; i++) {
+        JsonDocument doc;
+        fillState(doc);
+        String json;
+        serializeJson(doc, json);
+        const uint32_t free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+        minFree = free < minFree ? free : minFree;
+    }
+    const float heapUs = static_cast<float>(esp_timer_get_time() - heapStart) / RUNS;
+    const uint32_t heapPeak = heap_caps_get_free_size(MALLOC_CAP_8BIT) - minFree; // vom Heap belegt (ungefähr)
+
+    size_t arenaUsed = 0;
+    const int64_t arenaStart = esp_timer_get_time();
+    for (int i = 0; i < RUNS; i++) {
+        arena.tryAcquire();
+        {
+            JsonDocument doc(&arena);
+            fillState(doc);
+            serializeJson(doc, buffer, sizeof(buffer));
+            arenaUsed = arena.getUsed();
+        }
+        arena.release();
+    }
+    const float arenaUs = static_cast<float>(esp_timer_get_time() - arenaStart) / RUNS;
+
+    char message[128];
+    snprintf(message, sizeof(message), "Heap: %.1f us, %u Byte | Arena: %.1f us, %u Byte",
+             heapUs, heapPeak, arenaUs, static_cast<unsigned>(arenaUsed));
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(arenaUs < heapUs);
+}
+
+void setup() {
+    delay(2000);
+    arena.begin(2048);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_allocate_and_reset);
+    RUN_TEST(test_overflow);
+    RUN_TEST(test_no_heap_while_serializing);
+    RUN_TEST(test_benchmark_heap_vs_arena);
+    UNITY_END();
+}
+
+void loop() {}
@@ -5,6 +5,9 @@
 #include <Arduino.h>
 #include <unity.h>
 #include "LED.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
 
 LED led(5, true); // GPIO5
 
@@ -44,10 +47,56 @@ void test_blink_behavior() {
     TEST_ASSERT_EQUAL(stateBefore, led.isOn());
 }
 
+#if defined(NATIVE)
+void test_blink_timing() {
+    HostHal& hal = HostHal::instance();
+    led.begin();
+    led.blink(50, 150);
+    TEST_ASSERT_EQUAL_UINT8(HIGH, hal.getOutput(5));
+
+    delay(49);
+    led.update();
+    TEST_ASSERT_TRUE(led.isOn());
+
+    delay(1);
+    led.update();
+    TEST_ASSERT_FALSE(led.isOn());
+    TEST_ASSERT_EQUAL_UINT8(LOW, hal.getOutput(5));
+
+    delay(150);
+    led.update();
+    TEST_ASSERT_TRUE(led.isOn());
+    led.off();
+}
+
+void test_blink_across_millis_overflow() {
+    HostHal::instance().setUptime((1ULL << 32) * 1000 - 30000); // 30 ms vor dem Überlauf von millis()
+    led.begin();
+    led.blink(50, 50);
+
+    delay(49);
+    led.update();
+    TEST_ASSERT_TRUE(led.isOn());
+
+    delay(1); // nach dem Überlauf
+    led.update();
+    TEST_ASSERT_FALSE(led.isOn());
+
+    delay(50);
+    led.update();
+    TEST_ASSERT_TRUE(led.isOn());
+    led.off();
+}
+#endif
+
 void setup() {
     UNITY_BEGIN();
     RUN_TEST(test_on_off_toggle);
     RUN_TEST(test_blink_behavior);
+#if defined(NATIVE)
+    RUN_TEST(test_blink_timing);
+    RUN_TEST(test_blink_across_millis_overflow);
+#endif
     UNITY_END();
 }
 
@@ -0,0 +1,172 @@
+/**
+ * Unit-Test für die MetricsWriter-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "MetricsWriter.h"
+
+using Type = MetricsWriter::Type;
+using Sample = MetricsWriter::Sample;
+
+const MetricsWriter::Family FAMILIES[] = {
+    {"demo_temperature_celsius", Type::Gauge, "celsius", "Temperatur"},
+    {"demo_switches", Type::Counter, nullptr, "Schaltvorgänge"},
+    {"demo_duration_seconds", Type::Histogram, "seconds", "Laufzeit"},
+};
+
+/**
+ * @brief Liefert die Werte der Beispiel-Familien.
+ */
+bool demoSamples(const uint8_t family, const uint16_t index, Sample& sample) {
+    switch (family) {
+        case 0: // zwei Sensoren, der zweite ohne gültigen Wert
+            if (index > 1) return false;
+            sample.label("sensor", index == 0 ? "air" : "soil");
+            sample.value = index == 0 ? 21.5 : NAN;
+            return true;
+        case 1: // drei Relais, das mittlere fehlt
+            if (index > 2) return false;
+            sample.omit = index == 1;
+            sample.label("relay", index == 0 ? "fan" : "pump");
+            sample.value = index == 0 ? 12 : 4294967295.0;
+            return true;
+        case 2: // Histogramm mit zwei Grenzen
+            switch (index) {
+                case 0: sample.suffix = "_bucket"; sample.label("le", 0.001); sample.value = 3; return true;
+                case 1: sample.suffix = "_bucket"; sample.label("le", INFINITY); sample.value = 5; return true;
+                case 2: sample.suffix = "_sum"; sample.value = 0.0125; return true;
+                case 3: sample.suffix = "_count"; sample.value = 5; return true;
+                default: return false;
+            }
+        default:
+            return false;
+    }
+}
+
+const char EXPECTED[] =
+    "# TYPE demo_temperature_celsius gauge\n"
+    "# UNIT demo_temperature_celsius celsius\n"
+    "# HELP demo_temperature_celsius Temperatur\n"
+    "demo_temperature_celsius{sensor=\"air\"} 21.5\n"
+    "demo_temperature_celsius{sensor=\"soil\"} NaN\n"
+    "# TYPE demo_switches counter\n"
+    "# HELP demo_switches Schaltvorgänge\n"
+    "demo_switches_total{relay=\"fan\"} 12\n"
+    "demo_switches_total{relay=\"pump\"} 4294967295\n"
+    "# TYPE demo_duration_seconds histogram\n"
+    "# UNIT demo_duration_seconds seconds\n"
+    "# HELP demo_duration_seconds Laufzeit\n"
+    "demo_duration_seconds_bucket{le=\"0.001\"} 3\n"
+    "demo_duration_seconds_bucket{le=\"+Inf\"} 5\n"
+    "demo_duration_seconds_sum 0.0125\n"
+    "demo_duration_seconds_count 5\n"
+    "# EOF\n";
+
+char output[1024];
+
+/**
+ * @brief Schreibt den ganzen Text in Stücken zu chunk Byte nach output.
+ * @return Gesamtlänge.
+ */
+size_t drain(MetricsWriter& writer, const size_t chunk) {
+    size_t total = 0;
+    size_t length;
+    do {
+        const size_t space = sizeof(output) - 1 - total;
+        length = writer.fill(reinterpret_cast<uint8_t*>(output) + total, chunk < space ? chunk : space);
+        total += length;
+    } while (length > 0);
+    output[total] = '\0';
+    return total;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_writes_families_and_eof() {
+    MetricsWriter writer(FAMILIES, 3, demoSamples);
+    const size_t length = drain(writer, 512);
+    TEST_ASSERT_EQUAL_STRING(EXPECTED, output);
+    TEST_ASSERT_EQUAL_size_t(strlen(EXPECTED), length);
+    TEST_ASSERT_TRUE(writer.isDone());
+    TEST_ASSERT_EQUAL_size_t(0, writer.fill(reinterpret_cast<uint8_t*>(output), 16));
+}
+
+void test_small_chunks_give_same_text() {
+    MetricsWriter writer(FAMILIES, 3, demoSamples);
+    drain(writer, 7); // Zeilen werden über mehrere Aufrufe verteilt
+    TEST_ASSERT_EQUAL_STRING(EXPECTED, output);
+
+    writer.rewind();
+    TEST_ASSERT_FALSE(writer.isDone());
+    drain(writer, 1);
+    TEST_ASSERT_EQUAL_STRING(EXPECTED, output);
+}
+
+void test_escapes_label_values() {
+    const MetricsWriter::Family family = {"demo_info", Type::Gauge, nullptr, "Zeile 1\nZeile \\2"};
+    MetricsWriter writer(&family, 1, [](uint8_t, const uint16_t index, Sample& sample) {
+        sample.label("name", "a\"b\\c");
+        sample.value = 1;
+        return index == 0;
+    });
+    drain(writer, 64);
+    TEST_ASSERT_EQUAL_STRING("# TYPE demo_info gauge\n"
+                             "# HELP demo_info Zeile 1\\nZeile \\\\2\n"
+                             "demo_info{name=\"a\\\"b\\\\c\"} 1\n"
+                             "# EOF\n", output);
+}
+
+void test_too_long_line_is_skipped() {
+    const MetricsWriter::Family family = {"demo_long", Type::Gauge, nullptr, nullptr};
+    MetricsWriter writer(&family, 1, [](uint8_t, const uint16_t index, Sample& sample) {
+        // Drei Labels mit lauter maskierten Zeichen sind zu lang für LINE_SIZE
+        const char* value = index == 0 ? "\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"" : "ok";
+        sample.label("first_label_with_a_long_name_for_this_test", value);
+        sample.label("second_label_with_a_long_name_for_this_test", value);
+        sample.label("third_label_with_a_long_name_for_this_test", value);
+        sample.label("ignored", "x"); // mehr als MAX_LABELS
+        sample.value = index;
+        return index < 2;
+    });
+    drain(writer, 64);
+    TEST_ASSERT_NULL(strstr(output, "demo_long{first_label_with_a_long_name_for_this_test=\"\\\""));
+    TEST_ASSERT_NOT_NULL(strstr(output, "third_label_with_a_long_name_for_this_test=\"ok\"} 1\n# EOF\n"));
+    TEST_ASSERT_NULL(strstr(output, "ignored"));
+}
+
+void test_format_value() {
+    char buffer[32];
+    MetricsWriter::formatValue(buffer, sizeof(buffer), 0.0);
+    TEST_ASSERT_EQUAL_STRING("0", buffer);
+    MetricsWriter::formatValue(buffer, sizeof(buffer), -42.0);
+    TEST_ASSERT_EQUAL_STRING("-42", buffer);
+    MetricsWriter::formatValue(buffer, sizeof(buffer), 18446744073709.0); // z.B. Einschaltdauer in ms
+    TEST_ASSERT_EQUAL_STRING("18446744073709", buffer);
+    MetricsWriter::formatValue(buffer, sizeof(buffer), 0.000001);
+    TEST_ASSERT_EQUAL_STRING("1e-06", buffer);
+    MetricsWriter::formatValue(buffer, sizeof(buffer), -INFINITY);
+    TEST_ASSERT_EQUAL_STRING("-Inf", buffer);
+}
+
+void test_without_families_only_eof() {
+    MetricsWriter writer(nullptr, 0, demoSamples);
+    drain(writer, 64);
+    TEST_ASSERT_EQUAL_STRING("# EOF\n", output);
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_writes_families_and_eof);
+    RUN_TEST(test_small_chunks_give_same_text);
+    RUN_TEST(test_escapes_label_values);
+    RUN_TEST(test_too_long_line_is_skipped);
+    RUN_TEST(test_format_value);
+    RUN_TEST(test_without_families_only_eof);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,128 @@
+/**
+ * Unit-Test für die MicroSDCard-Bibliothek.
+ * 
+ * Dieser Test überprüft die grundlegende Funktionalität des SD-Kartenmoduls.
+ * Er stellt sicher, dass die Karte nicht nur initialisiert, sondern auch
+ * beschrieben und modifiziert werden kann.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "MicroSDCard.h"
+
+// GPIO-Pin für den Chip Select der SD-Karte
+const uint8_t SD_CS_PIN = 16;
+
+// Wurzel der Testbilder (statt "/img", das die echten Aufnahmen enthält)
+const char TEST_IMAGE_DIR[] = "/test_img";
+
+// Erstelle eine Instanz der zu testenden Klasse
+MicroSDCard sdCard(SD_CS_PIN);
+
+/**
+ * @brief Testet die Initialisierung und eine einfache Datei-I/O-Operation.
+ * 
+ * Dieser Test prüft drei Dinge:
+ * 1. Kann die SD-Karte erfolgreich initialisiert werden (`begin()`).
+ * 2. Kann eine Test-Datei erfolgreich erstellt und geschrieben werden (`writeFile()`).
+ * 3. Kann diese Test-Datei anschließend wieder gelöscht werden (`deleteFile()`).
+ */
+void test_sdcard_initialization_and_io() {
+    TEST_ASSERT_TRUE_MESSAGE(sdCard.begin(), "SD-Karten-Initialisierung fehlgeschlagen. Verkabelung oder Karte prüfen.");
+    
+    const char* testFile = "/unittest.txt";
+    
+    TEST_ASSERT_TRUE_MESSAGE(sdCard.writeFile(testFile, "test"), "Schreiben der Test-Datei fehlgeschlagen.");
+    
+    TEST_ASSERT_TRUE_MESSAGE(sdCard.deleteFile(testFile), "Löschen der Test-Datei fehlgeschlagen.");
+}
+
+/**
+ * @brief Testet den Pfad eines Bildes und das Anlegen der Tagesverzeichnisse.
+ */
+void test_image_path_creates_directories() {
+    tm timeInfo{};
+    timeInfo.tm_year = 2025 - 1900;
+    timeInfo.tm_mon = 11;
+    timeInfo.tm_mday = 5;
+    timeInfo.tm_hour = 10;
+    timeInfo.tm_min = 30;
+    char path[MicroSDCard::IMAGE_PATH_LENGTH];
+    MicroSDCard::formatImagePath(timeInfo, path, sizeof(path));
+    TEST_ASSERT_EQUAL_STRING("/img/2025/12/05/103000.jpg", path);
+
+    // Auf der Karte nur unter einem eigenen Verzeichnis arbeiten, damit echte Bilder unangetastet bleiben
+    char testPath[MicroSDCard::IMAGE_PATH_LENGTH];
+    snprintf(testPath, sizeof(testPath), "%s%s", TEST_IMAGE_DIR, path + strlen(MicroSDCard::IMAGE_DIR));
+    TEST_ASSERT_TRUE(sdCard.prepareImagePath(testPath));
+    TEST_ASSERT_TRUE(SD.exists("/test_img/2025/12/05"));
+    TEST_ASSERT_TRUE(sdCard.writeFile(testPath, "jpg"));
+    TEST_ASSERT_EQUAL_INT(1, sdCard.deleteFilesInTree(TEST_IMAGE_DIR, 10));
+    TEST_ASSERT_EQUAL_INT(0, sdCard.deleteFilesInTree(TEST_IMAGE_DIR, 10)); // leere Verzeichnisse sind bereits entfernt
+    TEST_ASSERT_FALSE(SD.exists("/test_img/2025"));
+    SD.rmdir(TEST_IMAGE_DIR);
+}
+
+/**
+ * @brief Legt eine Datei an und gibt die Dauer von open() bis close() in µs zurück.
+ */
+uint32_t measureCreate(const char* path) {
+    const uint32_t start = micros();
+    File file = SD.open(path, FILE_WRITE);
+    file.write('x');
+    file.close();
+    return micros() - start;
+}
+
+/**
+ * @brief Benchmark: Dauer zum Anlegen einer Datei abhängig von der Anzahl der Dateien.
+ *
+ * Vergleicht ein einziges Verzeichnis (altes Layout, alle Bilder im Wurzelverzeichnis) mit einem Verzeichnis pro Tag
+ * (24 Bilder pro Tag). Die Tabelle erscheint im Serial Monitor. Geprüft wird nur, dass die Zeit pro Tag nicht mit der
+ * Anzahl der Dateien wächst.
+ */
+void test_image_layout_create_latency() {
+    constexpr int FILES = 600;
+    constexpr int STEP = 100;
+    constexpr int IMAGES_PER_DAY = 24;
+    char path[40];
+
+    SD.mkdir("/bench_flat");
+    uint32_t flat[FILES / STEP] = {};
+    uint32_t daily[FILES / STEP] = {};
+    for (int i = 0; i < FILES; i++) {
+        snprintf(path, sizeof(path), "/bench_flat/img_%05d.jpg", i);
+        flat[i / STEP] += measureCreate(path);
+        snprintf(path, sizeof(path), "/bench_img/2025/%02d/%02d/%06d.jpg", 1 + i / IMAGES_PER_DAY / 28,
+                 1 + i / IMAGES_PER_DAY % 28, i % IMAGES_PER_DAY);
+        sdCard.prepareImagePath(path); // nicht mitgemessen, einmal pro Tag
+        daily[i / STEP] += measureCreate(path);
+    }
+
+    Serial.println("Dateien | flach (µs) | pro Tag (µs)");
+    for (int step = 0; step < FILES / STEP; step++) {
+        Serial.printf("%7d | %10u | %12u\n", (step + 1) * STEP, flat[step] / STEP, daily[step] / STEP);
+    }
+
+    sdCard.deleteFilesInTree("/bench_flat", FILES);
+    SD.rmdir("/bench_flat");
+    sdCard.deleteFilesInTree("/bench_img", FILES);
+    sdCard.deleteFilesInTree("/bench_img", FILES);
+    SD.rmdir("/bench_img");
+
+    TEST_ASSERT_LESS_THAN_UINT32(2 * daily[0] + 1000, daily[FILES / STEP - 1]);
+}
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_sdcard_initialization_and_io);
+    RUN_TEST(test_image_path_creates_directories);
+    RUN_TEST(test_image_layout_create_latency);
+    UNITY_END();
+}
+
+void loop() {
+    // Nichts zu tun hier
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+/**
+ * Unit-Test für die Profiler-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "Profiler.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+enum Section : uint8_t { SECTION_CONTROL, SECTION_DISPLAY, SECTION_COUNT };
+const char* const SECTION_NAMES[SECTION_COUNT] = {"control", "display"};
+
+void setUp() {
+#if defined(NATIVE)
+    HostHal::instance().reset();
+#endif
+}
+
+void tearDown() {}
+
+void test_starts_empty() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    TEST_ASSERT_EQUAL_UINT8(2, profiler.getSectionCount());
+    TEST_ASSERT_EQUAL_STRING("display", profiler.getName(SECTION_DISPLAY));
+    TEST_ASSERT_NULL(profiler.getName(SECTION_COUNT));
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.count);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.avgUs());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.percentileUs(0.99f));
+    TEST_ASSERT_FALSE(profiler.getStats(SECTION_COUNT, stats));
+}
+
+void test_buckets_are_log2() {
+    TEST_ASSERT_EQUAL_UINT8(0, Profiler::bucketOf(0));
+    TEST_ASSERT_EQUAL_UINT8(1, Profiler::bucketOf(1));
+    TEST_ASSERT_EQUAL_UINT8(2, Profiler::bucketOf(2));
+    TEST_ASSERT_EQUAL_UINT8(2, Profiler::bucketOf(3));
+    TEST_ASSERT_EQUAL_UINT8(11, Profiler::bucketOf(1500));
+    TEST_ASSERT_EQUAL_UINT8(Profiler::BUCKETS - 1, Profiler::bucketOf(UINT32_MAX));
+    TEST_ASSERT_EQUAL_UINT32(2048, Profiler::Stats::bucketLimitUs(11));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, Profiler::Stats::bucketLimitUs(Profiler::BUCKETS - 1));
+}
+
+void test_min_avg_max_and_histogram() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    profiler.record(SECTION_CONTROL, 100);
+    profiler.record(SECTION_CONTROL, 40);
+    profiler.record(SECTION_CONTROL, 400);
+    profiler.record(SECTION_DISPLAY, 5000);
+    profiler.record(SECTION_COUNT, 1); // unbekannt, wird ignoriert
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT32(3, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(40, stats.minUs);
+    TEST_ASSERT_EQUAL_UINT32(400, stats.maxUs);
+    TEST_ASSERT_EQUAL_UINT64(540, stats.totalUs);
+    TEST_ASSERT_EQUAL_FLOAT(180.0f, stats.avgUs());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.histogram[6]); // 40 µs: 32..63
+    TEST_ASSERT_EQUAL_UINT32(1, stats.histogram[7]); // 100 µs: 64..127
+    TEST_ASSERT_EQUAL_UINT32(1, stats.histogram[9]); // 400 µs: 256..511
+
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_DISPLAY, stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(5000, stats.minUs);
+}
+
+void test_percentile_from_histogram() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    for (int i = 0; i < 990; i++) {
+        profiler.record(SECTION_CONTROL, 100); // 64..127
+    }
+    for (int i = 0; i < 10; i++) {
+        profiler.record(SECTION_CONTROL, 3000); // 2048..4095
+    }
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    // Das 99. Perzentil ist die 990. Messung, also die letzte im Bereich 64..127 (genauer misst das Histogramm nicht)
+    TEST_ASSERT_UINT32_WITHIN(32, 96, stats.percentileUs(0.99f));
+    TEST_ASSERT_UINT32_WITHIN(32, 96, stats.percentileUs(0.5f));
+    TEST_ASSERT_LESS_THAN_UINT32(stats.percentileUs(0.99f), stats.percentileUs(0.5f));
+    // Das 99,9. Perzentil liegt im Bereich 2048..4095, aber nie über dem Maximum
+    const uint32_t p999 = stats.percentileUs(0.999f);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2048, p999);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3000, p999);
+    TEST_ASSERT_EQUAL_UINT32(3000, stats.percentileUs(1.0f));
+}
+
+void test_total_keeps_counting_past_32_bit() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    profiler.record(SECTION_CONTROL, 4000000000u);
+    profiler.record(SECTION_CONTROL, 1000000000u);
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT64(5000000000ull, stats.totalUs);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.histogram[Profiler::BUCKETS - 1]);
+}
+
+void test_reset_applies_with_next_measurement() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    profiler.record(SECTION_CONTROL, 900);
+    profiler.reset();
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.count); // noch nicht gemessen, noch die alten Werte
+
+    profiler.record(SECTION_CONTROL, 20);
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(20, stats.minUs);
+    TEST_ASSERT_EQUAL_UINT32(20, stats.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.histogram[Profiler::bucketOf(900)]);
+}
+
+#if defined(NATIVE)
+void test_scope_measures_virtual_time() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    for (uint32_t us : {250u, 750u}) {
+        Profiler::Scope scope(profiler, SECTION_DISPLAY);
+        HostHal::instance().advance(us);
+    }
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_DISPLAY, stats));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(250, stats.minUs);
+    TEST_ASSERT_EQUAL_UINT32(750, stats.maxUs);
+}
+
+void test_scope_across_micros_overflow() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    HostHal::instance().setUptime((1ull << 32) - 100); // 100 µs vor dem Überlauf von micros()
+    {
+        Profiler::Scope scope(profiler, SECTION_CONTROL);
+        HostHal::instance().advance(300);
+    }
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT32(300, stats.maxUs);
+}
+
+void test_macro_follows_build_flag() {
+    Profiler profiler(SECTION_NAMES, SECTION_COUNT);
+    {
+        PROFILE_SCOPE(profiler, SECTION_CONTROL);
+        HostHal::instance().advance(10);
+    }
+
+    Profiler::Stats stats;
+    TEST_ASSERT_TRUE(profiler.getStats(SECTION_CONTROL, stats));
+    TEST_ASSERT_EQUAL_UINT32(Profiler::isEnabled() ? 1 : 0, stats.count);
+}
+#endif
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_empty);
+    RUN_TEST(test_buckets_are_log2);
+    RUN_TEST(test_min_avg_max_and_histogram);
+    RUN_TEST(test_percentile_from_histogram);
+    RUN_TEST(test_total_keeps_counting_past_32_bit);
+    RUN_TEST(test_reset_applies_with_next_measurement);
+#if defined(NATIVE)
+    RUN_TEST(test_scope_measures_virtual_time);
+    RUN_TEST(test_scope_across_micros_overflow);
+    RUN_TEST(test_macro_follows_build_flag);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,169 @@
+/**
+ * Unit-Test für die Relay-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "Relay.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+Relay testRelay(25, false, false); // GPIO25, activeHigh=false, safeState=false (aus)
+
+void test_begin_and_basic_on_off() {
+    testRelay.begin();
+    TEST_ASSERT_FALSE(testRelay.isOn());
+
+    testRelay.on();
+    TEST_ASSERT_TRUE(testRelay.isOn());
+
+    testRelay.off();
+    TEST_ASSERT_FALSE(testRelay.isOn());
+
+    testRelay.toggle();
+    TEST_ASSERT_TRUE(testRelay.isOn());
+}
+
+void test_pulse_non_blocking() {
+    testRelay.begin();
+    testRelay.off();
+
+    // Starte 200 ms Pulse
+    testRelay.pulse(200);
+    TEST_ASSERT_TRUE(testRelay.isOn()); // sofort ein
+
+    // Warte 250 ms und rufe update() -> Pulse muss beendet sein
+    delay(250);
+    testRelay.update();
+    // Erwartung: zurück in safeState (off)
+    TEST_ASSERT_FALSE(testRelay.isOn());
+}
+
+void test_switch_count_counts_changes_only() {
+    Relay relay(26, false, false);
+    relay.begin();
+    TEST_ASSERT_EQUAL_UINT32(0, relay.getSwitchCount()); // begin() zählt nicht
+
+    relay.on();
+    relay.on(); // kein Wechsel
+    relay.off();
+    relay.toggle();
+    TEST_ASSERT_EQUAL_UINT32(3, relay.getSwitchCount());
+
+    relay.pulse(10); // läuft schon: kein Wechsel
+    delay(20);
+    relay.update(); // zurück auf AUS
+    TEST_ASSERT_EQUAL_UINT32(4, relay.getSwitchCount());
+}
+
+#if defined(NATIVE)
+void test_on_time_accumulates() {
+    Relay relay(26, false, false);
+    relay.begin();
+    delay(1000);
+    TEST_ASSERT_EQUAL_UINT64(0, relay.getOnTimeMs());
+
+    relay.on();
+    delay(300);
+    TEST_ASSERT_EQUAL_UINT64(300, relay.getOnTimeMs()); // laufende Einschaltphase zählt mit
+    relay.off();
+    delay(500);
+    relay.pulse(200);
+    delay(250);
+    relay.update();
+    TEST_ASSERT_EQUAL_UINT64(550, relay.getOnTimeMs()); // der Puls endet erst mit update() nach 250 ms
+}
+
+void test_on_time_across_millis_overflow() {
+    HostHal::instance().setUptime((1ULL << 32) * 1000 - 100000); // 100 ms vor dem Überlauf
+    Relay relay(26, false, true); // standardmäßig EIN
+    relay.begin();
+    delay(400);
+    TEST_ASSERT_EQUAL_UINT64(400, relay.getOnTimeMs());
+    relay.off();
+    delay(100);
+    TEST_ASSERT_EQUAL_UINT64(400, relay.getOnTimeMs());
+    TEST_ASSERT_EQUAL_UINT32(1, relay.getSwitchCount());
+}
+
+void test_active_low_levels() {
+    HostHal& hal = HostHal::instance();
+    testRelay.begin();
+    TEST_ASSERT_EQUAL_UINT8(OUTPUT, hal.getMode(25));
+    TEST_ASSERT_EQUAL_UINT8(HIGH, hal.getOutput(25)); // aus = HIGH (invertiertes Modul)
+
+    testRelay.on();
+    TEST_ASSERT_EQUAL_UINT8(LOW, hal.getOutput(25));
+
+    testRelay.off();
+    TEST_ASSERT_EQUAL_UINT8(HIGH, hal.getOutput(25));
+}
+
+void test_pulse_extends_to_latest_end() {
+    testRelay.begin();
+    testRelay.pulse(200);
+    delay(150);
+    testRelay.pulse(200); // endet jetzt erst 350 ms nach dem Start
+    delay(100);
+    testRelay.update();
+    TEST_ASSERT_TRUE(testRelay.isOn());
+
+    delay(100);
+    testRelay.update();
+    TEST_ASSERT_FALSE(testRelay.isOn());
+}
+
+void test_fan_pulse_across_millis_overflow() {
+    HostHal::instance().setUptime((1ULL << 32) * 1000 - 60000000); // eine Minute vor dem Überlauf von millis()
+    testRelay.begin();
+    testRelay.pulse(300000); // Lüfter: 5 Minuten
+
+    for (int minute = 1; minute < 5; minute++) {
+        delay(60000);
+        testRelay.update();
+        TEST_ASSERT_TRUE(testRelay.isOn());
+    }
+    TEST_ASSERT_LESS_THAN_UINT32(300000, millis()); // übergelaufen
+
+    testRelay.pulse(30000); // endet vor dem laufenden Puls: keine Verlängerung
+    delay(59999);
+    testRelay.update();
+    TEST_ASSERT_TRUE(testRelay.isOn());
+    delay(1);
+    testRelay.update();
+    TEST_ASSERT_FALSE(testRelay.isOn());
+}
+
+void test_pulse_extends_across_millis_overflow() {
+    HostHal::instance().setUptime((1ULL << 32) * 1000 - 100000); // 100 ms vor dem Überlauf
+    testRelay.begin();
+    testRelay.pulse(200);
+    delay(150);
+    testRelay.pulse(200); // endet nach dem Überlauf, 350 ms nach dem Start
+    delay(199);
+    testRelay.update();
+    TEST_ASSERT_TRUE(testRelay.isOn());
+    delay(1);
+    testRelay.update();
+    TEST_ASSERT_FALSE(testRelay.isOn());
+}
+#endif
+
+void setup() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_and_basic_on_off);
+    RUN_TEST(test_pulse_non_blocking);
+    RUN_TEST(test_switch_count_counts_changes_only);
+#if defined(NATIVE)
+    RUN_TEST(test_on_time_accumulates);
+    RUN_TEST(test_on_time_across_millis_overflow);
+    RUN_TEST(test_active_low_levels);
+    RUN_TEST(test_pulse_extends_to_latest_end);
+    RUN_TEST(test_fan_pulse_across_millis_overflow);
+    RUN_TEST(test_pulse_extends_across_millis_overflow);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
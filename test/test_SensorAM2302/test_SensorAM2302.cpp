@@ -0,0 +1,51 @@
+/**
+ * Unit-Test für die SensorAM2302-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SensorAM2302.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+SensorAM2302 sensor(13); // GPIO13
+
+void test_sensor_read() {
+    TEST_ASSERT_TRUE(sensor.read());
+    TEST_ASSERT_FLOAT_IS_NOT_NAN(sensor.getTemperature());
+    TEST_ASSERT_FLOAT_IS_NOT_NAN(sensor.getHumidity());
+}
+
+#if defined(NATIVE)
+void test_sensor_values_and_retries() {
+    HostHal& hal = HostHal::instance();
+    hal.setDht(13, 21.5f, 63.0f);
+    TEST_ASSERT_TRUE(sensor.read());
+    TEST_ASSERT_EQUAL_FLOAT(21.5f, sensor.getTemperature());
+    TEST_ASSERT_EQUAL_FLOAT(63.0f, sensor.getHumidity());
+
+    // Fehlerhafte Prüfsumme: alle Versuche schlagen fehl, dazwischen je 50 ms Pause
+    hal.setDht(13, 21.5f, 63.0f, SimpleDHTErrDataChecksum);
+    const unsigned long start = millis();
+    TEST_ASSERT_FALSE(sensor.read(3));
+    TEST_ASSERT_EQUAL_UINT32(100, millis() - start);
+    TEST_ASSERT_EQUAL_INT(SimpleDHTErrDataChecksum, sensor.getLastError());
+    TEST_ASSERT_FLOAT_IS_NAN(sensor.getTemperature());
+}
+#endif
+
+void setup() {
+    delay(2000);
+#if defined(NATIVE)
+    HostHal::instance().setDht(13, 22.0f, 60.0f); // simulierter Sensor
+#endif
+    UNITY_BEGIN();
+    RUN_TEST(test_sensor_read);
+#if defined(NATIVE)
+    RUN_TEST(test_sensor_values_and_retries);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,73 @@
+/**
+ * Unit-Test für die SensorBH1750-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <unity.h>
+#include "SensorBH1750.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+SensorBH1750 light; // Standard-I2C-Adresse 0x23
+
+#if defined(NATIVE)
+SimulatedBH1750 simulatedLight;
+#endif
+
+void test_light_read() {
+    TEST_ASSERT_TRUE(light.read());
+    TEST_ASSERT_FLOAT_IS_NOT_NAN(light.getLux());
+    TEST_ASSERT_GREATER_THAN(0.0f, light.getLux()); // typischer Lux-Wert > 0
+}
+
+#if defined(NATIVE)
+void test_light_conversion() {
+    simulatedLight.setLux(250.0f);
+    TEST_ASSERT_EQUAL_HEX8(SensorBH1750::CONTINUOUS_HIGH_RES_MODE, simulatedLight.getMode());
+    TEST_ASSERT_TRUE(light.read());
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 250.0f, light.getLux());
+
+    light.setMode(SensorBH1750::CONTINUOUS_HIGH_RES_MODE_2);
+    TEST_ASSERT_TRUE(light.read());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 250.0f, light.getLux());
+
+    // Einzelmessung wartet auf das Ergebnis
+    light.setMode(SensorBH1750::ONE_TIME_HIGH_RES_MODE);
+    const unsigned long start = millis();
+    TEST_ASSERT_TRUE(light.read());
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(120, millis() - start);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 250.0f, light.getLux());
+    light.setMode(SensorBH1750::CONTINUOUS_HIGH_RES_MODE);
+}
+
+void test_light_missing_sensor() {
+    HostHal::instance().attachI2c(0x23, nullptr);
+    TEST_ASSERT_FALSE(light.read());
+    TEST_ASSERT_EQUAL_INT(2, light.getLastError());
+    TEST_ASSERT_FLOAT_IS_NAN(light.getLux());
+    TEST_ASSERT_FALSE(light.begin());
+    HostHal::instance().attachI2c(0x23, &simulatedLight);
+    TEST_ASSERT_TRUE(light.begin());
+}
+#endif
+
+void setup() {
+    delay(2000);
+    Wire.begin();
+#if defined(NATIVE)
+    simulatedLight.setLux(100.0f); // simulierter Sensor
+    HostHal::instance().attachI2c(0x23, &simulatedLight);
+#endif
+    light.begin();
+    UNITY_BEGIN();
+    RUN_TEST(test_light_read);
+#if defined(NATIVE)
+    RUN_TEST(test_light_conversion);
+    RUN_TEST(test_light_missing_sensor);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,42 @@
+/**
+ * Unit-Test für die SensorCapacitiveSoil-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SensorCapacitiveSoil.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+SensorCapacitiveSoil soil(34); // GPIO34
+
+void test_soil_read() {
+    TEST_ASSERT_TRUE(soil.read());
+    TEST_ASSERT_INT_WITHIN(4095, 0, soil.getRaw());
+    TEST_ASSERT_INT_WITHIN(100, 0, soil.getPercent());
+}
+
+#if defined(NATIVE)
+void test_soil_percent_from_calibration() {
+    HostHal::instance().setAnalog(34, 1800); // genau zwischen trocken (2500) und nass (1100)
+    TEST_ASSERT_TRUE(soil.read());
+    TEST_ASSERT_EQUAL_INT(1800, soil.getRaw());
+    TEST_ASSERT_EQUAL_INT(50, soil.getPercent());
+}
+#endif
+
+void setup() {
+    delay(2000);
+#if defined(NATIVE)
+    HostHal::instance().setAnalog(34, 2000); // simulierter Sensor
+#endif
+    UNITY_BEGIN();
+    RUN_TEST(test_soil_read);
+#if defined(NATIVE)
+    RUN_TEST(test_soil_percent_from_calibration);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,106 @@
+/**
+ * Unit-Test für die SensorDS18B20-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SensorDS18B20.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+SensorDS18B20 sensor(4); // GPIO4 für 1-Wire
+
+void test_sensor_found() {
+    TEST_ASSERT_NOT_EQUAL(1, sensor.getLastError()); // Sensor sollte gefunden sein
+}
+
+void test_temperature_valid() {
+    TEST_ASSERT_TRUE(sensor.read());
+    float temp = sensor.getTemperature();
+    TEST_ASSERT_FALSE(isnan(temp));
+    TEST_ASSERT(temp > -55.0 && temp < 125.0); // SensorDS18B20 Messbereich
+}
+
+void test_conversion_time_per_resolution() {
+    sensor.setResolution(9);
+    TEST_ASSERT_EQUAL_UINT32(94, sensor.getConversionTime());
+    sensor.setResolution(10);
+    TEST_ASSERT_EQUAL_UINT32(188, sensor.getConversionTime());
+    sensor.setResolution(11);
+    TEST_ASSERT_EQUAL_UINT32(375, sensor.getConversionTime());
+    sensor.setResolution(12);
+    TEST_ASSERT_EQUAL_UINT32(750, sensor.getConversionTime());
+    sensor.setResolution(20); // wird auf 12 Bit begrenzt
+    TEST_ASSERT_EQUAL_UINT8(12, sensor.getResolution());
+}
+
+void test_start_conversion_does_not_block() {
+    sensor.setResolution(12);
+    const unsigned long start = micros();
+    TEST_ASSERT_TRUE(sensor.startConversion());
+    const unsigned long elapsed = micros() - start;
+    TEST_ASSERT_TRUE(sensor.isConverting());
+    TEST_ASSERT_LESS_THAN_UINT32(20000, elapsed); // weit unter den 750ms einer blockierenden Messung
+
+    // Während der Wandlung kehrt poll() sofort ohne Ergebnis zurück.
+    TEST_ASSERT_FALSE(sensor.poll());
+    TEST_ASSERT_TRUE(sensor.isConverting());
+}
+
+void test_poll_delivers_callback() {
+    bool called = false;
+    float result = NAN;
+    sensor.onConversionComplete([&](const bool success, const float temperature) {
+        called = success;
+        result = temperature;
+    });
+
+    sensor.startConversion();
+    const unsigned long start = millis();
+    while (!sensor.poll() && millis() - start < 2000) {
+        delay(1);
+    }
+    sensor.onConversionComplete(nullptr);
+
+    TEST_ASSERT_TRUE(called);
+    TEST_ASSERT_FALSE(sensor.isConverting());
+    TEST_ASSERT(result > -55.0 && result < 125.0);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(sensor.getConversionTime(), millis() - start);
+}
+
+#if defined(NATIVE)
+void test_poll_waits_for_end_of_conversion() {
+    // Der simulierte Sensor übernimmt den neuen Wert erst nach der vollen Wandlungszeit ins Scratchpad.
+    sensor.setResolution(9);
+    HostHal::instance().setOneWireTemperature(4, 30.0f);
+    TEST_ASSERT_TRUE(sensor.startConversion());
+    Hal::get().delay(sensor.getConversionTime() - 1);
+    TEST_ASSERT_FALSE(sensor.poll());
+    Hal::get().delay(1);
+    TEST_ASSERT_TRUE(sensor.poll());
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, sensor.getTemperature());
+    HostHal::instance().setOneWireTemperature(4, 23.4f);
+    sensor.setResolution(12);
+}
+#endif
+
+void setup() {
+    delay(2000); // Sensor-Stabilisierung
+#if defined(NATIVE)
+    HostHal::instance().setOneWireTemperature(4, 23.4f); // simulierter Sensor
+#endif
+    sensor.begin();
+    UNITY_BEGIN();
+    RUN_TEST(test_sensor_found);
+    RUN_TEST(test_temperature_valid);
+    RUN_TEST(test_conversion_time_per_resolution);
+    RUN_TEST(test_start_conversion_does_not_block);
+    RUN_TEST(test_poll_delivers_callback);
+#if defined(NATIVE)
+    RUN_TEST(test_poll_waits_for_end_of_conversion);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,103 @@
+/**
+ * Unit-Test für die SensorHistory-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SensorHistory.h"
+
+constexpr uint16_t CAPACITY = 10;
+constexpr uint32_t START = 1700000000; // beliebige Unix-Zeit
+
+SensorHistory history;
+int tempChannel = -1;
+int luxChannel = -1;
+
+void test_add_channel() {
+    TEST_ASSERT_EQUAL_INT(0, tempChannel);
+    TEST_ASSERT_EQUAL_INT(1, luxChannel);
+    TEST_ASSERT_EQUAL_INT(-1, history.addChannel("late", 1)); // nach begin() nicht mehr möglich
+    TEST_ASSERT_EQUAL_INT(luxChannel, history.getChannel("lux"));
+    TEST_ASSERT_EQUAL(sizeof(uint32_t) + 2 * sizeof(int16_t), history.getRowSize());
+}
+
+void test_fixed_point_and_missing() {
+    const float values[] = {21.37f, NAN};
+    history.record(START, values);
+
+    SensorHistory::Bucket bucket;
+    history.query(tempChannel, START, START + 1, 1, &bucket);
+    TEST_ASSERT_EQUAL_UINT16(1, bucket.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 21.37f, bucket.avg);
+
+    history.query(luxChannel, START, START + 1, 1, &bucket);
+    TEST_ASSERT_EQUAL_UINT16(0, bucket.count); // NAN wird nicht mitgezählt
+    TEST_ASSERT_TRUE(isnan(bucket.avg));
+}
+
+void test_wrap_around() {
+    // Insgesamt 15 Einträge, die ersten 5 werden überschrieben
+    for (uint32_t i = 1; i < 15; i++) {
+        const float values[] = {20.0f + static_cast<float>(i), 1000.0f * static_cast<float>(i)};
+        history.record(START + i * 5, values);
+    }
+    TEST_ASSERT_EQUAL_UINT16(CAPACITY, history.getSize());
+    TEST_ASSERT_EQUAL_UINT32(START + 25, history.getOldestTime());
+    TEST_ASSERT_EQUAL_UINT32(START + 70, history.getNewestTime());
+    TEST_ASSERT_EQUAL_UINT32(5, history.getLostCount()); // nie ausgelagert
+}
+
+void test_query_buckets() {
+    // 10 Einträge (i = 5..14) in zwei Abschnitte zu je 25 s
+    SensorHistory::Bucket buckets[2];
+    TEST_ASSERT_EQUAL_UINT16(2, history.query(tempChannel, START + 25, START + 75, 2, buckets));
+    TEST_ASSERT_EQUAL_UINT16(5, buckets[0].count);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, buckets[0].min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.0f, buckets[0].max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 27.0f, buckets[0].avg);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 34.0f, buckets[1].max);
+
+    // Lux mit Faktor 0.5: Auflösung 2 lx
+    history.query(luxChannel, START + 25, START + 75, 1, buckets);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, 14000.0f, buckets[0].max);
+}
+
+void test_spill() {
+    uint8_t buffer[4 * (sizeof(uint32_t) + 2 * sizeof(int16_t))];
+    uint32_t firstTime = 0;
+    TEST_ASSERT_EQUAL_UINT16(CAPACITY, history.getUnsavedCount());
+
+    const uint16_t rows = history.readUnsaved(buffer, sizeof(buffer), firstTime);
+    TEST_ASSERT_EQUAL_UINT16(4, rows);
+    TEST_ASSERT_EQUAL_UINT32(START + 25, firstTime);
+
+    // Erste Zeile: Zeitstempel, dann 25.00 °C als 2500
+    uint32_t time;
+    int16_t temp;
+    memcpy(&time, buffer, sizeof(time));
+    memcpy(&temp, buffer + sizeof(time), sizeof(temp));
+    TEST_ASSERT_EQUAL_UINT32(START + 25, time);
+    TEST_ASSERT_EQUAL_INT16(2500, temp);
+
+    history.markSaved(rows);
+    TEST_ASSERT_EQUAL_UINT16(CAPACITY - 4, history.getUnsavedCount());
+    history.readUnsaved(buffer, sizeof(buffer), firstTime);
+    TEST_ASSERT_EQUAL_UINT32(START + 45, firstTime);
+}
+
+void setup() {
+    delay(2000);
+    tempChannel = history.addChannel("temp", 100);
+    luxChannel = history.addChannel("lux", 0.5f);
+    history.begin(CAPACITY, 5);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_add_channel);
+    RUN_TEST(test_fixed_point_and_missing);
+    RUN_TEST(test_wrap_around);
+    RUN_TEST(test_query_buckets);
+    RUN_TEST(test_spill);
+    UNITY_END();
+}
+
+void loop() {}
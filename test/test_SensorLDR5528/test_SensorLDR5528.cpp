@@ -5,6 +5,9 @@
 #include <Arduino.h>
 #include <unity.h>
 #include "SensorLDR5528.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
 
 SensorLDR5528 ldr(36, 10000.0f, 1023); // GPIO36 (ADC1_0 auf ESP32)
 
@@ -16,9 +19,24 @@ void test_read_returns_true() {
     (void)raw;
 }
 
+#if defined(NATIVE)
+void test_read_rejects_rail_values() {
+    HostHal::instance().setAnalog(36, 1023); // Kurzschluss nach VCC
+    TEST_ASSERT_FALSE(ldr.read());
+    TEST_ASSERT_FLOAT_IS_NAN(ldr.getLux());
+    HostHal::instance().setAnalog(36, 512);
+}
+#endif
+
 void setup() {
+#if defined(NATIVE)
+    HostHal::instance().setAnalog(36, 512); // simulierter Sensor (halbe Versorgungsspannung)
+#endif
     UNITY_BEGIN();
     RUN_TEST(test_read_returns_true);
+#if defined(NATIVE)
+    RUN_TEST(test_read_rejects_rail_values);
+#endif
     UNITY_END();
 }
 
@@ -0,0 +1,186 @@
+/**
+ * Unit-Test für die SensorScheduler-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SensorScheduler.h"
+#if defined(NATIVE)
+#include "HostHal.h"
+#endif
+
+using Result = SensorScheduler::Result;
+
+/**
+ * @brief Ruft run() so lange auf, bis die Zeit abgelaufen ist.
+ */
+void runFor(SensorScheduler& scheduler, const uint32_t ms) {
+    const uint32_t start = millis();
+    while (millis() - start < ms) {
+        scheduler.run();
+        delay(1);
+    }
+}
+
+void test_conversion_time_is_respected() {
+    SensorScheduler scheduler;
+    unsigned long startedAt = 0;
+    unsigned long finishedAt = 0;
+    const int id = scheduler.addSensor("conv", 10000, 100, 1000,
+        [&] { startedAt = millis(); return true; },
+        [&] { finishedAt = millis(); return Result::Success; });
+
+    runFor(scheduler, 200);
+
+    TEST_ASSERT_TRUE(scheduler.hasSample(id));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(100, finishedAt - startedAt);
+    TEST_ASSERT_EQUAL_UINT32(finishedAt, scheduler.getLastSampledAt(id));
+}
+
+void test_budget_spreads_work() {
+    SensorScheduler scheduler(5000); // 5 ms
+    int calls = 0;
+    for (int i = 0; i < 4; i++) {
+        scheduler.addSensor("busy", 10000, 0, 1000, nullptr, [&] {
+            delayMicroseconds(3000); // jeder Sensor braucht 3 ms
+            calls++;
+            return Result::Success;
+        });
+    }
+
+    // Nach einem Durchlauf dürfen höchstens zwei Sensoren gelesen sein (2 * 3 ms > 5 ms).
+    scheduler.run();
+    TEST_ASSERT_EQUAL_INT(2, calls);
+    TEST_ASSERT_LESS_THAN_UINT32(9000, scheduler.getLastRunDuration());
+
+    scheduler.run();
+    TEST_ASSERT_EQUAL_INT(4, calls);
+
+    // Danach ist nichts mehr fällig.
+    scheduler.run();
+    TEST_ASSERT_EQUAL_INT(4, calls);
+}
+
+void test_is_due_until_read() {
+    SensorScheduler scheduler;
+    scheduler.addSensor("conv", 10000, 100, 1000, [] { return true; }, [] { return Result::Success; });
+
+    TEST_ASSERT_TRUE(scheduler.isDue()); // sofort fällig
+    scheduler.run();
+    TEST_ASSERT_FALSE(scheduler.isDue()); // Wandlung läuft
+    delay(110);
+    TEST_ASSERT_TRUE(scheduler.isDue());
+    scheduler.run();
+    TEST_ASSERT_FALSE(scheduler.isDue()); // nächste Messung erst im nächsten Intervall
+}
+
+void test_period_and_retry() {
+    SensorScheduler scheduler;
+    int attempts = 0;
+    const int id = scheduler.addSensor("flaky", 500, 0, 1000, nullptr, [&] {
+        attempts++;
+        return attempts == 1 ? Result::Failed : Result::Success; // erster Versuch schlägt fehl
+    });
+
+    runFor(scheduler, 50);
+    TEST_ASSERT_EQUAL_INT(1, attempts);
+    TEST_ASSERT_FALSE(scheduler.hasSample(id));
+
+    runFor(scheduler, 150); // Wiederholung nach RETRY_DELAY
+    TEST_ASSERT_EQUAL_INT(2, attempts);
+    TEST_ASSERT_TRUE(scheduler.hasSample(id));
+
+    runFor(scheduler, 500); // nächstes Intervall
+    TEST_ASSERT_EQUAL_INT(3, attempts);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getDeadlineMisses(id));
+}
+
+void test_deadline_miss_is_counted() {
+    SensorScheduler scheduler;
+    const int id = scheduler.addSensor("broken", 10000, 0, 250, nullptr, [] { return Result::Failed; });
+
+    runFor(scheduler, 400);
+
+    TEST_ASSERT_FALSE(scheduler.hasSample(id));
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getDeadlineMisses(id));
+}
+
+void test_deadline_miss_calls_back() {
+    SensorScheduler scheduler;
+    scheduler.addSensor("ok", 10000, 0, 250, nullptr, [] { return Result::Success; });
+    const int broken = scheduler.addSensor("broken", 10000, 0, 250, nullptr, [] { return Result::Failed; });
+    int missed = -1;
+    int calls = 0;
+    scheduler.onDeadlineMiss([&](const int id) {
+        missed = id;
+        calls++;
+    });
+
+    runFor(scheduler, 200);
+    TEST_ASSERT_EQUAL_INT(0, calls); // Wiederholungen vor der Deadline melden noch nichts
+
+    runFor(scheduler, 200);
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_EQUAL_INT(broken, missed);
+}
+
+void test_failures_are_counted_per_error_code() {
+    SensorScheduler scheduler;
+    int attempts = 0;
+    const int id = scheduler.addSensor("codes", 10000, 0, 10000, nullptr, [&] {
+        attempts++;
+        return Result::Failed;
+    });
+    // Versuch 1, 2: Code 16, danach jeweils ein neuer Code 1..4 (der letzte passt nicht mehr in die Tabelle)
+    scheduler.setErrorSource(id, [&] { return attempts <= 2 ? 16 : attempts - 2; });
+
+    runFor(scheduler, 650); // Versuche bei 0, 100, ..., 600 ms
+    TEST_ASSERT_EQUAL_INT(7, attempts);
+    TEST_ASSERT_EQUAL_UINT32(7, scheduler.getFailures(id));
+
+    SensorScheduler::ErrorCount counts[SensorScheduler::MAX_ERROR_CODES];
+    TEST_ASSERT_EQUAL_UINT8(SensorScheduler::MAX_ERROR_CODES,
+                            scheduler.getErrorCounts(id, counts, SensorScheduler::MAX_ERROR_CODES));
+    TEST_ASSERT_EQUAL_INT(16, counts[0].code);
+    TEST_ASSERT_EQUAL_UINT32(2, counts[0].count);
+    TEST_ASSERT_EQUAL_INT(3, counts[3].code);
+    TEST_ASSERT_EQUAL_UINT32(1, counts[3].count);
+
+    TEST_ASSERT_EQUAL_UINT8(1, scheduler.getErrorCounts(id, counts, 1)); // Platz begrenzt
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler.getErrorCounts(-1, counts, 1));
+}
+
+#if defined(NATIVE)
+void test_period_across_millis_overflow() {
+    HostHal::instance().setUptime((1ULL << 32) * 1000 - 1200000); // 1,2 s vor dem Überlauf von millis()
+    SensorScheduler scheduler;
+    int reads = 0;
+    const int id = scheduler.addSensor("wrap", 500, 100, 1000,
+        [] { return true; },
+        [&] { reads++; return Result::Success; });
+
+    // 3 s: Messungen bei 0, 0,5, 1,0 (kurz vor dem Überlauf), 1,5, 2,0 und 2,5 s
+    runFor(scheduler, 3000);
+    TEST_ASSERT_EQUAL_INT(6, reads);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getDeadlineMisses(id));
+    TEST_ASSERT_LESS_THAN_UINT32(2000, scheduler.getLastSampledAt(id)); // nach dem Überlauf
+}
+#endif
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_conversion_time_is_respected);
+    RUN_TEST(test_budget_spreads_work);
+    RUN_TEST(test_is_due_until_read);
+    RUN_TEST(test_period_and_retry);
+    RUN_TEST(test_deadline_miss_is_counted);
+    RUN_TEST(test_deadline_miss_calls_back);
+    RUN_TEST(test_failures_are_counted_per_error_code);
+#if defined(NATIVE)
+    RUN_TEST(test_period_across_millis_overflow);
+#endif
+    UNITY_END();
+}
+
+void loop() {}
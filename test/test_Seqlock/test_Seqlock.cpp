@@ -0,0 +1,75 @@
+/**
+ * Unit-Test für die Seqlock-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "Seqlock.h"
+
+/**
+ * @brief Testwert, dessen Felder immer zueinander passen müssen.
+ */
+struct Pair {
+    uint32_t value;
+    uint32_t inverted; // immer ~value
+    float half;        // immer value / 2
+};
+
+void test_write_read() {
+    Seqlock<Pair> lock;
+    TEST_ASSERT_EQUAL_UINT32(0, lock.getVersion());
+    TEST_ASSERT_EQUAL_UINT32(0, lock.read().value);
+
+    lock.write({42, ~42u, 21.0f});
+    const Pair pair = lock.read();
+    TEST_ASSERT_EQUAL_UINT32(42, pair.value);
+    TEST_ASSERT_EQUAL_UINT32(~42u, pair.inverted);
+    TEST_ASSERT_EQUAL_FLOAT(21.0f, pair.half);
+    TEST_ASSERT_EQUAL_UINT32(1, lock.getVersion());
+}
+
+static Seqlock<Pair> sharedLock;
+static volatile bool writerDone = false;
+
+void writerTask(void*) {
+    for (uint32_t i = 1; i <= 200000; i++) {
+        sharedLock.write({i, ~i, i / 2.0f});
+    }
+    writerDone = true;
+    vTaskDelete(nullptr);
+}
+
+void test_no_torn_reads_across_cores() {
+    // Schreiber auf Kern 0, Leser (dieser Test) auf Kern 1. Kein gelesener Wert darf gemischt sein.
+    writerDone = false;
+    xTaskCreatePinnedToCore(writerTask, "writer", 2048, nullptr, 1, nullptr, 0);
+
+    uint32_t reads = 0;
+    uint32_t torn = 0;
+    uint32_t last = 0;
+    while (!writerDone) {
+        const Pair pair = sharedLock.read();
+        if (pair.value == 0) {
+            continue; // Schreiber hat noch nicht begonnen
+        }
+        if (pair.inverted != ~pair.value || pair.half != pair.value / 2.0f || pair.value < last) {
+            torn++;
+        }
+        last = pair.value;
+        reads++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, reads);
+    TEST_ASSERT_EQUAL_UINT32(200000, sharedLock.getVersion());
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_write_read);
+    RUN_TEST(test_no_torn_reads_across_cores);
+    UNITY_END();
+}
+
+void loop() {}
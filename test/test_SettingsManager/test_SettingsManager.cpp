@@ -0,0 +1,85 @@
+/**
+ * Unit-Test für die SettingsManager-Bibliothek
+ *
+ * Die Datei liegt für den Test im LittleFS (im nativen Build in einem Verzeichnis des Rechners).
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "SettingsManager.h"
+
+const char* SETTINGS_PATH = "/test_settings.json";
+
+void test_missing_file_creates_defaults() {
+    LittleFS.remove(SETTINGS_PATH);
+    SettingsManager manager(SETTINGS_PATH);
+    TEST_ASSERT_TRUE(manager.begin());
+    TEST_ASSERT_TRUE(LittleFS.exists(SETTINGS_PATH));
+
+    const Settings defaults;
+    TEST_ASSERT_EQUAL_INT(defaults.soilMoistureTarget, manager.get().soilMoistureTarget);
+    TEST_ASSERT_EQUAL_INT(MODE_AUTO, manager.get().pumpMode);
+}
+
+void test_save_and_load_roundtrip() {
+    SettingsManager writer(SETTINGS_PATH);
+    Settings& settings = writer.getMutable();
+    settings.airTempThresholdHigh = 26.5f;
+    settings.soilMoistureTarget = 42;
+    settings.wateringDurationMs = 1234;
+    settings.light2OffHour = 22;
+    settings.fanMode = MODE_OFF;
+    settings.misterMode = MODE_ON;
+    TEST_ASSERT_TRUE(writer.save());
+
+    SettingsManager reader(SETTINGS_PATH);
+    TEST_ASSERT_TRUE(reader.begin());
+    TEST_ASSERT_EQUAL_FLOAT(26.5f, reader.get().airTempThresholdHigh);
+    TEST_ASSERT_EQUAL_INT(42, reader.get().soilMoistureTarget);
+    TEST_ASSERT_EQUAL_UINT32(1234, reader.get().wateringDurationMs);
+    TEST_ASSERT_EQUAL_INT(22, reader.get().light2OffHour);
+    TEST_ASSERT_EQUAL_INT(MODE_OFF, reader.get().fanMode);
+    TEST_ASSERT_EQUAL_INT(MODE_ON, reader.get().misterMode);
+    TEST_ASSERT_EQUAL_INT(MODE_AUTO, reader.get().heaterMode);
+}
+
+void test_missing_keys_keep_defaults() {
+    File file = LittleFS.open(SETTINGS_PATH, "w");
+    TEST_ASSERT_TRUE(static_cast<bool>(file));
+    const char json[] = "{\"soilMoistureTarget\":35}";
+    file.write(reinterpret_cast<const uint8_t*>(json), strlen(json));
+    file.close();
+
+    SettingsManager manager(SETTINGS_PATH);
+    TEST_ASSERT_TRUE(manager.begin());
+    TEST_ASSERT_EQUAL_INT(35, manager.get().soilMoistureTarget);
+    TEST_ASSERT_EQUAL_FLOAT(Settings().humidityTarget, manager.get().humidityTarget);
+}
+
+void test_corrupt_file_loads_defaults() {
+    File file = LittleFS.open(SETTINGS_PATH, "w");
+    TEST_ASSERT_TRUE(static_cast<bool>(file));
+    const char json[] = "{\"soilMoistureTarget\":";
+    file.write(reinterpret_cast<const uint8_t*>(json), strlen(json));
+    file.close();
+
+    SettingsManager manager(SETTINGS_PATH);
+    TEST_ASSERT_FALSE(manager.begin());
+    TEST_ASSERT_EQUAL_INT(Settings().soilMoistureTarget, manager.get().soilMoistureTarget);
+}
+
+void setup() {
+    delay(2000);
+    LittleFS.begin(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_missing_file_creates_defaults);
+    RUN_TEST(test_save_and_load_roundtrip);
+    RUN_TEST(test_missing_keys_keep_defaults);
+    RUN_TEST(test_corrupt_file_loads_defaults);
+    LittleFS.remove(SETTINGS_PATH);
+    UNITY_END();
+}
+
+void loop() {}
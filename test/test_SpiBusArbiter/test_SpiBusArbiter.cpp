@@ -0,0 +1,94 @@
+/**
+ * Unit-Test für die SpiBusArbiter-Bibliothek
+ *
+ * Die Tests prüfen nur die Verwaltung des Busses (Mutex, Verschachtelung, Statistik), es muss kein Gerät
+ * angeschlossen sein. Die CS-Pins werden lediglich auf HIGH gesetzt.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SpiBusArbiter.h"
+
+constexpr uint8_t SD_CS_PIN = 16;
+constexpr uint8_t CAM_CS_PIN = 17;
+
+SpiBusArbiter spiBus;
+int sdDevice = SpiBusArbiter::NO_DEVICE;
+int cameraDevice = SpiBusArbiter::NO_DEVICE;
+
+void test_add_device() {
+    TEST_ASSERT_EQUAL_INT(0, sdDevice);
+    TEST_ASSERT_EQUAL_INT(1, cameraDevice);
+    TEST_ASSERT_EQUAL_UINT8(2, spiBus.getDeviceCount());
+    TEST_ASSERT_EQUAL_UINT32(8000000, spiBus.getClock(cameraDevice));
+    TEST_ASSERT_EQUAL_STRING("sd", spiBus.getName(sdDevice));
+    TEST_ASSERT_EQUAL_INT(HIGH, digitalRead(CAM_CS_PIN));
+}
+
+void test_nested_locks_do_not_wait() {
+    const uint32_t before = spiBus.getStats(SpiBusArbiter::NO_DEVICE).acquisitions;
+    const uint32_t cameraBefore = spiBus.getStats(cameraDevice).acquisitions;
+    {
+        SpiBusArbiter::Lock batch(&spiBus, SpiBusArbiter::NO_DEVICE);
+        TEST_ASSERT_TRUE(static_cast<bool>(batch));
+        for (int i = 0; i < 10; i++) {
+            SpiBusArbiter::Lock lock(&spiBus, cameraDevice);
+            TEST_ASSERT_TRUE(static_cast<bool>(lock));
+        }
+    }
+    // Nur der äußere Lock musste den Mutex holen
+    TEST_ASSERT_EQUAL_UINT32(before + 1, spiBus.getStats(SpiBusArbiter::NO_DEVICE).acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(cameraBefore, spiBus.getStats(cameraDevice).acquisitions);
+}
+
+static volatile bool holderRunning = false;
+
+void holderTask(void*) {
+    {
+        SpiBusArbiter::Lock lock(&spiBus, sdDevice);
+        holderRunning = true;
+        vTaskDelay(pdMS_TO_TICKS(200));
+    }
+    holderRunning = false;
+    vTaskDelete(nullptr);
+}
+
+void test_timeout_and_wait_stats() {
+    xTaskCreatePinnedToCore(holderTask, "holder", 2048, nullptr, 1, nullptr, 0);
+    while (!holderRunning) {
+        delay(1);
+    }
+
+    // Der andere Task hält den Bus: kurzes Zeitlimit läuft ab
+    {
+        SpiBusArbiter::Lock lock(&spiBus, sdDevice, 20);
+        TEST_ASSERT_FALSE(static_cast<bool>(lock));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, spiBus.getStats(sdDevice).timeouts);
+
+    // Ohne Zeitlimit wird gewartet, bis der Bus frei ist
+    {
+        SpiBusArbiter::Lock lock(&spiBus, sdDevice);
+        TEST_ASSERT_TRUE(static_cast<bool>(lock));
+        TEST_ASSERT_FALSE(holderRunning);
+    }
+    const SpiBusArbiter::WaitStats stats = spiBus.getStats(sdDevice);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2, stats.contended);
+    TEST_ASSERT_GREATER_THAN_UINT32(100000, stats.maxWaitUs);
+}
+
+void setup() {
+    delay(2000);
+    sdDevice = spiBus.addDevice("sd", SD_CS_PIN, 20000000, SPI_MODE0, false);
+    cameraDevice = spiBus.addDevice("camera", CAM_CS_PIN, 8000000);
+    spiBus.begin();
+    SPI.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_add_device);
+    RUN_TEST(test_nested_locks_do_not_wait);
+    RUN_TEST(test_timeout_and_wait_stats);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,83 @@
+/**
+ * Unit-Test für die SpscQueue-Bibliothek
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SpscQueue.h"
+
+void test_push_pop_order() {
+    SpscQueue<int, 8> queue;
+    TEST_ASSERT_TRUE(queue.empty());
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(queue.push(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, queue.size());
+
+    int value = -1;
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL_INT(i, value);
+    }
+    TEST_ASSERT_FALSE(queue.pop(value));
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_full_queue_drops() {
+    SpscQueue<int, 4> queue;
+
+    // Kapazität 4 bedeutet 3 nutzbare Plätze.
+    TEST_ASSERT_TRUE(queue.push(1));
+    TEST_ASSERT_TRUE(queue.push(2));
+    TEST_ASSERT_TRUE(queue.push(3));
+    TEST_ASSERT_FALSE(queue.push(4));
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDropped());
+
+    // Nach pop() ist wieder Platz, auch über das Ende des Puffers hinweg.
+    int value = 0;
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_TRUE(queue.push(5));
+    TEST_ASSERT_EQUAL_UINT32(3, queue.size());
+}
+
+static SpscQueue<uint32_t, 32> crossCoreQueue;
+static constexpr uint32_t CROSS_CORE_COUNT = 10000;
+
+void producerTask(void*) {
+    for (uint32_t i = 0; i < CROSS_CORE_COUNT;) {
+        if (crossCoreQueue.push(i)) {
+            i++;
+        } else {
+            taskYIELD();
+        }
+    }
+    vTaskDelete(nullptr);
+}
+
+void test_cross_core_transfer() {
+    // Erzeuger auf Kern 0, Verbraucher (dieser Test) auf Kern 1. Alle Werte müssen vollständig und in Reihenfolge ankommen.
+    xTaskCreatePinnedToCore(producerTask, "producer", 2048, nullptr, 1, nullptr, 0);
+
+    uint32_t expected = 0;
+    const unsigned long start = millis();
+    while (expected < CROSS_CORE_COUNT && millis() - start < 5000) {
+        uint32_t value;
+        if (crossCoreQueue.pop(value)) {
+            TEST_ASSERT_EQUAL_UINT32(expected, value);
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(CROSS_CORE_COUNT, expected);
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_push_pop_order);
+    RUN_TEST(test_full_queue_drops);
+    RUN_TEST(test_cross_core_transfer);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,152 @@
+/**
+ * Unit-Test für die StateDelta-Bibliothek (Änderungserkennung der Statusnachricht)
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <unity.h>
+#include "StateDelta.h"
+
+const StateDelta::Deadbands DEADBANDS = {0.1f, 1.0f, 1, 0.05f}; // wie config.h
+
+/**
+ * @brief Ein Status mit gültigen Messwerten.
+ */
+StateFrame sampleFrame() {
+    StateFrame frame;
+    frame.valid = FIELD_AIR_TEMP | FIELD_HUMIDITY | FIELD_SOIL_TEMP | FIELD_SOIL_MOISTURE | FIELD_WATER_LEVEL | FIELD_LIGHT_LUX;
+    frame.actuators = ACTUATOR_LAMP1;
+    frame.flags = STATE_WATER_LEVEL_OK;
+    frame.sequence = 1;
+    frame.airTemp = 23.0f;
+    frame.humidity = 60.0f;
+    frame.soilTemp = 20.0f;
+    frame.soilMoisture = 40;
+    frame.lightLux = 1000.0f;
+    return frame;
+}
+
+/**
+ * @brief Legt einen StateDelta an, der frame bereits vollständig gesendet hat.
+ */
+StateDelta sentDelta(const StateFrame& frame) {
+    StateDelta delta(DEADBANDS);
+    delta.markSent(frame, delta.getChanges(frame, true));
+    return delta;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_deadband_edges() {
+    TEST_ASSERT_FALSE(StateDelta::exceedsDeadband(20.0f, 20.0f, 0.5f));
+    TEST_ASSERT_FALSE(StateDelta::exceedsDeadband(20.0f, 20.25f, 0.5f));
+    TEST_ASSERT_TRUE(StateDelta::exceedsDeadband(20.0f, 20.5f, 0.5f)); // genau die Schwelle zählt
+    TEST_ASSERT_TRUE(StateDelta::exceedsDeadband(20.0f, 19.5f, 0.5f)); // in beide Richtungen
+    TEST_ASSERT_FALSE(StateDelta::exceedsDeadband(NAN, NAN, 0.5f));
+}
+
+void test_nan_transitions_always_change() {
+    TEST_ASSERT_TRUE(StateDelta::exceedsDeadband(20.0f, NAN, 100.0f));
+    TEST_ASSERT_TRUE(StateDelta::exceedsDeadband(NAN, 20.0f, 100.0f));
+
+    // Auch wenn das valid-Bit (noch) gleich ist, zählt der Wechsel auf NAN
+    StateFrame frame = sampleFrame();
+    StateDelta delta = sentDelta(frame);
+    frame.airTemp = NAN;
+    TEST_ASSERT_EQUAL_HEX8(FIELD_AIR_TEMP, delta.getChanges(frame).sensors);
+    delta.markSent(frame, delta.getChanges(frame));
+    TEST_ASSERT_EQUAL_HEX8(0, delta.getChanges(frame).sensors); // NAN -> NAN ist keine Änderung
+    frame.airTemp = 23.0f;
+    TEST_ASSERT_EQUAL_HEX8(FIELD_AIR_TEMP, delta.getChanges(frame).sensors);
+}
+
+void test_valid_bit_changes() {
+    StateFrame frame = sampleFrame();
+    StateDelta delta = sentDelta(frame);
+    frame.valid &= ~FIELD_SOIL_MOISTURE;
+    frame.soilMoisture = 40; // Wert unverändert, nur ungültig geworden
+    TEST_ASSERT_EQUAL_HEX8(FIELD_SOIL_MOISTURE, delta.getChanges(frame).sensors);
+}
+
+void test_small_changes_add_up() {
+    StateFrame frame = sampleFrame();
+    StateDelta delta = sentDelta(frame);
+    frame.airTemp = 23.06f; // unter der Schwelle: nichts senden
+    StateDelta::Changes changes = delta.getChanges(frame);
+    TEST_ASSERT_FALSE(changes.any());
+    delta.markSent(frame, changes);
+
+    frame.airTemp = 23.12f; // gegenüber dem gesendeten Wert (23,0) über der Schwelle
+    changes = delta.getChanges(frame);
+    TEST_ASSERT_EQUAL_HEX8(FIELD_AIR_TEMP, changes.sensors);
+    delta.markSent(frame, changes);
+    TEST_ASSERT_EQUAL_FLOAT(23.12f, delta.getPublished().airTemp);
+}
+
+void test_light_and_soil_moisture_edges() {
+    StateFrame frame = sampleFrame();
+    StateDelta delta = sentDelta(frame);
+    frame.lightLux = 1049.0f; // 5 % von 1000 Lux = 50 Lux
+    TEST_ASSERT_EQUAL_HEX8(0, delta.getChanges(frame).sensors);
+    frame.lightLux = 1050.0f;
+    TEST_ASSERT_EQUAL_HEX8(FIELD_LIGHT_LUX, delta.getChanges(frame).sensors);
+
+    frame = sampleFrame();
+    frame.lightLux = 0.0f;
+    delta = sentDelta(frame);
+    frame.lightLux = 0.9f; // im Dunkeln mindestens 1 Lux
+    TEST_ASSERT_EQUAL_HEX8(0, delta.getChanges(frame).sensors);
+    frame.lightLux = 1.0f;
+    TEST_ASSERT_EQUAL_HEX8(FIELD_LIGHT_LUX, delta.getChanges(frame).sensors);
+
+    frame = sampleFrame();
+    delta = sentDelta(frame);
+    frame.soilMoisture = 41;
+    TEST_ASSERT_EQUAL_HEX8(FIELD_SOIL_MOISTURE, delta.getChanges(frame).sensors);
+}
+
+void test_actuators_and_full() {
+    StateFrame frame = sampleFrame();
+    StateDelta delta = sentDelta(frame);
+    frame.actuators = ACTUATOR_LAMP1 | ACTUATOR_PUMP;
+    frame.flags = 0;
+    const StateDelta::Changes changes = delta.getChanges(frame);
+    TEST_ASSERT_EQUAL_HEX8(ACTUATOR_PUMP, changes.actuators);
+    TEST_ASSERT_EQUAL_HEX8(FIELD_WATER_LEVEL, changes.sensors);
+
+    const StateDelta::Changes full = delta.getChanges(frame, true);
+    TEST_ASSERT_EQUAL_HEX8(StateDelta::ALL, full.sensors);
+    TEST_ASSERT_EQUAL_HEX8(StateDelta::ALL, full.actuators);
+}
+
+void test_json_contains_only_changes() {
+    StateFrame frame = sampleFrame();
+    StateDelta::Changes changes;
+    changes.sensors = FIELD_HUMIDITY;
+    changes.actuators = ACTUATOR_FAN;
+    JsonDocument doc;
+    const JsonObject values = doc.to<JsonObject>();
+    StateDelta::fillJson(values, frame, changes);
+    TEST_ASSERT_EQUAL_UINT32(1, values["seq"].as<uint32_t>());
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, values["humidity"].as<float>());
+    TEST_ASSERT_FALSE(values["fanOn"].as<bool>());
+    TEST_ASSERT_TRUE(values["airTemp"].isNull());
+    TEST_ASSERT_TRUE(values["lamp1On"].isNull());
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_deadband_edges);
+    RUN_TEST(test_nan_transitions_always_change);
+    RUN_TEST(test_valid_bit_changes);
+    RUN_TEST(test_small_changes_add_up);
+    RUN_TEST(test_light_and_soil_moisture_edges);
+    RUN_TEST(test_actuators_and_full);
+    RUN_TEST(test_json_contains_only_changes);
+    UNITY_END();
+}
+
+void loop() {}
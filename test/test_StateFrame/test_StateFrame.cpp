@@ -0,0 +1,128 @@
+/**
+ * Unit-Test für die binäre Statusnachricht (StateFrame) mit Vergleichsmessung gegen JSON
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <unity.h>
+#include <cstddef>
+#include <esp_timer.h>
+#include "StateFrame.h"
+
+constexpr int RUNS = 200; // Durchläufe je Messung
+
+/**
+ * @brief Erstellt die JSON-Statusnachricht mit denselben Werten wie der Frame (wie broadcastStateJson()).
+ */
+size_t serializeStateJson(const StateFrame& frame, String& out) {
+    JsonDocument doc;
+    doc["type"] = "state";
+    const JsonObject values = doc["payload"].to<JsonObject>();
+    values["seq"] = frame.sequence;
+    values["valid"] = frame.valid;
+    values["airTemp"] = frame.airTemp;
+    values["humidity"] = frame.humidity;
+    values["soilTemp"] = frame.soilTemp;
+    values["soilMoisture"] = frame.soilMoisture;
+    values["waterLevelOk"] = (frame.flags & STATE_WATER_LEVEL_OK) != 0;
+    values["lightLux"] = frame.lightLux;
+    values["lamp1On"] = (frame.actuators & ACTUATOR_LAMP1) != 0;
+    values["lamp2On"] = (frame.actuators & ACTUATOR_LAMP2) != 0;
+    values["heaterOn"] = (frame.actuators & ACTUATOR_HEATER) != 0;
+    values["fanOn"] = (frame.actuators & ACTUATOR_FAN) != 0;
+    values["pumpOn"] = (frame.actuators & ACTUATOR_PUMP) != 0;
+    values["misterOn"] = (frame.actuators & ACTUATOR_MISTER) != 0;
+    values["controlLatencyUs"] = frame.controlLatencyUs;
+    values["controlLatencyMaxUs"] = frame.controlLatencyMaxUs;
+    values["controlCycleMaxUs"] = frame.controlCycleMaxUs;
+    out = "";
+    return serializeJson(doc, out);
+}
+
+StateFrame sampleFrame() {
+    StateFrame frame;
+    frame.valid = 0x3F;
+    frame.actuators = ACTUATOR_LAMP1 | ACTUATOR_FAN;
+    frame.flags = STATE_WATER_LEVEL_OK;
+    frame.sequence = 123456;
+    frame.airTemp = 23.4f;
+    frame.humidity = 61.5f;
+    frame.soilTemp = 19.8f;
+    frame.soilMoisture = 42;
+    frame.lightLux = 1520.0f;
+    frame.controlLatencyUs = 180;
+    frame.controlLatencyMaxUs = 950;
+    frame.controlCycleMaxUs = 410;
+    return frame;
+}
+
+void test_layout() {
+    // Die Offsets sind in script.js (decodeStateFrame) fest eingetragen
+    TEST_ASSERT_EQUAL(40, sizeof(StateFrame));
+    TEST_ASSERT_EQUAL(0, offsetof(StateFrame, version));
+    TEST_ASSERT_EQUAL(1, offsetof(StateFrame, valid));
+    TEST_ASSERT_EQUAL(2, offsetof(StateFrame, actuators));
+    TEST_ASSERT_EQUAL(3, offsetof(StateFrame, flags));
+    TEST_ASSERT_EQUAL(4, offsetof(StateFrame, sequence));
+    TEST_ASSERT_EQUAL(8, offsetof(StateFrame, airTemp));
+    TEST_ASSERT_EQUAL(20, offsetof(StateFrame, soilMoisture));
+    TEST_ASSERT_EQUAL(24, offsetof(StateFrame, lightLux));
+    TEST_ASSERT_EQUAL(36, offsetof(StateFrame, controlCycleMaxUs));
+    TEST_ASSERT_EQUAL_UINT8(STATE_FRAME_VERSION, StateFrame().version);
+}
+
+void test_little_endian() {
+    const StateFrame frame = sampleFrame();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&frame);
+    TEST_ASSERT_EQUAL_UINT8(123456 & 0xFF, bytes[4]); // niedrigstes Byte zuerst
+    TEST_ASSERT_EQUAL_UINT8((123456 >> 16) & 0xFF, bytes[6]);
+    TEST_ASSERT_EQUAL_UINT8(42, bytes[20]);
+}
+
+volatile uint32_t benchmarkSink; // Nimmt das Ergebnis des Benchmarks auf
+
+void test_benchmark_json_vs_binary() {
+    const StateFrame frame = sampleFrame();
+    String json;
+    uint8_t buffer[sizeof(StateFrame)];
+
+    size_t jsonBytes = 0;
+    const int64_t jsonStart = esp_timer_get_time();
+    for (int i = 0; i < RUNS; i++) {
+        jsonBytes = serializeStateJson(frame, json);
+    }
+    const float jsonUs = static_cast<float>(esp_timer_get_time() - jsonStart) / RUNS;
+
+    // Die Prüfsumme verwendet jeden kopierten Frame, damit der Compiler die Schleife nicht wegoptimiert
+    uint32_t checksum = 0;
+    const int64_t binaryStart = esp_timer_get_time();
+    for (int i = 0; i < RUNS; i++) {
+        StateFrame copy = sampleFrame();
+        copy.sequence = i;
+        memcpy(buffer, &copy, sizeof(copy));
+        for (const uint8_t byte : buffer) {
+            checksum += byte;
+        }
+    }
+    const float binaryUs = static_cast<float>(esp_timer_get_time() - binaryStart) / RUNS;
+    benchmarkSink = checksum;
+
+    char message[96];
+    snprintf(message, sizeof(message), "JSON: %u Byte, %.1f us | binaer: %u Byte, %.1f us",
+             static_cast<unsigned>(jsonBytes), jsonUs, static_cast<unsigned>(sizeof(buffer)), binaryUs);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_LESS_THAN(jsonBytes, sizeof(StateFrame));
+    TEST_ASSERT_TRUE(binaryUs < jsonUs);
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_layout);
+    RUN_TEST(test_little_endian);
+    RUN_TEST(test_benchmark_json_vs_binary);
+    UNITY_END();
+}
+
+void loop() {}